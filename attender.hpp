@@ -10,8 +10,15 @@
 #include <attender/ssl_contexts/ssl_example_context.hpp>
 
 #include <attender/http/response.hpp>
+#include <attender/http/static_response.hpp>
+#include <attender/http/sse_hub.hpp>
 #include <attender/http/request.hpp>
+#include <attender/http/http_task.hpp>
+#include <attender/http/http_file_sink.hpp>
 
 // Encoders
 #include <attender/encoding/streaming_producer.hpp>
+#include <attender/encoding/spsc_producer.hpp>
 #include <attender/encoding/brotli.hpp>
+#include <attender/encoding/zlib.hpp>
+#include <attender/encoding/zstd.hpp>
@@ -0,0 +1,114 @@
+/**
+ *  Throughput and compression ratio of the gzip, brotli and (if enabled) zstd producers at several levels.
+ *  The input is generated json, fed in pieces of 16 KiB and drained after every piece, like send_chunked does.
+ *
+ *  zstd runs with 0 (compression on the pushing thread) and more workers.
+ *
+ *  usage: encoding_benchmark [input size in MB]
+ */
+
+#include <attender/encoding/brotli.hpp>
+#include <attender/encoding/zlib.hpp>
+#include <attender/encoding/zstd.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace attender;
+
+namespace
+{
+    std::string make_json(std::size_t size)
+    {
+        static char const* const names[] = {"alpha", "bravo", "charlie", "delta", "echo", "foxtrot", "golf"};
+
+        std::mt19937 random{42};
+        std::string json = "[";
+        while (json.size() < size)
+        {
+            json += "{\"id\":" + std::to_string(random() % 1'000'000);
+            json += ",\"name\":\"" + std::string{names[random() % 7]} + "\"";
+            json += ",\"score\":" + std::to_string(random() % 10'000) + "." + std::to_string(random() % 100);
+            json += ",\"active\":" + std::string{random() % 2 ? "true" : "false"} + "},";
+        }
+        json.back() = ']';
+        return json;
+    }
+
+    template <typename EncoderT>
+    std::size_t drain(EncoderT& encoder)
+    {
+        std::size_t drained = 0;
+        for (std::size_t size = 0; (size = encoder.available()) != 0; drained += size)
+            encoder.has_consumed(size);
+        return drained;
+    }
+
+    template <typename EncoderT>
+    void measure(std::string const& name, EncoderT& encoder, std::string const& input)
+    {
+        constexpr std::size_t piece = 16 * 1024;
+
+        std::size_t output = 0;
+        auto start = std::chrono::steady_clock::now();
+        for (std::size_t offset = 0; offset < input.size(); offset += piece)
+        {
+            encoder.push(input.data() + offset, std::min(piece, input.size() - offset));
+            output += drain(encoder);
+        }
+        encoder.finish();
+        output += drain(encoder);
+        auto elapsed = std::chrono::duration <double> (std::chrono::steady_clock::now() - start).count();
+
+        std::cout << std::left << std::setw(16) << name
+                  << std::right << std::setw(10) << std::fixed << std::setprecision(1) << input.size() / elapsed / 1e6 << " MB/s"
+                  << std::setw(10) << std::setprecision(2) << static_cast <double> (input.size()) / output << " ratio\n";
+    }
+}
+
+int main(int argc, char** argv)
+{
+    std::size_t size = (argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 8) * 1024 * 1024;
+    auto input = make_json(size);
+
+    for (int level : {1, 6, 9})
+    {
+        gzip_encoder gzip{{level, 15, 8}};
+        measure("gzip " + std::to_string(level), gzip, input);
+    }
+
+    for (int quality : {1, 4, 6, 9, 11})
+    {
+        auto config = brotli_configuration::make_default();
+        config.quality = quality;
+        brotli_encoder brotli{config};
+        measure("brotli " + std::to_string(quality), brotli, input);
+    }
+
+#ifdef ATTENDER_ENABLE_ZSTD
+    int cores = static_cast <int> (std::max(1u, std::thread::hardware_concurrency()));
+    std::vector <int> worker_counts{0, 1};
+    for (int workers = 2; workers <= cores; workers *= 2)
+        worker_counts.push_back(workers);
+
+    for (int level : {3, 9, 19})
+    {
+        for (int workers : worker_counts)
+        {
+            zstd_encoder zstd{{level, workers, false, 0}};
+            measure("zstd " + std::to_string(level) + " w" + std::to_string(workers), zstd, input);
+        }
+    }
+    zstd_encoder long_distance{{9, cores, true, 0}};
+    measure("zstd 9 ldm w" + std::to_string(cores), long_distance, input);
+#endif
+
+    return 0;
+}
@@ -0,0 +1,258 @@
+/**
+ *  Messages per second and latency of streaming_producer and spsc_producer.
+ *  A thread pushes small timestamped messages as fast as the producer takes them, waiting with when_writable
+ *  when it is full. A client in the same process reads the chunked stream and measures the time from push to
+ *  receive of every message.
+ *  It also measures the time from request to first chunk for a producer thread that blocks in wait_for_consumer
+ *  and for a producer that starts from when_attached.
+ *
+ *  usage: producer_benchmark [messages]
+ */
+
+#include <attender/encoding/spsc_producer.hpp>
+#include <attender/encoding/streaming_producer.hpp>
+#include <attender/http/chunked_decoder.hpp>
+#include <attender/http/http_read_sink.hpp>
+#include <attender/http/http_server.hpp>
+#include <attender/http/response.hpp>
+#include <attender/io_context/managed_io_context.hpp>
+#include <attender/io_context/thread_pooler.hpp>
+
+#include <boost/asio.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <cstdio>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace attender;
+
+namespace
+{
+    constexpr std::size_t message_size = 64;
+
+    std::size_t message_count = 1'000'000;
+
+    constexpr std::size_t first_chunk_rounds = 1000;
+
+    long long now()
+    {
+        return std::chrono::duration_cast <std::chrono::nanoseconds> (
+            std::chrono::steady_clock::now().time_since_epoch()
+        ).count();
+    }
+
+    /**
+     *  Pushes the messages, the producer has try_push and when_writable.
+     */
+    template <typename ProducerT>
+    void produce(ProducerT& produ)
+    {
+        produ.wait_for_consumer();
+
+        std::mutex mutex;
+        std::condition_variable writable;
+        bool ready = false;
+
+        char message[message_size];
+        std::fill(std::begin(message), std::end(message), '.');
+        message[message_size - 1] = '\n';
+
+        for (std::size_t i = 0; i != message_count && produ.has_consumer_attached(); ++i)
+        {
+            std::snprintf(message, 21, "%020lld", now());
+            message[20] = '.';
+            while (!produ.try_push({message, message_size}))
+            {
+                {
+                    std::lock_guard <std::mutex> guard{mutex};
+                    ready = false;
+                }
+                produ.when_writable([&]{
+                    std::lock_guard <std::mutex> guard{mutex};
+                    ready = true;
+                    writable.notify_one();
+                });
+                std::unique_lock <std::mutex> lock{mutex};
+                writable.wait(lock, [&]{ return ready; });
+            }
+        }
+        produ.finish();
+    }
+
+    /**
+     *  Collects the latency of every received message.
+     */
+    class latency_sink : public http_read_sink
+    {
+    public:
+        size_type write(const char* data, size_type size) override
+        {
+            auto received = now();
+            for (size_type i = 0; i != size; ++i)
+            {
+                partial_[filled_++] = data[i];
+                if (filled_ == message_size)
+                {
+                    latencies.push_back(received - std::strtoll(partial_, nullptr, 10));
+                    filled_ = 0;
+                }
+            }
+            return size;
+        }
+
+        size_type write(std::vector <char> const& buffer, size_type amount) override
+        {
+            return write(buffer.data(), amount);
+        }
+
+        std::vector <long long> latencies;
+
+    private:
+        char partial_[message_size + 1] = {};
+        std::size_t filled_ = 0;
+    };
+
+    void measure(std::string const& name, std::string const& path)
+    {
+        boost::asio::io_context context;
+        boost::asio::ip::tcp::socket socket{context};
+        socket.connect({boost::asio::ip::make_address("127.0.0.1"), 18302});
+
+        std::string request = "GET " + path + " HTTP/1.1\r\nHost: localhost\r\n\r\n";
+        boost::asio::write(socket, boost::asio::buffer(request));
+
+        latency_sink sink;
+        sink.latencies.reserve(message_count);
+        chunked_decoder decoder;
+        std::vector <char> buffer(256 * 1024);
+        bool header_done = false;
+        auto start = std::chrono::steady_clock::now();
+        for (;;)
+        {
+            boost::system::error_code ec;
+            auto size = socket.read_some(boost::asio::buffer(buffer), ec);
+            if (ec)
+                break;
+
+            char const* begin = buffer.data();
+            if (!header_done)
+            {
+                auto header_end = std::search(begin, begin + size, "\r\n\r\n", "\r\n\r\n" + 4);
+                if (header_end == begin + size)
+                    continue;
+                header_done = true;
+                size -= header_end + 4 - begin;
+                begin = header_end + 4;
+            }
+            if (decoder.feed(begin, size, sink) != chunked_decoder::result::need_more)
+                break;
+        }
+        auto elapsed = std::chrono::duration <double> (std::chrono::steady_clock::now() - start).count();
+
+        auto& latencies = sink.latencies;
+        if (latencies.size() != message_count)
+        {
+            std::cout << name << ": received " << latencies.size() << " of " << message_count << " messages\n";
+            return;
+        }
+        std::sort(latencies.begin(), latencies.end());
+
+        std::cout << std::left << std::setw(12) << name
+                  << std::right << std::setw(12) << std::fixed << std::setprecision(0) << latencies.size() / elapsed << " messages/s"
+                  << std::setw(10) << std::setprecision(1) << latencies[latencies.size() / 2] / 1000. << " us p50"
+                  << std::setw(10) << latencies[latencies.size() * 99 / 100] / 1000. << " us p99\n";
+    }
+
+    /**
+     *  The time from sending the request until the first chunk arrived, over a new connection each round.
+     */
+    void measure_first_chunk(std::string const& name, std::string const& path)
+    {
+        std::string request = "GET " + path + " HTTP/1.1\r\nHost: localhost\r\n\r\n";
+        std::vector <long long> latencies;
+        latencies.reserve(first_chunk_rounds);
+        for (std::size_t i = 0; i != first_chunk_rounds; ++i)
+        {
+            boost::asio::io_context context;
+            boost::asio::ip::tcp::socket socket{context};
+            socket.connect({boost::asio::ip::make_address("127.0.0.1"), 18302});
+
+            auto start = now();
+            boost::asio::write(socket, boost::asio::buffer(request));
+
+            std::string received;
+            boost::system::error_code ec;
+            boost::asio::read_until(socket, boost::asio::dynamic_buffer(received), "5\r\nfirst\r\n", ec);
+            if (ec)
+            {
+                std::cout << name << ": " << ec.message() << "\n";
+                return;
+            }
+            latencies.push_back(now() - start);
+        }
+        std::sort(latencies.begin(), latencies.end());
+
+        std::cout << std::left << std::setw(24) << name
+                  << std::right << std::fixed << std::setprecision(1)
+                  << std::setw(10) << latencies[latencies.size() / 2] / 1000. << " us p50"
+                  << std::setw(10) << latencies[latencies.size() * 99 / 100] / 1000. << " us p99 to first chunk\n";
+    }
+}
+
+int main(int argc, char** argv)
+{
+    if (argc > 1)
+        message_count = std::strtoull(argv[1], nullptr, 10);
+
+    managed_io_context <thread_pooler> context;
+    http_server server(context.get_io_context(), [](auto*, auto const&, auto const&){});
+
+    std::vector <std::thread> producers;
+    server.get("/streaming", [&producers](auto, auto res) {
+        auto produ = std::make_shared <streaming_producer> ("identity", []{}, [](auto){});
+        producers.emplace_back([produ]{ produce(*produ); });
+        res->send_chunked(*produ, [produ](auto){});
+    });
+    server.get("/spsc", [&producers, &context](auto, auto res) {
+        auto produ = std::make_shared <spsc_producer> (*context.get_io_context());
+        producers.emplace_back([produ]{ produce(*produ); });
+        res->send_chunked(*produ, [produ](auto){});
+    });
+    server.get("/first/waiting", [&producers](auto, auto res) {
+        auto produ = std::make_shared <streaming_producer> ("identity", []{}, [](auto){});
+        producers.emplace_back([produ]{
+            produ->wait_for_consumer();
+            *produ << std::string{"first"};
+            produ->finish();
+        });
+        res->send_chunked(*produ, [produ](auto){});
+    });
+    server.get("/first/attached", [](auto, auto res) {
+        auto produ = std::make_shared <streaming_producer> ("identity", []{}, [](auto){});
+        produ->when_attached([raw = produ.get()]{
+            *raw << std::string{"first"};
+            raw->finish();
+        });
+        res->send_chunked(*produ, [produ](auto){});
+    });
+    server.start("18302", "127.0.0.1");
+
+    measure("streaming", "/streaming");
+    measure("spsc", "/spsc");
+    measure_first_chunk("wait_for_consumer", "/first/waiting");
+    measure_first_chunk("when_attached", "/first/attached");
+
+    context.teardown();
+    for (auto& producer : producers)
+        producer.join();
+    return 0;
+}
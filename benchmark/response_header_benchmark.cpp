@@ -0,0 +1,128 @@
+/**
+ *  Nanoseconds and heap allocations per serialized response header, compared to the stringstream
+ *  serialization it replaced.
+ *
+ *  usage: response_header_benchmark [iterations]
+ */
+
+#include <attender/http/response_header.hpp>
+
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <new>
+#include <sstream>
+#include <string>
+
+using namespace attender;
+
+namespace
+{
+    std::size_t sink = 0;
+    std::size_t allocations = 0;
+}
+
+void* operator new(std::size_t size)
+{
+    ++allocations;
+    if (auto* ptr = std::malloc(size == 0 ? 1 : size))
+        return ptr;
+    throw std::bad_alloc{};
+}
+
+void operator delete(void* ptr) noexcept
+{
+    std::free(ptr);
+}
+
+void operator delete(void* ptr, std::size_t) noexcept
+{
+    std::free(ptr);
+}
+
+namespace
+{
+
+    response_header typical_header()
+    {
+        response_header header;
+        header.set_code(200);
+        header.set_field("Content-Type", "application/json");
+        header.set_field("Content-Length", "1387");
+        header.set_field("Cache-Control", "no-cache");
+        header.set_cookie(cookie{"session", "0123456789abcdef"}.set_path("/").set_http_only(true));
+        return header;
+    }
+
+    /**
+     *  The former implementation of response_header::to_string.
+     *  Fields are looked up by name here instead of iterating the map, which adds a little.
+     */
+    std::string stringstream_serialize(response_header const& header, std::initializer_list <char const*> fields, cookie const& ck)
+    {
+        std::stringstream sstr;
+        sstr << header.get_protocol() << '/' << header.get_version() << ' ' << header.get_code() << ' ' << header.get_message() << "\r\n";
+        for (auto const* field : fields)
+            sstr << field << ": " << header.get_field(field).get() << "\r\n";
+
+        std::stringstream cookie_stream;
+        cookie_stream << ck.get_name() << "=" << ck.get_value() << "; Path=" << ck.get_path() << "; HttpOnly";
+        sstr << "Set-Cookie: " << cookie_stream.str() << "\r\n";
+        sstr << "\r\n";
+        return sstr.str();
+    }
+
+    template <typename FunctionT>
+    void measure(std::string const& name, std::size_t iterations, FunctionT&& run)
+    {
+        auto allocations_before = allocations;
+        auto start = std::chrono::steady_clock::now();
+        for (std::size_t i = 0; i != iterations; ++i)
+            run();
+        auto elapsed = std::chrono::duration <double, std::nano> (std::chrono::steady_clock::now() - start).count();
+        auto allocated = static_cast <double> (allocations - allocations_before);
+
+        std::cout << std::left << std::setw(36) << name
+                  << std::right << std::setw(10) << std::fixed << std::setprecision(1) << elapsed / iterations << " ns/response"
+                  << std::setw(8) << allocated / iterations << " allocations/response\n";
+    }
+}
+
+int main(int argc, char** argv)
+{
+    std::size_t iterations = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 1'000'000;
+
+    auto header = typical_header();
+    auto ck = cookie{"session", "0123456789abcdef"}.set_path("/").set_http_only(true);
+
+    measure("stringstream (former)", iterations, [&]{
+        sink += stringstream_serialize(header, {"Content-Type", "Content-Length", "Cache-Control"}, ck).size();
+    });
+
+    measure("to_string", iterations, [&]{
+        sink += header.to_string().size();
+    });
+
+    std::string reused;
+    measure("append_to (reused buffer)", iterations, [&]{
+        reused.clear();
+        header.append_to(reused);
+        sink += reused.size();
+    });
+
+    measure("build and to_string", iterations, [&]{
+        sink += typical_header().to_string().size();
+    });
+
+    measure("build without cookie", iterations, [&]{
+        response_header header;
+        header.set_code(200);
+        header.set_field("Content-Type", "text/plain");
+        header.set_field("Content-Length", "1387");
+        header.set_field("Cache-Control", "no-cache");
+        sink += header.get_fields().size();
+    });
+
+    return sink == 0 ? 1 : 0;
+}
@@ -0,0 +1,223 @@
+/**
+ *  Heap allocations of body size and time per response for the send overloads.
+ *  A local server answers requests of a client in the same process, so the counted allocations are those of the server.
+ *
+ *  The handlers of "const&" and "&&" build the body first, which is one allocation of body size,
+ *  every further one is a copy. "shared" sends the same buffer to every response.
+ *  "chunked" streams the body through a streaming_producer in pieces of 64 KiB with send_chunked.
+ *
+ *  usage: send_benchmark [body size in MB] [requests]
+ */
+
+#include <attender/encoding/streaming_producer.hpp>
+#include <attender/http/http_server.hpp>
+#include <attender/http/response.hpp>
+#include <attender/io_context/managed_io_context.hpp>
+#include <attender/io_context/thread_pooler.hpp>
+
+#include <boost/asio.hpp>
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <new>
+#include <string>
+#include <vector>
+
+using namespace attender;
+
+namespace
+{
+    std::size_t body_size = 10 * 1024 * 1024;
+    std::atomic <std::size_t> large_allocations{0};
+}
+
+namespace
+{
+    /**
+     *  Every form of operator new and delete is replaced, so that they all pair malloc with free.
+     */
+    void* counted_allocate(std::size_t size, std::size_t alignment) noexcept
+    {
+        if (size >= body_size)
+            ++large_allocations;
+        size = size == 0 ? 1 : size;
+        if (alignment <= alignof(std::max_align_t))
+            return std::malloc(size);
+        return std::aligned_alloc(alignment, (size + alignment - 1) / alignment * alignment);
+    }
+
+    void* counted_allocate_or_throw(std::size_t size, std::size_t alignment)
+    {
+        if (auto* ptr = counted_allocate(size, alignment))
+            return ptr;
+        throw std::bad_alloc{};
+    }
+}
+
+void* operator new(std::size_t size)
+{
+    return counted_allocate_or_throw(size, alignof(std::max_align_t));
+}
+void* operator new[](std::size_t size)
+{
+    return counted_allocate_or_throw(size, alignof(std::max_align_t));
+}
+void* operator new(std::size_t size, std::align_val_t alignment)
+{
+    return counted_allocate_or_throw(size, static_cast <std::size_t> (alignment));
+}
+void* operator new[](std::size_t size, std::align_val_t alignment)
+{
+    return counted_allocate_or_throw(size, static_cast <std::size_t> (alignment));
+}
+void* operator new(std::size_t size, std::nothrow_t const&) noexcept
+{
+    return counted_allocate(size, alignof(std::max_align_t));
+}
+void* operator new[](std::size_t size, std::nothrow_t const&) noexcept
+{
+    return counted_allocate(size, alignof(std::max_align_t));
+}
+void* operator new(std::size_t size, std::align_val_t alignment, std::nothrow_t const&) noexcept
+{
+    return counted_allocate(size, static_cast <std::size_t> (alignment));
+}
+void* operator new[](std::size_t size, std::align_val_t alignment, std::nothrow_t const&) noexcept
+{
+    return counted_allocate(size, static_cast <std::size_t> (alignment));
+}
+
+void operator delete(void* ptr) noexcept
+{
+    std::free(ptr);
+}
+void operator delete[](void* ptr) noexcept
+{
+    std::free(ptr);
+}
+void operator delete(void* ptr, std::size_t) noexcept
+{
+    std::free(ptr);
+}
+void operator delete[](void* ptr, std::size_t) noexcept
+{
+    std::free(ptr);
+}
+void operator delete(void* ptr, std::align_val_t) noexcept
+{
+    std::free(ptr);
+}
+void operator delete[](void* ptr, std::align_val_t) noexcept
+{
+    std::free(ptr);
+}
+void operator delete(void* ptr, std::size_t, std::align_val_t) noexcept
+{
+    std::free(ptr);
+}
+void operator delete[](void* ptr, std::size_t, std::align_val_t) noexcept
+{
+    std::free(ptr);
+}
+void operator delete(void* ptr, std::nothrow_t const&) noexcept
+{
+    std::free(ptr);
+}
+void operator delete[](void* ptr, std::nothrow_t const&) noexcept
+{
+    std::free(ptr);
+}
+void operator delete(void* ptr, std::align_val_t, std::nothrow_t const&) noexcept
+{
+    std::free(ptr);
+}
+void operator delete[](void* ptr, std::align_val_t, std::nothrow_t const&) noexcept
+{
+    std::free(ptr);
+}
+
+namespace
+{
+    std::size_t fetch(std::string const& path, std::vector <char>& buffer)
+    {
+        boost::asio::io_context context;
+        boost::asio::ip::tcp::socket socket{context};
+        socket.connect({boost::asio::ip::make_address("127.0.0.1"), 18301});
+
+        std::string request = "GET " + path + " HTTP/1.1\r\nHost: localhost\r\n\r\n";
+        boost::asio::write(socket, boost::asio::buffer(request));
+
+        std::size_t received = 0;
+        boost::system::error_code ec;
+        while (!ec)
+            received += socket.read_some(boost::asio::buffer(buffer.data(), buffer.size()), ec);
+        return received;
+    }
+
+    void measure(std::string const& name, std::string const& path, std::size_t requests, std::vector <char>& buffer)
+    {
+        std::size_t received = 0;
+        auto allocations_before = large_allocations.load();
+        auto start = std::chrono::steady_clock::now();
+        for (std::size_t i = 0; i != requests; ++i)
+            received += fetch(path, buffer);
+        auto elapsed = std::chrono::duration <double, std::milli> (std::chrono::steady_clock::now() - start).count();
+        auto allocated = static_cast <double> (large_allocations.load() - allocations_before);
+
+        // chunked responses carry the chunk framing on top.
+        if (received < requests * body_size)
+            std::cout << name << ": incomplete response\n";
+
+        std::cout << std::left << std::setw(12) << name
+                  << std::right << std::setw(10) << std::fixed << std::setprecision(2) << elapsed / requests << " ms/response"
+                  << std::setw(8) << allocated / requests << " body sized allocations/response\n";
+    }
+}
+
+int main(int argc, char** argv)
+{
+    if (argc > 1)
+        body_size = std::strtoull(argv[1], nullptr, 10) * 1024 * 1024;
+    std::size_t requests = argc > 2 ? std::strtoull(argv[2], nullptr, 10) : 50;
+
+    // client buffer and shared body are allocated before anything is counted.
+    std::vector <char> buffer(1024 * 1024);
+    auto shared = std::make_shared <std::string const> (body_size, 'x');
+
+    managed_io_context <thread_pooler> context;
+    http_server server(context.get_io_context(), [](auto*, auto const&, auto const&){});
+
+    server.get("/copy", [](auto, auto res) {
+        std::string body(body_size, 'x');
+        res->send(body);
+    });
+    server.get("/move", [](auto, auto res) {
+        std::string body(body_size, 'x');
+        res->send(std::move(body));
+    });
+    server.get("/shared", [&shared](auto, auto res) {
+        res->send(shared);
+    });
+    server.get("/chunked", [](auto, auto res) {
+        auto produ = std::make_shared <streaming_producer> ("identity", []{}, [](auto){});
+        std::string piece(64 * 1024, 'x');
+        for (std::size_t size = 0; size < body_size; size += piece.size())
+            *produ << piece;
+        produ->finish();
+        res->send_chunked(*produ, [produ](auto){});
+    });
+    server.start("18301", "127.0.0.1");
+
+    measure("const&", "/copy", requests, buffer);
+    measure("&&", "/move", requests, buffer);
+    measure("shared", "/shared", requests, buffer);
+    measure("chunked", "/chunked", requests, buffer);
+
+    context.teardown();
+    return 0;
+}
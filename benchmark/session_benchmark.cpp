@@ -0,0 +1,264 @@
+/**
+ *  Session lookups per second of memory_session_storage, compared to one map behind one mutex that copies
+ *  the session out, like memory_session_storage did before it was sharded.
+ *  Every thread looks up random ids of the filled storage, one in twenty lookups is followed by a set_session.
+ *  shared_memory_session_storage is measured the same way, it deserializes on every lookup.
+ *  Then the time it takes file_session_storage to open the same amount of sessions again, as after a restart.
+ *
+ *  usage: session_benchmark [sessions] [lookups per thread] [max threads]
+ */
+
+#include <attender/session/file_session_storage.hpp>
+#include <attender/session/memory_session_storage.hpp>
+#include <attender/session/shared_memory_session_storage.hpp>
+#include <attender/session/uuid_session_cookie_generator.hpp>
+
+#include <boost/filesystem.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <mutex>
+#include <random>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+using namespace attender;
+
+namespace
+{
+    /**
+     *  A session with a bit of payload, so that copying it is not free.
+     */
+    class user_session : public session
+    {
+    public:
+        using session::session;
+
+        std::string user = "someone@example.com";
+        std::vector <std::string> roles = {"reader", "writer", "administrator of something"};
+    };
+
+    class persistent_session : public user_session, public session_data
+    {
+    public:
+        using user_session::user_session;
+
+        std::string serialize() override
+        {
+            auto data = user;
+            for (auto const& role : roles)
+                data += "\n" + role;
+            return data;
+        }
+        void deserialize(std::string const& data) override
+        {
+            user = data.substr(0, data.find('\n'));
+            roles.clear();
+            for (auto begin = data.find('\n'); begin != std::string::npos;)
+            {
+                auto end = data.find('\n', begin + 1);
+                roles.push_back(data.substr(begin + 1, end == std::string::npos ? end : end - begin - 1));
+                begin = end;
+            }
+        }
+    };
+
+    /**
+     *  The storage as it was: one map, one mutex, copies out.
+     */
+    class single_lock_storage : public session_storage_interface
+    {
+    public:
+        void clear() override
+        {
+            std::lock_guard <std::mutex> guard{lock_};
+            sessions_.clear();
+        }
+        uint64_t size() override
+        {
+            std::lock_guard <std::mutex> guard{lock_};
+            return sessions_.size();
+        }
+        std::string create_session() override
+        {
+            std::lock_guard <std::mutex> guard{lock_};
+            auto id = gen_.generate_id();
+            sessions_[id] = user_session{id};
+            return id;
+        }
+        void delete_session(std::string const& id) override
+        {
+            std::lock_guard <std::mutex> guard{lock_};
+            sessions_.erase(id);
+        }
+        bool get_session(std::string const& id, session* session) override
+        {
+            std::lock_guard <std::mutex> guard{lock_};
+            auto iter = sessions_.find(id);
+            if (iter == std::end(sessions_))
+                return false;
+            if (session != nullptr)
+                *static_cast <user_session*> (session) = iter->second;
+            return true;
+        }
+        bool set_session(std::string const& id, session const& session) override
+        {
+            std::lock_guard <std::mutex> guard{lock_};
+            auto iter = sessions_.find(id);
+            if (iter == std::end(sessions_))
+                return false;
+            iter->second = static_cast <user_session const&> (session);
+            return true;
+        }
+
+    private:
+        std::unordered_map <std::string, user_session> sessions_;
+        uuid_generator gen_;
+        std::mutex lock_;
+    };
+
+    std::vector <std::string> fill(session_storage_interface& storage, std::size_t sessions)
+    {
+        std::vector <std::string> ids;
+        ids.reserve(sessions);
+        for (std::size_t i = 0; i != sessions; ++i)
+            ids.push_back(storage.create_session());
+        return ids;
+    }
+
+    /**
+     *  Runs lookup(id) for random ids on every thread and prints lookups per second.
+     */
+    template <typename LookupT>
+    void measure(std::string const& name, std::vector <std::string> const& ids, std::size_t threads, std::size_t lookups, LookupT lookup)
+    {
+        std::vector <std::thread> workers;
+        std::vector <std::uint64_t> found(threads, 0);
+        auto start = std::chrono::steady_clock::now();
+        for (std::size_t t = 0; t != threads; ++t)
+        {
+            workers.emplace_back([&, t]{
+                std::mt19937_64 random{t};
+                std::uniform_int_distribution <std::size_t> pick{0, ids.size() - 1};
+                std::uint64_t hits = 0;
+                for (std::size_t i = 0; i != lookups; ++i)
+                    hits += lookup(ids[pick(random)], i % 20 == 0);
+                found[t] = hits;
+            });
+        }
+        for (auto& worker : workers)
+            worker.join();
+        auto elapsed = std::chrono::duration <double> (std::chrono::steady_clock::now() - start).count();
+
+        std::uint64_t hits = 0;
+        for (auto count : found)
+            hits += count;
+        if (hits != threads * lookups)
+            std::cout << name << ": " << threads * lookups - hits << " lookups missed\n";
+
+        std::cout << std::left << std::setw(40) << name + " (" + std::to_string(threads) + " threads)"
+                  << std::right << std::setw(14) << std::fixed << std::setprecision(0) << threads * lookups / elapsed
+                  << " lookups/s\n";
+    }
+}
+
+int main(int argc, char** argv)
+{
+    std::size_t sessions = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 1'000'000;
+    std::size_t lookups = argc > 2 ? std::strtoull(argv[2], nullptr, 10) : 1'000'000;
+    std::size_t max_threads = argc > 3 ? std::strtoull(argv[3], nullptr, 10) : std::max(1u, std::thread::hardware_concurrency());
+
+    std::vector <std::size_t> thread_counts{1};
+    for (std::size_t threads = 2; threads <= max_threads; threads *= 2)
+        thread_counts.push_back(threads);
+
+    std::cout << sessions << " sessions, " << lookups << " lookups per thread\n";
+
+    {
+        single_lock_storage storage;
+        auto ids = fill(storage, sessions);
+        for (auto threads : thread_counts)
+        {
+            measure("single lock get_session", ids, threads, lookups, [&storage](std::string const& id, bool write) {
+                user_session session;
+                auto hit = storage.get_session(id, &session);
+                if (hit && write)
+                    storage.set_session(id, session);
+                return hit;
+            });
+        }
+    }
+
+    {
+        memory_session_storage <uuid_generator, user_session> storage;
+        auto ids = fill(storage, sessions);
+        for (auto threads : thread_counts)
+        {
+            measure("sharded get_session", ids, threads, lookups, [&storage](std::string const& id, bool write) {
+                user_session session;
+                auto hit = storage.get_session(id, &session);
+                if (hit && write)
+                    storage.set_session(id, session);
+                return hit;
+            });
+        }
+        for (auto threads : thread_counts)
+        {
+            measure("sharded find_session", ids, threads, lookups, [&storage](std::string const& id, bool write) {
+                auto snapshot = storage.find_session(id);
+                if (snapshot && write)
+                    storage.set_session(id, *snapshot);
+                return snapshot != nullptr;
+            });
+        }
+    }
+
+    {
+        auto name = "session_benchmark-" + std::to_string(std::random_device{}());
+        shared_memory_session_storage <uuid_generator, persistent_session> storage{{
+            .name = name,
+            .slot_count = sessions + sessions / 3,
+            .id_capacity = 40,
+            .data_capacity = 96
+        }};
+        auto ids = fill(storage, sessions);
+        for (auto threads : thread_counts)
+        {
+            measure("shared memory get_session", ids, threads, lookups, [&storage](std::string const& id, bool write) {
+                persistent_session session;
+                auto hit = storage.get_session(id, &session);
+                if (hit && write)
+                    storage.set_session(id, session);
+                return hit;
+            });
+        }
+        shared_session_table::remove(name);
+    }
+
+    {
+        auto directory = boost::filesystem::temp_directory_path() / boost::filesystem::unique_path("session_benchmark-%%%%-%%%%");
+        session_log_options options{.directory = directory.string(), .compaction_interval = std::chrono::milliseconds{0}};
+        {
+            file_session_storage <uuid_generator, persistent_session> storage{options};
+            fill(storage, sessions);
+        }
+
+        auto start = std::chrono::steady_clock::now();
+        file_session_storage <uuid_generator, persistent_session> storage{options};
+        auto elapsed = std::chrono::duration <double> (std::chrono::steady_clock::now() - start).count();
+        std::cout << "file storage reopened " << storage.size() << " sessions in "
+                  << std::fixed << std::setprecision(3) << elapsed << " s\n";
+
+        storage.clear();
+        boost::system::error_code ec;
+        boost::filesystem::remove_all(directory, ec);
+    }
+
+    return 0;
+}
@@ -0,0 +1,163 @@
+/**
+ *  Throughput of small cpu bound tasks on the task_scheduler compared to posting them to an io_context
+ *  that is run by the same amount of threads.
+ *
+ *  usage: task_scheduler_benchmark [tasks] [threads]
+ */
+
+#include <attender/io_context/task_scheduler.hpp>
+
+#include <boost/asio.hpp>
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <future>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace attender;
+
+namespace
+{
+    std::atomic <std::uint64_t> sink{0};
+
+    /**
+     *  The unit of work, hashes 64 bytes.
+     */
+    void small_task(std::size_t seed)
+    {
+        std::uint64_t hash = 14695981039346656037ull;
+        for (std::size_t i = 0; i != 64; ++i)
+        {
+            hash ^= (seed + i) & 0xFF;
+            hash *= 1099511628211ull;
+        }
+        sink.fetch_add(hash & 1, std::memory_order_relaxed);
+    }
+
+    template <typename FunctionT>
+    void measure(std::string const& name, std::size_t tasks, FunctionT&& run)
+    {
+        auto start = std::chrono::steady_clock::now();
+        run();
+        auto elapsed = std::chrono::duration <double> (std::chrono::steady_clock::now() - start).count();
+
+        std::cout << std::left << std::setw(36) << name
+                  << std::right << std::setw(14) << std::fixed << std::setprecision(0) << tasks / elapsed << " tasks/s"
+                  << std::setw(10) << std::setprecision(1) << elapsed * 1e9 / tasks << " ns/task\n";
+    }
+
+    class io_context_runner
+    {
+    public:
+        explicit io_context_runner(std::size_t threads)
+            : context_{}
+            , guard_{boost::asio::make_work_guard(context_)}
+        {
+            for (std::size_t i = 0; i != threads; ++i)
+                threads_.emplace_back([this]{ context_.run(); });
+        }
+        ~io_context_runner()
+        {
+            guard_.reset();
+            for (auto& thread : threads_)
+                thread.join();
+        }
+        boost::asio::io_context& context()
+        {
+            return context_;
+        }
+
+    private:
+        boost::asio::io_context context_;
+        boost::asio::executor_work_guard <boost::asio::io_context::executor_type> guard_;
+        std::vector <std::thread> threads_;
+    };
+
+    /**
+     *  Splits [begin, end) in halves until single tasks remain, like a handler that forks its work.
+     */
+    void fork_range(task_scheduler& scheduler, std::size_t begin, std::size_t end)
+    {
+        if (end - begin == 1)
+            return small_task(begin);
+
+        auto middle = begin + (end - begin) / 2;
+        task_group group{scheduler};
+        group.run([&scheduler, begin, middle]{ fork_range(scheduler, begin, middle); });
+        fork_range(scheduler, middle, end);
+        group.wait();
+    }
+
+    void post_range(boost::asio::io_context& context, std::atomic <std::size_t>& remaining, std::promise <void>& done, std::size_t begin, std::size_t end)
+    {
+        if (end - begin == 1)
+        {
+            small_task(begin);
+            if (remaining.fetch_sub(1) == 1)
+                done.set_value();
+            return;
+        }
+
+        auto middle = begin + (end - begin) / 2;
+        boost::asio::post(context, [&context, &remaining, &done, begin, middle]{
+            post_range(context, remaining, done, begin, middle);
+        });
+        post_range(context, remaining, done, middle, end);
+    }
+}
+
+int main(int argc, char** argv)
+{
+    std::size_t tasks = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 1'000'000;
+    std::size_t threads = argc > 2 ? std::strtoull(argv[2], nullptr, 10) : std::max(1u, std::thread::hardware_concurrency());
+
+    std::cout << tasks << " tasks on " << threads << " threads\n";
+
+    {
+        io_context_runner runner{threads};
+        measure("io_context post (external)", tasks, [&]{
+            std::atomic <std::size_t> remaining{tasks};
+            std::promise <void> done;
+            for (std::size_t i = 0; i != tasks; ++i)
+            {
+                boost::asio::post(runner.context(), [i, &remaining, &done]{
+                    small_task(i);
+                    if (remaining.fetch_sub(1) == 1)
+                        done.set_value();
+                });
+            }
+            done.get_future().wait();
+        });
+
+        measure("io_context post (forked)", tasks, [&]{
+            std::atomic <std::size_t> remaining{tasks};
+            std::promise <void> done;
+            boost::asio::post(runner.context(), [&]{ post_range(runner.context(), remaining, done, 0, tasks); });
+            done.get_future().wait();
+        });
+    }
+
+    {
+        task_scheduler scheduler{{.threads = threads}};
+        measure("task_scheduler submit (external)", tasks, [&]{
+            task_group group{scheduler};
+            for (std::size_t i = 0; i != tasks; ++i)
+                group.run([i]{ small_task(i); });
+            group.wait();
+        });
+
+        measure("task_scheduler fork/join", tasks, [&]{
+            task_group group{scheduler};
+            group.run([&]{ fork_range(scheduler, 0, tasks); });
+            group.wait();
+        });
+    }
+
+    return sink.load() == 0xFFFFFFFF ? 1 : 0;
+}
@@ -1,2 +1,5 @@
 option(ENABLE_TESTING "Enable test build" off)
-option(PAUSE_AT_TEST_END "Pause tests" off)
\ No newline at end of file
+option(PAUSE_AT_TEST_END "Pause tests" off)
+option(ENABLE_IO_URING "Use io_uring for file io on Linux (requires liburing)" off)
+option(ENABLE_BENCHMARKS "Build the benchmarks" off)
+option(ENABLE_ZSTD "Build the zstd_encoder (requires libzstd)" off)
\ No newline at end of file
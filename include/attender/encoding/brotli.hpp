@@ -1,9 +1,11 @@
 #pragma once
 
 #include "producer.hpp"
+#include "segmented_buffer.hpp"
+
+#include <attender/io_context/task_scheduler.hpp>
 
 #include <memory>
-#include <vector>
 #include <atomic>
 #include <mutex>
 
@@ -28,19 +30,31 @@ namespace attender
         std::string encoding() const override;
 
         /**
-         *  Sets the amount of bytes where the buffer is started to be trimmed.
-         *  Stay well within cachable ranges. definitely less than 512kb.
+         *  Has no effect anymore, pushed data is compressed right away and not buffered.
          */
         void set_cut_off(std::size_t input_cutoff);
 
         /**
-         *  Sets the amount of bytes that the output buffer should have available.
+         *  Sets the size of the segments the output is stored in.
          *  Do NOT call while operation is in progress.
          */
         void set_minimum_avail(std::size_t min_avail);
 
         /**
-         *  Returns the amount of available bytes in the input buffer.
+         *  Sets the amount of compressed bytes that may wait for the consumer.
+         *  Producing more fails the stream.
+         */
+        void set_buffer_limit(std::size_t limit);
+
+        /**
+         *  Compresses on the scheduler instead of the calling thread.
+         *  push, flush and finish return immediately then, the operations still run in order.
+         *  Do NOT call while operation is in progress.
+         */
+        void set_scheduler(task_scheduler* scheduler);
+
+        /**
+         *  Returns the amount of pushed bytes that brotli did not take, only non zero after a failed push.
          */
         std::size_t available_in() const noexcept;
 
@@ -58,11 +72,13 @@ namespace attender
 
         // derived methods
         std::size_t available() const override;
+        std::size_t buffered() const override;
         char const* data() const override;
         bool complete() const override;
         void has_consumed(std::size_t size) override;
         void on_error(boost::system::error_code) override;
         void start_production() override;
+        void for_each_available(std::function <void(char const*, std::size_t)> const& fn) const override;
         void buffer_locked_do(std::function <void()> const&) const  override;
 
         /// Flushes the compressed data to output. Warning not the same as finish.
@@ -91,29 +107,19 @@ namespace attender
         }
 
     private:
-        void shrink_input();
-        void bufferize_input(char const* data_begin, std::size_t data_size);
-        void reserve_output();
         void push(char const* data_begin, std::size_t data_size, int operation);
 
     private:
         struct implementation;
         std::unique_ptr <implementation> brotctx_;
 
-        std::vector <uint8_t> input_;
-        std::vector <char> output_;
-        std::size_t input_start_;
-
-        /// Offset where brotli can write INTO the buffer
-        std::size_t output_start_offset_;
+        segmented_buffer output_;
         std::size_t avail_in_;
-        std::size_t input_cutoff_;
-        std::size_t output_minimum_avail_;
-        std::size_t output_considered_overflow_;
         std::size_t total_out_;
 
-        std::atomic <std::size_t> avail_;
         std::atomic_bool completed_;
         mutable std::recursive_mutex buffer_saver_;
+
+        task_sequence sequence_;
     };
 }
@@ -0,0 +1,76 @@
+#pragma once
+
+#include <cstddef>
+#include <string>
+#include <string_view>
+
+namespace attender
+{
+    /**
+     *  The content codings attender can produce.
+     */
+    enum class content_coding
+    {
+        identity,
+        brotli,
+        gzip,
+        deflate
+    };
+
+    /**
+     *  Whether response bodies are compressed, see compression_options and route_options.
+     */
+    enum class compression_mode
+    {
+        /** Use compression_options::enabled of the server. **/
+        inherit,
+
+        /** Compress, if the client accepts it. **/
+        enabled,
+
+        /** Never compress. **/
+        disabled
+    };
+
+    struct compression_options
+    {
+        /** Compress bodies passed to response_handler::send if the client accepts it. Routes can override this. **/
+        bool enabled = false;
+
+        /** Smaller bodies are sent as they are. **/
+        std::size_t minimum_size = 1024;
+
+        /** 0 to 11. Low qualities are fast and still beat gzip on text. **/
+        int brotli_quality = 4;
+
+        /** 1 to 9. **/
+        int zlib_level = 6;
+
+        /** Codings that may be negotiated. **/
+        bool allow_brotli = true;
+        bool allow_gzip = true;
+        bool allow_deflate = true;
+    };
+
+    /**
+     *  Picks the best coding the client accepts, following the q values of an Accept-Encoding field.
+     *  For equal q values, brotli is preferred over gzip over deflate.
+     *
+     *  @return identity if none of the allowed codings is acceptable.
+     */
+    content_coding negotiate_coding(std::string_view accept_encoding, compression_options const& options);
+
+    /**
+     *  Returns the token of the coding, like "br" or "gzip".
+     */
+    std::string_view coding_name(content_coding coding);
+
+    /**
+     *  Compresses a whole body at once.
+     *  The zlib streams are kept per thread and only reset between bodies.
+     *
+     *  @param output Receives the compressed body, previous content is replaced.
+     *  @return false if coding is identity or compression failed.
+     */
+    bool compress(content_coding coding, std::string_view input, std::string& output, compression_options const& options);
+}
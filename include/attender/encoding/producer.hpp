@@ -1,12 +1,16 @@
 #pragma once
 
+#include <attender/utility/completion_awaitable.hpp>
+
 #include <boost/system/error_code.hpp>
 
 #include <functional>
+#include <vector>
 #include <thread>
 #include <mutex>
 #include <atomic>
 #include <chrono>
+#include <condition_variable>
 
 namespace attender
 {
@@ -19,6 +23,15 @@ namespace attender
         std::function <void(std::string const& err, bool)> on_produce_{};
         std::function <void(boost::system::error_code)> on_finish_{};
         mutable std::recursive_mutex on_produce_protect_{};
+        mutable std::condition_variable_any attached_{};
+        std::function <void()> on_attached_{};
+
+        std::size_t low_water_mark_{256 * 1024};
+        std::size_t high_water_mark_{1024 * 1024};
+        std::function <void()> on_writable_{};
+        std::mutex on_writable_protect_{};
+
+        mutable std::vector <char> available_copy_{};
 
     protected:
         std::atomic_bool consuming_{false};
@@ -34,6 +47,12 @@ namespace attender
          */
         void production_failure(std::string const& fail);
 
+    private:
+        /**
+         *  Runs the when_writable callback if the buffer is drained to the low water mark or force is set.
+         */
+        void notify_writable(bool force);
+
     public:
         virtual ~producer();
 
@@ -56,21 +75,79 @@ namespace attender
          */
         bool wait_for_consumer(std::chrono::milliseconds timeout = std::chrono::milliseconds{1000}) const;
 
+        /**
+         *  Calls on_attached once a consumer is attached, right away if there already is one.
+         *  It runs on the thread that attaches, usually the io thread, so it must not block.
+         *  Only one callback waits at a time, a second one replaces the first.
+         */
+        void when_attached(std::function <void()> on_attached);
+
+        /**
+         *  co_await to continue once a consumer is attached, see when_attached.
+         *  The coroutine resumes on the thread that attaches.
+         */
+        auto attached_co()
+        {
+            return completion_awaitable{[this](auto const& on_complete) {
+                when_attached([on_complete]{
+                    on_complete({});
+                });
+            }};
+        }
+
         /**
          *  Returns the encoding the producer provides.
          */
         virtual std::string encoding() const = 0;
 
         /**
-         *  The amount of available data in the buffer.
+         *  The amount of data available contiguously at data().
+         *  Producers with segmented storage may have more buffered behind it, which becomes available once this is consumed.
          */
         virtual std::size_t available() const = 0;
 
         /**
-         *  A pointer to the begin of the buffer.
+         *  A pointer to the available data.
          */
         virtual char const* data() const = 0;
 
+        /**
+         *  The amount of all buffered bytes, available() and everything behind it.
+         *  The default returns available().
+         */
+        virtual std::size_t buffered() const;
+
+        /**
+         *  Sets the amounts of buffered bytes that control backpressure.
+         *  The producer is full at high, callbacks of when_writable run once the consumer drained it to low.
+         *  Do NOT call while operation is in progress.
+         */
+        void set_water_marks(std::size_t low, std::size_t high);
+
+        std::size_t low_water_mark() const noexcept;
+        std::size_t high_water_mark() const noexcept;
+
+        /**
+         *  Returns true if the buffered bytes reached the high water mark. Stop producing and wait with when_writable then.
+         */
+        bool is_full() const;
+
+        /**
+         *  Calls on_writable once the buffered bytes dropped to the low water mark, right away if they already are.
+         *  It runs on the consuming thread, usually the io thread, so it must not block.
+         *  It also runs when the consumer goes away, check has_consumer_attached.
+         *  Only one callback waits at a time, a second one replaces the first.
+         */
+        void when_writable(std::function <void()> on_writable);
+
+        /**
+         *  Calls fn for every span of available data in order, the first one holds the bytes of data() with available().
+         *  The spans must stay valid until they are consumed, because they are written without a copy.
+         *  The default passes a copy of data(), which stays valid until the next call, because data() may move
+         *  when more is produced. Override to pass spans of storage that does not move.
+         */
+        virtual void for_each_available(std::function <void(char const*, std::size_t)> const& fn) const;
+
         /**
          *  Everything within the supplied function is guarded by a mutex that also guards other buffer accesses.
          */
@@ -0,0 +1,115 @@
+#pragma once
+
+#include <cstddef>
+#include <deque>
+#include <memory>
+#include <span>
+#include <string_view>
+
+namespace attender
+{
+    /**
+     *  The output storage of the producers. Data is appended into fixed size segments and consumed from the front,
+     *  consuming only moves an offset or retires a segment, nothing is moved in memory.
+     *  A retired segment is kept for the next append, so a producer that is drained as fast as it fills
+     *  cycles between two segments like a ring buffer.
+     *
+     *  The amount of buffered bytes is limited, appends beyond the limit are refused.
+     *  Not thread safe, the producers guard it with their buffer mutex.
+     */
+    class segmented_buffer
+    {
+    public:
+        constexpr static std::size_t default_segment_size = 32'768;
+        constexpr static std::size_t default_limit = 20'000'000;
+
+        explicit segmented_buffer(std::size_t segment_size = default_segment_size, std::size_t limit = default_limit);
+
+        segmented_buffer(segmented_buffer const&) = delete;
+        segmented_buffer& operator=(segmented_buffer const&) = delete;
+
+        /**
+         *  Sets the size of segments allocated from now on.
+         */
+        void set_segment_size(std::size_t segment_size);
+
+        /**
+         *  Sets the maximum amount of buffered bytes.
+         */
+        void set_limit(std::size_t limit) noexcept;
+
+        std::size_t segment_size() const noexcept;
+        std::size_t limit() const noexcept;
+
+        /**
+         *  The amount of buffered bytes in all segments.
+         */
+        std::size_t size() const noexcept;
+        bool empty() const noexcept;
+
+        /**
+         *  The contiguous bytes at the front. Empty only if the whole buffer is empty.
+         *  The memory stays valid until it is consumed, appends do not move it.
+         */
+        std::string_view front() const noexcept;
+
+        /**
+         *  Calls fn(std::string_view) for every buffered span from front to back.
+         */
+        template <typename FunctionT>
+        void for_each(FunctionT&& fn) const
+        {
+            for (auto const& segment : segments_)
+            {
+                if (segment.end != segment.begin)
+                    fn(std::string_view{segment.memory.get() + segment.begin, segment.end - segment.begin});
+            }
+        }
+
+        /**
+         *  Removes size bytes from the front.
+         */
+        void consume(std::size_t size) noexcept;
+
+        /**
+         *  Returns free contiguous memory at the back to write into, followed by commit.
+         *  The span is empty if the limit is reached.
+         */
+        std::span <char> prepare();
+
+        /**
+         *  Appends size bytes written into the span of the last prepare.
+         */
+        void commit(std::size_t size) noexcept;
+
+        /**
+         *  Copies data to the back.
+         *
+         *  @return The amount of bytes appended, less than data_size if the limit is reached.
+         */
+        std::size_t append(char const* data_begin, std::size_t data_size);
+
+        /**
+         *  Removes everything, one segment is kept for reuse.
+         */
+        void clear() noexcept;
+
+    private:
+        struct segment
+        {
+            std::unique_ptr <char[]> memory;
+            std::size_t capacity;
+            std::size_t begin;
+            std::size_t end;
+        };
+
+        void retire_front() noexcept;
+
+    private:
+        std::deque <segment> segments_;
+        segment spare_;
+        std::size_t segment_size_;
+        std::size_t limit_;
+        std::size_t size_;
+    };
+}
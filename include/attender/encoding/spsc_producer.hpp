@@ -0,0 +1,116 @@
+#pragma once
+
+#include "producer.hpp"
+
+#include <attender/net_core.hpp>
+
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+
+namespace attender
+{
+    /**
+     *  A producer for one producing thread, built on a lock-free single-producer/single-consumer byte ring.
+     *  The producing thread appends with try_push, the connection writes straight out of the ring and
+     *  consumes from the other end. Neither side takes a lock per chunk.
+     *
+     *  When the connection is idle, the producer wakes it by posting to the io context. Wakeups are coalesced,
+     *  at most one post is in flight. While a write is in flight, its completion picks up new data without a post.
+     *
+     *  Only one thread may push, flush and finish.
+     */
+    class spsc_producer : public producer
+    {
+    public:
+        /**
+         *  @param service The io context of the connection, wakeups are posted to it.
+         *  @param capacity The size of the ring, rounded up to a power of two.
+         *  @param encoding The transfer encoding of the produced data.
+         */
+        spsc_producer(asio::io_service& service, std::size_t capacity = 1024 * 1024, std::string encoding = "identity");
+        ~spsc_producer();
+
+        spsc_producer(spsc_producer const&) = delete;
+        spsc_producer& operator=(spsc_producer const&) = delete;
+
+        /**
+         *  Appends all of data or nothing.
+         *
+         *  @return false if the ring does not have room for data. Wait with when_writable then.
+         */
+        bool try_push(std::string_view data);
+
+        /**
+         *  Wakes the connection for data that was pushed while it was busy. Usually not needed.
+         */
+        void flush();
+
+        /**
+         *  Sets stream as complete.
+         */
+        void finish();
+
+        /**
+         *  The size of the ring.
+         */
+        std::size_t capacity() const noexcept;
+
+        // derived methods
+        std::string encoding() const override;
+        std::size_t available() const override;
+        std::size_t buffered() const override;
+        char const* data() const override;
+        bool complete() const override;
+        void has_consumed(std::size_t size) override;
+        void on_error(boost::system::error_code) override;
+        void start_production() override;
+        void for_each_available(std::function <void(char const*, std::size_t)> const& fn) const override;
+
+        /**
+         *  Does not lock, the consumer owns the bytes between its end and the producer's end of the ring.
+         */
+        void buffer_locked_do(std::function <void()> const&) const override;
+
+    private:
+        /**
+         *  Posts a wakeup to the io context, unless one is already pending.
+         */
+        void wake();
+
+        /**
+         *  Wakes the connection if it does not write right now.
+         */
+        void wake_if_idle();
+
+    private:
+        // shared with posted wakeups, which may run after the producer is gone.
+        struct wake_state
+        {
+            std::recursive_mutex protect;
+            spsc_producer* producer;
+        };
+
+        // keeps the ends of the ring on separate cache lines.
+        constexpr static std::size_t cache_line = 64;
+
+        asio::io_service* service_;
+        std::string encoding_;
+        std::unique_ptr <char[]> ring_;
+        std::size_t mask_;
+        std::shared_ptr <wake_state> wake_state_;
+
+        // written by the consumer
+        alignas(cache_line) std::atomic <std::size_t> head_;
+
+        // written by the producer
+        alignas(cache_line) std::atomic <std::size_t> tail_;
+        std::atomic_bool completed_;
+
+        // written by both
+        alignas(cache_line) std::atomic_bool wake_pending_;
+    };
+}
@@ -1,6 +1,7 @@
 #pragma once
 
 #include "producer.hpp"
+#include "segmented_buffer.hpp"
 
 #include <atomic>
 #include <string>
@@ -9,7 +10,7 @@
 #include <string_view>
 #include <utility>
 #include <charconv>
-#include <vector>
+#include <iterator>
 #include <mutex>
 
 namespace attender
@@ -30,6 +31,7 @@ namespace attender
 
         std::string encoding() const override;
         std::size_t available() const override;
+        std::size_t buffered() const override;
         char const* data() const override;
         bool complete() const override;
         void has_consumed(std::size_t size) override;
@@ -41,6 +43,20 @@ namespace attender
          */
         void flush();
 
+        /**
+         *  Sets the amount of bytes that may wait for the consumer.
+         *  Writing more fails the stream.
+         */
+        void set_buffer_limit(std::size_t limit);
+
+        /**
+         *  Appends data unless the producer is full (see producer::set_water_marks).
+         *  Use when_writable to learn when to try again.
+         *
+         *  @return false if nothing was appended because the producer is full.
+         */
+        bool try_push(std::string_view data);
+
         // requires container that has size(), begin() and end().
         template <typename T>
         friend streaming_producer& operator<<(streaming_producer& stream, T const& data)
@@ -48,9 +64,24 @@ namespace attender
             // guard
             std::lock_guard <std::recursive_mutex> guard{stream.buffer_saver_};
 
-            // calculate size and offset
-            stream.buffer_.resize(stream.buffer_.size() + data.size());
-            std::copy(std::begin(data), std::end(data), std::end(stream.buffer_) - data.size());
+            // copy segment by segment
+            auto iter = std::begin(data);
+            auto remaining = static_cast <std::size_t> (data.size());
+            while (remaining > 0)
+            {
+                auto space = stream.buffer_.prepare();
+                if (space.empty())
+                {
+                    stream.production_failure("buffer limit reached");
+                    return stream;
+                }
+
+                auto piece = std::min(space.size(), remaining);
+                std::copy_n(iter, piece, space.data());
+                std::advance(iter, piece);
+                stream.buffer_.commit(piece);
+                remaining -= piece;
+            }
 
             stream.produced_data();
             return stream;
@@ -67,6 +98,7 @@ namespace attender
             return operator<<(stream, std::to_string(integral));
         }
 
+        void for_each_available(std::function <void(char const*, std::size_t)> const& fn) const override;
         void buffer_locked_do(std::function <void()> const&) const override;
 
         /**
@@ -75,7 +107,7 @@ namespace attender
         void finish();
 
     private:
-        std::vector <char> buffer_;
+        segmented_buffer buffer_;
         std::string encoding_;
         std::function <void()> on_ready_;
         std::function <void(boost::system::error_code)> on_error_;
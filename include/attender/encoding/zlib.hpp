@@ -0,0 +1,160 @@
+#pragma once
+
+#include "producer.hpp"
+#include "segmented_buffer.hpp"
+
+#include <attender/io_context/task_scheduler.hpp>
+
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <type_traits>
+
+namespace attender
+{
+    struct zlib_configuration
+    {
+        /// 1 (fastest) to 9 (smallest)
+        int level;
+
+        /// base two logarithm of the window size, 9 to 15
+        int window;
+
+        /// memory used for the compression state, 1 to 9
+        int memory_level;
+
+        static zlib_configuration make_default();
+    };
+
+    /**
+     *  The container format around the deflate stream.
+     */
+    enum class zlib_format
+    {
+        /// RFC 1952, Content-Encoding "gzip"
+        gzip,
+
+        /// RFC 1950, Content-Encoding "deflate"
+        deflate
+    };
+
+    /**
+     *  A producer that compresses with zlib, use gzip_encoder or deflate_encoder.
+     *  It is used like the brotli_encoder.
+     */
+    class zlib_encoder : public producer
+    {
+    public:
+        zlib_encoder(zlib_format format, zlib_configuration config);
+        ~zlib_encoder();
+
+        /// return 'gzip' or 'deflate'
+        std::string encoding() const override;
+
+        /**
+         *  Sets the size of the segments the output is stored in.
+         *  Do NOT call while operation is in progress.
+         */
+        void set_minimum_avail(std::size_t min_avail);
+
+        /**
+         *  Sets the amount of compressed bytes that may wait for the consumer.
+         *  Producing more fails the stream.
+         */
+        void set_buffer_limit(std::size_t limit);
+
+        /**
+         *  Compresses on the scheduler instead of the calling thread.
+         *  push, flush and finish return immediately then, the operations still run in order.
+         *  Do NOT call while operation is in progress.
+         */
+        void set_scheduler(task_scheduler* scheduler);
+
+        /**
+         *  Starts a new stream with the same configuration and keeps the zlib state and buffers allocated.
+         *  Do NOT call while a consumer is attached.
+         */
+        void reset();
+
+        /**
+         * Do NOT call concurrently with itself or other pushes!
+         */
+        void push(char const* data_begin, std::size_t data_size);
+
+        /**
+         * Do NOT call concurrently with itself or other pushes!
+         */
+        void push(std::string const& data);
+
+        // derived methods
+        std::size_t available() const override;
+        std::size_t buffered() const override;
+        char const* data() const override;
+        bool complete() const override;
+        void has_consumed(std::size_t size) override;
+        void on_error(boost::system::error_code) override;
+        void start_production() override;
+        void for_each_available(std::function <void(char const*, std::size_t)> const& fn) const override;
+        void buffer_locked_do(std::function <void()> const&) const  override;
+
+        /// Flushes the compressed data to output. Warning not the same as finish.
+        void flush();
+
+        /// Flushes remaining data to output and completes the compression.
+        void finish();
+
+        // requires data to have ".data()" and ".size()" and be convertible to char const*
+        template <typename T>
+        friend zlib_encoder& operator<<(zlib_encoder& stream, T const& data)
+        {
+            stream.push(data.data(), data.size());
+            return stream;
+        }
+
+        friend zlib_encoder& operator<<(zlib_encoder& stream, char const* nullterminated)
+        {
+            return operator<<(stream, std::string_view{nullterminated});
+        }
+
+        template <typename T>
+        friend std::enable_if_t <std::is_integral_v <T>, zlib_encoder&> operator<<(zlib_encoder& stream, T integral)
+        {
+            return operator<<(stream, std::to_string(integral));
+        }
+
+    private:
+        void compress(char const* data_begin, std::size_t data_size, int flush);
+
+    private:
+        struct implementation;
+        std::unique_ptr <implementation> zctx_;
+
+        zlib_format format_;
+        segmented_buffer output_;
+
+        std::atomic_bool completed_;
+        mutable std::recursive_mutex buffer_saver_;
+
+        task_sequence sequence_;
+    };
+
+    /**
+     *  Produces a gzip stream for "Content-Encoding: gzip".
+     */
+    class gzip_encoder : public zlib_encoder
+    {
+    public:
+        gzip_encoder(zlib_configuration config = zlib_configuration::make_default());
+    };
+
+    /**
+     *  Produces a zlib stream for "Content-Encoding: deflate".
+     */
+    class deflate_encoder : public zlib_encoder
+    {
+    public:
+        deflate_encoder(zlib_configuration config = zlib_configuration::make_default());
+    };
+}
@@ -0,0 +1,131 @@
+#pragma once
+
+#ifdef ATTENDER_ENABLE_ZSTD
+
+#include "producer.hpp"
+#include "segmented_buffer.hpp"
+
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <vector>
+
+namespace attender
+{
+    struct zstd_configuration
+    {
+        /// 1 (fastest) to 19, up to 22 with a lot of memory
+        int level;
+
+        /// Threads zstd compresses with in the background. 0 compresses on the thread that pushes.
+        /// The default is one per core, or 0 if libzstd was built without multithreading.
+        int workers;
+
+        /// Finds matches far back in the input, which helps with large repetitive streams. Costs memory.
+        bool long_distance_matching;
+
+        /// Bytes of input per job of a worker. 0 lets zstd choose from the level, at least 512 KiB otherwise.
+        std::size_t job_size;
+
+        static zstd_configuration make_default();
+    };
+
+    /**
+     *  A producer that compresses with zstd, "Content-Encoding: zstd".
+     *  It is used like the brotli_encoder. With workers, push only hands the data to zstd and large streams are
+     *  compressed on several cores.
+     */
+    class zstd_encoder : public producer
+    {
+    public:
+        zstd_encoder(zstd_configuration config = zstd_configuration::make_default());
+        ~zstd_encoder();
+
+        /// return 'zstd'
+        std::string encoding() const override;
+
+        /**
+         *  Sets the size of the segments the output is stored in.
+         *  Do NOT call while operation is in progress.
+         */
+        void set_minimum_avail(std::size_t min_avail);
+
+        /**
+         *  Sets the amount of compressed bytes that may wait for the consumer.
+         *  Producing more fails the stream.
+         */
+        void set_buffer_limit(std::size_t limit);
+
+        /**
+         *  Starts a new stream with the same configuration and keeps the compression context.
+         *  Do NOT call while a consumer is attached.
+         */
+        void reset();
+
+        /**
+         * Do NOT call concurrently with itself or other pushes!
+         */
+        void push(char const* data_begin, std::size_t data_size);
+
+        /**
+         * Do NOT call concurrently with itself or other pushes!
+         */
+        void push(std::string const& data);
+
+        // derived methods
+        std::size_t available() const override;
+        std::size_t buffered() const override;
+        char const* data() const override;
+        bool complete() const override;
+        void has_consumed(std::size_t size) override;
+        void on_error(boost::system::error_code) override;
+        void start_production() override;
+        void for_each_available(std::function <void(char const*, std::size_t)> const& fn) const override;
+        void buffer_locked_do(std::function <void()> const&) const  override;
+
+        /// Flushes the compressed data to output, waits for the workers. Warning not the same as finish.
+        void flush();
+
+        /// Flushes remaining data to output and completes the compression.
+        void finish();
+
+        // requires data to have ".data()" and ".size()" and be convertible to char const*
+        template <typename T>
+        friend zstd_encoder& operator<<(zstd_encoder& stream, T const& data)
+        {
+            stream.push(data.data(), data.size());
+            return stream;
+        }
+
+        friend zstd_encoder& operator<<(zstd_encoder& stream, char const* nullterminated)
+        {
+            return operator<<(stream, std::string_view{nullterminated});
+        }
+
+        template <typename T>
+        friend std::enable_if_t <std::is_integral_v <T>, zstd_encoder&> operator<<(zstd_encoder& stream, T integral)
+        {
+            return operator<<(stream, std::to_string(integral));
+        }
+
+    private:
+        void compress(char const* data_begin, std::size_t data_size, int directive);
+
+    private:
+        struct implementation;
+        std::unique_ptr <implementation> zctx_;
+
+        segmented_buffer output_;
+
+        // compress writes here outside of the buffer lock, only the producing thread uses it.
+        std::vector <char> staging_;
+
+        std::atomic_bool completed_;
+        mutable std::recursive_mutex buffer_saver_;
+    };
+}
+
+#endif // ATTENDER_ENABLE_ZSTD
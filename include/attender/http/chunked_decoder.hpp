@@ -0,0 +1,84 @@
+#pragma once
+
+#include <attender/http/http_fwd.hpp>
+
+#include <string>
+#include <unordered_map>
+
+namespace attender
+{
+    /**
+     *  Incremental decoder for request bodies sent with "Transfer-Encoding: chunked".
+     *  The decoder can be fed arbitrary slices of the stream. Chunk sizes and extensions are parsed in place and
+     *  the payload is handed to the sink directly from the input, so the body is never copied by the decoder.
+     *  Chunk extensions are skipped, trailer fields are collected.
+     */
+    class chunked_decoder
+    {
+    public:
+        enum class result
+        {
+            /// All input was consumed, the body is not complete yet.
+            need_more,
+            /// The last chunk and the trailer section were consumed.
+            finished,
+            /// The sink received max bytes, the remaining body was not consumed.
+            limit_reached,
+            /// The input does not follow the chunked encoding.
+            malformed
+        };
+
+    public:
+        chunked_decoder();
+
+        /**
+         *  Prepares the decoder for a new body.
+         *
+         *  @param max The maximum amount of payload bytes to pass to the sink. If max = 0, there is no limit.
+         */
+        void reset(size_type max = 0);
+
+        /**
+         *  Decodes the given input and writes the contained payload to the sink.
+         *
+         *  @param data Encoded input.
+         *  @param size The amount of bytes in data.
+         *  @param sink The sink that receives the payload.
+         *
+         *  @return Returns the state of the decoder after consuming the input.
+         *          Input that follows the end of the body is not consumed.
+         */
+        result feed(char const* data, size_type size, http_read_sink& sink);
+
+        /**
+         *  @return Returns the trailer fields sent after the last chunk.
+         */
+        std::unordered_map <std::string, std::string> const& get_trailers() const;
+
+    private:
+        enum class state
+        {
+            size,
+            extension,
+            size_lf,
+            data,
+            data_cr,
+            data_lf,
+            trailer,
+            trailer_lf,
+            done,
+            failed
+        };
+
+        bool add_trailer();
+
+    private:
+        state state_;
+        size_type max_;
+        size_type chunk_remaining_;
+        size_type size_digits_;
+        size_type line_length_;
+        std::string trailer_line_;
+        std::unordered_map <std::string, std::string> trailers_;
+    };
+}
@@ -5,6 +5,7 @@
 #include <attender/http/http_server_interface.hpp>
 
 #include <boost/asio.hpp>
+#include <unordered_map>
 #include <unordered_set>
 #include <mutex>
 #include <utility>
@@ -66,18 +67,43 @@ namespace attender
 
         /**
          *  Remove and terminate the given connection.
+         *  A held connection is stopped right away, but only freed when the last hold is released.
          *
          *  @param connection The connection to remove.
          */
         void remove(http_connection_interface* connection);
 
+        /**
+         *  Keeps the connection and its request and response handlers allocated, for handlers that
+         *  use them on other threads. Must be called on the io_service.
+         *
+         *  @param connection The connection to hold.
+         */
+        void hold(http_connection_interface* connection);
+
+        /**
+         *  Releases a hold. Can be called on any thread, a connection that was removed meanwhile
+         *  is freed on its io_service.
+         *
+         *  @param connection A held connection.
+         */
+        void release(http_connection_interface* connection);
+
         /**
          *  @return Returns the amount of active connections.
          */
         std::size_t count() const;
 
+    private:
+        struct hold_state
+        {
+            std::size_t count = 0;
+            bool removed = false;
+        };
+
     private:
         std::unordered_set <http_connection_interface*> connections_;
+        std::unordered_map <http_connection_interface*, hold_state> holds_;
         std::mutex connectionsLock_;
     };
 }
@@ -127,6 +127,11 @@ namespace attender
          **/
         std::string to_set_cookie_string() const;
 
+        /**
+         *  Appends the set cookie string to out.
+         **/
+        void append_set_cookie_string(std::string& out) const;
+
     private:
         std::string name_;
         std::string value_;
@@ -0,0 +1,109 @@
+#pragma once
+
+#include <boost/container/small_vector.hpp>
+#include <boost/optional.hpp>
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+namespace attender
+{
+    /**
+     *  Compact storage for the fields of a response header.
+     *  Fields keep their insertion order and a name can occur multiple times (see add).
+     *  Names compare case insensitively, common names are interned so that lookups mostly compare numbers.
+     *  Names and values live in an inline buffer, so a typical response header does not allocate.
+     */
+    class header_fields
+    {
+    public:
+        header_fields();
+
+        /**
+         *  Sets the field to value. Replaces all previous values, the field keeps its position.
+         */
+        void set(std::string_view name, std::string_view value);
+
+        /**
+         *  Adds another line for the field, previous values are kept.
+         */
+        void add(std::string_view name, std::string_view value);
+
+        /**
+         *  Sets the field, if it is not set yet.
+         *
+         *  @return Returns true if the field was set.
+         */
+        bool try_set(std::string_view name, std::string_view value);
+
+        /**
+         *  Removes all lines of the field.
+         *
+         *  @return Returns the amount of removed lines.
+         */
+        std::size_t erase(std::string_view name);
+
+        /**
+         *  Returns true if the field is set.
+         */
+        bool contains(std::string_view name) const;
+
+        /**
+         *  Returns the value of the field. Multiple values are joined with ", ".
+         */
+        boost::optional <std::string> get(std::string_view name) const;
+
+        /**
+         *  Returns the amount of lines.
+         */
+        std::size_t size() const noexcept;
+
+        bool empty() const noexcept;
+
+        /**
+         *  Returns the amount of characters append_to will append.
+         */
+        std::size_t serialized_size() const noexcept;
+
+        /**
+         *  Appends all lines as "name: value\r\n" in insertion order.
+         */
+        void append_to(std::string& out) const;
+
+        /**
+         *  Calls func(name, value) for every line in insertion order.
+         */
+        template <typename FunctionT>
+        void for_each(FunctionT&& func) const
+        {
+            for (auto const& e : entries_)
+                func(name_of(e), value_of(e));
+        }
+
+    private:
+        struct entry
+        {
+            std::uint32_t name_offset;
+            std::uint32_t name_length;
+            std::uint32_t value_offset;
+            std::uint32_t value_length;
+            std::uint16_t known;
+        };
+
+        static constexpr std::uint16_t unknown = 0xFFFF;
+
+        static std::uint16_t intern(std::string_view name) noexcept;
+        bool matches(entry const& e, std::uint16_t known, std::string_view name) const noexcept;
+        std::string_view name_of(entry const& e) const noexcept;
+        std::string_view value_of(entry const& e) const noexcept;
+        std::uint32_t store(std::string_view text);
+        void push(std::uint16_t known, std::string_view name, std::string_view value);
+        void compact();
+
+    private:
+        boost::container::small_vector <entry, 8> entries_;
+        boost::container::small_vector <char, 256> text_;
+        std::size_t garbage_;
+    };
+}
@@ -5,12 +5,20 @@
 #include <attender/http/http_server_interface.hpp>
 #include <attender/http/connection_manager.hpp>
 #include <attender/http/router.hpp>
+#include <attender/http/route_options.hpp>
 #include <attender/http/settings.hpp>
 #include <attender/session/session_cookie_generator_interface.hpp>
 #include <attender/session/session_manager.hpp>
 #include <attender/session/session_storage_interface.hpp>
 #include <attender/session/authorizer_interface.hpp>
 #include <attender/session/session_control.hpp>
+#include <attender/io_context/file_io.hpp>
+#include <attender/io_context/worker_pool.hpp>
+#include <attender/io_context/task_scheduler.hpp>
+
+#include <functional>
+#include <memory>
+#include <mutex>
 
 namespace attender
 {
@@ -61,6 +69,29 @@ namespace attender
          */
         settings get_settings() const override;
 
+        /**
+         *  Returns the service that performs file reads and writes off the io_context threads.
+         *  It is created on first use, as configured by settings::file_io.
+         */
+        file_io_service* get_file_io() override;
+
+        /**
+         *  Returns the pool that runs routes registered with execution_mode::offload.
+         *  It is created on first use, as configured by settings::offload.
+         */
+        worker_pool* get_worker_pool() override;
+
+        /**
+         *  Returns the work stealing scheduler for small cpu bound tasks that handlers and encoders can fork onto.
+         *  It is created on first use, as configured by settings::tasks.
+         */
+        task_scheduler* get_task_scheduler() override;
+
+        /**
+         *  Returns the io_service the server and its connections run on.
+         */
+        asio::io_service* get_io_service() override;
+
         /**
          *  After calling this function, every single request is checked for an active authorized session.
          *  Authorization can be performed on any request.
@@ -76,9 +107,16 @@ namespace attender
         /**
          *  Will try to perform authentication, if a session control is installed.
          *  Returns false if session is unauthorized to proceed.
+         *  Throws std::logic_error with an asynchronous authorizer or session storage, use async_authenticate_session then.
          */
         bool authenticate_session(request_handler* req, response_handler* res);
 
+        /**
+         *  Like authenticate_session, but does not wait for asynchronous authorizers and session storages.
+         *  on_complete is called on an io thread with whether the request may proceed, unless the connection is gone.
+         */
+        void async_authenticate_session(request_handler* req, response_handler* res, std::function <void(bool)> on_complete);
+
         /**
          *  Retrieve a weak ptr to the session manager.
          */
@@ -89,64 +127,115 @@ namespace attender
          *
          *  @param path_template A template for paths. These templates will be parsed and if a match occurs in a request, the routing will be used.
          *  @param connect_callback A callback which gets called upon a request is received, that matches the path_template.
+         *  @param options Route options, for instance to run the handler on the worker pool. @see route_options
          */
-        void get(std::string const& path_template, connected_callback const& on_connect);
+        void get(std::string const& path_template, connected_callback const& on_connect, route_options const& options = {});
 
         /**
          *  Will add a routing for put requests.
          *
          *  @param path_template A template for paths. These templates will be parsed and if a match occurs in a request, the routing will be used.
          *  @param connect_callback A callback which gets called upon a request is received, that matches the path_template.
+         *  @param options Route options, for instance to run the handler on the worker pool. @see route_options
          */
-        void put(std::string const& path_template, connected_callback const& on_connect);
+        void put(std::string const& path_template, connected_callback const& on_connect, route_options const& options = {});
 
         /**
          *  Will add a routing for post requests.
          *
          *  @param path_template A template for paths. These templates will be parsed and if a match occurs in a request, the routing will be used.
          *  @param connect_callback A callback which gets called upon a request is received, that matches the path_template.
+         *  @param options Route options, for instance to run the handler on the worker pool. @see route_options
          */
-        void post(std::string const& path_template, connected_callback const& on_connect);
+        void post(std::string const& path_template, connected_callback const& on_connect, route_options const& options = {});
 
         /**
          *  Will add a routing for head requests.
          *
          *  @param path_template A template for paths. These templates will be parsed and if a match occurs in a request, the routing will be used.
          *  @param connect_callback A callback which gets called upon a request is received, that matches the path_template.
+         *  @param options Route options, for instance to run the handler on the worker pool. @see route_options
          */
-        void head(std::string const& path_template, connected_callback const& on_connect);
+        void head(std::string const& path_template, connected_callback const& on_connect, route_options const& options = {});
 
         /**
          *  Will add a routing for delete_ requests.
          *
          *  @param path_template A template for paths. These templates will be parsed and if a match occurs in a request, the routing will be used.
          *  @param connect_callback A callback which gets called upon a request is received, that matches the path_template.
+         *  @param options Route options, for instance to run the handler on the worker pool. @see route_options
          */
-        void delete_(std::string const& path_template, connected_callback const& on_connect);
+        void delete_(std::string const& path_template, connected_callback const& on_connect, route_options const& options = {});
 
         /**
          *  Will add a routing for options requests.
          *
          *  @param path_template A template for paths. These templates will be parsed and if a match occurs in a request, the routing will be used.
          *  @param connect_callback A callback which gets called upon a request is received, that matches the path_template.
+         *  @param options Route options, for instance to run the handler on the worker pool. @see route_options
          */
-        void options(std::string const& path_template, connected_callback const& on_connect);
+        void options(std::string const& path_template, connected_callback const& on_connect, route_options const& options = {});
 
         /**
          *  Will add a routing for connect requests.
          *
          *  @param path_template A template for paths. These templates will be parsed and if a match occurs in a request, the routing will be used.
          *  @param connect_callback A callback which gets called upon a request is received, that matches the path_template.
+         *  @param options Route options, for instance to run the handler on the worker pool. @see route_options
          */
-        void connect(std::string const& path_template, connected_callback const& on_connect);
+        void connect(std::string const& path_template, connected_callback const& on_connect, route_options const& options = {});
 
         /**
          *  Will add a routing for a custom requests method string (they cannot contain spaces).
          *
          *  @param path_template A template for paths. These templates will be parsed and if a match occurs in a request, the routing will be used.
          *  @param connect_callback A callback which gets called upon a request is received, that matches the path_template.
+         *  @param options Route options, for instance to run the handler on the worker pool. @see route_options
+         */
+        void route(std::string const& route_name, std::string const& path_template, connected_callback const& on_connect, route_options const& options = {});
+
+        /**
+         *  Will add a routing for get requests that is handled by a coroutine.
+         *  The coroutine can co_await read_body and the *_co functions of the response_handler.
+         *  Its frame is allocated from the arena of the connection and the response ends when the coroutine returns.
+         *
+         *  @param path_template A template for paths. These templates will be parsed and if a match occurs in a request, the routing will be used.
+         *  @param on_connect A coroutine which gets called upon a request is received, that matches the path_template.
+         */
+        void get_co(std::string const& path_template, coroutine_callback const& on_connect);
+
+        /**
+         *  Will add a routing for put requests that is handled by a coroutine. @see get_co
+         *
+         *  @param path_template A template for paths. These templates will be parsed and if a match occurs in a request, the routing will be used.
+         *  @param on_connect A coroutine which gets called upon a request is received, that matches the path_template.
+         */
+        void put_co(std::string const& path_template, coroutine_callback const& on_connect);
+
+        /**
+         *  Will add a routing for post requests that is handled by a coroutine. @see get_co
+         *
+         *  @param path_template A template for paths. These templates will be parsed and if a match occurs in a request, the routing will be used.
+         *  @param on_connect A coroutine which gets called upon a request is received, that matches the path_template.
+         */
+        void post_co(std::string const& path_template, coroutine_callback const& on_connect);
+
+        /**
+         *  Will add a routing for delete requests that is handled by a coroutine. @see get_co
+         *
+         *  @param path_template A template for paths. These templates will be parsed and if a match occurs in a request, the routing will be used.
+         *  @param on_connect A coroutine which gets called upon a request is received, that matches the path_template.
          */
-        void route(std::string const& route_name, std::string const& path_template, connected_callback const& on_connect);
+        void delete_co(std::string const& path_template, coroutine_callback const& on_connect);
+
+        /**
+         *  Will add a routing for a custom request method that is handled by a coroutine. @see get_co
+         *
+         *  @param route_name The request method.
+         *  @param path_template A template for paths. These templates will be parsed and if a match occurs in a request, the routing will be used.
+         *  @param on_connect A coroutine which gets called upon a request is received, that matches the path_template.
+         */
+        void route_co(std::string const& route_name, std::string const& path_template, coroutine_callback const& on_connect);
 
         /**
          *  Returns a pointer to the connection manager. It holds all active connections.
@@ -200,12 +289,23 @@ namespace attender
         virtual void do_accept() = 0;
 
         /**
-         *  Returns false if session is unauthorized to proceed.
+         *  Loads the session and authenticates if there is none. Completes with false if session is unauthorized to proceed.
+         *  Completes before it returns with synchronous session storages and authorizers.
          */
-        bool handle_session(request_handler* req, response_handler* res);
+        void handle_session(request_handler* req, response_handler* res, std::function <void(bool)> on_complete);
 
         void header_read_handler(request_handler* req, response_handler* res, http_connection_interface* connection, boost::system::error_code ec, std::exception const& exc);
 
+        /**
+         *  Calls the route handler and turns escaping exceptions into a 500.
+         */
+        void invoke_route(connected_callback const& on_connect, request_handler* req, response_handler* res);
+
+        /**
+         *  Wraps the handler according to the route options.
+         */
+        connected_callback bind_route(connected_callback const& on_connect, route_options const& options);
+
     protected:
         // asio stuff
         asio::io_service* service_;
@@ -217,6 +317,12 @@ namespace attender
 
         // other
         settings settings_;
+        std::once_flag file_io_created_;
+        std::unique_ptr <file_io_service> file_io_;
+        std::once_flag worker_pool_created_;
+        std::unique_ptr <worker_pool> worker_pool_;
+        std::once_flag task_scheduler_created_;
+        std::unique_ptr <task_scheduler> task_scheduler_;
 
         // callbacks
         error_callback on_error_;
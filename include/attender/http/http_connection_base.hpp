@@ -74,12 +74,14 @@ namespace attender
             , socket_{socket}
             , buffer_(config::buffer_size)
             , write_buffer_{}
+            , gather_buffers_{}
             , read_callback_inst_{}
             , bytes_ready_{0}
             , read_timeout_timer_{internal::get_executor <SocketT>::ctx(socket)}
             , closed_{false}
             , kept_alive_{nullptr}
             , on_timeout_{on_timeout}
+            , arena_{}
         {
             // this will ensure, that the timer does not fire right away when it it started
             // the timer is started on read, but the timeout will be set later in every do_read cycle.
@@ -172,6 +174,26 @@ namespace attender
             );
         }
 
+        /**
+         *  Writes all the buffers onto the stream with a single gathering write, nothing is copied.
+         *  The memory the buffers refer to must stay valid until the handler is called.
+         *  Do not (!) call write while another write operation is in progress!
+         */
+        void write_buffers(buffer_sequence const& buffers, write_callback handler) override
+        {
+            gather_buffers_ = buffers;
+
+            boost::asio::async_write
+            (
+                *socket_,
+                gather_buffers_,
+                [handler](boost::system::error_code ec, std::size_t amount)
+                {
+                    handler(ec, amount);
+                }
+            );
+        }
+
         /**
          *  This function writes the whole container onto the stream.
          *  The handler function is called when the write operation completes.
@@ -296,6 +318,14 @@ namespace attender
             return buffer_;
         }
 
+        /**
+         *  Returns the arena that hosts the frames of coroutine handlers running on this connection.
+         */
+        coroutine_arena& get_coroutine_arena() override
+        {
+            return arena_;
+        }
+
         /**
          *  Returns the tcp server behind this tcp connection.
          *  Do not abuse.
@@ -430,12 +460,14 @@ namespace attender
         std::unique_ptr <SocketT> socket_;
         std::vector <char> buffer_;
         std::vector <char> write_buffer_;
+        buffer_sequence gather_buffers_;
         read_callback read_callback_inst_;
         std::size_t bytes_ready_;
         boost::asio::deadline_timer read_timeout_timer_;
         std::atomic_bool closed_;
         std::unique_ptr <lifetime_binding> kept_alive_;
         final_callback on_timeout_;
+        coroutine_arena arena_;
     };
 
     class http_stream_device
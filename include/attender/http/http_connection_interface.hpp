@@ -1,8 +1,10 @@
 #pragma once
 
 #include <attender/http/http_fwd.hpp>
+#include <attender/utility/coroutine_arena.hpp>
 
 #include <boost/asio.hpp>
+#include <boost/container/small_vector.hpp>
 
 #include <iosfwd>
 #include <string>
@@ -14,6 +16,7 @@ namespace attender
     {
     public:
         using buffer_iterator = std::vector <char>::const_iterator;
+        using buffer_sequence = boost::container::small_vector <boost::asio::const_buffer, 4>;
 
         // control
         virtual void start() = 0;
@@ -29,6 +32,7 @@ namespace attender
         virtual void write(std::string const& string, write_callback handler) = 0;
         virtual void write(std::vector <char> const& container, write_callback handler) = 0;
         virtual void write(std::vector <char>&& eol_container, write_callback handler) = 0;
+        virtual void write_buffers(buffer_sequence const& buffers, write_callback handler) = 0;
         virtual std::size_t ready_count() const = 0;
         virtual boost::system::error_code wait_write() = 0;
 
@@ -36,6 +40,7 @@ namespace attender
         virtual buffer_iterator begin() const = 0;
         virtual buffer_iterator end() const = 0;
         virtual std::vector <char>& get_read_buffer() = 0;
+        virtual coroutine_arena& get_coroutine_arena() = 0;
 
         // auxiliary info
         virtual std::string get_remote_address() const = 0;
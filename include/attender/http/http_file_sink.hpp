@@ -0,0 +1,63 @@
+#pragma once
+
+#include <attender/http/http_fwd.hpp>
+#include <attender/http/http_read_sink.hpp>
+#include <attender/io_context/file_io.hpp>
+#include <attender/utility/conclusion_observer.hpp>
+
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace attender
+{
+    /**
+     *  A read sink that writes the body into a file using the file io of the server, so the io thread
+     *  never waits for the disk. Received data is collected while a write is in flight, the body read is paused
+     *  when more than one block is waiting.
+     *
+     *  Call flush in the continuation of read_body before responding, the last write may still be in flight.
+     */
+    class http_file_sink : public http_read_sink
+                         , public std::enable_shared_from_this <http_file_sink>
+    {
+    public:
+        http_file_sink(request_handler* req, response_handler* res);
+
+        /**
+         *  Creates or truncates the file.
+         *
+         *  @return Returns false if the file cannot be opened.
+         */
+        bool open(std::string const& path);
+
+        size_type write(const char* data, size_type size) override;
+        size_type write(std::vector <char> const& buffer, size_type amount) override;
+
+        /**
+         *  Calls on_flushed once everything written to the sink reached the file.
+         *  The error code is set if any write failed.
+         */
+        void flush(custom_callback const& on_flushed);
+
+    private:
+        void start_write(std::unique_lock <std::mutex>& guard);
+        void on_written(boost::system::error_code ec, std::size_t amount);
+
+    private:
+        request_handler* req_;
+        file_io_service* file_io_;
+        std::shared_ptr <conclusion_observer> observer_;
+        async_file file_;
+
+        std::mutex lock_;
+        std::vector <char> pending_;
+        std::vector <char> in_flight_;
+        std::uint64_t offset_;
+        bool writing_;
+        bool paused_;
+        boost::system::error_code error_;
+        custom_callback on_flushed_;
+    };
+}
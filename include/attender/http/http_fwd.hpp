@@ -2,6 +2,7 @@
 
 #include <boost/asio.hpp>
 #include <string_view>
+#include <span>
 #include <memory>
 
 #ifdef DELETE
@@ -31,12 +32,21 @@ namespace attender
 
     class response_handler;
     class response_header;
+    class static_response;
     class mount_response;
 
+    class http_task;
+
+    class async_file;
+    class file_io_service;
+    class worker_pool;
+    class task_scheduler;
+
     // callback for functions with error code
     using custom_callback = std::function <void(boost::system::error_code /* ec */)>;
     using read_callback = std::function <void(boost::system::error_code /* ec */, std::size_t amountRead)>;
     using write_callback = std::function <void(boost::system::error_code /* ec */, std::size_t amount)>;
+    using data_callback = std::function <void(std::span <const char> /* data */)>;
     using parse_callback = std::function <void(boost::system::error_code /* ec */, std::exception const& /*exc*/)>;
     using error_callback = std::function <void(http_connection_interface* /*connection*/, boost::system::error_code /*ec*/, std::exception const& /* exc */)>;
 
@@ -45,6 +55,8 @@ namespace attender
                                                response_handler* /*response*/)>;
     using connected_callback = final_callback;
     using missing_handler_callback = final_callback;
+    using coroutine_callback = std::function <http_task(request_handler* /*request*/,
+                                                        response_handler* /*response*/)>;
     using interactive_connected_callback = std::function <bool(request_handler* /*request*/,
                                                                response_handler* /*response*/)>;
 
@@ -36,6 +36,14 @@ namespace attender
          */
         virtual size_type write(std::vector <char> const& buffer, size_type amount) = 0;
 
+        /**
+         *  Called before the first write with the amount of bytes that is going to be written, if it is known.
+         *  Sinks can use this to preallocate.
+         *
+         *  @param expected The expected amount of bytes.
+         */
+        virtual void expect(size_type expected);
+
         /**
          *  @return Returns the total amount of bytes that were written using this particular sink instance.
          */
@@ -62,7 +70,22 @@ namespace attender
         explicit http_string_sink(std::string* sink);
         size_type write(const char* data, size_type size) override;
         size_type write(std::vector <char> const& buffer, size_type amount) override;
+        void expect(size_type expected) override;
     private:
         std::string* sink_;
     };
+
+    /**
+     *  Passes views into the receive buffer to a callback, nothing is copied.
+     *  The view is only valid during the callback, unless the read is paused (see request_handler::pause_read).
+     */
+    class http_span_sink : public http_read_sink
+    {
+    public:
+        explicit http_span_sink(data_callback on_data);
+        size_type write(const char* data, size_type size) override;
+        size_type write(std::vector <char> const& buffer, size_type amount) override;
+    private:
+        data_callback on_data_;
+    };
 }
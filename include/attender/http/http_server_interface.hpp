@@ -18,5 +18,18 @@ namespace attender
         virtual boost::asio::ip::tcp::endpoint get_local_endpoint() const = 0;
         virtual settings get_settings() const = 0;
         virtual connection_manager* get_connections() = 0;
+        virtual file_io_service* get_file_io() = 0;
+        virtual worker_pool* get_worker_pool() = 0;
+        virtual task_scheduler* get_task_scheduler() = 0;
+        virtual boost::asio::io_service* get_io_service() = 0;
+
+        /**
+         *  Returns true if the calling thread is running the io_service of the server.
+         *  Handlers on the worker pool are not and hand socket operations over to the io_service.
+         */
+        bool running_in_io_thread()
+        {
+            return get_io_service()->get_executor().running_in_this_thread();
+        }
     };
 }
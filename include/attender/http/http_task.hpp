@@ -0,0 +1,125 @@
+#pragma once
+
+#include <attender/http/http_fwd.hpp>
+#include <attender/utility/coroutine_arena.hpp>
+
+#include <coroutine>
+#include <exception>
+#include <type_traits>
+#include <utility>
+
+namespace attender
+{
+    namespace internal
+    {
+        coroutine_arena* arena_of(response_handler* res);
+
+        inline coroutine_arena* find_arena()
+        {
+            return nullptr;
+        }
+
+        /**
+         *  Searches the coroutine parameters for the response handler, which leads to the arena of the connection.
+         */
+        template <typename HeadT, typename... TailT>
+        coroutine_arena* find_arena(HeadT const& head, TailT const&... tail)
+        {
+            if constexpr (std::is_convertible_v <HeadT, response_handler*>)
+                return arena_of(static_cast <response_handler*> (head));
+            else
+                return find_arena(tail...);
+        }
+
+        void* allocate_frame(std::size_t size, coroutine_arena* arena);
+        void deallocate_frame(void* ptr, std::size_t size) noexcept;
+    }
+
+    /**
+     *  The return type of coroutine route handlers (see http_basic_server::get_co).
+     *  The coroutine does not start before the server hands it the response and the frame is
+     *  allocated from the arena of the connection the handler is called for.
+     *
+     *  The response is concluded when the coroutine returns. If nothing was sent, the response is ended
+     *  with the current status, an escaping exception results in a 500. If the header was already sent,
+     *  the exception drops the connection instead, so the client does not mistake the body for complete.
+     */
+    class http_task
+    {
+    public:
+        struct promise_type;
+        using handle_type = std::coroutine_handle <promise_type>;
+
+        struct final_awaiter
+        {
+            bool await_ready() const noexcept
+            {
+                return false;
+            }
+            void await_suspend(handle_type handle) noexcept;
+            void await_resume() const noexcept
+            {
+            }
+        };
+
+        struct promise_type
+        {
+            response_handler* response = nullptr;
+            std::exception_ptr exception = {};
+
+            http_task get_return_object() noexcept
+            {
+                return http_task{handle_type::from_promise(*this)};
+            }
+            std::suspend_always initial_suspend() const noexcept
+            {
+                return {};
+            }
+            final_awaiter final_suspend() const noexcept
+            {
+                return {};
+            }
+            void return_void() const noexcept
+            {
+            }
+            void unhandled_exception() noexcept
+            {
+                exception = std::current_exception();
+            }
+
+            template <typename... ParametersT>
+            static void* operator new(std::size_t size, ParametersT const&... parameters)
+            {
+                return internal::allocate_frame(size, internal::find_arena(parameters...));
+            }
+            static void* operator new(std::size_t size)
+            {
+                return internal::allocate_frame(size, nullptr);
+            }
+            static void operator delete(void* ptr, std::size_t size) noexcept
+            {
+                internal::deallocate_frame(ptr, size);
+            }
+        };
+
+    public:
+        http_task(http_task&& other) noexcept;
+        http_task& operator=(http_task&& other) noexcept;
+        ~http_task();
+
+        http_task(http_task const&) = delete;
+        http_task& operator=(http_task const&) = delete;
+
+        /**
+         *  Starts the coroutine. The task releases the coroutine, which destroys itself on completion.
+         *  Called by the server.
+         */
+        void start(response_handler* res);
+
+    private:
+        explicit http_task(handle_type handle) noexcept;
+
+    private:
+        handle_type handle_;
+    };
+}
@@ -1,6 +1,7 @@
 #pragma once
 
 #include <string>
+#include <string_view>
 
 namespace attender
 {
@@ -16,4 +17,10 @@ namespace attender
      *  Trys to find a substring of a mime and return the mime type.
      */
     std::string search_mime(std::string const& part);
+
+    /**
+     *  Returns true for types that usually compress well, like text, json, xml or javascript.
+     *  Images, audio, video and archives are already compressed. Parameters like charset are ignored.
+     */
+    bool is_compressible_mime(std::string_view mime);
 }
@@ -15,6 +15,7 @@ namespace attender
         /**
          *  Appends the specified value to the HTTP response header field.
          *  If the header is not already set, it creates the header with the specified value.
+         *  Every appended value is sent as a line of its own.
          *
          *  @param field A header field identifier, such as "Warning" or "Link"
          *  @param value A value that is to be appended.
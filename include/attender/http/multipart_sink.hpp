@@ -0,0 +1,136 @@
+#pragma once
+
+#include <attender/http/http_fwd.hpp>
+#include <attender/http/http_read_sink.hpp>
+
+#include <boost/optional.hpp>
+
+#include <array>
+#include <functional>
+#include <memory>
+#include <string>
+#include <unordered_map>
+
+namespace attender
+{
+    /**
+     *  The header of a single part of a multipart body.
+     */
+    class multipart_header
+    {
+    public:
+        /**
+         *  Returns a header field of the part. The key is case insensitive.
+         *
+         *  @param key A header field key, such as "Content-Type".
+         *  @return The header fields value or boost::none.
+         */
+        boost::optional <std::string> get_field(std::string const& key) const;
+
+        /**
+         *  Returns the name parameter of the Content-Disposition field (the form field name).
+         */
+        boost::optional <std::string> name() const;
+
+        /**
+         *  Returns the filename parameter of the Content-Disposition field, which is set for file uploads.
+         */
+        boost::optional <std::string> filename() const;
+
+        /**
+         *  Returns the Content-Type of the part, which defaults to text/plain.
+         */
+        std::string content_type() const;
+
+        std::unordered_map <std::string, std::string> const& get_fields() const;
+
+    private:
+        friend class http_multipart_sink;
+
+        bool add_field(std::string const& line);
+        boost::optional <std::string> get_disposition_parameter(std::string const& parameter) const;
+
+    private:
+        std::unordered_map <std::string, std::string> fields_;
+    };
+
+    /**
+     *  A read sink that parses a multipart body (such as multipart/form-data) while it arrives.
+     *  Boundaries are searched with Boyer-Moore-Horspool directly in the received data and the
+     *  body of every part is passed on to a sink chosen per part, so memory use does not depend on the size of the upload.
+     *
+     *  Malformed input stops the parsing, check failed() after the read finished.
+     */
+    class http_multipart_sink : public http_read_sink
+    {
+    public:
+        /**
+         *  Called for every part once its header is complete. Returns the sink that receives the body of the part
+         *  or nullptr to discard it. The sink is released when the part ends.
+         */
+        using part_callback = std::function <std::shared_ptr <http_read_sink>(multipart_header const& header)>;
+
+    public:
+        /**
+         *  @param boundary The boundary parameter of the Content-Type (see get_boundary).
+         *  @param on_part Selects the sink for every part.
+         */
+        http_multipart_sink(std::string const& boundary, part_callback on_part);
+
+        size_type write(const char* data, size_type size) override;
+        size_type write(std::vector <char> const& buffer, size_type amount) override;
+
+        /**
+         *  @return Returns true, if the closing boundary was found.
+         */
+        bool finished() const;
+
+        /**
+         *  @return Returns true, if the body is not a valid multipart body.
+         */
+        bool failed() const;
+
+        /**
+         *  @return Returns the amount of parts encountered so far.
+         */
+        std::size_t get_part_count() const;
+
+        /**
+         *  Extracts the boundary from a Content-Type value like 'multipart/form-data; boundary=xyz'.
+         *
+         *  @return The boundary or boost::none if the content type is not multipart or has no boundary.
+         */
+        static boost::optional <std::string> get_boundary(std::string const& content_type);
+
+    private:
+        enum class state
+        {
+            preamble,
+            delimiter_suffix,
+            header,
+            body,
+            epilogue,
+            failed
+        };
+
+        char const* find_delimiter(char const* begin, char const* end) const;
+        std::size_t partial_delimiter(char const* begin, char const* end) const;
+        std::size_t scan(char const* data, std::size_t size);
+        std::size_t scan_carry(char const* data, std::size_t size);
+        std::size_t parse_suffix(char const* data, std::size_t size);
+        std::size_t parse_header(char const* data, std::size_t size);
+        void deliver(char const* data, std::size_t size);
+        void on_delimiter();
+
+    private:
+        std::string delimiter_;
+        std::array <std::size_t, 256> skip_;
+        part_callback on_part_;
+        state state_;
+        std::string carry_;
+        std::string line_;
+        multipart_header header_;
+        std::shared_ptr <http_read_sink> part_sink_;
+        std::size_t part_count_;
+    };
+}
@@ -3,9 +3,11 @@
 #include <attender/http/http_fwd.hpp>
 #include <attender/http/request_header.hpp>
 #include <attender/http/request_parser.hpp>
+#include <attender/http/chunked_decoder.hpp>
 #include <attender/utility/callback_wrapper.hpp>
 #include <attender/http/http_connection_interface.hpp>
 
+#include <atomic>
 #include <iosfwd>
 #include <unordered_map>
 
@@ -50,6 +52,9 @@ namespace attender
 
         /**
          *  Reads tcp-stream contents to the provided sink (in this case an ostream).
+         *  Bodies are either delimited by Content-Length or sent with "Transfer-Encoding: chunked",
+         *  in which case the payload is decoded and passed to the sink as it arrives.
+         *  Without either header, the read fails and 411 is sent.
          *  This stream must be kept alive until the read operation finishes and fullfill
          *  or except is called.
          *
@@ -82,11 +87,53 @@ namespace attender
          */
         callback_wrapper& read_body(std::shared_ptr <http_read_sink> sink, size_type max = 0);
 
+        /**
+         *  Streams the body to a callback as it arrives. The callback receives views into the receive buffer
+         *  of the connection, nothing is copied. A view is valid until the callback returns, or, if pause_read was
+         *  called, until resume_read is called.
+         *
+         *  @warning Do not start multiple read operations at the same time! This will crash you!
+         *  @warning Do not end the response from within the callback, do that in then().
+         *
+         *  @param on_data Called for every received part of the body.
+         *  @param max The maximum amount of bytes to read. If max = 0, there is no limit.
+         */
+        callback_wrapper& read_body(data_callback on_data, size_type max = 0);
+
+        /**
+         *  Stops issuing reads for the current body read until resume_read is called.
+         *  Data that was already received is still delivered. Can be used to apply backpressure when the consumer
+         *  of the body is slower than the client.
+         */
+        void pause_read();
+
+        /**
+         *  Continues a body read that was paused with pause_read.
+         *  Views into the receive buffer obtained while paused become invalid.
+         *  Can be called from any thread, the read is issued on the io_service.
+         */
+        void resume_read();
+
         /**
          *  Returns the amount of total bytes read in the last read call that was issued.
          */
         size_type get_read_amount() const;
 
+        /**
+         *  Returns true if the body is sent with "Transfer-Encoding: chunked".
+         */
+        bool is_chunked() const;
+
+        /**
+         *  Returns a trailer field sent after a chunked body.
+         *  Trailers are only available after the body was read completely.
+         *
+         *  @param key The trailer fields key.
+         *
+         *  @return The trailer fields value or boost::none.
+         */
+        boost::optional <std::string> get_trailer_field(std::string const& key) const;
+
         /**
          *  Contains the hostname derived from the Host HTTP header.
          *  When the trust proxy setting does not evaluate to false,
@@ -189,6 +236,9 @@ namespace attender
         // read handlers
         void header_read_handler(boost::system::error_code ec);
         void body_read_handler(boost::system::error_code ec, std::size_t amount);
+        void chunked_read(char const* data, std::size_t amount);
+        void continue_read();
+        void take_body_front();
 
         // server session handling
         void patch_cookie(std::string const& key, std::string const& value);
@@ -203,6 +253,7 @@ namespace attender
         // befriended
         void initiate_header_read(parse_callback on_parse);
         void set_parameters(std::unordered_map <std::string, std::string> const& params);
+        void issue_deferred_read();
 
     private:
         request_parser parser_;
@@ -213,6 +264,18 @@ namespace attender
         std::unordered_map <std::string, std::string> params_;
         callback_wrapper on_finished_read_;
         request_parser::buffer_size_type max_read_;
+        chunked_decoder chunked_decoder_;
+        bool chunked_body_;
+        std::string body_front_;
+
+        enum class read_flow
+        {
+            running,
+            paused,
+            withheld,
+            deferred // requested by a handler on the worker pool, issued when it returned.
+        };
+        std::atomic <read_flow> read_flow_;
     };
 //#####################################################################################################################
 }
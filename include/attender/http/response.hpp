@@ -5,20 +5,33 @@
 #include <attender/http/cookie.hpp>
 #include <attender/utility/conclusion_observer.hpp>
 #include <attender/encoding/producer.hpp>
+#include <attender/encoding/compression.hpp>
+#include <attender/utility/completion_awaitable.hpp>
+#include <attender/utility/date.hpp>
 
+#include <array>
 #include <atomic>
+#include <exception>
+#include <fstream>
 #include <map>
 #include <string>
+#include <string_view>
 #include <memory>
 
 namespace attender
 {
+    namespace internal
+    {
+        struct file_transfer;
+    }
+
     /**
      *  The response_handler is for everything writing and sending related.
      */
     class response_handler
     {
         friend mount_response;
+        friend http_task;
 
     public:
         explicit response_handler(http_connection_interface* connection) noexcept;
@@ -32,6 +45,7 @@ namespace attender
         /**
          *  Appends the specified value to the HTTP response header field.
          *  If the header is not already set, it creates the header with the specified value.
+         *  Every appended value is sent as a line of its own.
          *
          *  @param field A header field identifier, such as "Warning" or "Link"
          *  @param value A value that is to be appended.
@@ -80,6 +94,16 @@ namespace attender
          */
         response_handler& type(std::string const& mime, bool no_except = false);
 
+        /**
+         *  Overrides for this response whether bodies passed to send are compressed (see settings::compression).
+         *  Bodies are only compressed, if the client accepts a coding and the Content-Type is compressible.
+         *
+         *  @param mode compression_mode::inherit uses the setting of the route or server.
+         *
+         *  @return *this for chaining.
+         */
+        response_handler& compress(compression_mode mode);
+
         /**
          *  Sends the HTTP response. After a call to send, the status and header fields
          *  can no longer be changed as they will be sent with this function.
@@ -104,6 +128,36 @@ namespace attender
          */
         void send(std::vector <char> const& body);
 
+        /**
+         *  Like send(std::string const&), but takes over the body instead of copying it.
+         *
+         *  @param body A body to send.
+         */
+        void send(std::string&& body);
+
+        /**
+         *  Like send(std::vector <char> const&), but takes over the body instead of copying it.
+         *
+         *  @param body A body to send.
+         */
+        void send(std::vector <char>&& body);
+
+        /**
+         *  Like send(std::string const&), but the body is written directly from the shared buffer,
+         *  which is kept alive until the write completed. The same buffer can be sent to many responses at once.
+         *
+         *  @param body A body to send. Must not be nullptr.
+         */
+        void send(std::shared_ptr <std::string const> body);
+
+        /**
+         *  Like send(std::vector <char> const&), but the body is written directly from the shared buffer,
+         *  which is kept alive until the write completed. The same buffer can be sent to many responses at once.
+         *
+         *  @param body A body to send. Must not be nullptr.
+         */
+        void send(std::shared_ptr <std::vector <char> const> body);
+
         /**
          *  Sends the HTTP response. After a call to send, the status and header fields
          *  can no longer be changed as they will be sent with this function.
@@ -118,6 +172,17 @@ namespace attender
          */
         void send(std::istream& body, std::function <void()> const& on_finish = [](){});
 
+        /**
+         *  Sends a response that was serialized in advance (see static_response).
+         *  Its shared buffer is written to the socket as it is, only the Date line and the fields and cookies
+         *  that were set on this response handler are put in between by a gathering write.
+         *  Status and fields of this response handler do not override those of the static_response.
+         *  As this function completes the response, chaining will no longer be possible.
+         *
+         *  @param response The response to send. Copies share the buffer, so it can be a temporary.
+         */
+        void send(static_response const& response);
+
         /**
          *  Sends the HTTP response. After a call to send, the status and header fiels
          *  can no longer be changed as they will be sent with this function.
@@ -125,6 +190,7 @@ namespace attender
          *
          *  Content-Length will automatically be set, if not previously defined.
          *  Will force set Transfer-Encoding to chunked.
+         *  If the producer fails, the connection is reset without the terminating chunk.
          *
          *  @param body A body to send.
          *  @param on_finish A callback function that is called after the send operation finished.
@@ -141,16 +207,25 @@ namespace attender
          *  Sends the HTTP response. After a call to send, the status and header fields
          *  can no longer be changed as they will be sent with this function.
          *  As this function completes the response, chaining will no longer be possible.
-         *  The stream must provide seek and tell (some boost iostreams do not).
+         *  The file is read by the file io of the server (see http_server_interface::get_file_io), not on the io thread.
          *
          *  Content-Length will automatically be set, if not previously defined.
          *  Content-Type will be deduced from the filename if possible, "application/octet-stream" otherwise.
          *
          *  @param fileName A file to open in binary read mode and send.
          *  @return Returns false if the file could not be opened. The connection will not be closed and nothing will be sent.
+         *          To know this, the file is opened on the calling thread. The overload with missing_status does not block.
          */
         bool send_file(std::string const& fileName);
 
+        /**
+         *  Like send_file, but the file is also opened by the file io of the server, so nothing blocks the io thread.
+         *
+         *  @param file_name A file to open in binary read mode and send.
+         *  @param missing_status Sent with send_status instead, if the file could not be opened.
+         */
+        void send_file(std::string const& file_name, int missing_status);
+
         /**
          *  This function will set the status and send the status
          *  message a string in the body.
@@ -163,6 +238,85 @@ namespace attender
          */
         void send_status(int code);
 
+        /**
+         *  Awaitable version of send for coroutine handlers (see http_basic_server::get_co).
+         *  The coroutine is resumed once the body is written and the response ends when the coroutine returns.
+         *
+         *  Content-Length will automatically be set, if not previously defined.
+         *  Content-Type will be set to "text/plain" for this overload.
+         *
+         *  @param body A body to send. Owned by the awaitable until the write completes.
+         *  @return An awaitable yielding the boost::system::error_code of the write.
+         */
+        auto send_co(std::string body)
+        {
+            return completion_awaitable{[this, body = std::move(body)](custom_callback const& on_complete) {
+                send_then(body, on_complete);
+            }};
+        }
+
+        /**
+         *  Awaitable version of send for coroutine handlers (see http_basic_server::get_co).
+         *  The coroutine is resumed once the body is written and the response ends when the coroutine returns.
+         *
+         *  Content-Length will automatically be set, if not previously defined.
+         *  Content-Type will be set to "application/octet-stream" for this overload.
+         *
+         *  @param body A body to send. Owned by the awaitable until the write completes.
+         *  @return An awaitable yielding the boost::system::error_code of the write.
+         */
+        auto send_co(std::vector <char> body)
+        {
+            return completion_awaitable{[this, body = std::move(body)](custom_callback const& on_complete) {
+                send_then(body, on_complete);
+            }};
+        }
+
+        /**
+         *  Awaitable version of send_file for coroutine handlers (see http_basic_server::get_co).
+         *  If the file cannot be opened, nothing is sent and the awaitable yields no_such_file_or_directory.
+         *
+         *  @param file_name A file to open in binary read mode and send.
+         *  @return An awaitable yielding the boost::system::error_code of the operation.
+         */
+        auto send_file_co(std::string file_name)
+        {
+            return completion_awaitable{
+                [this, file_name = std::move(file_name)](custom_callback const& on_complete) {
+                    send_file_then(file_name, on_complete);
+                }
+            };
+        }
+
+        /**
+         *  Writes a chunk of a chunked response from a coroutine handler (see http_basic_server::get_co).
+         *  The first call sends the header with "Transfer-Encoding: chunked".
+         *  The data must stay valid until the awaitable completes, which it does when suspended in co_await.
+         *  Empty chunks are not written, because they would terminate the stream.
+         *
+         *  @param chunk The data of the chunk.
+         *  @return An awaitable yielding the boost::system::error_code of the write.
+         */
+        auto write_chunk_co(std::string_view chunk)
+        {
+            return completion_awaitable{[this, chunk](custom_callback const& on_complete) {
+                write_chunk_then(chunk, on_complete);
+            }};
+        }
+
+        /**
+         *  Terminates a chunked response started with write_chunk_co.
+         *  If omitted, the stream is terminated when the coroutine returns, unless an exception escapes it.
+         *
+         *  @return An awaitable yielding the boost::system::error_code of the write.
+         */
+        auto end_chunked_co()
+        {
+            return completion_awaitable{[this](custom_callback const& on_complete) {
+                end_chunked_then(on_complete);
+            }};
+        }
+
         /**
          *  Sets the location http header value to the specified path value.
          *
@@ -230,10 +384,102 @@ namespace attender
          */
         void try_set(std::string const& field, std::string const& value);
 
+        /**
+         *  Sets Content-Length and Content-Type if not set and fixes up 200/204 depending on the body size.
+         */
+        void prepare_body_header(std::size_t size, char const* default_type);
+
+        /**
+         *  Writes the header and the body with one gathering write and ends the response.
+         *  The storage keeps the memory of the body alive until then.
+         */
+        void send_retained(std::shared_ptr <void const> storage, boost::asio::const_buffer body);
+
+        /**
+         *  Completes the write of send_retained or send(static_response) and ends the response.
+         */
+        void finish_retained(boost::system::error_code ec);
+
+        /**
+         *  Resets the connection and removes it. The client sees an error instead of the end of a response
+         *  that was cut short. No write may be in flight.
+         */
+        void abort();
+
+        /**
+         *  Writes must start on the io_service. Off it, resume is posted there and runs unless the connection died meanwhile.
+         *
+         *  @return Returns true if resume was posted, the caller must return then.
+         */
+        bool post_to_io_thread(std::function <void()> const& resume);
+
+        /**
+         *  Compresses the body, if enabled and negotiated, and sets Content-Encoding, Content-Length and Vary.
+         *
+         *  @return nullptr if the body is to be sent as it is.
+         */
+        std::shared_ptr <std::string const> compress_body(std::string_view body);
+
+        /**
+         *  Seeks to the end of the stream and back to determine the size of its content.
+         */
+        static std::size_t stream_size(std::istream& stream);
+
+        /**
+         *  Opens a file for send_file and prepares the header.
+         *
+         *  @return nullptr if the file cannot be opened.
+         */
+        std::shared_ptr <internal::file_transfer> open_file(std::string const& file_name);
+
+        /**
+         *  Opens a file with the file io of the server and prepares the header. on_open receives nullptr if
+         *  the file cannot be opened and is not called if the connection went away in the meantime.
+         */
+        void open_file(std::string const& file_name, std::function <void(std::shared_ptr <internal::file_transfer> const&)> const& on_open);
+
+        void prepare_file_header(std::string const& file_name, std::uint64_t size);
+
+        /**
+         *  Reads the file block by block with the file io of the server and writes it to the connection.
+         */
+        void transfer_file(std::shared_ptr <internal::file_transfer> const& transfer, custom_callback const& on_done);
+
+        // coroutine support. These do not end the response, the http_task does when the coroutine returns.
+        void begin_coroutine();
+        void conclude_coroutine(std::exception_ptr const& exception);
+        void send_then(std::string const& body, custom_callback const& on_complete);
+        void send_then(std::vector <char> const& body, custom_callback const& on_complete);
+        void send_file_then(std::string const& file_name, custom_callback const& on_complete);
+        void write_chunk_then(std::string_view chunk, custom_callback const& on_complete);
+        void end_chunked_then(custom_callback const& on_complete);
+        void complete_pending(boost::system::error_code ec);
+
+        /**
+         *  Formats the size line of a chunk into chunk_header_.
+         */
+        std::string_view chunk_header(std::size_t size);
+
     private:
         http_connection_interface* connection_;
         response_header header_;
         std::atomic_bool header_sent_;
         std::shared_ptr <conclusion_observer> observer_;
+
+        // coroutine state
+        bool coroutine_driven_;
+        bool end_requested_;
+        bool chunked_open_;
+        custom_callback pending_completion_;
+        std::array <char, 2 * sizeof(std::size_t) + 2> chunk_header_;
+
+        // compression
+        compression_mode compression_;
+        std::shared_ptr <std::string const> compressed_;
+
+        // gathered writes
+        std::shared_ptr <void const> retained_;
+        std::array <char, 8 + date::gmt_string_length> date_line_;
+        std::string header_buffer_;
     };
 }
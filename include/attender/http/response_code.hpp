@@ -1,6 +1,7 @@
 #pragma once
 
 #include <string>
+#include <string_view>
 
 namespace attender
 {
@@ -8,4 +9,10 @@ namespace attender
      *  Returns a string representation for a given code number.
      */
     std::string translate_code(int status);
+
+    /**
+     *  Returns the precomputed status line "HTTP/1.1 <status> <message>\r\n" for a given code number.
+     *  Returns an empty view for codes translate_code does not know.
+     */
+    std::string_view status_line(int status);
 }
@@ -1,12 +1,14 @@
 #pragma once
 
 #include <attender/http/cookie.hpp>
+#include <attender/http/header_fields.hpp>
 
 #include <boost/optional.hpp>
 
+#include <functional>
 #include <string>
+#include <string_view>
 #include <vector>
-#include <unordered_map>
 
 namespace attender
 {
@@ -27,24 +29,61 @@ namespace attender
         void set_code(int code);
         void set_message(std::string const& message);
         void set_field(std::string const& field, std::string const& value);
+
+        /**
+         *  Adds another line for the field, so it is sent multiple times.
+         */
         void append_field(std::string const& field, std::string const& value);
+
+        /**
+         *  Sets the field if it is not set yet. Returns true if it was set.
+         */
+        bool try_set_field(std::string const& field, std::string const& value);
+        void remove_field(std::string const& field);
         void set_cookie(cookie const& cookie);
 
         std::string get_protocol() const;
         std::string get_version() const;
         int get_code() const;
         std::string get_message() const;
+        /**
+         *  Returns the value of a field, case insensitively. Multiple lines are joined with ", ".
+         */
         boost::optional <std::string> get_field(std::string const& key) const;
         bool has_field(std::string const& key) const;
+        header_fields const& get_fields() const;
 
+        /**
+         *  Serializes the header. A Date field is added, unless one was set.
+         */
         std::string to_string() const;
 
+        /**
+         *  Serializes the header like to_string, but appends to out.
+         */
+        void append_to(std::string& out) const;
+
+        /**
+         *  Appends only the status line, e.g. "HTTP/1.1 200 OK\r\n".
+         */
+        void append_status_line_to(std::string& out) const;
+
+        /**
+         *  Appends the field and Set-Cookie lines. Neither the Date line nor the terminating empty line are added.
+         */
+        void append_fields_to(std::string& out) const;
+
+        /**
+         *  Like append_fields_to, but only appends lines for which include(name) returns true.
+         */
+        void append_fields_to(std::string& out, std::function <bool(std::string_view /* name */)> const& include) const;
+
     private:
         std::string protocol_; // example: HTTP
         std::string version_; // example: 2.0
         int code_; // example: 200
         std::string message_; // example: OK
-        std::unordered_map <std::string, std::string> fields_; // example: Content-Length: 138
+        header_fields fields_; // example: Content-Length: 138
         std::vector <cookie> cookies_;
     };
 }
@@ -0,0 +1,29 @@
+#pragma once
+
+#include <attender/encoding/compression.hpp>
+
+namespace attender
+{
+    /**
+     *  Where a route handler is executed.
+     */
+    enum class execution_mode
+    {
+        /** On the io_context thread that read the request. For handlers that return quickly. **/
+        io,
+
+        /** On the worker_pool of the server (see settings::offload). For blocking or cpu heavy handlers. **/
+        offload
+    };
+
+    /**
+     *  Per route options that can be passed when registering a route.
+     */
+    struct route_options
+    {
+        execution_mode execution = execution_mode::io;
+
+        /** Overrides settings::compression for the responses of this route. **/
+        compression_mode compression = compression_mode::inherit;
+    };
+}
@@ -1,5 +1,10 @@
 #pragma once
 
+#include <attender/encoding/compression.hpp>
+#include <attender/io_context/file_io.hpp>
+#include <attender/io_context/worker_pool.hpp>
+#include <attender/io_context/task_scheduler.hpp>
+
 namespace attender
 {
     struct settings
@@ -9,5 +14,17 @@ namespace attender
 
         /** Send exceptions to client? I recommend no, to not leak information unneccessarily, but its useful for debugging, **/
         bool expose_exception = false;
+
+        /** Configures the file io used by send_file, mount and file sinks. **/
+        file_io_options file_io = {};
+
+        /** Configures the worker pool that runs routes registered with execution_mode::offload. **/
+        worker_pool_options offload = {};
+
+        /** Configures the scheduler for small cpu bound tasks, like compression. **/
+        task_scheduler_options tasks = {};
+
+        /** Compression of bodies passed to response_handler::send. Off unless enabled. **/
+        compression_options compression = {};
     };
 }
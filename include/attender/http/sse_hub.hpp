@@ -0,0 +1,133 @@
+#pragma once
+
+#include <attender/http/http_fwd.hpp>
+#include <attender/net_core.hpp>
+
+#include <chrono>
+#include <cstddef>
+#include <memory>
+#include <string>
+
+namespace attender
+{
+    /**
+     *  An event of a Server-Sent Events stream.
+     */
+    struct sse_event
+    {
+        /** The payload, every line is sent as a "data:" line of its own. **/
+        std::string data;
+
+        /** Sent as "id:" if not empty. Only events with an id can be replayed. Must not contain line breaks. **/
+        std::string id;
+
+        /** Sent as "event:" if not empty. Must not contain line breaks. **/
+        std::string event;
+    };
+
+    /**
+     *  What happens to a subscriber whose queue is full.
+     */
+    enum class sse_overflow
+    {
+        /** The oldest queued event is dropped for the new one. **/
+        drop_oldest,
+
+        /** The connection is closed, the client reconnects with Last-Event-ID and is replayed what it missed. **/
+        disconnect
+    };
+
+    struct sse_options
+    {
+        /** Events that may be queued per subscriber while its connection is busy writing. **/
+        std::size_t queue_limit = 1024;
+
+        /** Applied when a queue is full. **/
+        sse_overflow overflow = sse_overflow::disconnect;
+
+        /** Events with an id that are kept per topic for Last-Event-ID replay. 0 disables replay. **/
+        std::size_t replay_capacity = 256;
+
+        /** Interval of the comment lines that keep idle connections and proxies alive. 0 disables them. **/
+        std::chrono::milliseconds heartbeat_interval = std::chrono::seconds{15};
+
+        /** Sent as "retry:" to new subscribers, the reconnection delay of the client. 0 sends nothing. **/
+        std::chrono::milliseconds retry = std::chrono::milliseconds{0};
+    };
+
+    /**
+     *  Fans out Server-Sent Events to many connections.
+     *
+     *  A published event is formatted once, framing and chunk header included, into a shared immutable buffer.
+     *  Every subscriber of the topic queues a reference to that buffer and writes it with a gathering write,
+     *  nothing is copied per connection. Each subscriber has a bounded queue, a slow client is handled
+     *  by sse_options::overflow instead of buffering without limit.
+     *
+     *  Events with an id are kept in a ring per topic. A reconnecting client sends Last-Event-ID and is
+     *  sent the events it missed before the live stream continues.
+     *
+     *  One timer of the hub sends heartbeat comments to idle subscribers of all topics. They keep proxies from closing
+     *  idle streams. A client that closes its connection is noticed without them, its subscription ends right away.
+     *  All functions are thread safe, publish can be called from any thread.
+     */
+    class sse_hub
+    {
+    public:
+        /**
+         *  @param service The io context of the server, writes and heartbeats run on it. Must outlive the hub.
+         *  @param options Queue, replay and heartbeat configuration.
+         */
+        explicit sse_hub(asio::io_service& service, sse_options options = {});
+
+        /**
+         *  Ends the streams of all subscribers.
+         */
+        ~sse_hub();
+
+        sse_hub(sse_hub const&) = delete;
+        sse_hub& operator=(sse_hub const&) = delete;
+
+        /**
+         *  Turns the response into an event stream of the topic. The header is sent with
+         *  "Content-Type: text/event-stream" and "Transfer-Encoding: chunked".
+         *  If the request has a Last-Event-ID field, the events after it are sent first. If the id is not in
+         *  the ring anymore, the whole ring is sent.
+         *  The response ends when the client goes away, the hub is closed or the queue overflows with
+         *  sse_overflow::disconnect. Do not use the response afterwards.
+         *
+         *  @param topic The topic to subscribe to.
+         */
+        void subscribe(std::string const& topic, request_handler* req, response_handler* res);
+
+        /**
+         *  Sends an event to all subscribers of the topic.
+         *
+         *  @return The amount of subscribers the event was queued for.
+         */
+        std::size_t publish(std::string const& topic, sse_event const& event);
+
+        /**
+         *  Ends the streams of all subscribers and stops the heartbeats. Later subscribers are answered with 503.
+         */
+        void close();
+
+        /**
+         *  The amount of subscribers of the topic.
+         */
+        std::size_t subscriber_count(std::string const& topic) const;
+
+        /**
+         *  The amount of subscribers of all topics.
+         */
+        std::size_t subscriber_count() const;
+
+        /**
+         *  Formats an event as it is sent, without chunk framing.
+         */
+        static std::string format(sse_event const& event);
+
+    private:
+        struct implementation;
+        std::shared_ptr <implementation> impl_;
+    };
+}
@@ -0,0 +1,68 @@
+#pragma once
+
+#include <attender/http/response_header.hpp>
+
+#include <memory>
+#include <string>
+#include <string_view>
+
+namespace attender
+{
+    /**
+     *  An immutable response that is serialized once and can then be sent any number of times
+     *  (see response_handler::send(static_response const&)). Meant for hot replies that never change,
+     *  like health checks, favicons or canned error pages.
+     *
+     *  Status line, fields and body live in one shared buffer, copies of a static_response share it.
+     *  The Date line is not part of it, because it is written fresh for every response.
+     */
+    class static_response
+    {
+    public:
+        /**
+         *  @param code A response code 1xx, 2xx, 3xx, 4xx or 5xx
+         *  @param body The body of the response.
+         *  @param content_type The Content-Type of the body.
+         */
+        static_response(int code, std::string_view body, std::string const& content_type = "text/plain");
+
+        /**
+         *  Serializes the header and the body. Content-Length is always set to the size of the body and
+         *  a Date field of the header is dropped.
+         *
+         *  @param header Status and fields to send.
+         *  @param body The body of the response.
+         */
+        static_response(response_header header, std::string_view body);
+
+        int get_code() const noexcept;
+
+        /**
+         *  The status line, including its line break.
+         */
+        std::string_view get_status_line() const noexcept;
+
+        /**
+         *  Everything after the status line: the fields, the empty line and the body.
+         */
+        std::string_view get_remainder() const noexcept;
+
+        std::string_view get_body() const noexcept;
+
+        /**
+         *  Returns true if the serialized fields contain the field, compared case insensitively.
+         */
+        bool has_field(std::string_view name) const noexcept;
+
+        /**
+         *  The shared buffer that holds the serialized response.
+         */
+        std::shared_ptr <std::string const> const& get_buffer() const noexcept;
+
+    private:
+        std::shared_ptr <std::string const> buffer_;
+        std::size_t status_line_size_;
+        std::size_t body_offset_;
+        int code_;
+    };
+}
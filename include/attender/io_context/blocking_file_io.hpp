@@ -0,0 +1,55 @@
+#pragma once
+
+#include <attender/io_context/file_io.hpp>
+
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace attender
+{
+    /**
+     *  A file_io_service that runs blocking opens, reads and writes on its own threads,
+     *  so a slow disk does not stall the io_context threads.
+     */
+    class blocking_file_io : public file_io_service
+    {
+    public:
+        blocking_file_io(asio::io_context* context, file_io_options const& options);
+        ~blocking_file_io();
+
+        void async_read(async_file const& file, std::uint64_t offset, char* buffer, std::size_t size, file_io_callback handler) override;
+        void async_write(async_file const& file, std::uint64_t offset, char const* buffer, std::size_t size, file_io_callback handler) override;
+        void async_open(async_file& file, std::string const& path, async_file::mode open_mode, file_io_callback handler) override;
+        char const* backend() const override;
+
+    private:
+        struct operation
+        {
+            async_file const* file;
+            std::uint64_t offset;
+            char* read_buffer;
+            char const* write_buffer;
+            std::size_t size;
+            file_io_callback handler;
+
+            // set for opens, which have no buffer.
+            async_file* opened = nullptr;
+            std::string path = {};
+            async_file::mode open_mode = async_file::mode::read;
+        };
+
+        void enqueue(operation&& op);
+        void work();
+
+    private:
+        asio::io_context* context_;
+        std::mutex lock_;
+        std::condition_variable wake_;
+        std::deque <operation> queue_;
+        std::vector <std::thread> threads_;
+        bool stopping_;
+    };
+}
@@ -0,0 +1,132 @@
+#pragma once
+
+#include <attender/net_core.hpp>
+
+#include <boost/system/error_code.hpp>
+
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string>
+
+namespace attender
+{
+    using file_io_callback = std::function <void(boost::system::error_code /* ec */, std::size_t /* amount */)>;
+
+    struct file_io_options
+    {
+        /** Maximum amount of file operations in flight, further operations are queued. For io_uring this is the ring size, otherwise it limits the amount of threads. **/
+        std::size_t queue_depth = config::file_io_queue_depth;
+
+        /** Amount of threads that perform blocking file operations, if io_uring is not used. At most queue_depth. **/
+        std::size_t threads = 2;
+
+        /** Use io_uring where available (Linux, attender built with ENABLE_IO_URING). **/
+        bool prefer_io_uring = true;
+    };
+
+    /**
+     *  A file opened for positional reads or writes by a file_io_service.
+     */
+    class async_file
+    {
+    public:
+        enum class mode
+        {
+            /// Opens an existing file for reading.
+            read,
+            /// Creates or truncates a file for writing.
+            write
+        };
+
+    public:
+        async_file() noexcept;
+        ~async_file();
+
+        async_file(async_file const&) = delete;
+        async_file& operator=(async_file const&) = delete;
+
+        /**
+         *  Opens the file.
+         *
+         *  @return Returns false if the file could not be opened.
+         */
+        bool open(std::string const& path, mode open_mode);
+
+        /**
+         *  Takes over a descriptor that was opened elsewhere, for example by a file_io_service.
+         *
+         *  @return Returns false if fd is -1 or not a regular file, the descriptor is closed then.
+         */
+        bool assign(int fd);
+
+        /**
+         *  Closes the file. Must not be called while operations are in flight.
+         */
+        void close();
+
+        bool is_open() const;
+
+        /**
+         *  @return Returns the size of the file in bytes.
+         */
+        std::uint64_t size() const;
+
+        /**
+         *  Returns the file descriptor.
+         */
+        int native_handle() const;
+
+        /**
+         *  Blocking positional read. Reads until size bytes were read or the end of the file is reached.
+         */
+        std::size_t read_at(std::uint64_t offset, char* buffer, std::size_t size, boost::system::error_code& ec) const;
+
+        /**
+         *  Blocking positional write. Writes all size bytes unless an error occurs.
+         */
+        std::size_t write_at(std::uint64_t offset, char const* buffer, std::size_t size, boost::system::error_code& ec) const;
+
+    private:
+        int fd_;
+    };
+
+    /**
+     *  Performs file reads and writes without blocking the io_context threads.
+     *  The buffer and the file must stay alive until the handler is called.
+     *  Handlers are called on the io_context.
+     *  Operations that have not started when the service is destroyed complete with operation_aborted.
+     */
+    class file_io_service
+    {
+    public:
+        virtual ~file_io_service() = default;
+
+        /**
+         *  Reads up to size bytes from offset. Less is only read at the end of the file.
+         */
+        virtual void async_read(async_file const& file, std::uint64_t offset, char* buffer, std::size_t size, file_io_callback handler) = 0;
+
+        /**
+         *  Writes size bytes at offset.
+         */
+        virtual void async_write(async_file const& file, std::uint64_t offset, char const* buffer, std::size_t size, file_io_callback handler) = 0;
+
+        /**
+         *  Opens path into file, like async_file::open. The handler receives the size of the opened file as amount,
+         *  or an error if it could not be opened.
+         */
+        virtual void async_open(async_file& file, std::string const& path, async_file::mode open_mode, file_io_callback handler) = 0;
+
+        /**
+         *  Returns the name of the backend, "io_uring" or "threads".
+         */
+        virtual char const* backend() const = 0;
+
+        /**
+         *  Creates the best available file_io_service.
+         *  io_uring is used when preferred and available, otherwise blocking operations are run on a dedicated thread pool.
+         */
+        static std::unique_ptr <file_io_service> create(asio::io_context* context, file_io_options const& options = {});
+    };
+}
@@ -0,0 +1,201 @@
+#pragma once
+
+#include <attender/io_context/work_stealing_deque.hpp>
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+namespace attender
+{
+    class task_group;
+
+    /**
+     *  Rethrown by task_group::wait for tasks that never ran, because the scheduler was destroyed first.
+     */
+    class task_cancelled : public std::runtime_error
+    {
+    public:
+        task_cancelled()
+            : std::runtime_error{"the task_scheduler was destroyed before the task ran"}
+        {
+        }
+    };
+
+    struct task_scheduler_options
+    {
+        /** Amount of worker threads. **/
+        std::size_t threads = std::thread::hardware_concurrency() == 0 ? 4 : std::thread::hardware_concurrency();
+    };
+
+    /**
+     *  A work stealing scheduler for short, cpu bound tasks like compression, hashing or building responses.
+     *  Every worker owns a deque, tasks submitted from a worker are pushed to its own deque without locking.
+     *  Idle workers steal from the others. Tasks submitted from other threads go through a shared queue.
+     *
+     *  Unlike posting to the io_context, no lock is taken per task in the common case and forked subtasks stay
+     *  on the thread that created them while their data is still in its cache.
+     */
+    class task_scheduler
+    {
+    public:
+        explicit task_scheduler(task_scheduler_options const& options = {});
+
+        /**
+         *  Finishes the running tasks. Tasks that did not start are dropped, their groups see task_cancelled.
+         */
+        ~task_scheduler();
+
+        task_scheduler(task_scheduler const&) = delete;
+        task_scheduler& operator=(task_scheduler const&) = delete;
+
+        /**
+         *  Submits a task. Exceptions escaping the task are swallowed, use a task_group to observe them.
+         */
+        void submit(std::function <void()> work);
+
+        /**
+         *  Returns the amount of worker threads.
+         */
+        std::size_t get_thread_count() const noexcept;
+
+        /**
+         *  Returns the scheduler, if the calling thread is one of its workers, nullptr otherwise.
+         */
+        static task_scheduler* current() noexcept;
+
+    private:
+        friend task_group;
+
+        struct task
+        {
+            std::function <void()> work;
+            task_group* group;
+        };
+
+        struct worker
+        {
+            work_stealing_deque <task*> deque;
+            std::thread thread;
+        };
+
+        void submit(task* job);
+
+        /**
+         *  Finds and runs one task, used by workers waiting for a task_group.
+         *  Returns false if no task was found.
+         */
+        bool run_one();
+
+        task* find_task(std::size_t self);
+        void execute(task* job);
+        void work(std::size_t index);
+
+    private:
+        std::vector <std::unique_ptr <worker>> workers_;
+
+        std::mutex injection_lock_;
+        std::deque <task*> injected_;
+
+        std::mutex sleep_lock_;
+        std::condition_variable wake_;
+        std::atomic <std::size_t> sleeping_;
+        std::atomic <std::size_t> pending_;
+        std::atomic_bool stopping_;
+    };
+
+    /**
+     *  Forks tasks onto a task_scheduler and joins them.
+     *  A worker waiting for the group runs queued tasks in the meantime, other threads block.
+     */
+    class task_group
+    {
+    public:
+        explicit task_group(task_scheduler& scheduler);
+
+        /**
+         *  Waits for all tasks of the group.
+         */
+        ~task_group();
+
+        task_group(task_group const&) = delete;
+        task_group& operator=(task_group const&) = delete;
+
+        /**
+         *  Forks a task.
+         */
+        void run(std::function <void()> work);
+
+        /**
+         *  Joins all tasks forked so far. Rethrows the first exception that escaped one of them,
+         *  or task_cancelled if the scheduler was destroyed before one ran.
+         */
+        void wait();
+
+    private:
+        friend task_scheduler;
+
+        void finish(std::exception_ptr const& exception);
+
+    private:
+        task_scheduler* scheduler_;
+        std::atomic <std::size_t> outstanding_;
+
+        // guards exception_ and the last decrement of outstanding_.
+        std::mutex lock_;
+        std::condition_variable finished_;
+        std::exception_ptr exception_;
+    };
+
+    /**
+     *  Runs operations one after another in the order they were added.
+     *  With a scheduler they run as a single task on it at a time, otherwise right away on the calling thread.
+     *  Used for state that must not be touched concurrently, like that of the encoders.
+     */
+    class task_sequence
+    {
+    public:
+        task_sequence();
+
+        /**
+         *  Waits for the queued operations.
+         */
+        ~task_sequence();
+
+        task_sequence(task_sequence const&) = delete;
+        task_sequence& operator=(task_sequence const&) = delete;
+
+        /**
+         *  Do NOT call while operations are queued.
+         */
+        void set_scheduler(task_scheduler* scheduler);
+        task_scheduler* get_scheduler() const noexcept;
+
+        /**
+         *  Runs the operation after all that were added before.
+         */
+        void run(std::function <void()> operation);
+
+        /**
+         *  Waits for all operations added so far.
+         */
+        void wait();
+
+    private:
+        void run_queued();
+
+    private:
+        task_scheduler* scheduler_;
+        std::unique_ptr <task_group> group_;
+        std::mutex queue_lock_;
+        std::deque <std::function <void()>> queued_;
+        bool queue_running_;
+    };
+}
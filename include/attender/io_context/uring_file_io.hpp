@@ -0,0 +1,67 @@
+#pragma once
+
+#ifdef ATTENDER_ENABLE_IO_URING
+
+#include <attender/io_context/file_io.hpp>
+
+#include <liburing.h>
+
+#include <deque>
+#include <mutex>
+#include <string>
+#include <thread>
+
+namespace attender
+{
+    /**
+     *  A file_io_service backed by io_uring. Operations are submitted from the calling thread,
+     *  a reaper thread waits for completions and posts the handlers to the io_context.
+     */
+    class uring_file_io : public file_io_service
+    {
+    public:
+        /**
+         *  @throws std::system_error if the ring cannot be set up (old kernel, seccomp, ...).
+         */
+        uring_file_io(asio::io_context* context, file_io_options const& options);
+        ~uring_file_io();
+
+        void async_read(async_file const& file, std::uint64_t offset, char* buffer, std::size_t size, file_io_callback handler) override;
+        void async_write(async_file const& file, std::uint64_t offset, char const* buffer, std::size_t size, file_io_callback handler) override;
+        void async_open(async_file& file, std::string const& path, async_file::mode open_mode, file_io_callback handler) override;
+        char const* backend() const override;
+
+    private:
+        struct operation
+        {
+            int fd;
+            std::uint64_t offset;
+            char* read_buffer;
+            char const* write_buffer;
+            std::size_t size;
+            std::size_t done;
+            file_io_callback handler;
+
+            // set for opens, which have no buffer.
+            async_file* opened = nullptr;
+            std::string path = {};
+            int flags = 0;
+        };
+
+        void submit(operation* op);
+        void prepare(operation* op);
+        void reap();
+
+    private:
+        asio::io_context* context_;
+        io_uring ring_;
+        std::mutex lock_;
+        std::deque <operation*> backlog_;
+        std::size_t in_flight_;
+        std::size_t queue_depth_;
+        bool stopping_;
+        std::thread reaper_;
+    };
+}
+
+#endif // ATTENDER_ENABLE_IO_URING
@@ -0,0 +1,164 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <type_traits>
+#include <vector>
+
+namespace attender
+{
+    /**
+     *  A Chase-Lev work stealing deque (as formulated by Le, Pop, Cohen and Zappa Nardelli for C11 atomics).
+     *  The owning thread pushes and pops at the bottom, any other thread steals from the top without locking.
+     *  The buffer grows when full, old buffers are kept until destruction, because thieves may still read them.
+     *
+     *  @tparam T A trivially copyable type, usually a pointer.
+     */
+    template <typename T>
+    class work_stealing_deque
+    {
+        static_assert(std::is_trivially_copyable_v <T>, "work_stealing_deque requires trivially copyable elements");
+
+    public:
+        explicit work_stealing_deque(std::size_t capacity = 256)
+            : top_{0}
+            , bottom_{0}
+            , ring_{nullptr}
+            , retired_{}
+        {
+            std::size_t rounded = 1;
+            while (rounded < capacity)
+                rounded <<= 1;
+            retired_.push_back(std::make_unique <ring> (rounded));
+            ring_.store(retired_.back().get(), std::memory_order_relaxed);
+        }
+
+        work_stealing_deque(work_stealing_deque const&) = delete;
+        work_stealing_deque& operator=(work_stealing_deque const&) = delete;
+
+        /**
+         *  Pushes to the bottom. Only the owner may call this.
+         */
+        void push(T value)
+        {
+            auto bottom = bottom_.load(std::memory_order_relaxed);
+            auto top = top_.load(std::memory_order_acquire);
+            auto* buffer = ring_.load(std::memory_order_relaxed);
+
+            if (bottom - top > static_cast <std::int64_t> (buffer->capacity) - 1)
+                buffer = grow(buffer, bottom, top);
+
+            buffer->put(bottom, value);
+            std::atomic_thread_fence(std::memory_order_release);
+            bottom_.store(bottom + 1, std::memory_order_relaxed);
+        }
+
+        /**
+         *  Pops from the bottom. Only the owner may call this.
+         */
+        std::optional <T> pop()
+        {
+            auto bottom = bottom_.load(std::memory_order_relaxed) - 1;
+            auto* buffer = ring_.load(std::memory_order_relaxed);
+            bottom_.store(bottom, std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            auto top = top_.load(std::memory_order_relaxed);
+
+            if (top > bottom)
+            {
+                bottom_.store(bottom + 1, std::memory_order_relaxed);
+                return std::nullopt;
+            }
+
+            auto value = buffer->get(bottom);
+            if (top == bottom)
+            {
+                // last element, race against thieves.
+                bool won = top_.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst, std::memory_order_relaxed);
+                bottom_.store(bottom + 1, std::memory_order_relaxed);
+                if (!won)
+                    return std::nullopt;
+            }
+            return value;
+        }
+
+        /**
+         *  Steals from the top. Can be called from any thread.
+         */
+        std::optional <T> steal()
+        {
+            auto top = top_.load(std::memory_order_acquire);
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            auto bottom = bottom_.load(std::memory_order_acquire);
+
+            if (top >= bottom)
+                return std::nullopt;
+
+            auto* buffer = ring_.load(std::memory_order_acquire);
+            auto value = buffer->get(top);
+            if (!top_.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst, std::memory_order_relaxed))
+                return std::nullopt;
+            return value;
+        }
+
+        /**
+         *  Returns an estimate of the amount of elements.
+         */
+        std::size_t size() const noexcept
+        {
+            auto bottom = bottom_.load(std::memory_order_relaxed);
+            auto top = top_.load(std::memory_order_relaxed);
+            return bottom > top ? static_cast <std::size_t> (bottom - top) : 0;
+        }
+
+        bool empty() const noexcept
+        {
+            return size() == 0;
+        }
+
+    private:
+        struct ring
+        {
+            explicit ring(std::size_t capacity)
+                : capacity{capacity}
+                , mask{capacity - 1}
+                , slots{new std::atomic <T>[capacity]}
+            {
+            }
+
+            void put(std::int64_t index, T value) noexcept
+            {
+                slots[static_cast <std::size_t> (index) & mask].store(value, std::memory_order_relaxed);
+            }
+
+            T get(std::int64_t index) const noexcept
+            {
+                return slots[static_cast <std::size_t> (index) & mask].load(std::memory_order_relaxed);
+            }
+
+            std::size_t capacity;
+            std::size_t mask;
+            std::unique_ptr <std::atomic <T>[]> slots;
+        };
+
+        ring* grow(ring* buffer, std::int64_t bottom, std::int64_t top)
+        {
+            retired_.push_back(std::make_unique <ring> (buffer->capacity * 2));
+            auto* bigger = retired_.back().get();
+            for (auto i = top; i != bottom; ++i)
+                bigger->put(i, buffer->get(i));
+            ring_.store(bigger, std::memory_order_release);
+            return bigger;
+        }
+
+    private:
+        alignas(64) std::atomic <std::int64_t> top_;
+        alignas(64) std::atomic <std::int64_t> bottom_;
+        std::atomic <ring*> ring_;
+
+        // owner only
+        std::vector <std::unique_ptr <ring>> retired_;
+    };
+}
@@ -0,0 +1,85 @@
+#pragma once
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace attender
+{
+    struct worker_pool_options
+    {
+        /** Amount of worker threads. **/
+        std::size_t threads = std::thread::hardware_concurrency() == 0 ? 4 : std::thread::hardware_concurrency();
+
+        /** Maximum amount of waiting jobs. Jobs beyond are rejected. **/
+        std::size_t queue_limit = 1024;
+    };
+
+    struct worker_pool_statistics
+    {
+        /** Jobs currently waiting for a worker. **/
+        std::size_t queued = 0;
+
+        /** Highest amount of waiting jobs so far. **/
+        std::size_t peak_queued = 0;
+
+        /** Jobs currently running. **/
+        std::size_t active = 0;
+
+        std::uint64_t completed = 0;
+        std::uint64_t rejected = 0;
+
+        /** Time jobs waited for a worker. **/
+        std::chrono::microseconds average_wait{0};
+        std::chrono::microseconds max_wait{0};
+    };
+
+    /**
+     *  A bounded pool of threads for blocking or cpu heavy work, that must not run on the io_context threads.
+     */
+    class worker_pool
+    {
+    public:
+        explicit worker_pool(worker_pool_options const& options = {});
+        ~worker_pool();
+
+        worker_pool(worker_pool const&) = delete;
+        worker_pool& operator=(worker_pool const&) = delete;
+
+        /**
+         *  Queues a job.
+         *
+         *  @return Returns false if the queue is full and the job was rejected.
+         */
+        bool post(std::function <void()> job);
+
+        /**
+         *  Returns queue depth and wait times, to help sizing the pool.
+         */
+        worker_pool_statistics get_statistics() const;
+
+    private:
+        void work();
+
+    private:
+        struct queued_job
+        {
+            std::function <void()> job;
+            std::chrono::steady_clock::time_point enqueued;
+        };
+
+        std::size_t queue_limit_;
+        mutable std::mutex lock_;
+        std::condition_variable wake_;
+        std::deque <queued_job> queue_;
+        std::vector <std::thread> threads_;
+        worker_pool_statistics statistics_;
+        std::chrono::steady_clock::duration total_wait_;
+        bool stopping_;
+    };
+}
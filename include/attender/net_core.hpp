@@ -26,6 +26,22 @@
 #   define CONFIG_READ_TIMEOUT 11
 #endif // CONFIG_READ_TIMEOUT
 
+#ifndef CONFIG_MAX_BODY_RESERVE
+#   define CONFIG_MAX_BODY_RESERVE 16777216
+#endif // CONFIG_MAX_BODY_RESERVE
+
+#ifndef CONFIG_FILE_IO_QUEUE_DEPTH
+#   define CONFIG_FILE_IO_QUEUE_DEPTH 64
+#endif // CONFIG_FILE_IO_QUEUE_DEPTH
+
+#ifndef CONFIG_FILE_IO_BLOCK_SIZE
+#   define CONFIG_FILE_IO_BLOCK_SIZE 65536
+#endif // CONFIG_FILE_IO_BLOCK_SIZE
+
+#ifndef CONFIG_COROUTINE_ARENA_SIZE
+#   define CONFIG_COROUTINE_ARENA_SIZE 4096
+#endif // CONFIG_COROUTINE_ARENA_SIZE
+
 namespace attender
 {
     namespace asio = boost::asio;
@@ -36,5 +52,9 @@ namespace attender
         constexpr static std::size_t header_buffer_max = CONFIG_MAX_HEADER_BUFFER;
         constexpr static std::size_t header_field_max = CONFIG_MAX_HEADER_FIELDS;
         constexpr static uint32_t read_timeout = CONFIG_READ_TIMEOUT;
+        constexpr static std::size_t body_reserve_max = CONFIG_MAX_BODY_RESERVE;
+        constexpr static std::size_t file_io_queue_depth = CONFIG_FILE_IO_QUEUE_DEPTH;
+        constexpr static std::size_t file_io_block_size = CONFIG_FILE_IO_BLOCK_SIZE;
+        constexpr static std::size_t coroutine_arena_size = CONFIG_COROUTINE_ARENA_SIZE;
     }
 }
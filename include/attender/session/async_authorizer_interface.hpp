@@ -0,0 +1,60 @@
+#pragma once
+
+#include <attender/session/authorizer_interface.hpp>
+
+#include <functional>
+#include <memory>
+#include <string>
+
+namespace attender
+{
+    /**
+     *  An authorizer that does not block, for credentials that are checked by another service.
+     *  The results mean the same as for authorizer_interface.
+     *
+     *  The completion handler may be called before the function returns, or later on any thread.
+     *  The server continues the request on its io_service when it is called from elsewhere.
+     */
+    class async_authorizer_interface
+    {
+    public:
+        using authorization_callback = std::function <void(authorization_result)>;
+
+        virtual ~async_authorizer_interface() = default;
+
+        /**
+         *  Supply a realm. Can be anything
+         */
+        virtual std::string realm() const = 0;
+
+        /**
+         *  See authorizer_interface::negotiate_authorization_method.
+         **/
+        virtual void negotiate_authorization_method(request_handler* req, response_handler* res) = 0;
+
+        /**
+         *  Try to authenticate user with given request. req and res stay valid until on_complete is called,
+         *  unless the connection is closed.
+         */
+        virtual void async_perform_authorization(request_handler* req, response_handler* res, authorization_callback on_complete) = 0;
+    };
+
+    /**
+     *  Makes a synchronous authorizer usable where an asynchronous one is expected.
+     *  Every authorization completes before it returns.
+     */
+    class sync_authorizer_adapter : public async_authorizer_interface
+    {
+    public:
+        explicit sync_authorizer_adapter(std::shared_ptr <authorizer_interface> authorizer);
+
+        std::string realm() const override;
+        void negotiate_authorization_method(request_handler* req, response_handler* res) override;
+        void async_perform_authorization(request_handler* req, response_handler* res, authorization_callback on_complete) override;
+
+        authorizer_interface* get_authorizer() const;
+
+    private:
+        std::shared_ptr <authorizer_interface> authorizer_;
+    };
+}
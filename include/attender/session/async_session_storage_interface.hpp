@@ -0,0 +1,71 @@
+#pragma once
+
+#include <attender/session/session_storage_interface.hpp>
+
+#include <boost/system/error_code.hpp>
+
+#include <functional>
+#include <string>
+
+namespace attender
+{
+    /**
+     *  A session storage that does not block, for storages behind the network or on disk.
+     *
+     *  The completion handlers may be called before the function returns, or later on any thread.
+     *  The server continues the request on its io_service when they are called from elsewhere.
+     *  An error code tells that the storage could not be reached, not that the session does not exist.
+     */
+    class async_session_storage_interface
+    {
+    public:
+        using lookup_callback = std::function <void(boost::system::error_code, session_state)>;
+        using create_callback = std::function <void(boost::system::error_code, std::string const& /*id*/)>;
+        using set_callback = std::function <void(boost::system::error_code, bool /*stored*/)>;
+        using completion_callback = std::function <void(boost::system::error_code)>;
+
+        /**
+         *  Like session_storage_interface::lookup_session.
+         *
+         *  @param session [out] Some sort of session. Is ignored if session is nullptr, must live until on_complete is called.
+         **/
+        virtual void async_lookup_session(std::string const& id, session* session, lookup_callback on_complete) = 0;
+
+        /**
+         *  Creates a session and completes with its id.
+         **/
+        virtual void async_create_session(create_callback on_complete) = 0;
+
+        /**
+         *  Like session_storage_interface::set_session. The session is copied or serialized before the call returns.
+         *
+         *  @param on_complete May be empty.
+         **/
+        virtual void async_set_session(std::string const& id, session const& session, set_callback on_complete) = 0;
+
+        /**
+         *  @param on_complete May be empty.
+         **/
+        virtual void async_delete_session(std::string const& id, completion_callback on_complete) = 0;
+
+        virtual ~async_session_storage_interface() = default;
+    };
+
+    /**
+     *  Makes a synchronous session storage usable where an asynchronous one is expected.
+     *  Every call completes before it returns. Does not own the storage.
+     */
+    class sync_session_storage_adapter : public async_session_storage_interface
+    {
+    public:
+        explicit sync_session_storage_adapter(session_storage_interface& storage);
+
+        void async_lookup_session(std::string const& id, session* session, lookup_callback on_complete) override;
+        void async_create_session(create_callback on_complete) override;
+        void async_set_session(std::string const& id, session const& session, set_callback on_complete) override;
+        void async_delete_session(std::string const& id, completion_callback on_complete) override;
+
+    private:
+        session_storage_interface& storage_;
+    };
+}
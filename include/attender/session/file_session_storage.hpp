@@ -0,0 +1,95 @@
+#pragma once
+
+#include <attender/session/session_data.hpp>
+#include <attender/session/session_log.hpp>
+#include <attender/session/session_storage_interface.hpp>
+
+#include <string>
+#include <string_view>
+#include <utility>
+
+namespace attender
+{
+    /**
+     *  Keeps the sessions in a session_log on disk, so they survive a restart of the server.
+     *  SessionT derives from session and session_data, sessions are stored as what serialize returns.
+     *
+     *  Opening the storage reads the index of all sessions from the segment files in one pass,
+     *  the sessions themselves are only deserialized when they are requested.
+     */
+    template <typename IdGenerator, typename SessionT>
+    class file_session_storage : public session_storage_interface
+    {
+    public:
+        explicit file_session_storage(session_log_options options)
+            : log_{std::move(options)}
+        {
+        }
+
+        void clear() override
+        {
+            log_.clear();
+        }
+        uint64_t size() override
+        {
+            return log_.size();
+        }
+        std::string create_session() override
+        {
+            thread_local IdGenerator gen;
+            auto id = gen.generate_id();
+            SessionT created{id};
+            log_.put(id, created.serialize());
+            return id;
+        }
+        void delete_session(std::string const& id) override
+        {
+            log_.erase(id);
+        }
+        bool get_session(std::string const& id, session* session) override
+        {
+            if (session == nullptr)
+                return log_.contains(id);
+
+            // copied out, so that deserialize does not run under the lock of the log.
+            std::string data;
+            if (!log_.read(id, [&data](std::string_view stored){ data.assign(stored); }))
+                return false;
+
+            auto* restored = static_cast <SessionT*> (session);
+            restored->id(id);
+            restored->deserialize(data);
+            return true;
+        }
+        bool set_session(std::string const& id, session const& session) override
+        {
+            // serialize is not const in session_data, but does not change the session.
+            auto& stored = const_cast <SessionT&> (static_cast <SessionT const&> (session));
+            return log_.replace(id, stored.serialize());
+        }
+
+        /**
+         *  Compacts the log now, instead of waiting for the background compaction.
+         */
+        std::size_t compact()
+        {
+            return log_.compact();
+        }
+
+        /**
+         *  Writes the sessions to disk, see session_log::flush.
+         */
+        void flush()
+        {
+            log_.flush();
+        }
+
+        session_log& log()
+        {
+            return log_;
+        }
+
+    private:
+        session_log log_;
+    };
+}
@@ -2,60 +2,391 @@
 
 #include <attender/session/session_storage_interface.hpp>
 
-#include <unordered_map>
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <list>
+#include <map>
+#include <memory>
 #include <mutex>
+#include <shared_mutex>
+#include <stop_token>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <utility>
+#include <vector>
 
 namespace attender
 {
+    /**
+     *  Keeps the sessions in memory, split into shards by the hash of the id. Each shard has a shared mutex,
+     *  so lookups on any shard run in parallel and writers only block the lookups of their own shard.
+     *
+     *  Sessions are stored as immutable snapshots. find_session hands out the snapshot without copying the session,
+     *  set_session replaces it, and readers that still hold the old snapshot keep it alive until they are done.
+     *  Ids are generated outside of all locks, by an IdGenerator per thread.
+     *
+     *  With set_expiry, sessions expire and their number is limited:
+     *  Lookups of expired sessions report timed_out and remove them. A background thread removes the others,
+     *  in the order they expire and in small batches per shard, so requests are never blocked for long.
+     *  Lookups only mark sessions as used, the expiry index is corrected when the sweep finds a renewed session.
+     *  When max_sessions is reached, a session that was not used recently makes room (second chance, like
+     *  the CLOCK approximation of LRU). The limit is split evenly over the shards.
+     */
     template <typename IdGenerator, typename SessionT>
     class memory_session_storage : public session_storage_interface
     {
+        using clock = std::chrono::steady_clock;
+
     public:
+        constexpr static std::size_t default_shard_count = 64;
+
+        /**
+         *  @param shard_count The amount of shards, rounded up to a power of two.
+         */
+        explicit memory_session_storage(std::size_t shard_count = default_shard_count)
+            : shards_{new shard[std::bit_ceil(std::max <std::size_t> (shard_count, 1))]}
+            , shard_bits_{static_cast <unsigned> (std::countr_zero(std::bit_ceil(std::max <std::size_t> (shard_count, 1))))}
+            , expiry_{}
+            , expires_{false}
+            , shard_capacity_{0}
+            , sweeper_{}
+        {
+        }
+
         void clear() override
         {
-            std::lock_guard <std::mutex> guard{lock_};
-            sessions_.clear();
+            for (std::size_t i = 0; i != shard_count(); ++i)
+            {
+                std::unique_lock <std::shared_mutex> guard{shards_[i].protect};
+                shards_[i].sessions.clear();
+                shards_[i].order.clear();
+                shards_[i].expiries.clear();
+            }
         }
         uint64_t size() override
         {
-            std::lock_guard <std::mutex> guard{lock_};
-            return sessions_.size();
+            uint64_t count = 0;
+            for (std::size_t i = 0; i != shard_count(); ++i)
+            {
+                std::shared_lock <std::shared_mutex> guard{shards_[i].protect};
+                count += shards_[i].sessions.size();
+            }
+            return count;
         }
         std::string create_session() override
         {
-            std::lock_guard <std::mutex> guard{lock_};
-            auto id = gen_.generate_id();
-            sessions_[id] = SessionT{id};
+            thread_local IdGenerator gen;
+            auto id = gen.generate_id();
+            auto created = std::make_shared <SessionT const> (SessionT{id});
+            auto now = clock::now();
+
+            auto& owner = shard_of(id);
+            std::unique_lock <std::shared_mutex> guard{owner.protect};
+            while (shard_capacity_ != 0 && owner.sessions.size() >= shard_capacity_)
+                evict_least_recently_used(owner);
+
+            auto [iter, inserted] = owner.sessions.try_emplace(id);
+            auto& stored = iter->second;
+            stored.snapshot = std::move(created);
+            stored.created = now;
+            stored.last_access.store(now.time_since_epoch().count(), std::memory_order_relaxed);
+            if (inserted)
+                stored.order = owner.order.insert(owner.order.end(), &iter->first);
+            if (expires_)
+                owner.expiries.emplace(deadline(stored), id);
             return id;
         }
         void delete_session(std::string const& id) override
         {
-            std::lock_guard <std::mutex> guard{lock_};
-            sessions_.erase(id);
+            auto& owner = shard_of(id);
+            std::unique_lock <std::shared_mutex> guard{owner.protect};
+            auto iter = owner.sessions.find(id);
+            if (iter != std::end(owner.sessions))
+                erase(owner, iter);
         }
         bool get_session(std::string const& id, session* session) override
         {
-            std::lock_guard <std::mutex> guard{lock_};
-            auto iter = sessions_.find(id);
-            if (iter == std::end(sessions_))
-                return false;
-            if (session != nullptr)
-                *static_cast <SessionT*> (session) = iter->second;
-            return true;
+            return lookup_session(id, session) == session_state::live;
+        }
+        session_state lookup_session(std::string const& id, session* session) override
+        {
+            auto [state, snapshot] = acquire(id);
+            if (snapshot && session != nullptr)
+                *static_cast <SessionT*> (session) = *snapshot;
+            return state;
         }
         bool set_session(std::string const& id, session const& session) override
         {
-            std::lock_guard <std::mutex> guard{lock_};
-            auto iter = sessions_.find(id);
-            if (iter == std::end(sessions_))
+            auto replacement = std::make_shared <SessionT const> (static_cast <SessionT const&> (session));
+            auto now = clock::now();
+
+            auto& owner = shard_of(id);
+            std::unique_lock <std::shared_mutex> guard{owner.protect};
+            auto iter = owner.sessions.find(id);
+            if (iter == std::end(owner.sessions))
+                return false;
+            if (expired(iter->second, now))
+            {
+                erase(owner, iter);
                 return false;
-            iter->second = session;
+            }
+            iter->second.snapshot.swap(replacement);
+            touch(iter->second, now);
             return true;
         }
 
+        /**
+         *  Sessions that exist already expire from now on as well.
+         *  Can be called while the storage is in use, it waits for all shards.
+         */
+        void set_expiry(session_expiry const& expiry) override
+        {
+            if (sweeper_.joinable())
+            {
+                sweeper_.request_stop();
+                sweeper_.join();
+            }
+
+            // the settings are only read under a shard lock, so all of them are held while they change.
+            std::vector <std::unique_lock <std::shared_mutex>> guards;
+            guards.reserve(shard_count());
+            for (std::size_t i = 0; i != shard_count(); ++i)
+                guards.emplace_back(shards_[i].protect);
+
+            expiry_ = expiry;
+            expires_ = expiry.absolute.count() > 0 || expiry.idle.count() > 0;
+            shard_capacity_ = expiry.max_sessions == 0 ? 0 : (expiry.max_sessions + shard_count() - 1) / shard_count();
+
+            for (std::size_t i = 0; i != shard_count(); ++i)
+            {
+                auto& owner = shards_[i];
+                owner.expiries.clear();
+                if (expires_)
+                {
+                    for (auto const& [id, stored] : owner.sessions)
+                        owner.expiries.emplace(deadline(stored), id);
+                }
+            }
+            guards.clear();
+
+            if (expires_ && expiry.sweep_interval.count() > 0)
+                sweeper_ = std::jthread{[this](std::stop_token stop){ run_sweeper(stop); }};
+        }
+
+        /**
+         *  Returns the current snapshot of the session without copying it.
+         *  The snapshot does not change, a later set_session stores a new one.
+         *
+         *  @return nullptr if there is no session with this id or it expired.
+         */
+        std::shared_ptr <SessionT const> find_session(std::string const& id)
+        {
+            return acquire(id).second;
+        }
+
+        /**
+         *  Removes the expired sessions of all shards, sweep_batch at a time per shard.
+         *  Called by the background thread, but can also be called directly.
+         *
+         *  @return The amount of removed sessions.
+         */
+        std::size_t sweep()
+        {
+            std::size_t removed = 0;
+            for (std::size_t i = 0; i != shard_count(); ++i)
+            {
+                auto& owner = shards_[i];
+                for (;;)
+                {
+                    std::unique_lock <std::shared_mutex> guard{owner.protect};
+                    if (sweep_batch(owner, clock::now(), removed) < std::max <std::size_t> (expiry_.sweep_batch, 1))
+                        break;
+                }
+            }
+            return removed;
+        }
+
+        std::size_t shard_count() const noexcept
+        {
+            return std::size_t{1} << shard_bits_;
+        }
+
     private:
-        std::unordered_map <std::string, SessionT> sessions_;
-        IdGenerator gen_;
-        std::mutex lock_;
+        struct entry
+        {
+            std::shared_ptr <SessionT const> snapshot;
+            clock::time_point created;
+
+            // written by lookups that only hold the shared lock.
+            std::atomic <clock::rep> last_access;
+            std::atomic_bool referenced;
+
+            // position in shard::order
+            typename std::list <std::string const*>::iterator order;
+        };
+
+        // on a cache line of its own, so that the mutexes of neighbouring shards do not contend.
+        struct alignas(64) shard
+        {
+            mutable std::shared_mutex protect;
+            std::unordered_map <std::string, entry> sessions;
+
+            // the keys of sessions, in the order the clock hand passes them for eviction.
+            std::list <std::string const*> order;
+
+            // the ids ordered by when they expire. Renewals are not reflected until the sweep gets to them.
+            std::multimap <clock::time_point, std::string> expiries;
+        };
+
+        shard& shard_of(std::string const& id) const
+        {
+            // the shard takes the high bits of the mixed hash, the map of the shard uses the hash as it is.
+            auto hash = static_cast <std::uint64_t> (std::hash <std::string>{}(id)) * 0x9E3779B97F4A7C15ull;
+            return shards_[shard_bits_ == 0 ? 0 : hash >> (64 - shard_bits_)];
+        }
+
+        std::pair <session_state, std::shared_ptr <SessionT const>> acquire(std::string const& id)
+        {
+            auto now = clock::now();
+            auto& owner = shard_of(id);
+            {
+                std::shared_lock <std::shared_mutex> guard{owner.protect};
+                auto iter = owner.sessions.find(id);
+                if (iter == std::end(owner.sessions))
+                    return {session_state::not_found, nullptr};
+                if (!expired(iter->second, now))
+                {
+                    touch(iter->second, now);
+                    return {session_state::live, iter->second.snapshot};
+                }
+            }
+
+            // removed right away, instead of waiting for the sweep.
+            std::unique_lock <std::shared_mutex> guard{owner.protect};
+            auto iter = owner.sessions.find(id);
+            if (iter != std::end(owner.sessions) && expired(iter->second, now))
+                erase(owner, iter);
+            return {session_state::timed_out, nullptr};
+        }
+
+        /**
+         *  Marks the session as used, under the shared lock.
+         */
+        void touch(entry& stored, clock::time_point now) const
+        {
+            if (expiry_.idle.count() > 0)
+                stored.last_access.store(now.time_since_epoch().count(), std::memory_order_relaxed);
+            if (shard_capacity_ != 0 && !stored.referenced.load(std::memory_order_relaxed))
+                stored.referenced.store(true, std::memory_order_relaxed);
+        }
+
+        clock::time_point deadline(entry const& stored) const
+        {
+            auto due = clock::time_point::max();
+            if (expiry_.absolute.count() > 0)
+                due = std::min(due, stored.created + expiry_.absolute);
+            if (expiry_.idle.count() > 0)
+            {
+                auto last_access = clock::time_point{clock::duration{stored.last_access.load(std::memory_order_relaxed)}};
+                due = std::min(due, last_access + expiry_.idle);
+            }
+            return due;
+        }
+
+        bool expired(entry const& stored, clock::time_point now) const
+        {
+            return expires_ && deadline(stored) <= now;
+        }
+
+        /**
+         *  Under the unique lock. The entry in expiries is left, the sweep drops it.
+         */
+        void erase(shard& owner, typename std::unordered_map <std::string, entry>::iterator iter)
+        {
+            owner.order.erase(iter->second.order);
+            owner.sessions.erase(iter);
+        }
+
+        /**
+         *  Passes the clock hand over the sessions of the shard. Used sessions get a second chance and go
+         *  to the back, the first one that was not used since the hand passed it last is removed.
+         *  Under the unique lock.
+         */
+        void evict_least_recently_used(shard& owner)
+        {
+            while (!owner.order.empty())
+            {
+                auto iter = owner.sessions.find(*owner.order.front());
+                if (iter->second.referenced.exchange(false, std::memory_order_relaxed))
+                {
+                    owner.order.splice(owner.order.end(), owner.order, owner.order.begin());
+                    continue;
+                }
+                return erase(owner, iter);
+            }
+        }
+
+        /**
+         *  Removes up to sweep_batch expired sessions of the shard. Under the unique lock.
+         *
+         *  @return The amount of visited entries of the expiry index.
+         */
+        std::size_t sweep_batch(shard& owner, clock::time_point now, std::size_t& removed)
+        {
+            std::size_t visited = 0;
+            if (!expires_)
+                return visited;
+
+            auto const batch = std::max <std::size_t> (expiry_.sweep_batch, 1);
+            while (!owner.expiries.empty() && visited != batch && owner.expiries.begin()->first <= now)
+            {
+                ++visited;
+                auto node = owner.expiries.extract(owner.expiries.begin());
+                auto iter = owner.sessions.find(node.mapped());
+                if (iter == std::end(owner.sessions))
+                    continue;
+
+                auto due = deadline(iter->second);
+                if (due <= now)
+                {
+                    erase(owner, iter);
+                    ++removed;
+                    continue;
+                }
+
+                // renewed since it was indexed.
+                node.key() = due;
+                owner.expiries.insert(std::move(node));
+            }
+            return visited;
+        }
+
+        void run_sweeper(std::stop_token stop)
+        {
+            std::mutex protect;
+            std::condition_variable_any wake;
+            std::unique_lock <std::mutex> lock{protect};
+            while (!wake.wait_for(lock, stop, expiry_.sweep_interval, []{ return false; }) && !stop.stop_requested())
+                sweep();
+        }
+
+    private:
+        std::unique_ptr <shard[]> shards_;
+        unsigned shard_bits_;
+
+        // written by set_expiry while it holds the locks of all shards, read under the lock of one.
+        session_expiry expiry_;
+        bool expires_;
+        std::size_t shard_capacity_;
+
+        // last, it is joined before the shards go away.
+        std::jthread sweeper_;
     };
 }
@@ -2,6 +2,8 @@
 
 #include <attender/session/session_storage_interface.hpp>
 #include <attender/session/authorizer_interface.hpp>
+#include <attender/session/async_session_storage_interface.hpp>
+#include <attender/session/async_authorizer_interface.hpp>
 
 #include <attender/http/http_fwd.hpp>
 #include <attender/http/cookie.hpp>
@@ -22,12 +24,16 @@ namespace attender
         std::function <void(request_handler*, response_handler*)> authorization_conditioner = {};
         bool disable_automatic_authentication = false;
         std::string authentication_path; // used if disable_automatic_authentication is true.
+
+        // used instead of session_storage and authorizer if set, so that the io threads do not wait for them.
+        std::unique_ptr <async_session_storage_interface> async_session_storage = {};
+        std::unique_ptr <async_authorizer_interface> async_authorizer = {};
     };
 
     struct SessionControl
     {
         std::shared_ptr <session_manager> sessions;
-        std::shared_ptr <authorizer_interface> authorizer;
+        std::shared_ptr <async_authorizer_interface> authorizer;
         std::function <void(request_handler*, response_handler*)> authorization_conditioner;
         std::string id_cookie_key;
         bool allowOptionsUnauthorized;
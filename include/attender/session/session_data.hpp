@@ -1,5 +1,7 @@
 #pragma once
 
+#include <string>
+
 namespace attender
 {
     class session_data
@@ -0,0 +1,171 @@
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <shared_mutex>
+#include <stop_token>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <unordered_map>
+
+namespace attender
+{
+    struct session_log_options
+    {
+        /** The directory of the segment files. Created if it does not exist. **/
+        std::string directory;
+
+        /** The size of a segment file. A record that does not fit gets a segment of its own size. **/
+        std::size_t segment_size = 64 * 1024 * 1024;
+
+        /** A full segment is compacted when more than this share of it is garbage. **/
+        double compaction_threshold = 0.5;
+
+        /** How often segments are compacted in the background. 0 compacts only on compact(). **/
+        std::chrono::milliseconds compaction_interval = std::chrono::seconds{30};
+    };
+
+    /**
+     *  A persistent map from session id to serialized session, the storage behind file_session_storage.
+     *
+     *  Records are appended to memory mapped segment files and never changed. An in-memory hash index points
+     *  to the latest record of every id, replaced and deleted ones are garbage, and so are the tombstones of deletions.
+     *  Opening the log rebuilds the index in one pass over the segments, a record that was torn by a crash ends
+     *  the scan of its segment. Full segments with much garbage are compacted in the background: their live records
+     *  are appended again and the segment file is deleted. Tombstones are only appended again while an older segment
+     *  may still hold a record of the deleted id.
+     *
+     *  Data is in the page cache as soon as a call returns, so it survives a restart of the process.
+     *  Call flush to survive a crash of the machine. Only one process may open a directory at a time,
+     *  it holds a lock on the file "sessions.lock" in the directory.
+     *  Thread safe, reads only take a shared lock.
+     */
+    class session_log
+    {
+    public:
+        /**
+         *  @throws std::runtime_error if another process has the directory open.
+         */
+        explicit session_log(session_log_options options);
+        ~session_log();
+
+        session_log(session_log const&) = delete;
+        session_log& operator=(session_log const&) = delete;
+
+        /**
+         *  Inserts or replaces the record of the id.
+         */
+        void put(std::string_view id, std::string_view data);
+
+        /**
+         *  Replaces the record of the id.
+         *
+         *  @return false if there is no record with this id.
+         */
+        bool replace(std::string_view id, std::string_view data);
+
+        /**
+         *  Removes the record of the id.
+         */
+        void erase(std::string_view id);
+
+        /**
+         *  Calls reader with the data of the id. The data is only valid during the call, which holds a shared lock.
+         *
+         *  @return false if there is no record with this id.
+         */
+        bool read(std::string const& id, std::function <void(std::string_view)> const& reader) const;
+
+        bool contains(std::string const& id) const;
+
+        /**
+         *  The amount of ids.
+         */
+        std::size_t size() const;
+
+        /**
+         *  Removes all records and segment files.
+         */
+        void clear();
+
+        /**
+         *  Compacts every full segment whose share of garbage is above the threshold.
+         *
+         *  @return The amount of removed segment files.
+         */
+        std::size_t compact();
+
+        /**
+         *  Writes the mapped segments to disk.
+         */
+        void flush();
+
+        /**
+         *  The amount of segment files.
+         */
+        std::size_t segment_count() const;
+
+    private:
+        struct segment;
+        struct directory_lock;
+
+        struct deletion
+        {
+            // the oldest segment that may still hold a record of the deleted id.
+            std::uint32_t oldest;
+
+            // the segment of the latest tombstone.
+            std::uint32_t tombstone;
+        };
+
+        struct location
+        {
+            segment* owner;
+            std::uint32_t offset;
+            std::uint32_t size;
+
+            // the oldest segment that may still hold a replaced record of the id.
+            std::uint32_t oldest;
+        };
+
+        void open_segments();
+        segment& add_segment(std::uint32_t number, std::size_t size);
+        location append(std::string_view id, std::string_view data, bool tombstone);
+        void retire(location const& where);
+        void index_record(std::string_view id, location where);
+        void index_tombstone(std::string_view id, location const& where);
+        void compact_segment(segment& compacted);
+        void run_compaction(std::stop_token stop);
+
+    private:
+        session_log_options options_;
+
+        // released last, after the segments were written.
+        std::unique_ptr <directory_lock> lock_;
+
+        // guards the index and the segment list against readers.
+        mutable std::shared_mutex protect_;
+
+        // serializes appends and the index updates that follow them.
+        std::mutex write_protect_;
+
+        // serializes compaction and clear.
+        std::mutex compact_protect_;
+
+        std::unordered_map <std::string, location> index_;
+
+        // deleted ids whose tombstone may still be needed. Only used under the write lock.
+        std::unordered_map <std::string, deletion> tombstones_;
+        std::map <std::uint32_t, std::unique_ptr <segment>> segments_;
+        segment* active_;
+
+        // last, it is joined before the segments go away.
+        std::jthread compactor_;
+    };
+}
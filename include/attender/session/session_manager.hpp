@@ -1,26 +1,25 @@
 #pragma once
 
 #include <attender/session/session_storage_interface.hpp>
+#include <attender/session/async_session_storage_interface.hpp>
 #include <attender/http/request.hpp>
 
 #include <memory>
 #include <boost/optional.hpp>
 #include <string>
+#include <utility>
 
 namespace attender
 {
-    enum class session_state
-    {
-        live,
-        not_found,
-        no_session,
-        timed_out
-    };
-
+    /**
+     *  Owns the session storage. A synchronous storage can be used with both the synchronous and the async_ functions.
+     *  An asynchronous storage only with the async_ functions, the others throw std::logic_error.
+     */
     class session_manager
     {
     public:
         session_manager(std::unique_ptr <session_storage_interface> session_storage);
+        session_manager(std::unique_ptr <async_session_storage_interface> session_storage);
 
         template <typename SessionT>
         session_state load_session(std::string const& session_cookie_name, SessionT* session, request_handler* req)
@@ -29,38 +28,30 @@ namespace attender
             if (!opt)
                 return session_state::no_session;
             else
-            {
-                auto sessionFound = session_storage_->get_session(opt.get(), session);
-                if (!sessionFound)
-                    return session_state::not_found;
-                return session_state::live;
-            }
+                return sync_storage().lookup_session(opt.get(), session);
         }
 
         template <typename SessionT>
         session_state load_session(std::string const& id, SessionT* session)
         {
-            auto sessionFound = session_storage_->get_session(id, session);
-            if (!sessionFound)
-                return session_state::not_found;
-            return session_state::live;
+            return sync_storage().lookup_session(id, session);
         }
 
         template <typename SessionT>
         SessionT make_session()
         {
-            return SessionT{session_storage_->create_session()};
+            return SessionT{sync_storage().create_session()};
         }
 
         std::string make_session()
         {
-            return session_storage_->create_session();
+            return sync_storage().create_session();
         }
 
         template <typename SessionT>
         void save_session(SessionT const& session)
         {
-            session_storage_->set_session(session.id(), session);
+            sync_storage().set_session(session.id(), session);
         }
 
         template <typename SessionT>
@@ -73,26 +64,72 @@ namespace attender
         template <typename SessionT>
         void terminate_session(SessionT const& session)
         {
-            session_storage_->delete_session(session.id());
+            sync_storage().delete_session(session.id());
         }
 
         template <typename SessionT>
         void terminate_session(boost::optional <SessionT> const& session)
         {
             if (session)
-                session_storage_->delete_session(session.get().id());
+                sync_storage().delete_session(session.get().id());
+        }
+
+        /**
+         *  Like load_session, but completes with the state when the storage answers.
+         *  session must live until then.
+         */
+        template <typename SessionT>
+        void async_load_session(std::string const& session_cookie_name, SessionT* session, request_handler* req, async_session_storage_interface::lookup_callback on_complete)
+        {
+            auto opt = req->get_cookie_value(session_cookie_name);
+            if (!opt)
+                return on_complete({}, session_state::no_session);
+            async_storage_->async_lookup_session(opt.get(), session, std::move(on_complete));
+        }
+
+        template <typename SessionT>
+        void async_load_session(std::string const& id, SessionT* session, async_session_storage_interface::lookup_callback on_complete)
+        {
+            async_storage_->async_lookup_session(id, session, std::move(on_complete));
+        }
+
+        void async_make_session(async_session_storage_interface::create_callback on_complete)
+        {
+            async_storage_->async_create_session(std::move(on_complete));
+        }
+
+        template <typename SessionT>
+        void async_save_session(SessionT const& session, async_session_storage_interface::set_callback on_complete = {})
+        {
+            async_storage_->async_set_session(session.id(), session, std::move(on_complete));
+        }
+
+        template <typename SessionT>
+        void async_terminate_session(SessionT const& session, async_session_storage_interface::completion_callback on_complete = {})
+        {
+            async_storage_->async_delete_session(session.id(), std::move(on_complete));
         }
 
+        /**
+         *  Returns true if the storage is synchronous, so that the functions without async_ can be used.
+         */
+        bool is_synchronous() const;
+
         template <typename SessionStorageT>
         SessionStorageT* get_storage()
         {
-            auto* ptr = session_storage_.get();
-            if (ptr == nullptr)
-                return nullptr;
-            return dynamic_cast <SessionStorageT*> (ptr);
+            if (session_storage_)
+                return dynamic_cast <SessionStorageT*> (session_storage_.get());
+            return dynamic_cast <SessionStorageT*> (async_storage_.get());
         }
 
+    private:
+        session_storage_interface& sync_storage();
+
     private:
         std::unique_ptr <session_storage_interface> session_storage_;
+
+        // adapts session_storage_, if it is set.
+        std::unique_ptr <async_session_storage_interface> async_storage_;
     };
 }
@@ -2,11 +2,39 @@
 
 #include <attender/session/session.hpp>
 
+#include <chrono>
+#include <cstddef>
 #include <string>
 #include <cstdint>
 
 namespace attender
 {
+    enum class session_state
+    {
+        live,
+        not_found,
+        no_session,
+        timed_out
+    };
+
+    struct session_expiry
+    {
+        /** Sessions end this long after they were created, no matter how active they are. 0 = never. **/
+        std::chrono::milliseconds absolute = std::chrono::milliseconds{0};
+
+        /** Sessions end after this long without being accessed, every access renews them. 0 = never. **/
+        std::chrono::milliseconds idle = std::chrono::milliseconds{0};
+
+        /** The most sessions kept, the least recently used ones make room for new ones. 0 = unlimited. **/
+        std::size_t max_sessions = 0;
+
+        /** How often expired sessions are removed in the background. 0 leaves them to lookups and sweep calls. **/
+        std::chrono::milliseconds sweep_interval = std::chrono::seconds{1};
+
+        /** The most sessions removed at once, before the lock is released for requests. **/
+        std::size_t sweep_batch = 256;
+    };
+
     class session_storage_interface
     {
     public:
@@ -53,6 +81,27 @@ namespace attender
          **/
         virtual bool set_session(std::string const& id, session const& session) = 0;
 
+        /**
+         *  Like get_session, but tells sessions that expired apart from unknown ones.
+         *  The default implementation cannot and reports them as not_found.
+         *
+         *  @param id The session id.
+         *  @param session [out] Some sort of session. Is ignored if session is nullptr
+         *  @return live, not_found or timed_out.
+         **/
+        virtual session_state lookup_session(std::string const& id, session* session)
+        {
+            return get_session(id, session) ? session_state::live : session_state::not_found;
+        }
+
+        /**
+         *  Sets when sessions expire and how many are kept. Storages that do not support it ignore it.
+         *  Meant to be called once, before the storage is used.
+         **/
+        virtual void set_expiry(session_expiry const&)
+        {
+        }
+
         virtual ~session_storage_interface() = default;
     };
 }
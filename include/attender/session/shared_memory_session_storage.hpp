@@ -0,0 +1,127 @@
+#pragma once
+
+#include <attender/session/session_data.hpp>
+#include <attender/session/session_storage_interface.hpp>
+#include <attender/session/shared_session_table.hpp>
+
+#include <condition_variable>
+#include <mutex>
+#include <stop_token>
+#include <string>
+#include <thread>
+
+namespace attender
+{
+    /**
+     *  Keeps the sessions in a shared_session_table, so that all server processes on a host that use the same
+     *  name share them. A login in one process is seen by the others, no sticky sessions are needed.
+     *  SessionT derives from session and session_data, sessions are stored as what serialize returns.
+     *
+     *  Expiry is supported by absolute and idle, max_sessions is ignored: the table has a fixed amount of slots.
+     *  Every process sweeps in the background, which is harmless, they take turns on the stripe locks.
+     */
+    template <typename IdGenerator, typename SessionT>
+    class shared_memory_session_storage : public session_storage_interface
+    {
+    public:
+        explicit shared_memory_session_storage(shared_session_options const& options)
+            : table_{options}
+            , sweep_interval_{0}
+            , sweeper_{}
+        {
+        }
+
+        void clear() override
+        {
+            table_.clear();
+        }
+        uint64_t size() override
+        {
+            return table_.size();
+        }
+        std::string create_session() override
+        {
+            thread_local IdGenerator gen;
+            for (;;)
+            {
+                auto id = gen.generate_id();
+                SessionT created{id};
+                if (table_.insert(id, created.serialize()))
+                    return id;
+            }
+        }
+        void delete_session(std::string const& id) override
+        {
+            table_.erase(id);
+        }
+        bool get_session(std::string const& id, session* session) override
+        {
+            return lookup_session(id, session) == session_state::live;
+        }
+        session_state lookup_session(std::string const& id, session* session) override
+        {
+            if (session == nullptr)
+                return table_.read(id, nullptr);
+
+            // deserialized outside of the stripe lock.
+            std::string data;
+            auto state = table_.read(id, &data);
+            if (state == session_state::live)
+            {
+                auto* restored = static_cast <SessionT*> (session);
+                restored->id(id);
+                restored->deserialize(data);
+            }
+            return state;
+        }
+        bool set_session(std::string const& id, session const& session) override
+        {
+            // serialize is not const in session_data, but does not change the session.
+            auto& stored = const_cast <SessionT&> (static_cast <SessionT const&> (session));
+            return table_.replace(id, stored.serialize());
+        }
+        void set_expiry(session_expiry const& expiry) override
+        {
+            if (sweeper_.joinable())
+            {
+                sweeper_.request_stop();
+                sweeper_.join();
+            }
+
+            table_.set_expiry(expiry.absolute, expiry.idle);
+            sweep_interval_ = expiry.sweep_interval;
+            if ((expiry.absolute.count() > 0 || expiry.idle.count() > 0) && sweep_interval_.count() > 0)
+                sweeper_ = std::jthread{[this](std::stop_token stop){ run_sweeper(stop); }};
+        }
+
+        /**
+         *  Removes the expired sessions, see shared_session_table::sweep.
+         */
+        std::size_t sweep()
+        {
+            return table_.sweep();
+        }
+
+        shared_session_table& table()
+        {
+            return table_;
+        }
+
+    private:
+        void run_sweeper(std::stop_token stop)
+        {
+            std::mutex protect;
+            std::condition_variable_any wake;
+            std::unique_lock <std::mutex> lock{protect};
+            while (!wake.wait_for(lock, stop, sweep_interval_, []{ return false; }) && !stop.stop_requested())
+                sweep();
+        }
+
+    private:
+        shared_session_table table_;
+        std::chrono::milliseconds sweep_interval_;
+
+        // last, it is joined before the table goes away.
+        std::jthread sweeper_;
+    };
+}
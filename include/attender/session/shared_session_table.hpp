@@ -0,0 +1,166 @@
+#pragma once
+
+#include <attender/session/session_storage_interface.hpp>
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <string_view>
+
+namespace attender
+{
+    struct shared_session_options
+    {
+        /** The name of the shared memory object. Processes that use the same name share the sessions. **/
+        std::string name;
+
+        /** The amount of slots, rounded up to a power of two. One session takes one slot. **/
+        std::size_t slot_count = 64 * 1024;
+
+        /** The amount of locks, rounded up to a power of two. Each lock guards an equal part of the slots. **/
+        std::size_t stripe_count = 256;
+
+        /** The longest session id. **/
+        std::size_t id_capacity = 64;
+
+        /** Serialized sessions up to this size are kept in their slot, the rest goes to overflow blocks. **/
+        std::size_t data_capacity = 192;
+
+        /** The size of an overflow block, including its link to the next block. **/
+        std::size_t overflow_block_size = 256;
+
+        /** The memory for overflow blocks. **/
+        std::size_t overflow_size = 16 * 1024 * 1024;
+    };
+
+    /**
+     *  A hash table from session id to serialized session in shared memory, the storage behind
+     *  shared_memory_session_storage. Every process that opens the same name sees the same sessions.
+     *
+     *  The slots have a fixed size and are split into stripes, each with a process shared mutex in the shared
+     *  memory. An id hashes to a stripe and a home slot in it, collisions are resolved by linear probing inside
+     *  the stripe, and deletes shift the following slots back, so there are no tombstones.
+     *  Data that does not fit into the slot is continued in a chain of overflow blocks, taken from a lock free
+     *  free list that all stripes share.
+     *
+     *  The first process creates and initializes the shared memory, later ones must use the same layout.
+     *  The shared memory outlives the processes, until remove is called. The table does not grow,
+     *  a full stripe or running out of overflow blocks throws std::length_error.
+     *  The mutexes are robust. If a process dies while it holds one, the next process that locks it drops
+     *  the sessions of that stripe, and their overflow blocks stay lost until the shared memory is removed.
+     */
+    class shared_session_table
+    {
+    public:
+        explicit shared_session_table(shared_session_options const& options);
+        ~shared_session_table();
+
+        shared_session_table(shared_session_table const&) = delete;
+        shared_session_table& operator=(shared_session_table const&) = delete;
+
+        /**
+         *  @return false if the id exists already.
+         */
+        bool insert(std::string_view id, std::string_view data);
+
+        /**
+         *  @return false if there is no live record with this id.
+         */
+        bool replace(std::string_view id, std::string_view data);
+
+        void erase(std::string_view id);
+
+        /**
+         *  Copies the data of the id, if data is not nullptr, and marks it as used.
+         *  Expired records are removed.
+         *
+         *  @return live, not_found or timed_out.
+         */
+        session_state read(std::string_view id, std::string* data);
+
+        /**
+         *  Records expire this long after they were inserted or used. 0 = never.
+         *  Only applies to this process, every process should set the same. May be changed while requests are served.
+         */
+        void set_expiry(std::chrono::milliseconds absolute, std::chrono::milliseconds idle);
+
+        /**
+         *  Removes the expired records, one stripe at a time.
+         *
+         *  @return The amount of removed records.
+         */
+        std::size_t sweep();
+
+        std::size_t size() const;
+
+        void clear();
+
+        /**
+         *  The amount of slots.
+         */
+        std::size_t capacity() const;
+
+        /**
+         *  Removes the shared memory object. Processes that have it open keep using it.
+         */
+        static bool remove(std::string const& name);
+
+    private:
+        struct mapping;
+        struct header;
+        struct stripe;
+        struct slot;
+
+        class stripe_guard;
+
+        void initialize();
+        void validate() const;
+
+        stripe& stripe_at(std::size_t index) const;
+        slot& slot_at(std::size_t index) const;
+        char* block_at(std::uint32_t index) const;
+
+        /**
+         *  The index of the slot with this id in the stripe, or -1.
+         */
+        std::ptrdiff_t find(std::size_t stripe_index, std::uint64_t hash, std::string_view id) const;
+
+        bool expired(slot const& record, std::int64_t now) const;
+
+        std::uint32_t store(std::string_view data);
+        void load(slot const& record, std::string& data) const;
+        void release(std::uint32_t block);
+        void erase_at(std::size_t stripe_index, std::size_t position);
+
+        /**
+         *  Empties a stripe whose lock was held by a process that died, its records may be half written.
+         */
+        void repair(std::size_t stripe_index) const;
+
+        std::uint32_t pop_block();
+        void push_block(std::uint32_t block);
+
+    private:
+        std::unique_ptr <mapping> mapping_;
+        header* header_;
+        char* stripes_;
+        char* slots_;
+        char* blocks_;
+
+        std::size_t slot_count_;
+        std::size_t stripe_count_;
+        unsigned stripe_bits_;
+        std::size_t slot_size_;
+        std::size_t id_capacity_;
+        std::size_t data_capacity_;
+        std::size_t block_size_;
+        std::size_t block_count_;
+
+        // set_expiry may run while requests are served.
+        std::atomic <std::int64_t> absolute_;
+        std::atomic <std::int64_t> idle_;
+    };
+}
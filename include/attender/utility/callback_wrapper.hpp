@@ -1,5 +1,8 @@
 #pragma once
 
+#include <boost/system/error_code.hpp>
+
+#include <coroutine>
 #include <functional>
 #include <atomic>
 
@@ -7,6 +10,7 @@ namespace attender
 {
     /**
      *  The callback wrapper provides javascript promise like .then().except() syntax.
+     *  It can also be co_awaited from coroutine handlers, which yields the error code (empty on success).
      */
     class callback_wrapper
     {
@@ -16,6 +20,7 @@ namespace attender
             , fail_{}
             , fullfilled_{false}
             , error_{false}
+            , resumed_{false}
         {
         }
 
@@ -102,12 +107,62 @@ namespace attender
             error_.store(true);
         }
 
+        /**
+         *  Awaiter used when the wrapper is co_awaited. co_await yields the error code (empty on success).
+         */
+        class awaiter
+        {
+        public:
+            explicit awaiter(callback_wrapper* wrapper) noexcept
+                : wrapper_{wrapper}
+            {
+            }
+
+            bool await_ready() const noexcept
+            {
+                return wrapper_->fullfilled_.load() || wrapper_->error_.load();
+            }
+
+            bool await_suspend(std::coroutine_handle <> handle)
+            {
+                auto* wrapper = wrapper_;
+                wrapper->func_ = [wrapper, handle]{
+                    if (!wrapper->resumed_.exchange(true))
+                        handle.resume();
+                };
+                wrapper->fail_ = [wrapper, handle](boost::system::error_code const& ec) {
+                    wrapper->last_ec_.store(ec);
+                    if (!wrapper->resumed_.exchange(true))
+                        handle.resume();
+                };
+
+                // completed while the continuation was installed, whoever claims the resumption continues.
+                if (await_ready())
+                    return wrapper->resumed_.exchange(true);
+                return true;
+            }
+
+            boost::system::error_code await_resume() const noexcept
+            {
+                return wrapper_->last_ec_.load();
+            }
+
+        private:
+            callback_wrapper* wrapper_;
+        };
+
+        awaiter operator co_await() noexcept
+        {
+            return awaiter{this};
+        }
+
         void reset()
         {
             func_ = {};
             fail_ = {};
             fullfilled_.store(false);
             error_.store(false);
+            resumed_.store(false);
             last_ec_.store(boost::system::error_code{});
         }
 
@@ -116,6 +171,7 @@ namespace attender
         std::function <void(boost::system::error_code)> fail_;
         std::atomic_bool fullfilled_;
         std::atomic_bool error_;
+        std::atomic_bool resumed_;
         std::atomic <boost::system::error_code> last_ec_;
     };
 }
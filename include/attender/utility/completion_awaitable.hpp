@@ -0,0 +1,60 @@
+#pragma once
+
+#include <boost/system/error_code.hpp>
+
+#include <atomic>
+#include <coroutine>
+#include <functional>
+#include <utility>
+
+namespace attender
+{
+    /**
+     *  Adapts a callback based asynchronous operation to co_await.
+     *  The initiator is invoked with a completion function that takes an error code,
+     *  co_await yields that error code.
+     *
+     *  The completion function only captures this awaitable and the coroutine handle, so it fits into the
+     *  small buffer of std::function and does not allocate.
+     *
+     *  The operation may complete before the initiator returns, then the coroutine continues without
+     *  suspending instead of being resumed from within the initiator.
+     */
+    template <typename InitiatorT>
+    class completion_awaitable
+    {
+    public:
+        explicit completion_awaitable(InitiatorT initiator)
+            : initiator_{std::move(initiator)}
+            , ec_{}
+            , completed_{false}
+        {
+        }
+
+        bool await_ready() const noexcept
+        {
+            return false;
+        }
+
+        bool await_suspend(std::coroutine_handle <> handle)
+        {
+            initiator_([this, handle](boost::system::error_code ec) {
+                ec_ = ec;
+                // resumes only when await_suspend has already returned and the coroutine is suspended.
+                if (completed_.exchange(true, std::memory_order_acq_rel))
+                    handle.resume();
+            });
+            return !completed_.exchange(true, std::memory_order_acq_rel);
+        }
+
+        boost::system::error_code await_resume() const noexcept
+        {
+            return ec_;
+        }
+
+    private:
+        InitiatorT initiator_;
+        boost::system::error_code ec_;
+        std::atomic_bool completed_;
+    };
+}
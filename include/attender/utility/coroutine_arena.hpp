@@ -0,0 +1,54 @@
+#pragma once
+
+#include <attender/net_core.hpp>
+
+#include <cstddef>
+
+namespace attender
+{
+    /**
+     *  A small bump allocator that lives inside every connection and hosts the coroutine frames of
+     *  coroutine route handlers. Frames are released in reverse order of allocation, so the arena
+     *  only has to track its top. Requests that do not fit are served from the heap.
+     */
+    class coroutine_arena
+    {
+    public:
+        coroutine_arena() noexcept;
+
+        coroutine_arena(coroutine_arena const&) = delete;
+        coroutine_arena& operator=(coroutine_arena const&) = delete;
+
+        /**
+         *  Allocates size bytes from the arena.
+         *
+         *  @return A pointer aligned to std::max_align_t or nullptr if the arena is exhausted.
+         */
+        void* allocate(std::size_t size) noexcept;
+
+        /**
+         *  Releases memory previously obtained from allocate.
+         *  Releasing anything but the most recent allocation only marks it free and the space is reclaimed
+         *  when everything above it was released too.
+         */
+        void deallocate(void* ptr, std::size_t size) noexcept;
+
+        /**
+         *  Returns true if the pointer points into the arena.
+         */
+        bool owns(void const* ptr) const noexcept;
+
+        /**
+         *  Returns the amount of bytes currently handed out.
+         */
+        std::size_t used() const noexcept;
+
+    private:
+        static std::size_t align(std::size_t size) noexcept;
+
+    private:
+        alignas(std::max_align_t) std::byte storage_[config::coroutine_arena_size];
+        std::size_t top_;
+        std::size_t live_;
+    };
+}
@@ -3,6 +3,7 @@
 // RFC 2616 https://tools.ietf.org/html/rfc2616#section-3.3.1
 
 #include <string>
+#include <string_view>
 #include <chrono>
 
 namespace attender
@@ -13,6 +14,11 @@ namespace attender
     class date
     {
     public:
+        /**
+         *  The length of the RFC 2616 representation, for instance "Sun, 06 Nov 1994 08:49:37 GMT".
+         */
+        static constexpr std::size_t gmt_string_length = 29;
+
         /**
          *  Creates a time date object from a specific time point.
          */
@@ -35,7 +41,19 @@ namespace attender
          */
         std::string to_gmt_string() const;
 
+        /**
+         *  Writes the same representation as to_gmt_string to out, which must have room for gmt_string_length characters.
+         */
+        void write_gmt_string(char* out) const;
+
     private:
         std::chrono::system_clock::time_point time_point_;
     };
+
+    /**
+     *  Returns the current time in the representation of date::to_gmt_string, as used by the Date header.
+     *  The string is cached per thread and only formatted again when the second changes.
+     *  The view is valid until the next call on the same thread.
+     */
+    std::string_view current_gmt_string();
 }
@@ -49,58 +49,72 @@ namespace attender
 //---------------------------------------------------------------------------------------------------------------------
     brotli_encoder::brotli_encoder(brotli_configuration config)
         : brotctx_{new brotli_encoder::implementation(std::move(config))}
-        , input_{}
         , output_{}
-        , input_start_{0}
-        , output_start_offset_{0}
         , avail_in_{0}
-        , input_cutoff_{128'000}
-        , output_minimum_avail_{32'768}
-        , output_considered_overflow_{20'000'000}
         , total_out_{0}
-        , avail_{0}
         , completed_{}
         , buffer_saver_{}
+        , sequence_{}
     {
 
     }
 //---------------------------------------------------------------------------------------------------------------------
     void brotli_encoder::set_minimum_avail(std::size_t min_avail)
     {
-        output_minimum_avail_ = min_avail;
+        std::lock_guard <std::recursive_mutex> guard{buffer_saver_};
+        output_.set_segment_size(min_avail);
     }
 //---------------------------------------------------------------------------------------------------------------------
-    void brotli_encoder::set_cut_off(std::size_t input_cutoff)
+    void brotli_encoder::set_buffer_limit(std::size_t limit)
+    {
+        std::lock_guard <std::recursive_mutex> guard{buffer_saver_};
+        output_.set_limit(limit);
+    }
+//---------------------------------------------------------------------------------------------------------------------
+    void brotli_encoder::set_cut_off(std::size_t)
     {
-        input_cutoff_ = input_cutoff;
     }
 //---------------------------------------------------------------------------------------------------------------------
     brotli_encoder::~brotli_encoder()
     {
+        sequence_.wait();
+    }
+//---------------------------------------------------------------------------------------------------------------------
+    void brotli_encoder::set_scheduler(task_scheduler* scheduler)
+    {
+        sequence_.set_scheduler(scheduler);
     }
 //---------------------------------------------------------------------------------------------------------------------
     std::size_t brotli_encoder::available() const
     {
-        return avail_.load();
+        std::lock_guard <std::recursive_mutex> guard{buffer_saver_};
+        return output_.front().size();
+    }
+//---------------------------------------------------------------------------------------------------------------------
+    std::size_t brotli_encoder::buffered() const
+    {
+        std::lock_guard <std::recursive_mutex> guard{buffer_saver_};
+        return output_.size();
     }
 //---------------------------------------------------------------------------------------------------------------------
     char const* brotli_encoder::data() const
     {
-        return output_.data();
+        return output_.front().data();
     }
 //---------------------------------------------------------------------------------------------------------------------
     bool brotli_encoder::complete() const
     {
-        return completed_.load();
+        // the stream is only complete once the consumer took everything.
+        std::lock_guard <std::recursive_mutex> guard{buffer_saver_};
+        return completed_.load() && output_.empty();
     }
 //---------------------------------------------------------------------------------------------------------------------
     void brotli_encoder::has_consumed(std::size_t size)
     {
         if (size > 0)
         {
-            avail_.store(avail_.load() - size);
             std::lock_guard <std::recursive_mutex> guard{buffer_saver_};
-            output_.erase(output_.begin(), output_.begin() + size);
+            output_.consume(size);
         }
         producer::has_consumed(size);
         if (consuming_.load() == false && completed_.load())
@@ -121,104 +135,100 @@ namespace attender
 //---------------------------------------------------------------------------------------------------------------------
     void brotli_encoder::flush()
     {
-        do
-        {
+        sequence_.run([this]{
             push(nullptr, 0, BROTLI_OPERATION_FLUSH);
-        } while (avail_in_ != 0);
-        produced_data();
+        });
     }
 //---------------------------------------------------------------------------------------------------------------------
     void brotli_encoder::finish()
     {
-        do
-        {
+        sequence_.run([this]{
             push(nullptr, 0, BROTLI_OPERATION_FINISH);
-        } while (avail_in_ != 0);
-        completed_.store(true);
-        produced_data();
-    }
-//---------------------------------------------------------------------------------------------------------------------
-    void brotli_encoder::shrink_input()
-    {
-        if (input_.size() > input_cutoff_ && input_start_ > 0)
-        {
-            input_.erase(std::begin(input_), std::begin(input_) + input_start_);
-            input_start_ = 0;
-        }
+            completed_.store(true);
+            produced_data();
+        });
     }
 //---------------------------------------------------------------------------------------------------------------------
-    void brotli_encoder::bufferize_input(char const* data_begin, std::size_t data_size)
+    void brotli_encoder::push(char const* data_begin, std::size_t data_size)
     {
-        if (avail_in_)
-
-        shrink_input();
-        input_.resize(input_.size() + data_size);
+        if (!sequence_.get_scheduler())
+            return push(data_begin, data_size, BROTLI_OPERATION_PROCESS);
 
-        auto start = &*input_.begin() + input_start_;
-        std::memcpy(start, data_begin, data_size);
-        avail_in_ += data_size;
+        sequence_.run([this, data = std::string{data_begin, data_size}]{
+            push(data.data(), data.size(), BROTLI_OPERATION_PROCESS);
+        });
     }
 //---------------------------------------------------------------------------------------------------------------------
-    void brotli_encoder::reserve_output()
+    void brotli_encoder::push(char const* data_begin, std::size_t data_size, int operation)
     {
         std::lock_guard <std::recursive_mutex> guard(buffer_saver_);
 
-        std::size_t avail_out = output_.size() - output_start_offset_;
-        if (avail_out < output_minimum_avail_)
-        {
-            output_.resize(output_.size() + output_minimum_avail_);
-        }
-    }
-//---------------------------------------------------------------------------------------------------------------------
-    void brotli_encoder::push(char const* data_begin, std::size_t data_size)
-    {
-        push(data_begin, data_size, BROTLI_OPERATION_PROCESS);
-    }
-//---------------------------------------------------------------------------------------------------------------------
-    void brotli_encoder::push(char const* data_begin, std::size_t data_size, int operation)
-    {
-        if (data_begin != nullptr && data_size > 0)
-        {
-            bufferize_input(data_begin, data_size);
-        }
-        reserve_output();
+        // brotli takes the input straight from the caller, the loop does not return before all of it is consumed.
+        uint8_t const* next_in = reinterpret_cast <uint8_t const*> (data_begin);
+        avail_in_ = data_begin != nullptr ? data_size : 0;
+        BROTLI_BOOL res = BROTLI_TRUE;
+        bool overflow = false;
 
-        std::lock_guard <std::recursive_mutex> guard(buffer_saver_);
-        uint8_t const* next_in = &*input_.begin();
-        uint8_t* next_out = reinterpret_cast <uint8_t*>(&*output_.begin() + output_start_offset_);
+        // runs until all input is taken and brotli has no more output for this operation.
+        do
+        {
+            auto space = output_.prepare();
+            if (space.empty())
+            {
+                overflow = true;
+                break;
+            }
 
-        std::size_t avail_out = output_.size() - output_start_offset_;
-        std::size_t avail_out_before = avail_out;
-        auto res = BrotliEncoderCompressStream
-        (
-            // state
-            brotctx_->ctx,
+            uint8_t* next_out = reinterpret_cast <uint8_t*> (space.data());
+            std::size_t avail_out = space.size();
+            res = BrotliEncoderCompressStream
+            (
+                // state
+                brotctx_->ctx,
 
-            // operation BROTLI_OPERATION_PROCESS most of the times. type: enum BrotliEncoderOperation
-            static_cast <BrotliEncoderOperation> (operation),
+                // operation BROTLI_OPERATION_PROCESS most of the times. type: enum BrotliEncoderOperation
+                static_cast <BrotliEncoderOperation> (operation),
 
-            // available data on the input buffer
-            &avail_in_,
+                // available data on the input buffer
+                &avail_in_,
 
-            // point to input (also carries OUT)
-            &next_in,
+                // point to input (also carries OUT)
+                &next_in,
 
-            // available space in output
-            &avail_out,
+                // available space in output
+                &avail_out,
 
-            // pointer to free output space
-            &next_out,
+                // pointer to free output space
+                &next_out,
 
-            // total bytes compressed since last state initialization
-            &total_out_
+                // total bytes compressed since last state initialization
+                &total_out_
+            );
+            output_.commit(space.size() - avail_out);
+        }
+        while (
+            res &&
+            (
+                avail_in_ != 0 ||
+                BrotliEncoderHasMoreOutput(brotctx_->ctx) ||
+                (operation == BROTLI_OPERATION_FINISH && !BrotliEncoderIsFinished(brotctx_->ctx))
+            )
         );
-        avail_.store(avail_.load() + (avail_out_before - avail_out));
-
-        if (res)
+        if (overflow)
+            production_failure("buffer limit reached");
+        else if (res)
             produced_data();
         else
             production_failure("error "s + std::to_string(res));
     }
+//---------------------------------------------------------------------------------------------------------------------
+    void brotli_encoder::for_each_available(std::function <void(char const*, std::size_t)> const& fn) const
+    {
+        std::lock_guard <std::recursive_mutex> guard{buffer_saver_};
+        output_.for_each([&fn](std::string_view span) {
+            fn(span.data(), span.size());
+        });
+    }
 //---------------------------------------------------------------------------------------------------------------------
     void brotli_encoder::buffer_locked_do(std::function <void()> const& fn) const
     {
@@ -233,6 +243,7 @@ namespace attender
 //---------------------------------------------------------------------------------------------------------------------
     std::size_t brotli_encoder::available_in() const noexcept
     {
+        std::lock_guard <std::recursive_mutex> guard{buffer_saver_};
         return avail_in_;
     }
 //#####################################################################################################################
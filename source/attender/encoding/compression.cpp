@@ -0,0 +1,243 @@
+#include <attender/encoding/compression.hpp>
+
+#include <brotli/encode.h>
+#include <zlib.h>
+
+#include <algorithm>
+#include <charconv>
+#include <climits>
+#include <cstring>
+#include <optional>
+
+namespace attender
+{
+//#####################################################################################################################
+    namespace
+    {
+        std::string_view trim(std::string_view view)
+        {
+            while (!view.empty() && (view.front() == ' ' || view.front() == '\t'))
+                view.remove_prefix(1);
+            while (!view.empty() && (view.back() == ' ' || view.back() == '\t'))
+                view.remove_suffix(1);
+            return view;
+        }
+
+        bool equal_ignore_case(std::string_view lhs, std::string_view rhs)
+        {
+            return std::equal(lhs.begin(), lhs.end(), rhs.begin(), rhs.end(), [](char l, char r) {
+                return (l | 0x20) == (r | 0x20);
+            });
+        }
+
+        /**
+         *  Parses the q parameter of an Accept-Encoding element in thousandths, 1000 if there is none.
+         */
+        int parse_quality(std::string_view parameters)
+        {
+            while (!parameters.empty())
+            {
+                auto end = parameters.find(';');
+                auto parameter = trim(parameters.substr(0, end));
+                parameters = end == std::string_view::npos ? std::string_view{} : parameters.substr(end + 1);
+
+                if (parameter.size() < 2 || (parameter[0] | 0x20) != 'q' || parameter[1] != '=')
+                    continue;
+
+                auto value = parameter.substr(2);
+                int integral = 0;
+                auto [next, ec] = std::from_chars(value.data(), value.data() + value.size(), integral);
+                if (ec != std::errc{} || integral < 0)
+                    return 0;
+                if (integral >= 1)
+                    return 1000;
+
+                int quality = 0;
+                int scale = 100;
+                if (next != value.data() + value.size() && *next == '.')
+                {
+                    for (++next; next != value.data() + value.size() && *next >= '0' && *next <= '9' && scale != 0; ++next)
+                    {
+                        quality += (*next - '0') * scale;
+                        scale /= 10;
+                    }
+                }
+                return quality;
+            }
+            return 1000;
+        }
+
+        /**
+         *  A deflate stream that lives as long as its thread and is reset for every body.
+         */
+        class zlib_stream
+        {
+        public:
+            explicit zlib_stream(int window_bits)
+                : stream_{}
+                , window_bits_{window_bits}
+                , level_{}
+            {
+            }
+
+            ~zlib_stream()
+            {
+                if (level_)
+                    deflateEnd(&stream_);
+            }
+
+            zlib_stream(zlib_stream const&) = delete;
+            zlib_stream& operator=(zlib_stream const&) = delete;
+
+            bool compress(std::string_view input, std::string& output, int level)
+            {
+                if (input.size() > UINT_MAX)
+                    return false;
+
+                if (level_ != level)
+                {
+                    if (level_)
+                        deflateEnd(&stream_);
+                    level_.reset();
+                    stream_ = {};
+                    if (deflateInit2(&stream_, level, Z_DEFLATED, window_bits_, 8, Z_DEFAULT_STRATEGY) != Z_OK)
+                        return false;
+                    level_ = level;
+                }
+                else if (deflateReset(&stream_) != Z_OK)
+                    return false;
+
+                output.resize(deflateBound(&stream_, static_cast <uLong> (input.size())));
+
+                stream_.next_in = reinterpret_cast <Bytef*> (const_cast <char*> (input.data()));
+                stream_.avail_in = static_cast <uInt> (input.size());
+                stream_.next_out = reinterpret_cast <Bytef*> (output.data());
+                stream_.avail_out = static_cast <uInt> (output.size());
+
+                if (deflate(&stream_, Z_FINISH) != Z_STREAM_END)
+                    return false;
+
+                output.resize(stream_.total_out);
+                return true;
+            }
+
+        private:
+            z_stream stream_;
+            int window_bits_;
+
+            // the level the stream was initialized with, -1 is Z_DEFAULT_COMPRESSION.
+            std::optional <int> level_;
+        };
+
+        bool compress_brotli(std::string_view input, std::string& output, int quality)
+        {
+            // a window larger than the body only costs memory.
+            int window = BROTLI_MIN_WINDOW_BITS;
+            while (window < BROTLI_DEFAULT_WINDOW && (std::size_t{1} << window) < input.size())
+                ++window;
+
+            output.resize(BrotliEncoderMaxCompressedSize(input.size()));
+            std::size_t size = output.size();
+            auto result = BrotliEncoderCompress(
+                quality,
+                window,
+                BROTLI_MODE_GENERIC,
+                input.size(),
+                reinterpret_cast <uint8_t const*> (input.data()),
+                &size,
+                reinterpret_cast <uint8_t*> (output.data())
+            );
+            if (result != BROTLI_TRUE)
+                return false;
+
+            output.resize(size);
+            return true;
+        }
+    }
+//#####################################################################################################################
+    content_coding negotiate_coding(std::string_view accept_encoding, compression_options const& options)
+    {
+        // -1 means not mentioned.
+        int brotli = -1;
+        int gzip = -1;
+        int deflate = -1;
+        int any = -1;
+
+        while (!accept_encoding.empty())
+        {
+            auto end = accept_encoding.find(',');
+            auto element = accept_encoding.substr(0, end);
+            accept_encoding = end == std::string_view::npos ? std::string_view{} : accept_encoding.substr(end + 1);
+
+            auto parameters_start = element.find(';');
+            auto name = trim(element.substr(0, parameters_start));
+            auto quality = parameters_start == std::string_view::npos ? 1000 : parse_quality(element.substr(parameters_start + 1));
+
+            if (equal_ignore_case(name, "br"))
+                brotli = quality;
+            else if (equal_ignore_case(name, "gzip") || equal_ignore_case(name, "x-gzip"))
+                gzip = quality;
+            else if (equal_ignore_case(name, "deflate"))
+                deflate = quality;
+            else if (name == "*")
+                any = quality;
+        }
+
+        auto effective = [any](int quality, bool allowed) {
+            if (!allowed)
+                return 0;
+            return quality == -1 ? std::max(any, 0) : quality;
+        };
+
+        content_coding best = content_coding::identity;
+        int best_quality = 0;
+        for (auto [coding, quality] : {
+            std::pair{content_coding::brotli, effective(brotli, options.allow_brotli)},
+            std::pair{content_coding::gzip, effective(gzip, options.allow_gzip)},
+            std::pair{content_coding::deflate, effective(deflate, options.allow_deflate)}
+        })
+        {
+            if (quality > best_quality)
+            {
+                best = coding;
+                best_quality = quality;
+            }
+        }
+        return best;
+    }
+//---------------------------------------------------------------------------------------------------------------------
+    std::string_view coding_name(content_coding coding)
+    {
+        switch (coding)
+        {
+            case content_coding::brotli: return "br";
+            case content_coding::gzip: return "gzip";
+            case content_coding::deflate: return "deflate";
+            default: return "identity";
+        }
+    }
+//---------------------------------------------------------------------------------------------------------------------
+    bool compress(content_coding coding, std::string_view input, std::string& output, compression_options const& options)
+    {
+        switch (coding)
+        {
+            case content_coding::brotli:
+                return compress_brotli(input, output, options.brotli_quality);
+            case content_coding::gzip:
+            {
+                // 16 added to the window bits selects the gzip wrapper.
+                thread_local zlib_stream gzip{15 + 16};
+                return gzip.compress(input, output, options.zlib_level);
+            }
+            case content_coding::deflate:
+            {
+                // "deflate" in http is the zlib format (RFC 1950).
+                thread_local zlib_stream deflate{15};
+                return deflate.compress(input, output, options.zlib_level);
+            }
+            default:
+                return false;
+        }
+    }
+//#####################################################################################################################
+}
@@ -1,9 +1,8 @@
 #include <attender/encoding/producer.hpp>
 
+#include <algorithm>
 #include <iostream>
 
-using namespace std::chrono_literals;
-
 namespace attender
 {
     namespace
@@ -58,16 +57,102 @@ namespace attender
         }
         else
             consuming_.store(false);
+
+        notify_writable(false);
+    }
+//---------------------------------------------------------------------------------------------------------------------
+    std::size_t producer::buffered() const
+    {
+        return available();
+    }
+//---------------------------------------------------------------------------------------------------------------------
+    void producer::set_water_marks(std::size_t low, std::size_t high)
+    {
+        low_water_mark_ = std::min(low, high);
+        high_water_mark_ = high;
+    }
+//---------------------------------------------------------------------------------------------------------------------
+    std::size_t producer::low_water_mark() const noexcept
+    {
+        return low_water_mark_;
+    }
+//---------------------------------------------------------------------------------------------------------------------
+    std::size_t producer::high_water_mark() const noexcept
+    {
+        return high_water_mark_;
+    }
+//---------------------------------------------------------------------------------------------------------------------
+    bool producer::is_full() const
+    {
+        return buffered() >= high_water_mark_;
+    }
+//---------------------------------------------------------------------------------------------------------------------
+    void producer::when_writable(std::function <void()> on_writable)
+    {
+        {
+            std::lock_guard <std::mutex> guard{on_writable_protect_};
+            on_writable_ = std::move(on_writable);
+        }
+        // the consumer may have drained the buffer before the callback was set.
+        notify_writable(false);
+    }
+//---------------------------------------------------------------------------------------------------------------------
+    void producer::notify_writable(bool force)
+    {
+        if (!force && buffered() > low_water_mark_)
+            return;
+
+        std::function <void()> on_writable;
+        {
+            std::lock_guard <std::mutex> guard{on_writable_protect_};
+            std::swap(on_writable, on_writable_);
+        }
+        if (on_writable)
+            on_writable();
+    }
+//---------------------------------------------------------------------------------------------------------------------
+    void producer::for_each_available(std::function <void(char const*, std::size_t)> const& fn) const
+    {
+        buffer_locked_do([this, &fn]{
+            auto size = available();
+            if (size == 0)
+                return;
+
+            // the buffer behind data() may reallocate while the span is written.
+            available_copy_.assign(data(), data() + size);
+            fn(available_copy_.data(), size);
+        });
     }
 //---------------------------------------------------------------------------------------------------------------------
     void producer::set_on_produce_cb(std::function <void(std::string const& err, bool)> cb)
     {
-        std::lock_guard <std::recursive_mutex> guard{on_produce_protect_};
-        on_produce_ = [this, cb{std::move(cb)}](std::string const& err, bool control)
+        std::function <void()> on_attached;
+        {
+            std::lock_guard <std::recursive_mutex> guard{on_produce_protect_};
+            on_produce_ = [this, cb{std::move(cb)}](std::string const& err, bool control)
+            {
+                consuming_.store(true);
+                cb(err, control);
+            };
+            std::swap(on_attached, on_attached_);
+        }
+        attached_.notify_all();
+
+        if (on_attached)
+            on_attached();
+    }
+//---------------------------------------------------------------------------------------------------------------------
+    void producer::when_attached(std::function <void()> on_attached)
+    {
         {
-            consuming_.store(true);
-            cb(err, control);
-        };
+            std::lock_guard <std::recursive_mutex> guard{on_produce_protect_};
+            if (!on_produce_)
+            {
+                on_attached_ = std::move(on_attached);
+                return;
+            }
+        }
+        on_attached();
     }
 //---------------------------------------------------------------------------------------------------------------------
     bool producer::has_consumer_attached() const
@@ -90,26 +175,30 @@ namespace attender
 //---------------------------------------------------------------------------------------------------------------------
     void producer::production_failure(std::string const& fail)
     {
-        on_produce_(fail, false);
+        std::lock_guard <std::recursive_mutex> guard{on_produce_protect_};
+        if (on_produce_)
+            on_produce_(fail, false);
     }
 //---------------------------------------------------------------------------------------------------------------------
     bool producer::wait_for_consumer(std::chrono::milliseconds timeout) const
     {
-        auto start_time = std::chrono::high_resolution_clock::now();
-        while(!has_consumer_attached())
-        {
-            auto now = std::chrono::high_resolution_clock::now();
-            if (now - start_time > timeout)
-                return false;
-            std::this_thread::sleep_for(50ms);
-        }
-        return true;
+        std::unique_lock <std::recursive_mutex> lock{on_produce_protect_};
+        return attached_.wait_for(lock, timeout, [this]{
+            return on_produce_.operator bool();
+        });
     }
 //---------------------------------------------------------------------------------------------------------------------
     void producer::end_production(boost::system::error_code ec)
     {
+        {
+            std::lock_guard <std::recursive_mutex> guard{on_produce_protect_};
+            on_produce_ = {};
+        }
+
+        // a producer waiting for space must not wait forever.
+        notify_writable(true);
+
         std::lock_guard <std::recursive_mutex> guard{on_produce_protect_};
-        on_produce_ = {};
         on_finish_(ec);
     }
 //---------------------------------------------------------------------------------------------------------------------
@@ -0,0 +1,145 @@
+#include <attender/encoding/segmented_buffer.hpp>
+
+#include <algorithm>
+#include <cstring>
+
+namespace attender
+{
+//#####################################################################################################################
+    segmented_buffer::segmented_buffer(std::size_t segment_size, std::size_t limit)
+        : segments_{}
+        , spare_{}
+        , segment_size_{std::max <std::size_t> (segment_size, 1)}
+        , limit_{limit}
+        , size_{0}
+    {
+    }
+//---------------------------------------------------------------------------------------------------------------------
+    void segmented_buffer::set_segment_size(std::size_t segment_size)
+    {
+        segment_size_ = std::max <std::size_t> (segment_size, 1);
+        if (spare_.capacity != segment_size_)
+            spare_ = {};
+    }
+//---------------------------------------------------------------------------------------------------------------------
+    void segmented_buffer::set_limit(std::size_t limit) noexcept
+    {
+        limit_ = limit;
+    }
+//---------------------------------------------------------------------------------------------------------------------
+    std::size_t segmented_buffer::segment_size() const noexcept
+    {
+        return segment_size_;
+    }
+//---------------------------------------------------------------------------------------------------------------------
+    std::size_t segmented_buffer::limit() const noexcept
+    {
+        return limit_;
+    }
+//---------------------------------------------------------------------------------------------------------------------
+    std::size_t segmented_buffer::size() const noexcept
+    {
+        return size_;
+    }
+//---------------------------------------------------------------------------------------------------------------------
+    bool segmented_buffer::empty() const noexcept
+    {
+        return size_ == 0;
+    }
+//---------------------------------------------------------------------------------------------------------------------
+    std::string_view segmented_buffer::front() const noexcept
+    {
+        if (segments_.empty())
+            return {};
+
+        auto const& segment = segments_.front();
+        return {segment.memory.get() + segment.begin, segment.end - segment.begin};
+    }
+//---------------------------------------------------------------------------------------------------------------------
+    void segmented_buffer::consume(std::size_t size) noexcept
+    {
+        size = std::min(size, size_);
+        size_ -= size;
+        while (size > 0)
+        {
+            auto& segment = segments_.front();
+            auto taken = std::min(size, segment.end - segment.begin);
+            segment.begin += taken;
+            size -= taken;
+            if (segment.begin == segment.end)
+                retire_front();
+        }
+    }
+//---------------------------------------------------------------------------------------------------------------------
+    void segmented_buffer::retire_front() noexcept
+    {
+        // the last segment is still written to, it starts over instead.
+        if (segments_.size() == 1)
+        {
+            segments_.front().begin = 0;
+            segments_.front().end = 0;
+            return;
+        }
+
+        if (!spare_.memory && segments_.front().capacity == segment_size_)
+            spare_ = std::move(segments_.front());
+        segments_.pop_front();
+    }
+//---------------------------------------------------------------------------------------------------------------------
+    std::span <char> segmented_buffer::prepare()
+    {
+        if (size_ >= limit_)
+            return {};
+
+        if (segments_.empty() || segments_.back().end == segments_.back().capacity)
+        {
+            if (spare_.memory)
+            {
+                segments_.push_back(std::move(spare_));
+                spare_ = {};
+                segments_.back().begin = 0;
+                segments_.back().end = 0;
+            }
+            else
+                segments_.push_back({std::unique_ptr <char[]>{new char[segment_size_]}, segment_size_, 0, 0});
+        }
+
+        auto& segment = segments_.back();
+        return {segment.memory.get() + segment.end, std::min(segment.capacity - segment.end, limit_ - size_)};
+    }
+//---------------------------------------------------------------------------------------------------------------------
+    void segmented_buffer::commit(std::size_t size) noexcept
+    {
+        if (size == 0)
+            return;
+
+        segments_.back().end += size;
+        size_ += size;
+    }
+//---------------------------------------------------------------------------------------------------------------------
+    std::size_t segmented_buffer::append(char const* data_begin, std::size_t data_size)
+    {
+        std::size_t appended = 0;
+        while (appended < data_size)
+        {
+            auto space = prepare();
+            if (space.empty())
+                break;
+
+            auto piece = std::min(space.size(), data_size - appended);
+            std::memcpy(space.data(), data_begin + appended, piece);
+            commit(piece);
+            appended += piece;
+        }
+        return appended;
+    }
+//---------------------------------------------------------------------------------------------------------------------
+    void segmented_buffer::clear() noexcept
+    {
+        if (!spare_.memory && !segments_.empty() && segments_.front().capacity == segment_size_)
+            spare_ = std::move(segments_.front());
+        segments_.clear();
+        size_ = 0;
+    }
+//#####################################################################################################################
+}
@@ -0,0 +1,153 @@
+#include <attender/encoding/spsc_producer.hpp>
+
+#include <algorithm>
+#include <bit>
+#include <cstring>
+
+namespace attender
+{
+//#####################################################################################################################
+    spsc_producer::spsc_producer(asio::io_service& service, std::size_t capacity, std::string encoding)
+        : service_{&service}
+        , encoding_{std::move(encoding)}
+        , ring_{new char[std::bit_ceil(std::max <std::size_t> (capacity, 2))]}
+        , mask_{std::bit_ceil(std::max <std::size_t> (capacity, 2)) - 1}
+        , wake_state_{std::make_shared <wake_state>()}
+        , head_{0}
+        , tail_{0}
+        , completed_{false}
+        , wake_pending_{false}
+    {
+        wake_state_->producer = this;
+    }
+//---------------------------------------------------------------------------------------------------------------------
+    spsc_producer::~spsc_producer()
+    {
+        std::lock_guard <std::recursive_mutex> guard{wake_state_->protect};
+        wake_state_->producer = nullptr;
+    }
+//---------------------------------------------------------------------------------------------------------------------
+    std::size_t spsc_producer::capacity() const noexcept
+    {
+        return mask_ + 1;
+    }
+//---------------------------------------------------------------------------------------------------------------------
+    bool spsc_producer::try_push(std::string_view data)
+    {
+        auto tail = tail_.load(std::memory_order_relaxed);
+        if (data.size() > capacity() - (tail - head_.load(std::memory_order_acquire)))
+            return false;
+
+        // the free space may wrap around the end of the ring.
+        auto offset = tail & mask_;
+        auto first = std::min(data.size(), capacity() - offset);
+        std::memcpy(ring_.get() + offset, data.data(), first);
+        std::memcpy(ring_.get(), data.data() + first, data.size() - first);
+
+        // sequentially consistent with the load of consuming_ in wake_if_idle, see has_consumed.
+        tail_.store(tail + data.size());
+        wake_if_idle();
+        return true;
+    }
+//---------------------------------------------------------------------------------------------------------------------
+    void spsc_producer::flush()
+    {
+        wake_if_idle();
+    }
+//---------------------------------------------------------------------------------------------------------------------
+    void spsc_producer::finish()
+    {
+        completed_.store(true);
+        wake();
+    }
+//---------------------------------------------------------------------------------------------------------------------
+    void spsc_producer::wake_if_idle()
+    {
+        if (!consuming_.load())
+            wake();
+    }
+//---------------------------------------------------------------------------------------------------------------------
+    void spsc_producer::wake()
+    {
+        if (wake_pending_.exchange(true))
+            return;
+
+        asio::post(*service_, [state = wake_state_]{
+            std::lock_guard <std::recursive_mutex> guard{state->protect};
+            if (state->producer == nullptr)
+                return;
+
+            state->producer->wake_pending_.store(false);
+            state->producer->produced_data();
+        });
+    }
+//---------------------------------------------------------------------------------------------------------------------
+    std::string spsc_producer::encoding() const
+    {
+        return encoding_;
+    }
+//---------------------------------------------------------------------------------------------------------------------
+    std::size_t spsc_producer::available() const
+    {
+        auto head = head_.load(std::memory_order_relaxed);
+        auto size = tail_.load(std::memory_order_acquire) - head;
+
+        // only up to the end of the ring, the rest follows at its start.
+        return std::min(size, capacity() - (head & mask_));
+    }
+//---------------------------------------------------------------------------------------------------------------------
+    std::size_t spsc_producer::buffered() const
+    {
+        return tail_.load(std::memory_order_acquire) - head_.load(std::memory_order_acquire);
+    }
+//---------------------------------------------------------------------------------------------------------------------
+    char const* spsc_producer::data() const
+    {
+        return ring_.get() + (head_.load(std::memory_order_relaxed) & mask_);
+    }
+//---------------------------------------------------------------------------------------------------------------------
+    bool spsc_producer::complete() const
+    {
+        return completed_.load() && buffered() == 0;
+    }
+//---------------------------------------------------------------------------------------------------------------------
+    void spsc_producer::has_consumed(std::size_t size)
+    {
+        head_.store(head_.load(std::memory_order_relaxed) + size, std::memory_order_release);
+        producer::has_consumed(size);
+
+        // The base class marks the connection idle if the ring looked empty. A push may have slipped in between,
+        // and that push saw the connection busy and did not wake it. Either this sees its data or it sees idle.
+        if (!consuming_.load() && (tail_.load() != head_.load(std::memory_order_relaxed) || completed_.load()))
+            wake();
+    }
+//---------------------------------------------------------------------------------------------------------------------
+    void spsc_producer::on_error(boost::system::error_code)
+    {
+    }
+//---------------------------------------------------------------------------------------------------------------------
+    void spsc_producer::start_production()
+    {
+        if (buffered() > 0 || completed_.load())
+            produced_data();
+    }
+//---------------------------------------------------------------------------------------------------------------------
+    void spsc_producer::for_each_available(std::function <void(char const*, std::size_t)> const& fn) const
+    {
+        auto head = head_.load(std::memory_order_relaxed);
+        auto size = tail_.load(std::memory_order_acquire) - head;
+        auto offset = head & mask_;
+        auto first = std::min(size, capacity() - offset);
+
+        if (first > 0)
+            fn(ring_.get() + offset, first);
+        if (size > first)
+            fn(ring_.get(), size - first);
+    }
+//---------------------------------------------------------------------------------------------------------------------
+    void spsc_producer::buffer_locked_do(std::function <void()> const& fn) const
+    {
+        fn();
+    }
+//#####################################################################################################################
+}
@@ -23,6 +23,12 @@ namespace attender
     {
         produced_data();
     }
+//---------------------------------------------------------------------------------------------------------------------
+    void streaming_producer::set_buffer_limit(std::size_t limit)
+    {
+        std::lock_guard <std::recursive_mutex> guard{buffer_saver_};
+        buffer_.set_limit(limit);
+    }
 //---------------------------------------------------------------------------------------------------------------------
     void streaming_producer::finish()
     {
@@ -36,30 +42,59 @@ namespace attender
     }
 //---------------------------------------------------------------------------------------------------------------------
     std::size_t streaming_producer::available() const
+    {
+        std::lock_guard <std::recursive_mutex> guard{buffer_saver_};
+        return buffer_.front().size();
+    }
+//---------------------------------------------------------------------------------------------------------------------
+    std::size_t streaming_producer::buffered() const
     {
         std::lock_guard <std::recursive_mutex> guard{buffer_saver_};
         return buffer_.size();
     }
+//---------------------------------------------------------------------------------------------------------------------
+    bool streaming_producer::try_push(std::string_view data)
+    {
+        {
+            std::lock_guard <std::recursive_mutex> guard{buffer_saver_};
+            if (buffer_.size() >= high_water_mark())
+                return false;
+        }
+        *this << data;
+        return true;
+    }
 //---------------------------------------------------------------------------------------------------------------------
     char const* streaming_producer::data() const
     {
-        return buffer_.data();
+        return buffer_.front().data();
     }
 //---------------------------------------------------------------------------------------------------------------------
     bool streaming_producer::complete() const
     {
-        return completed_.load();
+        // the stream is only complete once the consumer took everything.
+        std::lock_guard <std::recursive_mutex> guard{buffer_saver_};
+        return completed_.load() && buffer_.empty();
     }
 //---------------------------------------------------------------------------------------------------------------------
     void streaming_producer::has_consumed(std::size_t size)
     {
-        std::lock_guard <std::recursive_mutex> guard{buffer_saver_};
-        if (buffer_.size() < size)
-            buffer_.clear();
-        else
-            buffer_.erase(buffer_.begin(), buffer_.begin() + size);
+        {
+            std::lock_guard <std::recursive_mutex> guard{buffer_saver_};
+            buffer_.consume(size);
+        }
 
+        // not under the buffer lock, finish() locks the other way around.
         producer::has_consumed(size);
+        if (consuming_.load() == false && completed_.load())
+            produced_data();
+    }
+//---------------------------------------------------------------------------------------------------------------------
+    void streaming_producer::for_each_available(std::function <void(char const*, std::size_t)> const& fn) const
+    {
+        std::lock_guard <std::recursive_mutex> guard{buffer_saver_};
+        buffer_.for_each([&fn](std::string_view span) {
+            fn(span.data(), span.size());
+        });
     }
 //---------------------------------------------------------------------------------------------------------------------
     void streaming_producer::buffer_locked_do(std::function <void()> const& fn) const
@@ -0,0 +1,247 @@
+#include <attender/encoding/zlib.hpp>
+
+#include <zlib.h>
+
+#include <algorithm>
+#include <climits>
+#include <stdexcept>
+
+using namespace std::string_literals;
+
+namespace attender
+{
+//#####################################################################################################################
+    zlib_configuration zlib_configuration::make_default()
+    {
+        return {
+            Z_DEFAULT_COMPRESSION,
+            MAX_WBITS,
+            8
+        };
+    }
+//#####################################################################################################################
+    struct zlib_encoder::implementation
+    {
+        z_stream stream;
+
+        implementation(zlib_format format, zlib_configuration const& config);
+        ~implementation();
+    };
+//---------------------------------------------------------------------------------------------------------------------
+    zlib_encoder::implementation::implementation(zlib_format format, zlib_configuration const& config)
+        : stream{}
+    {
+        // 16 added to the window bits selects the gzip wrapper.
+        auto window = format == zlib_format::gzip ? config.window + 16 : config.window;
+        if (deflateInit2(&stream, config.level, Z_DEFLATED, window, config.memory_level, Z_DEFAULT_STRATEGY) != Z_OK)
+            throw std::invalid_argument("invalid zlib configuration");
+    }
+//---------------------------------------------------------------------------------------------------------------------
+    zlib_encoder::implementation::~implementation()
+    {
+        deflateEnd(&stream);
+    }
+//#####################################################################################################################
+    zlib_encoder::zlib_encoder(zlib_format format, zlib_configuration config)
+        : zctx_{new zlib_encoder::implementation(format, config)}
+        , format_{format}
+        , output_{}
+        , completed_{false}
+        , buffer_saver_{}
+        , sequence_{}
+    {
+    }
+//---------------------------------------------------------------------------------------------------------------------
+    zlib_encoder::~zlib_encoder()
+    {
+        sequence_.wait();
+    }
+//---------------------------------------------------------------------------------------------------------------------
+    std::string zlib_encoder::encoding() const
+    {
+        return format_ == zlib_format::gzip ? "gzip" : "deflate";
+    }
+//---------------------------------------------------------------------------------------------------------------------
+    void zlib_encoder::set_minimum_avail(std::size_t min_avail)
+    {
+        std::lock_guard <std::recursive_mutex> guard{buffer_saver_};
+        output_.set_segment_size(min_avail);
+    }
+//---------------------------------------------------------------------------------------------------------------------
+    void zlib_encoder::set_buffer_limit(std::size_t limit)
+    {
+        std::lock_guard <std::recursive_mutex> guard{buffer_saver_};
+        output_.set_limit(limit);
+    }
+//---------------------------------------------------------------------------------------------------------------------
+    void zlib_encoder::set_scheduler(task_scheduler* scheduler)
+    {
+        sequence_.set_scheduler(scheduler);
+    }
+//---------------------------------------------------------------------------------------------------------------------
+    void zlib_encoder::reset()
+    {
+        sequence_.wait();
+
+        std::lock_guard <std::recursive_mutex> guard{buffer_saver_};
+        deflateReset(&zctx_->stream);
+        output_.clear();
+        completed_.store(false);
+    }
+//---------------------------------------------------------------------------------------------------------------------
+    std::size_t zlib_encoder::available() const
+    {
+        std::lock_guard <std::recursive_mutex> guard{buffer_saver_};
+        return output_.front().size();
+    }
+//---------------------------------------------------------------------------------------------------------------------
+    std::size_t zlib_encoder::buffered() const
+    {
+        std::lock_guard <std::recursive_mutex> guard{buffer_saver_};
+        return output_.size();
+    }
+//---------------------------------------------------------------------------------------------------------------------
+    char const* zlib_encoder::data() const
+    {
+        return output_.front().data();
+    }
+//---------------------------------------------------------------------------------------------------------------------
+    bool zlib_encoder::complete() const
+    {
+        // the stream is only complete once the consumer took everything.
+        std::lock_guard <std::recursive_mutex> guard{buffer_saver_};
+        return completed_.load() && output_.empty();
+    }
+//---------------------------------------------------------------------------------------------------------------------
+    void zlib_encoder::has_consumed(std::size_t size)
+    {
+        if (size > 0)
+        {
+            std::lock_guard <std::recursive_mutex> guard{buffer_saver_};
+            output_.consume(size);
+        }
+        producer::has_consumed(size);
+        if (consuming_.load() == false && completed_.load())
+            produced_data();
+    }
+//---------------------------------------------------------------------------------------------------------------------
+    void zlib_encoder::on_error(boost::system::error_code)
+    {
+    }
+//---------------------------------------------------------------------------------------------------------------------
+    void zlib_encoder::start_production()
+    {
+        if (available() > 0)
+            produced_data();
+    }
+//---------------------------------------------------------------------------------------------------------------------
+    void zlib_encoder::for_each_available(std::function <void(char const*, std::size_t)> const& fn) const
+    {
+        std::lock_guard <std::recursive_mutex> guard{buffer_saver_};
+        output_.for_each([&fn](std::string_view span) {
+            fn(span.data(), span.size());
+        });
+    }
+//---------------------------------------------------------------------------------------------------------------------
+    void zlib_encoder::buffer_locked_do(std::function <void()> const& fn) const
+    {
+        std::lock_guard <std::recursive_mutex> guard(buffer_saver_);
+        fn();
+    }
+//---------------------------------------------------------------------------------------------------------------------
+    void zlib_encoder::push(char const* data_begin, std::size_t data_size)
+    {
+        if (!sequence_.get_scheduler())
+            return compress(data_begin, data_size, Z_NO_FLUSH);
+
+        sequence_.run([this, data = std::string{data_begin, data_size}]{
+            compress(data.data(), data.size(), Z_NO_FLUSH);
+        });
+    }
+//---------------------------------------------------------------------------------------------------------------------
+    void zlib_encoder::push(std::string const& data)
+    {
+        push(data.data(), data.size());
+    }
+//---------------------------------------------------------------------------------------------------------------------
+    void zlib_encoder::flush()
+    {
+        sequence_.run([this]{
+            compress(nullptr, 0, Z_SYNC_FLUSH);
+        });
+    }
+//---------------------------------------------------------------------------------------------------------------------
+    void zlib_encoder::finish()
+    {
+        sequence_.run([this]{
+            compress(nullptr, 0, Z_FINISH);
+            completed_.store(true);
+            produced_data();
+        });
+    }
+//---------------------------------------------------------------------------------------------------------------------
+    void zlib_encoder::compress(char const* data_begin, std::size_t data_size, int flush)
+    {
+        auto& stream = zctx_->stream;
+        bool produced = false;
+        bool overflow = false;
+        int result = Z_OK;
+        {
+            std::lock_guard <std::recursive_mutex> guard(buffer_saver_);
+            for (;;)
+            {
+                // zlib counts in unsigned int, larger inputs are fed in pieces.
+                auto piece = std::min <std::size_t> (data_size, UINT_MAX);
+                auto piece_flush = piece == data_size ? flush : Z_NO_FLUSH;
+                stream.next_in = reinterpret_cast <Bytef*> (const_cast <char*> (data_begin));
+                stream.avail_in = static_cast <uInt> (piece);
+
+                do
+                {
+                    auto space = output_.prepare();
+                    if (space.empty())
+                    {
+                        overflow = true;
+                        break;
+                    }
+
+                    auto space_size = std::min <std::size_t> (space.size(), UINT_MAX);
+                    stream.next_out = reinterpret_cast <Bytef*> (space.data());
+                    stream.avail_out = static_cast <uInt> (space_size);
+
+                    result = deflate(&stream, piece_flush);
+
+                    output_.commit(space_size - stream.avail_out);
+                    produced = produced || stream.avail_out != space_size;
+                }
+                while (stream.avail_out == 0 && result == Z_OK);
+
+                if (overflow || (result != Z_OK && result != Z_STREAM_END && result != Z_BUF_ERROR))
+                    break;
+
+                data_begin += piece;
+                data_size -= piece;
+                if (data_size == 0)
+                    break;
+            }
+        }
+
+        if (overflow)
+            production_failure("buffer limit reached");
+        else if (result != Z_OK && result != Z_STREAM_END && result != Z_BUF_ERROR)
+            production_failure("error "s + std::to_string(result));
+        else if (produced)
+            produced_data();
+    }
+//#####################################################################################################################
+    gzip_encoder::gzip_encoder(zlib_configuration config)
+        : zlib_encoder{zlib_format::gzip, config}
+    {
+    }
+//#####################################################################################################################
+    deflate_encoder::deflate_encoder(zlib_configuration config)
+        : zlib_encoder{zlib_format::deflate, config}
+    {
+    }
+//#####################################################################################################################
+}
@@ -0,0 +1,233 @@
+#include <attender/encoding/zstd.hpp>
+
+#ifdef ATTENDER_ENABLE_ZSTD
+
+#include <zstd.h>
+
+#include <algorithm>
+#include <stdexcept>
+#include <thread>
+
+using namespace std::string_literals;
+
+namespace attender
+{
+//#####################################################################################################################
+    zstd_configuration zstd_configuration::make_default()
+    {
+        auto threads = static_cast <int> (std::thread::hardware_concurrency());
+        if (threads == 0)
+            threads = 4;
+
+        // a libzstd built without multithreading only takes 0 workers.
+        auto bounds = ZSTD_cParam_getBounds(ZSTD_c_nbWorkers);
+        if (ZSTD_isError(bounds.error))
+            threads = 0;
+        else
+            threads = std::clamp(threads, bounds.lowerBound, bounds.upperBound);
+
+        return {
+            ZSTD_CLEVEL_DEFAULT,
+            threads,
+            false,
+            0
+        };
+    }
+//#####################################################################################################################
+    struct zstd_encoder::implementation
+    {
+        ZSTD_CCtx* ctx;
+
+        implementation(zstd_configuration const& config);
+        ~implementation();
+    };
+//---------------------------------------------------------------------------------------------------------------------
+    zstd_encoder::implementation::implementation(zstd_configuration const& config)
+        : ctx{ZSTD_createCCtx()}
+    {
+        if (ctx == nullptr)
+            throw std::bad_alloc{};
+
+        auto set = [this](ZSTD_cParameter parameter, int value) {
+            if (ZSTD_isError(ZSTD_CCtx_setParameter(ctx, parameter, value)))
+            {
+                ZSTD_freeCCtx(ctx);
+                throw std::invalid_argument("invalid zstd configuration");
+            }
+        };
+
+        set(ZSTD_c_compressionLevel, config.level);
+        // fails if libzstd was built without multithreading, the default configuration asks for none then.
+        if (config.workers > 0)
+            set(ZSTD_c_nbWorkers, config.workers);
+        if (config.long_distance_matching)
+            set(ZSTD_c_enableLongDistanceMatching, 1);
+        if (config.job_size != 0)
+            set(ZSTD_c_jobSize, static_cast <int> (config.job_size));
+    }
+//---------------------------------------------------------------------------------------------------------------------
+    zstd_encoder::implementation::~implementation()
+    {
+        ZSTD_freeCCtx(ctx);
+    }
+//#####################################################################################################################
+    zstd_encoder::zstd_encoder(zstd_configuration config)
+        : zctx_{new zstd_encoder::implementation(config)}
+        , output_{ZSTD_CStreamOutSize()}
+        , staging_(ZSTD_CStreamOutSize())
+        , completed_{false}
+        , buffer_saver_{}
+    {
+    }
+//---------------------------------------------------------------------------------------------------------------------
+    zstd_encoder::~zstd_encoder() = default;
+//---------------------------------------------------------------------------------------------------------------------
+    std::string zstd_encoder::encoding() const
+    {
+        return "zstd";
+    }
+//---------------------------------------------------------------------------------------------------------------------
+    void zstd_encoder::set_minimum_avail(std::size_t min_avail)
+    {
+        std::lock_guard <std::recursive_mutex> guard{buffer_saver_};
+        output_.set_segment_size(min_avail);
+    }
+//---------------------------------------------------------------------------------------------------------------------
+    void zstd_encoder::set_buffer_limit(std::size_t limit)
+    {
+        std::lock_guard <std::recursive_mutex> guard{buffer_saver_};
+        output_.set_limit(limit);
+    }
+//---------------------------------------------------------------------------------------------------------------------
+    void zstd_encoder::reset()
+    {
+        std::lock_guard <std::recursive_mutex> guard{buffer_saver_};
+        ZSTD_CCtx_reset(zctx_->ctx, ZSTD_reset_session_only);
+        output_.clear();
+        completed_.store(false);
+    }
+//---------------------------------------------------------------------------------------------------------------------
+    std::size_t zstd_encoder::available() const
+    {
+        std::lock_guard <std::recursive_mutex> guard{buffer_saver_};
+        return output_.front().size();
+    }
+//---------------------------------------------------------------------------------------------------------------------
+    std::size_t zstd_encoder::buffered() const
+    {
+        std::lock_guard <std::recursive_mutex> guard{buffer_saver_};
+        return output_.size();
+    }
+//---------------------------------------------------------------------------------------------------------------------
+    char const* zstd_encoder::data() const
+    {
+        return output_.front().data();
+    }
+//---------------------------------------------------------------------------------------------------------------------
+    bool zstd_encoder::complete() const
+    {
+        // the stream is only complete once the consumer took everything.
+        std::lock_guard <std::recursive_mutex> guard{buffer_saver_};
+        return completed_.load() && output_.empty();
+    }
+//---------------------------------------------------------------------------------------------------------------------
+    void zstd_encoder::has_consumed(std::size_t size)
+    {
+        if (size > 0)
+        {
+            std::lock_guard <std::recursive_mutex> guard{buffer_saver_};
+            output_.consume(size);
+        }
+        producer::has_consumed(size);
+        if (consuming_.load() == false && completed_.load())
+            produced_data();
+    }
+//---------------------------------------------------------------------------------------------------------------------
+    void zstd_encoder::on_error(boost::system::error_code)
+    {
+    }
+//---------------------------------------------------------------------------------------------------------------------
+    void zstd_encoder::start_production()
+    {
+        if (available() > 0)
+            produced_data();
+    }
+//---------------------------------------------------------------------------------------------------------------------
+    void zstd_encoder::for_each_available(std::function <void(char const*, std::size_t)> const& fn) const
+    {
+        std::lock_guard <std::recursive_mutex> guard{buffer_saver_};
+        output_.for_each([&fn](std::string_view span) {
+            fn(span.data(), span.size());
+        });
+    }
+//---------------------------------------------------------------------------------------------------------------------
+    void zstd_encoder::buffer_locked_do(std::function <void()> const& fn) const
+    {
+        std::lock_guard <std::recursive_mutex> guard(buffer_saver_);
+        fn();
+    }
+//---------------------------------------------------------------------------------------------------------------------
+    void zstd_encoder::push(char const* data_begin, std::size_t data_size)
+    {
+        compress(data_begin, data_size, ZSTD_e_continue);
+    }
+//---------------------------------------------------------------------------------------------------------------------
+    void zstd_encoder::push(std::string const& data)
+    {
+        push(data.data(), data.size());
+    }
+//---------------------------------------------------------------------------------------------------------------------
+    void zstd_encoder::flush()
+    {
+        compress(nullptr, 0, ZSTD_e_flush);
+    }
+//---------------------------------------------------------------------------------------------------------------------
+    void zstd_encoder::finish()
+    {
+        compress(nullptr, 0, ZSTD_e_end);
+        completed_.store(true);
+        produced_data();
+    }
+//---------------------------------------------------------------------------------------------------------------------
+    void zstd_encoder::compress(char const* data_begin, std::size_t data_size, int directive)
+    {
+        ZSTD_inBuffer input{data_begin, data_size, 0};
+        bool produced = false;
+        bool overflow = false;
+        std::size_t result = 0;
+        for (;;)
+        {
+            ZSTD_outBuffer output{staging_.data(), staging_.size(), 0};
+
+            // with workers, continue only hands the input over and collects what the workers finished so far.
+            // flush and end wait for the workers, so this runs outside of the buffer lock that the consumer takes.
+            result = ZSTD_compressStream2(zctx_->ctx, &output, &input, static_cast <ZSTD_EndDirective> (directive));
+
+            if (output.pos != 0)
+            {
+                std::lock_guard <std::recursive_mutex> guard(buffer_saver_);
+                if (output_.append(staging_.data(), output.pos) != output.pos)
+                {
+                    overflow = true;
+                    break;
+                }
+                produced = true;
+            }
+
+            if (ZSTD_isError(result))
+                break;
+            if (directive == ZSTD_e_continue ? input.pos == input.size : result == 0)
+                break;
+        }
+
+        if (overflow)
+            production_failure("buffer limit reached");
+        else if (ZSTD_isError(result))
+            production_failure("error "s + ZSTD_getErrorName(result));
+        else if (produced)
+            produced_data();
+    }
+//#####################################################################################################################
+}
+
+#endif // ATTENDER_ENABLE_ZSTD
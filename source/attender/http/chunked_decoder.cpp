@@ -0,0 +1,207 @@
+#include <attender/http/chunked_decoder.hpp>
+#include <attender/http/http_read_sink.hpp>
+#include <attender/net_core.hpp>
+
+#include <algorithm>
+#include <limits>
+
+namespace attender
+{
+    namespace
+    {
+        int hex_value(char c)
+        {
+            if (c >= '0' && c <= '9')
+                return c - '0';
+            if (c >= 'a' && c <= 'f')
+                return c - 'a' + 10;
+            if (c >= 'A' && c <= 'F')
+                return c - 'A' + 10;
+            return -1;
+        }
+    }
+//#####################################################################################################################
+    chunked_decoder::chunked_decoder()
+        : state_{state::size}
+        , max_{0}
+        , chunk_remaining_{0}
+        , size_digits_{0}
+        , line_length_{0}
+        , trailer_line_{}
+        , trailers_{}
+    {
+    }
+//---------------------------------------------------------------------------------------------------------------------
+    void chunked_decoder::reset(size_type max)
+    {
+        state_ = state::size;
+        max_ = max;
+        chunk_remaining_ = 0;
+        size_digits_ = 0;
+        line_length_ = 0;
+        trailer_line_.clear();
+        trailers_.clear();
+    }
+//---------------------------------------------------------------------------------------------------------------------
+    std::unordered_map <std::string, std::string> const& chunked_decoder::get_trailers() const
+    {
+        return trailers_;
+    }
+//---------------------------------------------------------------------------------------------------------------------
+    bool chunked_decoder::add_trailer()
+    {
+        auto colon = trailer_line_.find(':');
+        if (colon == std::string::npos || colon == 0 || trailers_.size() + 1u > config::header_field_max)
+            return false;
+
+        auto value_begin = trailer_line_.find_first_not_of(" \t", colon + 1);
+        auto value_end = trailer_line_.find_last_not_of(" \t");
+        std::string value;
+        if (value_begin != std::string::npos)
+            value = trailer_line_.substr(value_begin, value_end - value_begin + 1);
+
+        trailers_[trailer_line_.substr(0, colon)] = std::move(value);
+        trailer_line_.clear();
+        return true;
+    }
+//---------------------------------------------------------------------------------------------------------------------
+    chunked_decoder::result chunked_decoder::feed(char const* data, size_type size, http_read_sink& sink)
+    {
+        constexpr auto size_limit = std::numeric_limits <size_type>::max() >> 4;
+
+        auto fail = [this]() {
+            state_ = state::failed;
+            return result::malformed;
+        };
+
+        for (size_type i = 0; i < size;)
+        {
+            switch (state_)
+            {
+                case state::size:
+                {
+                    auto digit = hex_value(data[i]);
+                    if (digit >= 0)
+                    {
+                        if (chunk_remaining_ > size_limit)
+                            return fail();
+                        chunk_remaining_ = (chunk_remaining_ << 4) | static_cast <size_type> (digit);
+                        ++size_digits_;
+                    }
+                    else if (size_digits_ == 0)
+                        return fail();
+                    else if (data[i] == '\r')
+                        state_ = state::size_lf;
+                    else if (data[i] == ';' || data[i] == ' ' || data[i] == '\t')
+                        state_ = state::extension;
+                    else
+                        return fail();
+                    ++i;
+                    break;
+                }
+                case state::extension:
+                {
+                    // extensions are not interpreted, but must not grow without bounds.
+                    auto end = std::find(data + i, data + size, '\r');
+                    line_length_ += static_cast <size_type> (end - (data + i));
+                    if (line_length_ > config::header_buffer_max)
+                        return fail();
+                    i = static_cast <size_type> (end - data);
+                    if (i < size)
+                    {
+                        state_ = state::size_lf;
+                        ++i;
+                    }
+                    break;
+                }
+                case state::size_lf:
+                {
+                    if (data[i] != '\n')
+                        return fail();
+                    ++i;
+                    size_digits_ = 0;
+                    line_length_ = 0;
+                    state_ = chunk_remaining_ == 0 ? state::trailer : state::data;
+                    break;
+                }
+                case state::data:
+                {
+                    auto slice = std::min(chunk_remaining_, size - i);
+                    if (max_ != 0)
+                    {
+                        auto written = sink.get_total_bytes_written();
+                        if (written >= max_)
+                            return result::limit_reached;
+                        slice = std::min(slice, max_ - written);
+                    }
+
+                    sink.write(data + i, slice);
+                    i += slice;
+                    chunk_remaining_ -= slice;
+
+                    if (chunk_remaining_ == 0)
+                        state_ = state::data_cr;
+                    else if (max_ != 0 && sink.get_total_bytes_written() >= max_)
+                        return result::limit_reached;
+                    break;
+                }
+                case state::data_cr:
+                {
+                    if (data[i] != '\r')
+                        return fail();
+                    ++i;
+                    state_ = state::data_lf;
+                    break;
+                }
+                case state::data_lf:
+                {
+                    if (data[i] != '\n')
+                        return fail();
+                    ++i;
+                    state_ = state::size;
+                    break;
+                }
+                case state::trailer:
+                {
+                    auto end = std::find(data + i, data + size, '\r');
+                    trailer_line_.append(data + i, end);
+                    if (trailer_line_.size() > config::header_buffer_max)
+                        return fail();
+                    i = static_cast <size_type> (end - data);
+                    if (i < size)
+                    {
+                        state_ = state::trailer_lf;
+                        ++i;
+                    }
+                    break;
+                }
+                case state::trailer_lf:
+                {
+                    if (data[i] != '\n')
+                        return fail();
+                    ++i;
+                    if (trailer_line_.empty())
+                    {
+                        state_ = state::done;
+                        return result::finished;
+                    }
+                    if (!add_trailer())
+                        return fail();
+                    state_ = state::trailer;
+                    break;
+                }
+                case state::done:
+                    return result::finished;
+                case state::failed:
+                    return result::malformed;
+            }
+        }
+
+        if (state_ == state::done)
+            return result::finished;
+        if (state_ == state::failed)
+            return result::malformed;
+        return result::need_more;
+    }
+//#####################################################################################################################
+}
@@ -1,5 +1,6 @@
 #include <attender/http/connection_manager.hpp>
 #include <attender/http/http_connection.hpp>
+#include <attender/http/response.hpp>
 
 #include <stdexcept>
 
@@ -16,11 +17,50 @@ namespace attender
     void connection_manager::remove(http_connection_interface* connection)
     {
         std::lock_guard <std::mutex> guard (connectionsLock_);
+
+        auto held = holds_.find(connection);
+        if (held != holds_.end())
+        {
+            // the holder still uses the handlers, they must see that the connection is gone.
+            if (!held->second.removed)
+            {
+                held->second.removed = true;
+                connection->stop();
+                connection->get_response_handler().observe_conclusion()->has_died();
+            }
+            return;
+        }
+
         if (connections_.erase(connection) != 0)
             free_connection(connection);
         else
             throw std::logic_error("connection was already freed");
     }
+//---------------------------------------------------------------------------------------------------------------------
+    void connection_manager::hold(http_connection_interface* connection)
+    {
+        std::lock_guard <std::mutex> guard (connectionsLock_);
+        ++holds_[connection].count;
+    }
+//---------------------------------------------------------------------------------------------------------------------
+    void connection_manager::release(http_connection_interface* connection)
+    {
+        std::lock_guard <std::mutex> guard (connectionsLock_);
+
+        auto held = holds_.find(connection);
+        if (held == holds_.end() || --held->second.count != 0)
+            return;
+
+        auto removed = held->second.removed;
+        holds_.erase(held);
+        if (removed)
+        {
+            // completions of the aborted operations may still be queued, they run before this.
+            boost::asio::post(connection->get_socket()->get_executor(), [this, connection]{
+                remove(connection);
+            });
+        }
+    }
 //---------------------------------------------------------------------------------------------------------------------
     void connection_manager::clear()
     {
@@ -29,6 +69,7 @@ namespace attender
         for (auto& c : connections_)
             free_connection(c);
         connections_.clear();
+        holds_.clear();
     }
 //---------------------------------------------------------------------------------------------------------------------
     connection_manager::~connection_manager()
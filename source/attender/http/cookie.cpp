@@ -1,7 +1,7 @@
 #include <attender/http/cookie.hpp>
 
 #include <boost/algorithm/string.hpp>
-#include <sstream>
+#include <charconv>
 
 
 namespace attender {
@@ -109,25 +109,35 @@ uint64_t cookie::get_max_age() const { return max_age_; }
 std::string cookie::get_same_site() const { return same_site_; }
 //---------------------------------------------------------------------------------------------------------------------
 std::string cookie::to_set_cookie_string() const {
-  std::stringstream sstr;
-  sstr << name_ << "=" << value_;
+  std::string result;
+  append_set_cookie_string(result);
+  return result;
+}
+//---------------------------------------------------------------------------------------------------------------------
+void cookie::append_set_cookie_string(std::string &out) const {
+  out.append(name_).append(1, '=').append(value_);
 
   if (!domain_.empty())
-    sstr << "; Domain=" << domain_;
+    out.append("; Domain=").append(domain_);
   if (!path_.empty())
-    sstr << "; Path=" << path_;
+    out.append("; Path=").append(path_);
   if (!same_site_.empty())
-    sstr << "; SameSite=" << same_site_;
-  if (max_age_ > 0)
-    sstr << "; Max-Age=" << max_age_;
-  if (expires_)
-    sstr << "; Expires=" << expires_.get().to_gmt_string();
+    out.append("; SameSite=").append(same_site_);
+  if (max_age_ > 0) {
+    char buffer[24];
+    auto [end, ec] = std::to_chars(buffer, buffer + sizeof(buffer), max_age_);
+    out.append("; Max-Age=").append(buffer, end);
+  }
+  if (expires_) {
+    out.append("; Expires=");
+    auto offset = out.size();
+    out.resize(offset + date::gmt_string_length);
+    expires_.get().write_gmt_string(out.data() + offset);
+  }
   if (secure_)
-    sstr << "; Secure";
+    out.append("; Secure");
   if (http_only_)
-    sstr << "; HttpOnly";
-
-  return sstr.str();
+    out.append("; HttpOnly");
 }
 //#####################################################################################################################
 } // namespace attender
@@ -0,0 +1,248 @@
+#include <attender/http/header_fields.hpp>
+
+#include <algorithm>
+#include <array>
+
+namespace attender
+{
+    namespace
+    {
+        constexpr std::array <std::string_view, 24> known_names = {
+            "Content-Type",
+            "Content-Length",
+            "Content-Encoding",
+            "Transfer-Encoding",
+            "Date",
+            "Connection",
+            "Cache-Control",
+            "Location",
+            "Server",
+            "Vary",
+            "ETag",
+            "Last-Modified",
+            "Expires",
+            "Accept-Ranges",
+            "Content-Range",
+            "Content-Disposition",
+            "Allow",
+            "Keep-Alive",
+            "Link",
+            "WWW-Authenticate",
+            "Access-Control-Allow-Origin",
+            "Access-Control-Allow-Methods",
+            "Access-Control-Allow-Headers",
+            "Access-Control-Allow-Credentials"
+        };
+
+        char ascii_lower(char c) noexcept
+        {
+            return (c >= 'A' && c <= 'Z') ? static_cast <char> (c - 'A' + 'a') : c;
+        }
+
+        /**
+         *  Field names are ascii tokens, no locale needed.
+         */
+        bool equal_ignore_case(std::string_view lhs, std::string_view rhs) noexcept
+        {
+            if (lhs.size() != rhs.size())
+                return false;
+            for (std::size_t i = 0; i != lhs.size(); ++i)
+                if (ascii_lower(lhs[i]) != ascii_lower(rhs[i]))
+                    return false;
+            return true;
+        }
+    }
+//#####################################################################################################################
+    header_fields::header_fields()
+        : entries_{}
+        , text_{}
+        , garbage_{0}
+    {
+    }
+//---------------------------------------------------------------------------------------------------------------------
+    std::uint16_t header_fields::intern(std::string_view name) noexcept
+    {
+        for (std::size_t i = 0; i != known_names.size(); ++i)
+        {
+            if (equal_ignore_case(known_names[i], name))
+                return static_cast <std::uint16_t> (i);
+        }
+        return unknown;
+    }
+//---------------------------------------------------------------------------------------------------------------------
+    bool header_fields::matches(entry const& e, std::uint16_t known, std::string_view name) const noexcept
+    {
+        if (known != unknown || e.known != unknown)
+            return known == e.known;
+        return equal_ignore_case(name_of(e), name);
+    }
+//---------------------------------------------------------------------------------------------------------------------
+    std::string_view header_fields::name_of(entry const& e) const noexcept
+    {
+        if (e.known != unknown)
+            return known_names[e.known];
+        return {text_.data() + e.name_offset, e.name_length};
+    }
+//---------------------------------------------------------------------------------------------------------------------
+    std::string_view header_fields::value_of(entry const& e) const noexcept
+    {
+        return {text_.data() + e.value_offset, e.value_length};
+    }
+//---------------------------------------------------------------------------------------------------------------------
+    std::uint32_t header_fields::store(std::string_view text)
+    {
+        auto offset = static_cast <std::uint32_t> (text_.size());
+
+        // views from for_each point into the buffer, which might move while inserting.
+        if (text.data() >= text_.data() && text.data() < text_.data() + text_.size())
+        {
+            std::string copy{text};
+            text_.insert(text_.end(), copy.begin(), copy.end());
+        }
+        else
+            text_.insert(text_.end(), text.begin(), text.end());
+        return offset;
+    }
+//---------------------------------------------------------------------------------------------------------------------
+    void header_fields::push(std::uint16_t known, std::string_view name, std::string_view value)
+    {
+        entry e{0, 0, 0, static_cast <std::uint32_t> (value.size()), known};
+        if (known == unknown)
+        {
+            e.name_offset = store(name);
+            e.name_length = static_cast <std::uint32_t> (name.size());
+        }
+        e.value_offset = store(value);
+        entries_.push_back(e);
+    }
+//---------------------------------------------------------------------------------------------------------------------
+    void header_fields::set(std::string_view name, std::string_view value)
+    {
+        auto known = intern(name);
+        auto first = std::find_if(entries_.begin(), entries_.end(), [&](entry const& e) {
+            return matches(e, known, name);
+        });
+
+        if (first == entries_.end())
+            return push(known, name, value);
+
+        garbage_ += first->value_length;
+        first->value_offset = store(value);
+        first->value_length = static_cast <std::uint32_t> (value.size());
+
+        // remove further lines of the same field.
+        auto rest = std::remove_if(first + 1, entries_.end(), [&](entry const& e) {
+            if (!matches(e, known, name))
+                return false;
+            garbage_ += e.name_length + e.value_length;
+            return true;
+        });
+        entries_.erase(rest, entries_.end());
+
+        if (garbage_ > 128 && garbage_ * 2 > text_.size())
+            compact();
+    }
+//---------------------------------------------------------------------------------------------------------------------
+    void header_fields::add(std::string_view name, std::string_view value)
+    {
+        push(intern(name), name, value);
+    }
+//---------------------------------------------------------------------------------------------------------------------
+    bool header_fields::try_set(std::string_view name, std::string_view value)
+    {
+        auto known = intern(name);
+        for (auto const& e : entries_)
+            if (matches(e, known, name))
+                return false;
+        push(known, name, value);
+        return true;
+    }
+//---------------------------------------------------------------------------------------------------------------------
+    std::size_t header_fields::erase(std::string_view name)
+    {
+        auto known = intern(name);
+        auto rest = std::remove_if(entries_.begin(), entries_.end(), [&](entry const& e) {
+            if (!matches(e, known, name))
+                return false;
+            garbage_ += e.name_length + e.value_length;
+            return true;
+        });
+        auto removed = static_cast <std::size_t> (entries_.end() - rest);
+        entries_.erase(rest, entries_.end());
+
+        if (garbage_ > 128 && garbage_ * 2 > text_.size())
+            compact();
+        return removed;
+    }
+//---------------------------------------------------------------------------------------------------------------------
+    bool header_fields::contains(std::string_view name) const
+    {
+        auto known = intern(name);
+        for (auto const& e : entries_)
+            if (matches(e, known, name))
+                return true;
+        return false;
+    }
+//---------------------------------------------------------------------------------------------------------------------
+    boost::optional <std::string> header_fields::get(std::string_view name) const
+    {
+        auto known = intern(name);
+        boost::optional <std::string> result;
+        for (auto const& e : entries_)
+        {
+            if (!matches(e, known, name))
+                continue;
+
+            if (!result)
+                result.emplace(value_of(e));
+            else
+                result->append(", ").append(value_of(e));
+        }
+        return result;
+    }
+//---------------------------------------------------------------------------------------------------------------------
+    std::size_t header_fields::size() const noexcept
+    {
+        return entries_.size();
+    }
+//---------------------------------------------------------------------------------------------------------------------
+    bool header_fields::empty() const noexcept
+    {
+        return entries_.empty();
+    }
+//---------------------------------------------------------------------------------------------------------------------
+    std::size_t header_fields::serialized_size() const noexcept
+    {
+        std::size_t size = 0;
+        for (auto const& e : entries_)
+            size += name_of(e).size() + e.value_length + 4;
+        return size;
+    }
+//---------------------------------------------------------------------------------------------------------------------
+    void header_fields::append_to(std::string& out) const
+    {
+        for (auto const& e : entries_)
+            out.append(name_of(e)).append(": ").append(value_of(e)).append("\r\n");
+    }
+//---------------------------------------------------------------------------------------------------------------------
+    void header_fields::compact()
+    {
+        decltype(text_) compacted;
+        compacted.reserve(text_.size() - garbage_);
+        for (auto& e : entries_)
+        {
+            if (e.known == unknown)
+            {
+                auto name_offset = static_cast <std::uint32_t> (compacted.size());
+                compacted.insert(compacted.end(), text_.begin() + e.name_offset, text_.begin() + e.name_offset + e.name_length);
+                e.name_offset = name_offset;
+            }
+            auto value_offset = static_cast <std::uint32_t> (compacted.size());
+            compacted.insert(compacted.end(), text_.begin() + e.value_offset, text_.begin() + e.value_offset + e.value_length);
+            e.value_offset = value_offset;
+        }
+        text_ = std::move(compacted);
+        garbage_ = 0;
+    }
+//#####################################################################################################################
+}
@@ -1,10 +1,45 @@
 #include <attender/http/http_basic_server.hpp>
 #include <attender/http/response.hpp>
+#include <attender/http/http_task.hpp>
 
 #include <iostream>
+#include <stdexcept>
+#include <thread>
+#include <utility>
 
 namespace attender
 {
+//#####################################################################################################################
+    /**
+     *  Makes a regular route callback that starts the coroutine.
+     */
+    static connected_callback spawn_coroutine(coroutine_callback const& on_connect)
+    {
+        return [on_connect](request_handler* req, response_handler* res) {
+            on_connect(req, res).start(res);
+        };
+    }
+//---------------------------------------------------------------------------------------------------------------------
+    /**
+     *  Wraps the continuation of an asynchronous step of the session handling. It runs right away when the step
+     *  completes on an io thread or on the thread that started it, otherwise it is posted to the io_service.
+     *  It is dropped if the connection is gone.
+     */
+    template <typename FunctionT>
+    static auto resume_on_io(http_basic_server* server, response_handler* res, FunctionT continuation)
+    {
+        return [server, observer = res->observe_conclusion(), initiator = std::this_thread::get_id(), continuation = std::move(continuation)](auto... args) {
+            if (!observer->is_alive())
+                return;
+            if (std::this_thread::get_id() == initiator || server->running_in_io_thread())
+                return continuation(args...);
+
+            asio::post(*server->get_io_service(), [observer, continuation, args...]{
+                if (observer->is_alive())
+                    continuation(args...);
+            });
+        };
+    }
 //#####################################################################################################################
     http_basic_server::http_basic_server(asio::io_service* service,
                            error_callback on_error,
@@ -15,6 +50,12 @@ namespace attender
         , connections_{}
         , router_{}
         , settings_{std::move(setting)}
+        , file_io_created_{}
+        , file_io_{}
+        , worker_pool_created_{}
+        , worker_pool_{}
+        , task_scheduler_created_{}
+        , task_scheduler_{}
         , on_error_{std::move(on_error)}
     {
     }
@@ -28,6 +69,35 @@ namespace attender
     {
         return &connections_;
     }
+//---------------------------------------------------------------------------------------------------------------------
+    file_io_service* http_basic_server::get_file_io()
+    {
+        std::call_once(file_io_created_, [this]{
+            file_io_ = file_io_service::create(service_, settings_.file_io);
+        });
+        return file_io_.get();
+    }
+//---------------------------------------------------------------------------------------------------------------------
+    worker_pool* http_basic_server::get_worker_pool()
+    {
+        std::call_once(worker_pool_created_, [this]{
+            worker_pool_ = std::make_unique <worker_pool> (settings_.offload);
+        });
+        return worker_pool_.get();
+    }
+//---------------------------------------------------------------------------------------------------------------------
+    task_scheduler* http_basic_server::get_task_scheduler()
+    {
+        std::call_once(task_scheduler_created_, [this]{
+            task_scheduler_ = std::make_unique <task_scheduler> (settings_.tasks);
+        });
+        return task_scheduler_.get();
+    }
+//---------------------------------------------------------------------------------------------------------------------
+    asio::io_service* http_basic_server::get_io_service()
+    {
+        return service_;
+    }
 //---------------------------------------------------------------------------------------------------------------------
     boost::asio::ip::tcp::endpoint http_basic_server::get_local_endpoint() const
     {
@@ -65,8 +135,14 @@ namespace attender
     )
     {
         sessionControl_.id_cookie_key = controlParam.id_cookie_key;
-        sessionControl_.sessions = std::make_shared <session_manager>(std::move(controlParam.session_storage));
-        sessionControl_.authorizer = std::shared_ptr <authorizer_interface>(controlParam.authorizer.release());
+        if (controlParam.async_session_storage)
+            sessionControl_.sessions = std::make_shared <session_manager>(std::move(controlParam.async_session_storage));
+        else
+            sessionControl_.sessions = std::make_shared <session_manager>(std::move(controlParam.session_storage));
+        if (controlParam.async_authorizer)
+            sessionControl_.authorizer = std::move(controlParam.async_authorizer);
+        else if (controlParam.authorizer)
+            sessionControl_.authorizer = std::make_shared <sync_authorizer_adapter>(std::shared_ptr <authorizer_interface>(controlParam.authorizer.release()));
         sessionControl_.authorization_conditioner = controlParam.authorization_conditioner;
         router_.add_session_manager(sessionControl_.sessions, sessionControl_.id_cookie_key);
         sessionControl_.allowOptionsUnauthorized = controlParam.allowOptionsUnauthorized;
@@ -88,129 +164,199 @@ namespace attender
     }
 //---------------------------------------------------------------------------------------------------------------------
     bool http_basic_server::authenticate_session(request_handler* req, response_handler* res)
+    {
+        // asynchronous ones would go on after this returned, and the caller would respond a second time.
+        if (!sessionControl_.sessions->is_synchronous() || !dynamic_cast <sync_authorizer_adapter*> (sessionControl_.authorizer.get()))
+            throw std::logic_error("the session storage or authorizer is asynchronous, use async_authenticate_session");
+
+        // completes before it returns.
+        bool proceed = false;
+        async_authenticate_session(req, res, [&proceed](bool result) {
+            proceed = result;
+        });
+        return proceed;
+    }
+//---------------------------------------------------------------------------------------------------------------------
+    void http_basic_server::async_authenticate_session(request_handler* req, response_handler* res, std::function <void(bool)> on_complete)
     {
         if (sessionControl_.authorization_conditioner)
             sessionControl_.authorization_conditioner(req, res);
 
         auto observer = res->observe_conclusion();
-        auto result = sessionControl_.authorizer->try_perform_authorization(req, res);
-        if (observer->has_concluded())
-            return false;
-
-        auto make_session = [this, res, req]()
+        auto on_authorized = [this, req, res, observer, on_complete = std::move(on_complete)](authorization_result result)
         {
-            auto id = sessionControl_.sessions->make_session();
-            cookie c = sessionControl_.cookie_base;
-            c.set_name(sessionControl_.id_cookie_key);
-            c.set_value(id);
-            c.set_path("/");
-            res->set_cookie(c);
-            req->patch_cookie(sessionControl_.id_cookie_key, id);
-            return true;
-        };
+            if (observer->has_concluded())
+                return on_complete(false);
 
-        switch (result)
-        {
-            case(authorization_result::denied):
+            auto make_session = [this, req, res, on_complete](std::function <void()> on_made)
             {
-                if (!observer->has_concluded())
-                    res->status(401).end();
-                return false;
-            }
-            case(authorization_result::negotiate):
-            {
-                sessionControl_.authorizer->negotiate_authorization_method(req, res);
-                return false;
-            }
-            case(authorization_result::allowed_continue):
-            {
-                make_session();
-                return true;
-            }
-            case(authorization_result::allowed_but_stop):
-            {
-                make_session();
-                if (!observer->has_concluded())
-                    res->status(204).end();
-                return false;
-            }
-            case(authorization_result::bad_request):
-            {
-                if (!observer->has_concluded())
-                    res->status(400).end();
-                return false;
-            }
-            default:
+                sessionControl_.sessions->async_make_session(resume_on_io(this, res,
+                    [this, req, res, on_complete, on_made = std::move(on_made)](boost::system::error_code ec, std::string const& id)
+                    {
+                        if (ec)
+                        {
+                            res->send_status(503);
+                            return on_complete(false);
+                        }
+
+                        cookie c = sessionControl_.cookie_base;
+                        c.set_name(sessionControl_.id_cookie_key);
+                        c.set_value(id);
+                        c.set_path("/");
+                        res->set_cookie(c);
+                        req->patch_cookie(sessionControl_.id_cookie_key, id);
+                        on_made();
+                    }
+                ));
+            };
+
+            switch (result)
             {
-                res->end();
-                return false;
+                case(authorization_result::denied):
+                {
+                    if (!observer->has_concluded())
+                        res->status(401).end();
+                    return on_complete(false);
+                }
+                case(authorization_result::negotiate):
+                {
+                    sessionControl_.authorizer->negotiate_authorization_method(req, res);
+                    return on_complete(false);
+                }
+                case(authorization_result::allowed_continue):
+                {
+                    return make_session([on_complete]{
+                        on_complete(true);
+                    });
+                }
+                case(authorization_result::allowed_but_stop):
+                {
+                    return make_session([res, observer, on_complete]{
+                        if (!observer->has_concluded())
+                            res->status(204).end();
+                        on_complete(false);
+                    });
+                }
+                case(authorization_result::bad_request):
+                {
+                    if (!observer->has_concluded())
+                        res->status(400).end();
+                    return on_complete(false);
+                }
+                default:
+                {
+                    res->end();
+                    return on_complete(false);
+                }
             }
-        }
+        };
+
+        sessionControl_.authorizer->async_perform_authorization(req, res, resume_on_io(this, res, std::move(on_authorized)));
     }
 //---------------------------------------------------------------------------------------------------------------------
-    bool http_basic_server::handle_session(request_handler* req, response_handler* res)
+    void http_basic_server::handle_session(request_handler* req, response_handler* res, std::function <void(bool)> on_complete)
     {
         if (!sessionControl_.sessions)
-            return true;
+            return on_complete(true);
+
+        auto on_loaded = [this, req, res, on_complete = std::move(on_complete)](boost::system::error_code ec, session_state state)
+        {
+            if (ec)
+            {
+                res->send_status(503);
+                return on_complete(false);
+            }
 
-        auto state = sessionControl_.sessions->load_session <attender::session>(sessionControl_.id_cookie_key, nullptr, req);
-        if (state == session_state::live)
-            return true;
+            if (state == session_state::live)
+                return on_complete(true);
 
-        if (sessionControl_.allowOptionsUnauthorized && req->method() == "OPTIONS")
-            return true;
+            if (sessionControl_.allowOptionsUnauthorized && req->method() == "OPTIONS")
+                return on_complete(true);
 
-        if (sessionControl_.disable_automatic_authentication)
-        {
-            if (req->path() != sessionControl_.authentication_path)
+            if (sessionControl_.disable_automatic_authentication)
             {
-                res->status(401).end();
-                return false;
+                if (req->path() != sessionControl_.authentication_path)
+                {
+                    res->status(401).end();
+                    return on_complete(false);
+                }
+                return on_complete(true);
             }
-            return true;
-        }
 
-        return authenticate_session(req, res);
+            async_authenticate_session(req, res, on_complete);
+        };
+
+        sessionControl_.sessions->async_load_session <attender::session>(
+            sessionControl_.id_cookie_key,
+            nullptr,
+            req,
+            resume_on_io(this, res, std::move(on_loaded))
+        );
+    }
+//---------------------------------------------------------------------------------------------------------------------
+    void http_basic_server::get(std::string const& path_template, connected_callback const& on_connect, route_options const& options)
+    {
+        router_.add_route("GET", path_template, bind_route(on_connect, options));
+    }
+//---------------------------------------------------------------------------------------------------------------------
+    void http_basic_server::put(std::string const& path_template, connected_callback const& on_connect, route_options const& options)
+    {
+        router_.add_route("PUT", path_template, bind_route(on_connect, options));
+    }
+//---------------------------------------------------------------------------------------------------------------------
+    void http_basic_server::post(std::string const& path_template, connected_callback const& on_connect, route_options const& options)
+    {
+        router_.add_route("POST", path_template, bind_route(on_connect, options));
+    }
+//---------------------------------------------------------------------------------------------------------------------
+    void http_basic_server::head(std::string const& path_template, connected_callback const& on_connect, route_options const& options)
+    {
+        router_.add_route("HEAD", path_template, bind_route(on_connect, options));
+    }
+//---------------------------------------------------------------------------------------------------------------------
+    void http_basic_server::delete_(std::string const& path_template, connected_callback const& on_connect, route_options const& options)
+    {
+        router_.add_route("DELETE", path_template, bind_route(on_connect, options));
     }
 //---------------------------------------------------------------------------------------------------------------------
-    void http_basic_server::get(std::string const& path_template, connected_callback const& on_connect)
+    void http_basic_server::options(std::string const& path_template, connected_callback const& on_connect, route_options const& options)
     {
-        router_.add_route("GET", path_template, on_connect);
+        router_.add_route("OPTIONS", path_template, bind_route(on_connect, options));
     }
 //---------------------------------------------------------------------------------------------------------------------
-    void http_basic_server::put(std::string const& path_template, connected_callback const& on_connect)
+    void http_basic_server::connect(std::string const& path_template, connected_callback const& on_connect, route_options const& options)
     {
-        router_.add_route("PUT", path_template, on_connect);
+        router_.add_route("CONNECT", path_template, bind_route(on_connect, options));
     }
 //---------------------------------------------------------------------------------------------------------------------
-    void http_basic_server::post(std::string const& path_template, connected_callback const& on_connect)
+    void http_basic_server::route(std::string const& route_name, std::string const& path_template, connected_callback const& on_connect, route_options const& options)
     {
-        router_.add_route("POST", path_template, on_connect);
+        router_.add_route(route_name, path_template, bind_route(on_connect, options));
     }
 //---------------------------------------------------------------------------------------------------------------------
-    void http_basic_server::head(std::string const& path_template, connected_callback const& on_connect)
+    void http_basic_server::get_co(std::string const& path_template, coroutine_callback const& on_connect)
     {
-        router_.add_route("HEAD", path_template, on_connect);
+        router_.add_route("GET", path_template, spawn_coroutine(on_connect));
     }
 //---------------------------------------------------------------------------------------------------------------------
-    void http_basic_server::delete_(std::string const& path_template, connected_callback const& on_connect)
+    void http_basic_server::put_co(std::string const& path_template, coroutine_callback const& on_connect)
     {
-        router_.add_route("DELETE", path_template, on_connect);
+        router_.add_route("PUT", path_template, spawn_coroutine(on_connect));
     }
 //---------------------------------------------------------------------------------------------------------------------
-    void http_basic_server::options(std::string const& path_template, connected_callback const& on_connect)
+    void http_basic_server::post_co(std::string const& path_template, coroutine_callback const& on_connect)
     {
-        router_.add_route("OPTIONS", path_template, on_connect);
+        router_.add_route("POST", path_template, spawn_coroutine(on_connect));
     }
 //---------------------------------------------------------------------------------------------------------------------
-    void http_basic_server::connect(std::string const& path_template, connected_callback const& on_connect)
+    void http_basic_server::delete_co(std::string const& path_template, coroutine_callback const& on_connect)
     {
-        router_.add_route("CONNECT", path_template, on_connect);
+        router_.add_route("DELETE", path_template, spawn_coroutine(on_connect));
     }
 //---------------------------------------------------------------------------------------------------------------------
-    void http_basic_server::route(std::string const& route_name, std::string const& path_template, connected_callback const& on_connect)
+    void http_basic_server::route_co(std::string const& route_name, std::string const& path_template, coroutine_callback const& on_connect)
     {
-        router_.add_route(route_name, path_template, on_connect);
+        router_.add_route(route_name, path_template, spawn_coroutine(on_connect));
     }
 //---------------------------------------------------------------------------------------------------------------------
     void http_basic_server::mount(
@@ -253,24 +399,15 @@ namespace attender
         if (maybeRoute)
         {
             req->set_parameters(maybeRoute.get().get_path_parameters(req->get_header().get_path()));
-            if (handle_session(req, res))
-            {
-                try
-                {
-                    maybeRoute.get().get_callback()(req, res);
-                }
-                catch(std::exception const& exc)
-                {
-                    if (settings_.expose_exception)
-                        res->status(500).send(exc.what());
-                    else
-                        res->status(500).end();
-                }
-                catch(...)
-                {
-                    res->send_status(500);
-                }
-            }
+
+            if (!sessionControl_.sessions)
+                return invoke_route(maybeRoute.get().get_callback(), req, res);
+
+            // continues right away with synchronous session storages and authorizers.
+            handle_session(req, res, [this, req, res, on_connect = maybeRoute.get().get_callback()](bool proceed) {
+                if (proceed)
+                    invoke_route(on_connect, req, res);
+            });
         }
         else
         {
@@ -282,6 +419,69 @@ namespace attender
                 res->send_status(404);
         }
     }
+//---------------------------------------------------------------------------------------------------------------------
+    void http_basic_server::invoke_route(connected_callback const& on_connect, request_handler* req, response_handler* res)
+    {
+        try
+        {
+            on_connect(req, res);
+        }
+        catch(std::exception const& exc)
+        {
+            if (settings_.expose_exception)
+                res->status(500).send(exc.what());
+            else
+                res->status(500).end();
+        }
+        catch(...)
+        {
+            res->send_status(500);
+        }
+    }
+//---------------------------------------------------------------------------------------------------------------------
+    connected_callback http_basic_server::bind_route(connected_callback const& handler, route_options const& options)
+    {
+        auto on_connect = handler;
+        if (options.compression != compression_mode::inherit)
+        {
+            on_connect = [handler, mode = options.compression](request_handler* req, response_handler* res) {
+                res->compress(mode);
+                handler(req, res);
+            };
+        }
+
+        if (options.execution == execution_mode::io)
+            return on_connect;
+
+        return [this, on_connect](request_handler* req, response_handler* res) {
+            auto observer = res->observe_conclusion();
+
+            // req and res must outlive the handler, even if the connection is closed while it runs.
+            auto* connection = res->get_connection();
+            connections_.hold(connection);
+
+            auto accepted = get_worker_pool()->post([this, on_connect, req, res, observer, connection]{
+                // the connection might have timed out while the job was queued.
+                if (observer->is_alive())
+                {
+                    invoke_route(on_connect, req, res);
+
+                    // reads requested by the handler are issued on the io_context, now that the handler returned.
+                    asio::post(*service_, [req, observer]{
+                        if (observer->is_alive())
+                            req->issue_deferred_read();
+                    });
+                }
+                connections_.release(connection);
+            });
+
+            if (!accepted)
+            {
+                connections_.release(connection);
+                res->send_status(503);
+            }
+        };
+    }
 //---------------------------------------------------------------------------------------------------------------------
     void http_basic_server::mount(
         std::string const& root_path,
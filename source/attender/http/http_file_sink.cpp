@@ -0,0 +1,128 @@
+#include <attender/http/http_file_sink.hpp>
+#include <attender/http/http_connection_interface.hpp>
+#include <attender/http/http_server_interface.hpp>
+#include <attender/http/request.hpp>
+#include <attender/http/response.hpp>
+
+namespace attender
+{
+//#####################################################################################################################
+    http_file_sink::http_file_sink(request_handler* req, response_handler* res)
+        : req_{req}
+        , file_io_{res->get_connection()->get_parent()->get_file_io()}
+        , observer_{res->observe_conclusion()}
+        , file_{}
+        , lock_{}
+        , pending_{}
+        , in_flight_{}
+        , offset_{0}
+        , writing_{false}
+        , paused_{false}
+        , error_{}
+        , on_flushed_{}
+    {
+    }
+//---------------------------------------------------------------------------------------------------------------------
+    bool http_file_sink::open(std::string const& path)
+    {
+        return file_.open(path, async_file::mode::write);
+    }
+//---------------------------------------------------------------------------------------------------------------------
+    size_type http_file_sink::write(const char* data, size_type size)
+    {
+        written_bytes_ += size;
+
+        std::unique_lock <std::mutex> guard{lock_};
+        if (error_)
+            return size;
+
+        // the receive buffer is reused by the next read, so the data has to be copied.
+        pending_.insert(std::end(pending_), data, data + size);
+
+        if (!writing_)
+            start_write(guard);
+        else if (!paused_ && pending_.size() >= config::file_io_block_size)
+        {
+            paused_ = true;
+            guard.unlock();
+            req_->pause_read();
+        }
+        return size;
+    }
+//---------------------------------------------------------------------------------------------------------------------
+    size_type http_file_sink::write(std::vector <char> const& buffer, size_type amount)
+    {
+        return write(buffer.data(), std::min(buffer.size(), amount));
+    }
+//---------------------------------------------------------------------------------------------------------------------
+    void http_file_sink::flush(custom_callback const& on_flushed)
+    {
+        std::unique_lock <std::mutex> guard{lock_};
+        if (writing_)
+        {
+            on_flushed_ = on_flushed;
+            return;
+        }
+        auto ec = error_;
+        guard.unlock();
+        on_flushed(ec);
+    }
+//---------------------------------------------------------------------------------------------------------------------
+    void http_file_sink::start_write(std::unique_lock <std::mutex>& guard)
+    {
+        std::swap(pending_, in_flight_);
+        pending_.clear();
+        writing_ = true;
+
+        auto offset = offset_;
+        guard.unlock();
+
+        file_io_->async_write(file_, offset, in_flight_.data(), in_flight_.size(),
+            [self = shared_from_this()](boost::system::error_code ec, std::size_t amount) {
+                self->on_written(ec, amount);
+            }
+        );
+    }
+//---------------------------------------------------------------------------------------------------------------------
+    void http_file_sink::on_written(boost::system::error_code ec, std::size_t amount)
+    {
+        std::unique_lock <std::mutex> guard{lock_};
+        offset_ += amount;
+        writing_ = false;
+        if (ec)
+        {
+            error_ = ec;
+            pending_.clear();
+        }
+
+        // the request is gone, nobody is waiting for the file anymore.
+        if (!observer_->is_alive())
+            return;
+
+        if (!pending_.empty())
+        {
+            auto resume = paused_;
+            paused_ = false;
+            start_write(guard);
+            if (resume)
+                req_->resume_read();
+            return;
+        }
+
+        if (paused_)
+        {
+            paused_ = false;
+            guard.unlock();
+            req_->resume_read();
+            return;
+        }
+
+        auto on_flushed = std::move(on_flushed_);
+        on_flushed_ = {};
+        auto error = error_;
+        guard.unlock();
+        if (on_flushed)
+            on_flushed(error);
+    }
+//#####################################################################################################################
+}
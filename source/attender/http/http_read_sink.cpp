@@ -1,4 +1,5 @@
 #include <attender/http/http_read_sink.hpp>
+#include <attender/net_core.hpp>
 
 #include <iostream>
 
@@ -14,6 +15,10 @@ namespace attender
     {
         return written_bytes_;
     }
+//---------------------------------------------------------------------------------------------------------------------
+    void http_read_sink::expect(size_type)
+    {
+    }
 //#####################################################################################################################
     http_stream_sink::http_stream_sink(std::ostream* sink)
         : sink_{sink}
@@ -48,5 +53,28 @@ namespace attender
     {
         return write(buffer.data(), std::min(buffer.size(), amount));
     }
+//---------------------------------------------------------------------------------------------------------------------
+    void http_string_sink::expect(size_type expected)
+    {
+        // the client announces the size, it is not trusted beyond a sane limit.
+        sink_->reserve(sink_->size() + std::min(expected, config::body_reserve_max));
+    }
+//#####################################################################################################################
+    http_span_sink::http_span_sink(data_callback on_data)
+        : on_data_{std::move(on_data)}
+    {
+    }
+//---------------------------------------------------------------------------------------------------------------------
+    size_type http_span_sink::write(const char* data, size_type size)
+    {
+        written_bytes_ += size;
+        on_data_(std::span <const char>{data, size});
+        return size;
+    }
+//---------------------------------------------------------------------------------------------------------------------
+    size_type http_span_sink::write(std::vector <char> const& buffer, size_type amount)
+    {
+        return write(buffer.data(), std::min(buffer.size(), amount));
+    }
 //#####################################################################################################################
 }
@@ -0,0 +1,99 @@
+#include <attender/http/http_task.hpp>
+#include <attender/http/http_connection_interface.hpp>
+#include <attender/http/response.hpp>
+
+#include <new>
+
+namespace attender
+{
+    namespace internal
+    {
+        /**
+         *  Every frame is prefixed by the arena it came from, nullptr for heap frames.
+         */
+        constexpr static std::size_t frame_prefix = alignof(std::max_align_t);
+//#####################################################################################################################
+        coroutine_arena* arena_of(response_handler* res)
+        {
+            if (res == nullptr || res->get_connection() == nullptr)
+                return nullptr;
+            return &res->get_connection()->get_coroutine_arena();
+        }
+//---------------------------------------------------------------------------------------------------------------------
+        void* allocate_frame(std::size_t size, coroutine_arena* arena)
+        {
+            void* memory = nullptr;
+            if (arena != nullptr)
+                memory = arena->allocate(size + frame_prefix);
+
+            if (memory == nullptr)
+            {
+                arena = nullptr;
+                memory = ::operator new(size + frame_prefix);
+            }
+
+            *static_cast <coroutine_arena**> (memory) = arena;
+            return static_cast <std::byte*> (memory) + frame_prefix;
+        }
+//---------------------------------------------------------------------------------------------------------------------
+        void deallocate_frame(void* ptr, std::size_t size) noexcept
+        {
+            void* memory = static_cast <std::byte*> (ptr) - frame_prefix;
+            auto* arena = *static_cast <coroutine_arena**> (memory);
+
+            if (arena != nullptr)
+                arena->deallocate(memory, size + frame_prefix);
+            else
+                ::operator delete(memory);
+        }
+//#####################################################################################################################
+    }
+//#####################################################################################################################
+    http_task::http_task(handle_type handle) noexcept
+        : handle_{handle}
+    {
+    }
+//---------------------------------------------------------------------------------------------------------------------
+    http_task::http_task(http_task&& other) noexcept
+        : handle_{std::exchange(other.handle_, {})}
+    {
+    }
+//---------------------------------------------------------------------------------------------------------------------
+    http_task& http_task::operator=(http_task&& other) noexcept
+    {
+        if (this != &other)
+        {
+            if (handle_)
+                handle_.destroy();
+            handle_ = std::exchange(other.handle_, {});
+        }
+        return *this;
+    }
+//---------------------------------------------------------------------------------------------------------------------
+    http_task::~http_task()
+    {
+        // only the case if the task was never started.
+        if (handle_)
+            handle_.destroy();
+    }
+//---------------------------------------------------------------------------------------------------------------------
+    void http_task::start(response_handler* res)
+    {
+        handle_.promise().response = res;
+        res->begin_coroutine();
+        std::exchange(handle_, {}).resume();
+    }
+//---------------------------------------------------------------------------------------------------------------------
+    void http_task::final_awaiter::await_suspend(handle_type handle) noexcept
+    {
+        auto* res = handle.promise().response;
+        auto exception = std::move(handle.promise().exception);
+
+        // The frame must be gone before the response concludes, because concluding may free the connection and its arena.
+        handle.destroy();
+
+        if (res != nullptr)
+            res->conclude_coroutine(exception);
+    }
+//#####################################################################################################################
+}
@@ -1,5 +1,7 @@
 #include <attender/http/mime.hpp>
 
+#include <algorithm>
+#include <array>
 #include <unordered_map>
 
 namespace attender
@@ -711,6 +713,49 @@ namespace attender
         }
         return "";
     }
+//---------------------------------------------------------------------------------------------------------------------
+    bool is_compressible_mime(std::string_view mime)
+    {
+        constexpr std::array <std::string_view, 14> compressible = {
+            "application/json",
+            "application/javascript",
+            "application/ecmascript",
+            "application/x-javascript",
+            "application/xml",
+            "application/x-www-form-urlencoded",
+            "application/graphql",
+            "application/yaml",
+            "application/x-yaml",
+            "application/rtf",
+            "application/x-sh",
+            "application/wasm",
+            "image/x-icon",
+            "image/bmp"
+        };
+
+        mime = mime.substr(0, mime.find(';'));
+        while (!mime.empty() && mime.back() == ' ')
+            mime.remove_suffix(1);
+
+        auto lower = [](char c) -> char {
+            return c >= 'A' && c <= 'Z' ? static_cast <char> (c - 'A' + 'a') : c;
+        };
+        auto starts_with = [&](std::string_view prefix) {
+            return mime.size() >= prefix.size() &&
+                std::equal(prefix.begin(), prefix.end(), mime.begin(), [&](char l, char r) { return l == lower(r); });
+        };
+        auto ends_with = [&](std::string_view suffix) {
+            return mime.size() >= suffix.size() &&
+                std::equal(suffix.begin(), suffix.end(), mime.end() - suffix.size(), [&](char l, char r) { return l == lower(r); });
+        };
+
+        if (starts_with("text/") || ends_with("+json") || ends_with("+xml"))
+            return true;
+
+        return std::any_of(compressible.begin(), compressible.end(), [&](std::string_view type) {
+            return type.size() == mime.size() && starts_with(type);
+        });
+    }
 //#####################################################################################################################
 } // namespace Rest
 
@@ -18,8 +18,7 @@ namespace attender
 //---------------------------------------------------------------------------------------------------------------------
     mount_response& mount_response::try_set(std::string const& field, std::string const& value)
     {
-        if (!header_.has_field(field))
-            set(field, value);
+        header_.try_set_field(field, value);
         return *this;
     }
 //---------------------------------------------------------------------------------------------------------------------
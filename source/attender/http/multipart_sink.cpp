@@ -0,0 +1,371 @@
+#include <attender/http/multipart_sink.hpp>
+#include <attender/net_core.hpp>
+
+#include <boost/algorithm/string/predicate.hpp>
+#include <boost/algorithm/string/trim.hpp>
+
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+
+namespace attender
+{
+    namespace
+    {
+        /**
+         *  Splits "value; key=value; key="quoted value"" into its parameters and calls func for each key/value pair.
+         */
+        template <typename FunctionT>
+        void for_each_parameter(std::string const& value, FunctionT&& func)
+        {
+            std::size_t i = value.find(';');
+            while (i != std::string::npos && i < value.size())
+            {
+                ++i;
+                while (i < value.size() && (value[i] == ' ' || value[i] == '\t'))
+                    ++i;
+
+                auto equals = value.find_first_of("=;", i);
+                if (equals == std::string::npos || value[equals] == ';')
+                {
+                    i = equals;
+                    continue;
+                }
+
+                auto key = value.substr(i, equals - i);
+                boost::algorithm::trim(key);
+
+                std::string parameter;
+                i = equals + 1;
+                if (i < value.size() && value[i] == '"')
+                {
+                    for (++i; i < value.size() && value[i] != '"'; ++i)
+                    {
+                        if (value[i] == '\\' && i + 1 < value.size())
+                            ++i;
+                        parameter.push_back(value[i]);
+                    }
+                    i = value.find(';', i);
+                }
+                else
+                {
+                    auto end = value.find(';', i);
+                    parameter = value.substr(i, end == std::string::npos ? std::string::npos : end - i);
+                    boost::algorithm::trim(parameter);
+                    i = end;
+                }
+
+                if (func(key, parameter))
+                    return;
+            }
+        }
+    }
+//#####################################################################################################################
+    boost::optional <std::string> multipart_header::get_field(std::string const& key) const
+    {
+        for (auto const& [name, value] : fields_)
+            if (boost::algorithm::iequals(name, key))
+                return value;
+        return boost::none;
+    }
+//---------------------------------------------------------------------------------------------------------------------
+    boost::optional <std::string> multipart_header::get_disposition_parameter(std::string const& parameter) const
+    {
+        auto disposition = get_field("Content-Disposition");
+        if (!disposition)
+            return boost::none;
+
+        boost::optional <std::string> result;
+        for_each_parameter(disposition.get(), [&](std::string const& key, std::string const& value) {
+            if (boost::algorithm::iequals(key, parameter))
+            {
+                result = value;
+                return true;
+            }
+            return false;
+        });
+        return result;
+    }
+//---------------------------------------------------------------------------------------------------------------------
+    boost::optional <std::string> multipart_header::name() const
+    {
+        return get_disposition_parameter("name");
+    }
+//---------------------------------------------------------------------------------------------------------------------
+    boost::optional <std::string> multipart_header::filename() const
+    {
+        return get_disposition_parameter("filename");
+    }
+//---------------------------------------------------------------------------------------------------------------------
+    std::string multipart_header::content_type() const
+    {
+        auto type = get_field("Content-Type");
+        if (type)
+            return type.get();
+        return "text/plain";
+    }
+//---------------------------------------------------------------------------------------------------------------------
+    std::unordered_map <std::string, std::string> const& multipart_header::get_fields() const
+    {
+        return fields_;
+    }
+//---------------------------------------------------------------------------------------------------------------------
+    bool multipart_header::add_field(std::string const& line)
+    {
+        auto colon = line.find(':');
+        if (colon == std::string::npos || colon == 0 || fields_.size() + 1u > config::header_field_max)
+            return false;
+
+        auto value = line.substr(colon + 1);
+        boost::algorithm::trim(value);
+        fields_[line.substr(0, colon)] = std::move(value);
+        return true;
+    }
+//#####################################################################################################################
+    http_multipart_sink::http_multipart_sink(std::string const& boundary, part_callback on_part)
+        : delimiter_{"\r\n--" + boundary}
+        , skip_{}
+        , on_part_{std::move(on_part)}
+        , state_{state::preamble}
+        , carry_{"\r\n"} // the first boundary is not preceded by a line break.
+        , line_{}
+        , header_{}
+        , part_sink_{}
+        , part_count_{0}
+    {
+        if (boundary.empty() || boundary.size() > 70)
+            throw std::invalid_argument("multipart boundary must have 1 to 70 characters");
+
+        // Boyer-Moore-Horspool bad character table
+        auto const length = delimiter_.size();
+        skip_.fill(length);
+        for (std::size_t i = 0; i != length - 1; ++i)
+            skip_[static_cast <unsigned char> (delimiter_[i])] = length - 1 - i;
+    }
+//---------------------------------------------------------------------------------------------------------------------
+    boost::optional <std::string> http_multipart_sink::get_boundary(std::string const& content_type)
+    {
+        if (!boost::algorithm::istarts_with(content_type, "multipart/"))
+            return boost::none;
+
+        boost::optional <std::string> boundary;
+        for_each_parameter(content_type, [&](std::string const& key, std::string const& value) {
+            if (boost::algorithm::iequals(key, "boundary") && !value.empty())
+            {
+                boundary = value;
+                return true;
+            }
+            return false;
+        });
+        return boundary;
+    }
+//---------------------------------------------------------------------------------------------------------------------
+    size_type http_multipart_sink::write(const char* data, size_type size)
+    {
+        written_bytes_ += size;
+
+        auto const total = size;
+        while (size > 0)
+        {
+            std::size_t consumed = size;
+            switch (state_)
+            {
+                case state::preamble:
+                case state::body:
+                    consumed = carry_.empty() ? scan(data, size) : scan_carry(data, size);
+                    break;
+                case state::delimiter_suffix:
+                    consumed = parse_suffix(data, size);
+                    break;
+                case state::header:
+                    consumed = parse_header(data, size);
+                    break;
+                case state::epilogue:
+                case state::failed:
+                    return total;
+            }
+            data += consumed;
+            size -= consumed;
+        }
+        return total;
+    }
+//---------------------------------------------------------------------------------------------------------------------
+    size_type http_multipart_sink::write(std::vector <char> const& buffer, size_type amount)
+    {
+        return write(buffer.data(), std::min(buffer.size(), amount));
+    }
+//---------------------------------------------------------------------------------------------------------------------
+    bool http_multipart_sink::finished() const
+    {
+        return state_ == state::epilogue;
+    }
+//---------------------------------------------------------------------------------------------------------------------
+    bool http_multipart_sink::failed() const
+    {
+        return state_ == state::failed;
+    }
+//---------------------------------------------------------------------------------------------------------------------
+    std::size_t http_multipart_sink::get_part_count() const
+    {
+        return part_count_;
+    }
+//---------------------------------------------------------------------------------------------------------------------
+    char const* http_multipart_sink::find_delimiter(char const* begin, char const* end) const
+    {
+        auto const length = delimiter_.size();
+        if (static_cast <std::size_t> (end - begin) < length)
+            return end;
+
+        auto const last = delimiter_[length - 1];
+        for (auto p = begin; p <= end - length; p += skip_[static_cast <unsigned char> (p[length - 1])])
+        {
+            if (p[length - 1] == last && std::memcmp(p, delimiter_.data(), length - 1) == 0)
+                return p;
+        }
+        return end;
+    }
+//---------------------------------------------------------------------------------------------------------------------
+    std::size_t http_multipart_sink::partial_delimiter(char const* begin, char const* end) const
+    {
+        // length of the longest suffix of the range that is a proper prefix of the delimiter.
+        // the delimiter starts with '\r', so only those positions have to be checked.
+        auto p = end - std::min(static_cast <std::size_t> (end - begin), delimiter_.size() - 1);
+        while ((p = static_cast <char const*> (std::memchr(p, '\r', end - p))) != nullptr)
+        {
+            if (std::memcmp(p, delimiter_.data(), end - p) == 0)
+                return end - p;
+            ++p;
+        }
+        return 0;
+    }
+//---------------------------------------------------------------------------------------------------------------------
+    std::size_t http_multipart_sink::scan(char const* data, std::size_t size)
+    {
+        auto end = data + size;
+        auto delimiter = find_delimiter(data, end);
+        if (delimiter != end)
+        {
+            deliver(data, delimiter - data);
+            on_delimiter();
+            return delimiter - data + delimiter_.size();
+        }
+
+        // a delimiter might begin at the end of this buffer, keep that part for the next write.
+        auto keep = partial_delimiter(data, end);
+        deliver(data, size - keep);
+        carry_.assign(end - keep, end);
+        return size;
+    }
+//---------------------------------------------------------------------------------------------------------------------
+    std::size_t http_multipart_sink::scan_carry(char const* data, std::size_t size)
+    {
+        auto const previous = carry_.size();
+        auto const appended = std::min(size, delimiter_.size());
+        carry_.append(data, appended);
+
+        auto delimiter = carry_.find(delimiter_);
+        if (delimiter != std::string::npos)
+        {
+            deliver(carry_.data(), delimiter);
+            carry_.clear();
+            on_delimiter();
+            return delimiter + delimiter_.size() - previous;
+        }
+
+        // every delimiter starting in the carry would have been found, the rest of the input is scanned in place.
+        if (appended == delimiter_.size())
+        {
+            deliver(carry_.data(), previous);
+            carry_.clear();
+            return 0;
+        }
+
+        auto keep = partial_delimiter(carry_.data(), carry_.data() + carry_.size());
+        deliver(carry_.data(), carry_.size() - keep);
+        carry_.erase(0, carry_.size() - keep);
+        return size;
+    }
+//---------------------------------------------------------------------------------------------------------------------
+    std::size_t http_multipart_sink::parse_suffix(char const* data, std::size_t size)
+    {
+        // after a delimiter follows either "--" for the last one or optional whitespace and a line break.
+        for (std::size_t i = 0; i != size; ++i)
+        {
+            line_.push_back(data[i]);
+            if (line_ == "--")
+            {
+                state_ = state::epilogue;
+                return i + 1;
+            }
+            if (data[i] == '\n')
+            {
+                if (line_.size() < 2 || line_[line_.size() - 2] != '\r' || line_.find_first_not_of(" \t") != line_.size() - 2)
+                {
+                    state_ = state::failed;
+                    return size;
+                }
+                line_.clear();
+                header_ = {};
+                state_ = state::header;
+                return i + 1;
+            }
+            if (line_.size() > 64)
+            {
+                state_ = state::failed;
+                return size;
+            }
+        }
+        return size;
+    }
+//---------------------------------------------------------------------------------------------------------------------
+    std::size_t http_multipart_sink::parse_header(char const* data, std::size_t size)
+    {
+        auto end = static_cast <char const*> (std::memchr(data, '\n', size));
+        auto consumed = end ? static_cast <std::size_t> (end - data) + 1 : size;
+
+        line_.append(data, end ? end : data + size);
+        if (line_.size() > config::header_buffer_max)
+        {
+            state_ = state::failed;
+            return size;
+        }
+        if (!end)
+            return consumed;
+
+        if (line_.empty() || line_.back() != '\r')
+        {
+            state_ = state::failed;
+            return size;
+        }
+        line_.pop_back();
+
+        if (line_.empty())
+        {
+            ++part_count_;
+            part_sink_ = on_part_ ? on_part_(header_) : nullptr;
+            state_ = state::body;
+        }
+        else if (!header_.add_field(line_))
+        {
+            state_ = state::failed;
+            return size;
+        }
+
+        line_.clear();
+        return consumed;
+    }
+//---------------------------------------------------------------------------------------------------------------------
+    void http_multipart_sink::deliver(char const* data, std::size_t size)
+    {
+        if (state_ == state::body && part_sink_ && size > 0)
+            part_sink_->write(data, size);
+    }
+//---------------------------------------------------------------------------------------------------------------------
+    void http_multipart_sink::on_delimiter()
+    {
+        part_sink_.reset();
+        line_.clear();
+        state_ = state::delimiter_suffix;
+    }
+//#####################################################################################################################
+}
@@ -6,6 +6,8 @@
 
 #include <attender/http/response.hpp>
 
+#include <boost/algorithm/string/predicate.hpp>
+
 #include <string>
 #include <limits>
 
@@ -21,6 +23,10 @@ namespace attender
         , params_{}
         , on_finished_read_{}
         , max_read_{0}
+        , chunked_decoder_{}
+        , chunked_body_{false}
+        , body_front_{}
+        , read_flow_{read_flow::running}
     {
     }
 //---------------------------------------------------------------------------------------------------------------------
@@ -93,9 +99,23 @@ namespace attender
     {
         if (expects_continue())
         {
-            connection_->write("HTTP/1.1 100 Continue\r\n\r\n", [continuation](boost::system::error_code ec, std::size_t){
-                continuation(ec);
-            });
+            auto write_continue = [this, continuation]{
+                connection_->write("HTTP/1.1 100 Continue\r\n\r\n", [continuation](boost::system::error_code ec, std::size_t){
+                    continuation(ec);
+                });
+            };
+
+            if (connection_->get_parent()->running_in_io_thread())
+                write_continue();
+            else
+            {
+                asio::post(*connection_->get_parent()->get_io_service(),
+                    [write_continue, observer = connection_->get_response_handler().observe_conclusion()]{
+                        if (observer->is_alive())
+                            write_continue();
+                    }
+                );
+            }
             return true;
         }
         return false;
@@ -129,7 +149,14 @@ namespace attender
             return;
         }
 
+        if (chunked_body_)
+        {
+            chunked_read(connection_->get_read_buffer().data(), amount);
+            return;
+        }
+
         // remaining limit = Min(Amount Read Overall, Maximum Read Allowed)
+        bool limit_reached = false;
         if (max_read_ != 0)
         {
             int64_t remaining_limit = static_cast <int64_t> (max_read_) - static_cast <int64_t> (sink_->get_total_bytes_written());
@@ -140,19 +167,110 @@ namespace attender
                 on_finished_read_.fullfill();
                 return;
             }
-        }
 
-        // write into the sink
-        sink_->write(connection_->get_read_buffer(), amount);
+            if (static_cast <int64_t> (amount) >= remaining_limit)
+            {
+                amount = static_cast <std::size_t> (remaining_limit);
+                limit_reached = true;
+            }
+        }
 
         // remaining = ContentLength - Amount Read Overall  (after read)
-        auto remaining = std::max(static_cast <int64_t> (get_content_length()) - static_cast <int64_t>(sink_->get_total_bytes_written()), static_cast <int64_t> (0));
+        auto remaining = std::max(static_cast <int64_t> (get_content_length()) - static_cast <int64_t>(sink_->get_total_bytes_written() + amount), static_cast <int64_t> (0));
 
-        if (remaining == 0ll)
+        // write into the sink, directly from the receive buffer
+        sink_->write(connection_->get_read_buffer().data(), amount);
+
+        if (remaining == 0ll || limit_reached)
             on_finished_read_.fullfill();
         else
+            continue_read();
+    }
+//---------------------------------------------------------------------------------------------------------------------
+    void request_handler::chunked_read(char const* data, std::size_t amount)
+    {
+        switch (chunked_decoder_.feed(data, amount, *sink_))
+        {
+            case chunked_decoder::result::need_more:
+                continue_read();
+                break;
+            case chunked_decoder::result::finished:
+            case chunked_decoder::result::limit_reached:
+                on_finished_read_.fullfill();
+                break;
+            case chunked_decoder::result::malformed:
+                on_finished_read_.error(boost::system::errc::make_error_code(boost::system::errc::protocol_error));
+                connection_->get_response_handler().send_status(400);
+                break;
+        }
+    }
+//---------------------------------------------------------------------------------------------------------------------
+    void request_handler::continue_read()
+    {
+        // while paused, the read is withheld until resume_read issues it.
+        auto flow = read_flow::paused;
+        if (read_flow_.compare_exchange_strong(flow, read_flow::withheld))
+            return;
+
+        // handlers on the worker pool must not touch the socket, the server issues the read when they returned.
+        if (connection_->get_parent()->running_in_io_thread())
+            connection_->read();
+        else
+            read_flow_.store(read_flow::deferred);
+    }
+//---------------------------------------------------------------------------------------------------------------------
+    void request_handler::pause_read()
+    {
+        auto flow = read_flow::running;
+        if (!read_flow_.compare_exchange_strong(flow, read_flow::paused))
+        {
+            flow = read_flow::deferred;
+            read_flow_.compare_exchange_strong(flow, read_flow::withheld);
+        }
+    }
+//---------------------------------------------------------------------------------------------------------------------
+    void request_handler::resume_read()
+    {
+        auto flow = read_flow_.exchange(read_flow::running);
+        if (flow != read_flow::withheld && flow != read_flow::deferred)
+            return;
+
+        if (connection_->get_parent()->running_in_io_thread())
+            connection_->read();
+        else
+        {
+            asio::post(*connection_->get_parent()->get_io_service(),
+                [this, observer = connection_->get_response_handler().observe_conclusion()]{
+                    if (observer->is_alive())
+                        connection_->read();
+                }
+            );
+        }
+    }
+//---------------------------------------------------------------------------------------------------------------------
+    void request_handler::issue_deferred_read()
+    {
+        auto flow = read_flow::deferred;
+        if (read_flow_.compare_exchange_strong(flow, read_flow::running))
             connection_->read();
     }
+//---------------------------------------------------------------------------------------------------------------------
+    bool request_handler::is_chunked() const
+    {
+        auto encoding = header_.get_field("Transfer-Encoding");
+        return encoding && boost::algorithm::iends_with(encoding.get(), "chunked");
+    }
+//---------------------------------------------------------------------------------------------------------------------
+    boost::optional <std::string> request_handler::get_trailer_field(std::string const& key) const
+    {
+        // field names are case insensitive, there are only a few trailers.
+        for (auto const& [name, value] : chunked_decoder_.get_trailers())
+        {
+            if (boost::algorithm::iequals(name, key))
+                return value;
+        }
+        return boost::none;
+    }
 //---------------------------------------------------------------------------------------------------------------------
     void request_handler::initialize_read(request_parser::buffer_size_type& max)
     {
@@ -164,6 +282,7 @@ namespace attender
         });
 
         max_read_ = max;
+        read_flow_.store(read_flow::running);
     }
 //---------------------------------------------------------------------------------------------------------------------
     request_parser::buffer_size_type request_handler::get_read_amount() const
@@ -204,8 +323,36 @@ namespace attender
         return body_read_start(max);
     }
 //---------------------------------------------------------------------------------------------------------------------
+    callback_wrapper& request_handler::read_body(data_callback on_data, size_type max)
+    {
+        // set handler and set reader maximum
+        initialize_read(max);
+
+        sink_ = std::make_shared <http_span_sink> (std::move(on_data));
+
+        return body_read_start(max);
+    }
+//---------------------------------------------------------------------------------------------------------------------
     callback_wrapper& request_handler::body_read_start(size_type max)
     {
+        // chunked transfer encoding takes precedence over Content-Length
+        chunked_body_ = is_chunked();
+        if (chunked_body_)
+        {
+            chunked_decoder_.reset(max);
+
+            // decode what we already have read by parsing the header
+            if (!parser_.is_buffer_empty())
+            {
+                take_body_front();
+                chunked_read(body_front_.data(), body_front_.size());
+            }
+            else
+                continue_read();
+
+            return on_finished_read_;
+        }
+
         try
         {
             // Content-Length requirement test (411 otherwise)
@@ -218,35 +365,48 @@ namespace attender
             return on_finished_read_;
         }
 
+        auto content_length = get_content_length();
+        sink_->expect(max != 0 ? std::min(max, content_length) : content_length);
+
         // write what we already have read by parsing the header
         if (!parser_.is_buffer_empty())
         {
-            size_type from_header_buffer = static_cast <size_type> (parser_.get_buffer().length());
+            take_body_front();
+
+            size_type from_header_buffer = static_cast <size_type> (body_front_.length());
             if (max != 0)
                 from_header_buffer = std::min(max, from_header_buffer);
 
-            auto&& body_begin = parser_.read_front(from_header_buffer); // start of body
-            sink_->write(body_begin.c_str(), from_header_buffer);
-
             // if header buffer exhausted & more content & max not reached.
             // = read more if more data is to be expected.
-            if (parser_.is_buffer_empty() && (get_content_length() - from_header_buffer) > 0 && (max == 0 || from_header_buffer < max))
-                connection_->read();
+            bool read_more = from_header_buffer == body_front_.length() && content_length > from_header_buffer && (max == 0 || from_header_buffer < max);
+
+            sink_->write(body_front_.data(), from_header_buffer); // start of body
+
+            if (read_more)
+                continue_read();
             else
                 on_finished_read_.fullfill();
         }
         else
         {
             // do not start a read operation, if the whole content has been read.
-            auto remaining = std::max(static_cast <int64_t> (get_content_length()) - static_cast <int64_t>(sink_->get_total_bytes_written()), static_cast <int64_t> (0));
+            auto remaining = std::max(static_cast <int64_t> (content_length) - static_cast <int64_t>(sink_->get_total_bytes_written()), static_cast <int64_t> (0));
             if (remaining == 0ll)
                 on_finished_read_.fullfill();
             else
-                connection_->read();
+                continue_read();
         }
 
         return on_finished_read_;
     }
+//---------------------------------------------------------------------------------------------------------------------
+    void request_handler::take_body_front()
+    {
+        // moved, not copied. Views handed to the sink stay valid while the read is paused.
+        body_front_ = std::move(parser_.get_buffer());
+        parser_.get_buffer().clear();
+    }
 //---------------------------------------------------------------------------------------------------------------------
     std::string request_handler::hostname() const
     {
@@ -2,12 +2,16 @@
 #include <attender/http/http_connection.hpp>
 #include <attender/http/http_server.hpp>
 #include <attender/http/mime.hpp>
+#include <attender/http/static_response.hpp>
+#include <attender/io_context/file_io.hpp>
 
 #include <boost/filesystem.hpp>
 
 #include <fstream>
 #include <memory>
+#include <mutex>
 #include <charconv>
+#include <cstring>
 #include <iostream>
 #include <iomanip>
 
@@ -68,12 +72,58 @@ namespace attender
 
         std::istream* stream;
     };
+//---------------------------------------------------------------------------------------------------------------------
+    namespace
+    {
+        constexpr std::string_view chunk_end = "\r\n";
+        constexpr std::string_view last_chunk = "0\r\n\r\n";
+
+        // send_chunked gathers at most this many spans of the producer into one chunk.
+        constexpr std::size_t max_chunk_spans = 16;
+
+        asio::const_buffer view_buffer(std::string_view view)
+        {
+            return asio::buffer(view.data(), view.size());
+        }
+
+        /**
+         *  Whether send_chunked has a write in flight, and whether the producer failed meanwhile.
+         */
+        struct chunked_progress
+        {
+            std::mutex protect;
+            bool writing = false;
+            bool failed = false;
+        };
+    }
+//---------------------------------------------------------------------------------------------------------------------
+    namespace internal
+    {
+        struct file_transfer
+        {
+            async_file file;
+            std::vector <char> buffer;
+            std::uint64_t offset = 0;
+            std::uint64_t remaining = 0;
+            std::shared_ptr <conclusion_observer> observer;
+        };
+    }
 //#####################################################################################################################
     response_handler::response_handler(http_connection_interface* connection) noexcept
         : connection_{connection}
         , header_{}
         , header_sent_{false}
         , observer_{}
+        , coroutine_driven_{false}
+        , end_requested_{false}
+        , chunked_open_{false}
+        , pending_completion_{}
+        , chunk_header_{}
+        , compression_{compression_mode::inherit}
+        , compressed_{}
+        , retained_{}
+        , date_line_{}
+        , header_buffer_{}
     {
 
     }
@@ -127,53 +177,229 @@ namespace attender
         value.pop_back();
         value.pop_back();
 
-        set("Links", value);
+        set("Link", value);
         return *this;
     }
 //---------------------------------------------------------------------------------------------------------------------
     void response_handler::send(std::string const& body)
     {
-        try_set("Content-Length", std::to_string(body.length()));
-        try_set("Content-Type", "text/plain");
+        send(std::make_shared <std::string const> (body));
+    }
+//---------------------------------------------------------------------------------------------------------------------
+    void response_handler::send(std::vector <char> const& body)
+    {
+        send(std::make_shared <std::vector <char> const> (body));
+    }
+//---------------------------------------------------------------------------------------------------------------------
+    void response_handler::send(std::string&& body)
+    {
+        send(std::make_shared <std::string const> (std::move(body)));
+    }
+//---------------------------------------------------------------------------------------------------------------------
+    void response_handler::send(std::vector <char>&& body)
+    {
+        send(std::make_shared <std::vector <char> const> (std::move(body)));
+    }
+//---------------------------------------------------------------------------------------------------------------------
+    void response_handler::send(std::shared_ptr <std::string const> body)
+    {
+        prepare_body_header(body->size(), "text/plain");
+        if (auto compressed = compress_body(*body))
+            body = std::move(compressed);
 
-        // fix code
-        if (header_.get_code() == 204 && !body.empty())
-            status(200);
-        else if (header_.get_code() == 200 && body.empty())
-            status(204);
+        auto view = asio::buffer(*body);
+        send_retained(std::move(body), view);
+    }
+//---------------------------------------------------------------------------------------------------------------------
+    void response_handler::send(std::shared_ptr <std::vector <char> const> body)
+    {
+        prepare_body_header(body->size(), "application/octet-stream");
+        if (auto compressed = compress_body({body->data(), body->size()}))
+        {
+            auto view = asio::buffer(*compressed);
+            return send_retained(std::move(compressed), view);
+        }
 
-        write(this, std::make_shared <std::string> (body));
+        auto view = asio::buffer(*body);
+        send_retained(std::move(body), view);
     }
 //---------------------------------------------------------------------------------------------------------------------
-    void response_handler::send(std::vector <char> const& body)
+    std::shared_ptr <std::string const> response_handler::compress_body(std::string_view body)
     {
-        try_set("Content-Length", std::to_string(body.size()));
-        try_set("Content-Type", "application/octet-stream");
+        auto options = connection_->get_parent()->get_settings().compression;
+        auto mode = compression_;
+        if (mode == compression_mode::inherit)
+            mode = options.enabled ? compression_mode::enabled : compression_mode::disabled;
 
-        // fix code
-        if (header_.get_code() == 204 && !body.empty())
-            status(200);
-        else if (header_.get_code() == 200 && body.empty())
-            status(204);
+        if (mode != compression_mode::enabled || body.size() < options.minimum_size)
+            return {};
+
+        auto code = header_.get_code();
+        if (code < 200 || code == 204 || code == 206 || code == 304 || header_.has_field("Content-Encoding"))
+            return {};
+
+        auto type = header_.get_field("Content-Type");
+        if (!type || !is_compressible_mime(*type))
+            return {};
+
+        // from here on, the representation depends on Accept-Encoding.
+        if (header_.has_field("Vary"))
+            header_.append_field("Vary", "Accept-Encoding");
+        else
+            header_.set_field("Vary", "Accept-Encoding");
 
-        write(this, std::make_shared <std::vector <char>> (body));
+        auto accept_encoding = connection_->get_request_handler().get_header_field("Accept-Encoding");
+        if (!accept_encoding)
+            return {};
+
+        auto coding = negotiate_coding(*accept_encoding, options);
+        if (coding == content_coding::identity)
+            return {};
+
+        auto compressed = std::make_shared <std::string> ();
+        if (!attender::compress(coding, body, *compressed, options) || compressed->size() >= body.size())
+            return {};
+
+        header_.set_field("Content-Encoding", std::string{coding_name(coding)});
+        header_.set_field("Content-Length", std::to_string(compressed->size()));
+        return compressed;
+    }
+//---------------------------------------------------------------------------------------------------------------------
+    response_handler& response_handler::compress(compression_mode mode)
+    {
+        compression_ = mode;
+        return *this;
+    }
+//---------------------------------------------------------------------------------------------------------------------
+    void response_handler::send_retained(std::shared_ptr <void const> storage, asio::const_buffer body)
+    {
+        if (post_to_io_thread([this, storage, body]{ send_retained(storage, body); }))
+            return;
+
+        if (observer_) observer_->conclude();
+
+        // the header might have been sent on its own already, then only the body follows.
+        http_connection_interface::buffer_sequence buffers;
+        if (!header_sent_.exchange(true))
+        {
+            header_buffer_.clear();
+            header_.append_to(header_buffer_);
+            buffers.push_back(asio::buffer(header_buffer_));
+        }
+        buffers.push_back(body);
+        retained_ = std::move(storage);
+
+        connection_->write_buffers(buffers, [this](boost::system::error_code ec, std::size_t) {
+            finish_retained(ec);
+        });
+    }
+//---------------------------------------------------------------------------------------------------------------------
+    void response_handler::finish_retained(boost::system::error_code ec)
+    {
+        retained_.reset();
+
+        // nothing else can be sent after a failed write. Coroutine handlers are still running, they end on return.
+        if (ec && !coroutine_driven_)
+            return connection_->get_parent()->get_connections()->remove(connection_);
+        end();
+    }
+//---------------------------------------------------------------------------------------------------------------------
+    void response_handler::abort()
+    {
+        // without lingering, close sends a reset instead of the end of the stream.
+        boost::system::error_code ignored;
+        auto* socket = connection_->get_socket();
+        socket->set_option(asio::socket_base::linger{true, 0}, ignored);
+        socket->close(ignored);
+        connection_->get_parent()->get_connections()->remove(connection_);
+    }
+//---------------------------------------------------------------------------------------------------------------------
+    bool response_handler::post_to_io_thread(std::function <void()> const& resume)
+    {
+        if (connection_->get_parent()->running_in_io_thread())
+            return false;
+
+        auto observer = observe_conclusion();
+        observer->conclude();
+        asio::post(*connection_->get_parent()->get_io_service(), [observer, resume]{
+            if (observer->is_alive())
+                resume();
+        });
+        return true;
     }
 //---------------------------------------------------------------------------------------------------------------------
     void response_handler::send(std::istream& body, std::function <void()> const& on_finish)
     {
-        body.seekg(0, std::ios_base::end);
-        auto size = body.tellg();
-        body.seekg(0);
+        prepare_body_header(stream_size(body), "application/octet-stream");
+        write(this, std::make_shared <stream_keeper> (body), on_finish);
+    }
+//---------------------------------------------------------------------------------------------------------------------
+    void response_handler::send(static_response const& response)
+    {
+        if (post_to_io_thread([this, response]{ send(response); }))
+            return;
+
+        if (observer_) observer_->conclude();
 
+        if (header_sent_.exchange(true))
+        {
+            // the header of this response went out already, the one of the static response is dropped.
+            auto body = response.get_body();
+            retained_ = response.get_buffer();
+            connection_->write_buffers({asio::buffer(body.data(), body.size())}, [this](boost::system::error_code ec, std::size_t) {
+                finish_retained(ec);
+            });
+            return;
+        }
+
+        // "Date: " + date + "\r\n"
+        std::memcpy(date_line_.data(), "Date: ", 6);
+        auto date_string = current_gmt_string();
+        std::memcpy(date_line_.data() + 6, date_string.data(), date_string.size());
+        std::memcpy(date_line_.data() + 6 + date_string.size(), "\r\n", 2);
+
+        // fields of the static response win, Content-Length and Content-Type must match its body.
+        header_buffer_.clear();
+        header_.append_fields_to(header_buffer_, [&response](std::string_view name) {
+            return !response.has_field(name);
+        });
+
+        auto status_line = response.get_status_line();
+        auto remainder = response.get_remainder();
+        retained_ = response.get_buffer();
+
+        connection_->write_buffers
+        (
+            {
+                asio::buffer(status_line.data(), status_line.size()),
+                asio::buffer(date_line_.data(), 8 + date_string.size()),
+                asio::buffer(header_buffer_),
+                asio::buffer(remainder.data(), remainder.size())
+            },
+            [this](boost::system::error_code ec, std::size_t) {
+                finish_retained(ec);
+            }
+        );
+    }
+//---------------------------------------------------------------------------------------------------------------------
+    void response_handler::prepare_body_header(std::size_t size, char const* default_type)
+    {
         try_set("Content-Length", std::to_string(size));
-        try_set("Content-Type", "application/octet-stream");
+        try_set("Content-Type", default_type);
 
-        if (header_.get_code() == 204 && size > 0)
+        // fix code
+        if (header_.get_code() == 204 && size != 0)
             status(200);
-        else if (header_.get_code() == 200 && static_cast <size_type> (size) == 0u)
+        else if (header_.get_code() == 200 && size == 0)
             status(204);
-
-        write(this, std::make_shared <stream_keeper> (body), on_finish);
+    }
+//---------------------------------------------------------------------------------------------------------------------
+    std::size_t response_handler::stream_size(std::istream& stream)
+    {
+        stream.seekg(0, std::ios_base::end);
+        auto size = stream.tellg();
+        stream.seekg(0);
+        return static_cast <std::size_t> (size);
     }
 //---------------------------------------------------------------------------------------------------------------------
     std::shared_ptr <conclusion_observer> response_handler::observe_conclusion()
@@ -197,8 +423,9 @@ namespace attender
         write_header_for_chunked(this, [concl=std::shared_ptr <conclusion_observer>{observe_conclusion()}, this, &prod, on_finish](auto)
         {
             // header is sent, now send chunked data.
+            auto progress = std::make_shared <chunked_progress> ();
             std::function <void(std::string const& err, bool)> on_produce;
-            on_produce = [this, concl, &prod, on_produce](std::string const& err, bool /*control_call*/)
+            on_produce = [this, concl, progress, &prod, on_produce](std::string const& err, bool /*control_call*/)
             {
                 if (!concl->is_alive())
                 {
@@ -209,51 +436,78 @@ namespace attender
 
                 if (!err.empty())
                 {
-                    this->get_connection()->write("0\r\n\r\n"s, [this, &prod](boost::system::error_code, std::size_t) {
+                    // the stream is incomplete, a terminating chunk would hide that. A write in flight aborts when done.
+                    {
+                        std::lock_guard <std::mutex> guard{progress->protect};
+                        progress->failed = true;
+                        if (progress->writing)
+                            return;
+                    }
+                    asio::post(*connection_->get_parent()->get_io_service(), [this, concl, &prod]{
                         prod.end_production({boost::system::errc::connection_reset, boost::system::system_category()});
-                        this->end();
+                        if (concl->is_alive())
+                            abort();
+                        else
+                            this->end();
                     });
                     return;
                 }
 
+                {
+                    std::lock_guard <std::mutex> guard{progress->protect};
+                    if (progress->failed)
+                        return;
+                    progress->writing = true;
+                }
+
                 if (prod.complete())
                 {
-                    this->get_connection()->write("0\r\n\r\n"s, [this, &prod](boost::system::error_code, std::size_t) {
+                    this->get_connection()->write_buffers({view_buffer(last_chunk)}, [this, &prod](boost::system::error_code, std::size_t) {
                         prod.end_production({boost::system::errc::connection_reset, boost::system::system_category()});
                         this->end();
                     });
                     return;
                 }
 
-                std::size_t avail = prod.available();
+                // everything the producer has buffered becomes one chunk. The spans stay in the producer until
+                // has_consumed, so they are written from there.
+                http_connection_interface::buffer_sequence buffers{asio::const_buffer{}};
+                std::size_t avail = 0;
+                prod.for_each_available([&buffers, &avail](char const* data, std::size_t size) {
+                    if (buffers.size() > max_chunk_spans)
+                        return;
+                    buffers.push_back(asio::buffer(data, size));
+                    avail += size;
+                });
                 if (avail == 0)
                 {
+                    {
+                        std::lock_guard <std::mutex> guard{progress->protect};
+                        progress->writing = false;
+                    }
                     prod.has_consumed(0);
                     return;
                 }
+                buffers.front() = view_buffer(chunk_header(avail));
+                buffers.push_back(view_buffer(chunk_end));
 
-                std::size_t size_len = producer::hexlen(avail);
-
-                std::vector <char> avail_bytes(avail + size_len + 4ull);
-                auto [p, to_chars_error] = std::to_chars(avail_bytes.data(), avail_bytes.data() + size_len, avail, 16);
-
-                *p = '\r';
-                *(p+1) = '\n';
-
-                auto iter = std::begin(avail_bytes) + size_len + 2;
-                prod.buffer_locked_do([&prod, &avail, &iter]{
-                    std::copy(prod.data(), prod.data() + avail, iter);
-                });
-                iter += avail;
-                *iter = '\r';
-                ++iter;
-                *iter = '\n';
-
-                get_connection()->write(
-                    /*std::move(avail_bytes)*/ avail_bytes,
-                    [&prod, avail, this](auto ec, auto)
+                get_connection()->write_buffers(
+                    buffers,
+                    [&prod, avail, progress, this](auto ec, auto)
                     {
-                        if (!ec)
+                        bool failed;
+                        {
+                            std::lock_guard <std::mutex> guard{progress->protect};
+                            progress->writing = false;
+                            failed = progress->failed;
+                        }
+
+                        if (!ec && failed)
+                        {
+                            prod.end_production({boost::system::errc::connection_reset, boost::system::system_category()});
+                            abort();
+                        }
+                        else if (!ec)
                         {
                             /*
                             if (amount < avail)
@@ -283,14 +537,106 @@ namespace attender
 //---------------------------------------------------------------------------------------------------------------------
     bool response_handler::send_file(std::string const& fileName)
     {
-        auto reader = std::make_shared <std::ifstream> (fileName, std::ios_base::binary);
-        if (!reader->good())
+        auto transfer = open_file(fileName);
+        if (!transfer)
             return false;
 
-        type(boost::filesystem::path{fileName}.extension().string(), true);
-        send(*reader.get(), [reader]{}); // binds the shared ptr to the function, extending the life time, until the write operation terminates.
+        send_header([this, transfer](boost::system::error_code ec, std::size_t) {
+            if (ec)
+                return end();
+
+            transfer_file(transfer, [this](boost::system::error_code) {
+                end();
+            });
+        });
         return true;
     }
+//---------------------------------------------------------------------------------------------------------------------
+    void response_handler::send_file(std::string const& file_name, int missing_status)
+    {
+        open_file(file_name, [this, missing_status](std::shared_ptr <internal::file_transfer> const& transfer) {
+            if (!transfer)
+                return send_status(missing_status);
+
+            send_header([this, transfer](boost::system::error_code ec, std::size_t) {
+                if (ec)
+                    return end();
+
+                transfer_file(transfer, [this](boost::system::error_code) {
+                    end();
+                });
+            });
+        });
+    }
+//---------------------------------------------------------------------------------------------------------------------
+    std::shared_ptr <internal::file_transfer> response_handler::open_file(std::string const& file_name)
+    {
+        auto transfer = std::make_shared <internal::file_transfer>();
+        if (!transfer->file.open(file_name, async_file::mode::read))
+            return nullptr;
+
+        transfer->remaining = transfer->file.size();
+        transfer->observer = observe_conclusion();
+        prepare_file_header(file_name, transfer->remaining);
+        return transfer;
+    }
+//---------------------------------------------------------------------------------------------------------------------
+    void response_handler::open_file(std::string const& file_name, std::function <void(std::shared_ptr <internal::file_transfer> const&)> const& on_open)
+    {
+        auto transfer = std::make_shared <internal::file_transfer>();
+        transfer->observer = observe_conclusion();
+        connection_->get_parent()->get_file_io()->async_open(transfer->file, file_name, async_file::mode::read,
+            [this, transfer, file_name, on_open](boost::system::error_code ec, std::size_t size) {
+                // the connection went away while the disk was busy.
+                if (!transfer->observer->is_alive())
+                    return;
+                if (ec)
+                    return on_open(nullptr);
+
+                transfer->remaining = size;
+                prepare_file_header(file_name, transfer->remaining);
+                on_open(transfer);
+            }
+        );
+    }
+//---------------------------------------------------------------------------------------------------------------------
+    void response_handler::prepare_file_header(std::string const& file_name, std::uint64_t size)
+    {
+        type(boost::filesystem::path{file_name}.extension().string(), true);
+        prepare_body_header(static_cast <std::size_t> (size), "application/octet-stream");
+    }
+//---------------------------------------------------------------------------------------------------------------------
+    void response_handler::transfer_file(std::shared_ptr <internal::file_transfer> const& transfer, custom_callback const& on_done)
+    {
+        if (transfer->remaining == 0)
+            return on_done({});
+
+        auto amount = static_cast <std::size_t> (std::min <std::uint64_t> (transfer->remaining, config::file_io_block_size));
+        transfer->buffer.resize(amount);
+
+        connection_->get_parent()->get_file_io()->async_read(transfer->file, transfer->offset, transfer->buffer.data(), amount,
+            [this, transfer, on_done](boost::system::error_code ec, std::size_t read) {
+                // the connection went away while the disk was busy.
+                if (!transfer->observer->is_alive())
+                    return;
+
+                if (!ec && read == 0)
+                    ec = boost::asio::error::eof;
+                if (ec)
+                    return on_done(ec);
+
+                transfer->buffer.resize(read);
+                transfer->offset += read;
+                transfer->remaining -= read;
+
+                connection_->write(transfer->buffer, [this, transfer, on_done](boost::system::error_code ec, std::size_t) {
+                    if (ec)
+                        return on_done(ec);
+                    transfer_file(transfer, on_done);
+                });
+            }
+        );
+    }
 //---------------------------------------------------------------------------------------------------------------------
     void response_handler::send_status(int code)
     {
@@ -303,6 +649,13 @@ namespace attender
 //---------------------------------------------------------------------------------------------------------------------
     void response_handler::end()
     {
+        // coroutine handlers end when the coroutine returns, see conclude_coroutine.
+        if (coroutine_driven_)
+        {
+            end_requested_ = true;
+            return;
+        }
+
         if (observer_) observer_->conclude();
 
         send_header([this](boost::system::error_code, std::size_t){
@@ -313,8 +666,7 @@ namespace attender
 //---------------------------------------------------------------------------------------------------------------------
     void response_handler::try_set(std::string const& field, std::string const& value)
     {
-        if (!header_.has_field(field))
-            set(field, value);
+        header_.try_set_field(field, value);
     }
 //---------------------------------------------------------------------------------------------------------------------
     response_handler& response_handler::status(int code)
@@ -325,6 +677,10 @@ namespace attender
 //---------------------------------------------------------------------------------------------------------------------
     void response_handler::send_header(write_callback continuation)
     {
+        // handlers on the worker pool hand the write over to the io_service, writes that follow run in its completions.
+        if (post_to_io_thread([this, continuation]{ send_header(continuation); }))
+            return;
+
         if (observer_) observer_->conclude();
 
         if (header_sent_.load() == false)
@@ -367,5 +723,176 @@ namespace attender
     {
         header_.set_cookie(ck);
     }
+//---------------------------------------------------------------------------------------------------------------------
+    void response_handler::begin_coroutine()
+    {
+        coroutine_driven_ = true;
+        end_requested_ = false;
+    }
+//---------------------------------------------------------------------------------------------------------------------
+    void response_handler::conclude_coroutine(std::exception_ptr const& exception)
+    {
+        coroutine_driven_ = false;
+
+        if (exception && header_sent_.load())
+        {
+            // a terminator would make the truncated body look complete, the client must see the connection break.
+            chunked_open_ = false;
+            return abort();
+        }
+
+        if (exception)
+        {
+            std::string what;
+            try
+            {
+                std::rethrow_exception(exception);
+            }
+            catch (std::exception const& exc)
+            {
+                what = exc.what();
+            }
+            catch (...)
+            {
+            }
+
+            if (connection_->get_parent()->get_settings().expose_exception && !what.empty())
+                status(500).send(what);
+            else
+                send_status(500);
+            return;
+        }
+
+        if (chunked_open_)
+        {
+            chunked_open_ = false;
+            connection_->write_buffers({view_buffer(last_chunk)}, [this](boost::system::error_code, std::size_t) {
+                end();
+            });
+            return;
+        }
+
+        // Otherwise a send that was not awaited is still in flight and ends the response when done.
+        if (end_requested_ || !header_sent_.load())
+            end();
+    }
+//---------------------------------------------------------------------------------------------------------------------
+    void response_handler::complete_pending(boost::system::error_code ec)
+    {
+        end_requested_ = true;
+        auto completion = std::move(pending_completion_);
+        pending_completion_ = {};
+        completion(ec);
+    }
+//---------------------------------------------------------------------------------------------------------------------
+    void response_handler::send_then(std::string const& body, custom_callback const& on_complete)
+    {
+        // the awaitable owns the body until the write completed, so it is written without a copy.
+        prepare_body_header(body.length(), "text/plain");
+        compressed_ = compress_body({body.data(), body.size()});
+        pending_completion_ = on_complete;
+        send_header([this, &body](boost::system::error_code ec, std::size_t) {
+            if (ec)
+                return complete_pending(ec);
+
+            auto view = compressed_ ? asio::buffer(*compressed_) : asio::buffer(body);
+            connection_->write_buffers({view}, [this](boost::system::error_code ec, std::size_t) {
+                compressed_.reset();
+                complete_pending(ec);
+            });
+        });
+    }
+//---------------------------------------------------------------------------------------------------------------------
+    void response_handler::send_then(std::vector <char> const& body, custom_callback const& on_complete)
+    {
+        prepare_body_header(body.size(), "application/octet-stream");
+        compressed_ = compress_body({body.data(), body.size()});
+        pending_completion_ = on_complete;
+        send_header([this, &body](boost::system::error_code ec, std::size_t) {
+            if (ec)
+                return complete_pending(ec);
+
+            auto view = compressed_ ? asio::buffer(*compressed_) : asio::buffer(body);
+            connection_->write_buffers({view}, [this](boost::system::error_code ec, std::size_t) {
+                compressed_.reset();
+                complete_pending(ec);
+            });
+        });
+    }
+//---------------------------------------------------------------------------------------------------------------------
+    void response_handler::send_file_then(std::string const& file_name, custom_callback const& on_complete)
+    {
+        pending_completion_ = on_complete;
+        open_file(file_name, [this](std::shared_ptr <internal::file_transfer> const& transfer) {
+            if (!transfer)
+            {
+                // nothing was sent, the response is not ended.
+                auto completion = std::move(pending_completion_);
+                pending_completion_ = {};
+                return completion(boost::system::errc::make_error_code(boost::system::errc::no_such_file_or_directory));
+            }
+
+            send_header([this, transfer](boost::system::error_code ec, std::size_t) {
+                if (ec)
+                    return complete_pending(ec);
+
+                transfer_file(transfer, [this](boost::system::error_code ec) {
+                    complete_pending(ec);
+                });
+            });
+        });
+    }
+//---------------------------------------------------------------------------------------------------------------------
+    void response_handler::write_chunk_then(std::string_view chunk, custom_callback const& on_complete)
+    {
+        if (chunk.empty())
+            return on_complete({});
+
+        if (!header_sent_.load())
+        {
+            if (header_.get_code() == 204)
+                status(200);
+            set("Transfer-Encoding", "chunked");
+            chunked_open_ = true;
+        }
+
+        pending_completion_ = on_complete;
+        send_header([this, chunk](boost::system::error_code ec, std::size_t) {
+            if (ec)
+                return complete_pending(ec);
+
+            // the awaiting coroutine keeps the chunk alive until the write completed.
+            connection_->write_buffers({
+                view_buffer(chunk_header(chunk.size())),
+                view_buffer(chunk),
+                view_buffer(chunk_end)
+            }, [this](boost::system::error_code ec, std::size_t) {
+                // the stream is not complete yet, the response must not be considered ended.
+                auto completion = std::move(pending_completion_);
+                pending_completion_ = {};
+                completion(ec);
+            });
+        });
+    }
+//---------------------------------------------------------------------------------------------------------------------
+    std::string_view response_handler::chunk_header(std::size_t size)
+    {
+        auto [end, ec] = std::to_chars(chunk_header_.data(), chunk_header_.data() + chunk_header_.size() - 2, size, 16);
+        *end++ = '\r';
+        *end++ = '\n';
+        return {chunk_header_.data(), static_cast <std::size_t> (end - chunk_header_.data())};
+    }
+//---------------------------------------------------------------------------------------------------------------------
+    void response_handler::end_chunked_then(custom_callback const& on_complete)
+    {
+        if (!chunked_open_)
+            return on_complete({});
+
+        chunked_open_ = false;
+        pending_completion_ = on_complete;
+        connection_->write_buffers({view_buffer(last_chunk)}, [this](boost::system::error_code ec, std::size_t) {
+            complete_pending(ec);
+        });
+    }
 //#####################################################################################################################
 }
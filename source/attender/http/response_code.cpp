@@ -1,6 +1,7 @@
 #include <attender/http/response_code.hpp>
 
 #include <stdexcept>
+#include <array>
 
 namespace attender
 {
@@ -91,5 +92,23 @@ namespace attender
 			default: return {};
 		}
     }
+//---------------------------------------------------------------------------------------------------------------------
+    std::string_view status_line(int status)
+    {
+        static auto const lines = []{
+            std::array <std::string, 500> lines;
+            for (int code = 100; code != 600; ++code)
+            {
+                auto message = translate_code(code);
+                if (!message.empty())
+                    lines[code - 100] = "HTTP/1.1 " + std::to_string(code) + " " + message + "\r\n";
+            }
+            return lines;
+        }();
+
+        if (status < 100 || status >= 600)
+            return {};
+        return lines[status - 100];
+    }
 //#####################################################################################################################
 }
@@ -1,7 +1,8 @@
 #include <attender/http/response_header.hpp>
 #include <attender/http/response_code.hpp>
+#include <attender/utility/date.hpp>
 
-#include <sstream>
+#include <charconv>
 
 namespace attender
 {
@@ -39,12 +40,22 @@ namespace attender
 //---------------------------------------------------------------------------------------------------------------------
     void response_header::set_field(std::string const& field, std::string const& value)
     {
-        fields_[field] = value;
+        fields_.set(field, value);
     }
 //---------------------------------------------------------------------------------------------------------------------
     void response_header::append_field(std::string const& field, std::string const& value)
     {
-        fields_[field] += value;
+        fields_.add(field, value);
+    }
+//---------------------------------------------------------------------------------------------------------------------
+    bool response_header::try_set_field(std::string const& field, std::string const& value)
+    {
+        return fields_.try_set(field, value);
+    }
+//---------------------------------------------------------------------------------------------------------------------
+    void response_header::remove_field(std::string const& field)
+    {
+        fields_.erase(field);
     }
 //---------------------------------------------------------------------------------------------------------------------
     std::string response_header::get_protocol() const
@@ -69,32 +80,96 @@ namespace attender
 //---------------------------------------------------------------------------------------------------------------------
     boost::optional <std::string> response_header::get_field(std::string const& key) const
     {
-        auto iter = fields_.find(key);
-        if (iter != std::end(fields_))
-            return iter->second;
-        else
-            return boost::none;
+        return fields_.get(key);
     }
 //---------------------------------------------------------------------------------------------------------------------
     bool response_header::has_field(std::string const& key) const
     {
-        return fields_.find(key) != std::end(fields_);
+        return fields_.contains(key);
+    }
+//---------------------------------------------------------------------------------------------------------------------
+    header_fields const& response_header::get_fields() const
+    {
+        return fields_;
     }
 //---------------------------------------------------------------------------------------------------------------------
     std::string response_header::to_string() const
     {
-        std::stringstream sstr;
-        sstr << protocol_ << '/' << version_ << ' ' << code_ << ' ' << message_ << "\r\n";
-        for (auto const& i : fields_)
+        std::string result;
+        append_to(result);
+        return result;
+    }
+//---------------------------------------------------------------------------------------------------------------------
+    void response_header::append_to(std::string& out) const
+    {
+        bool add_date = !has_field("Date");
+
+        // reserve once, cookies are estimated.
+        std::size_t size = protocol_.size() + version_.size() + message_.size() + 16;
+        if (add_date)
+            size += 8 + date::gmt_string_length;
+        size += fields_.serialized_size();
+        size += cookies_.size() * 128 + 2;
+        out.reserve(out.size() + size);
+
+        append_status_line_to(out);
+
+        if (add_date)
+            out.append("Date: ").append(current_gmt_string()).append("\r\n");
+
+        append_fields_to(out);
+        out.append("\r\n");
+    }
+//---------------------------------------------------------------------------------------------------------------------
+    void response_header::append_status_line_to(std::string& out) const
+    {
+        // the precomputed status line can be used, unless protocol, version or message were changed.
+        auto line = status_line(code_);
+        bool precomputed =
+            !line.empty() &&
+            protocol_ == "HTTP" &&
+            version_ == "1.1" &&
+            line.substr(13, line.size() - 15) == message_
+        ;
+
+        if (precomputed)
+            out.append(line);
+        else
+        {
+            char code[12];
+            auto [end, ec] = std::to_chars(code, code + sizeof(code), code_);
+            out.append(protocol_).append(1, '/').append(version_).append(1, ' ');
+            out.append(code, end).append(1, ' ').append(message_).append("\r\n");
+        }
+    }
+//---------------------------------------------------------------------------------------------------------------------
+    void response_header::append_fields_to(std::string& out) const
+    {
+        fields_.append_to(out);
+
+        for (auto const& cookie : cookies_)
         {
-            sstr << i.first << ": " << i.second << "\r\n";
+            out.append("Set-Cookie: ");
+            cookie.append_set_cookie_string(out);
+            out.append("\r\n");
         }
+    }
+//---------------------------------------------------------------------------------------------------------------------
+    void response_header::append_fields_to(std::string& out, std::function <bool(std::string_view)> const& include) const
+    {
+        fields_.for_each([&](std::string_view name, std::string_view value) {
+            if (include(name))
+                out.append(name).append(": ").append(value).append("\r\n");
+        });
+
+        if (cookies_.empty() || !include("Set-Cookie"))
+            return;
         for (auto const& cookie : cookies_)
         {
-            sstr << "Set-Cookie: " << cookie.to_set_cookie_string() << "\r\n";
+            out.append("Set-Cookie: ");
+            cookie.append_set_cookie_string(out);
+            out.append("\r\n");
         }
-        sstr << "\r\n";
-        return sstr.str();
     }
 //---------------------------------------------------------------------------------------------------------------------
     void response_header::set_cookie(cookie const& cookie)
@@ -2,13 +2,13 @@
 #include <attender/http/request_header.hpp>
 #include <attender/http/response.hpp>
 #include <attender/http/request.hpp>
+#include <attender/http/http_file_sink.hpp>
 
 #include <boost/filesystem.hpp>
 #include <boost/algorithm/string.hpp>
 
 #include <stdexcept>
 #include <deque>
-#include <fstream>
 #include <iostream>
 
 namespace attender
@@ -237,8 +237,7 @@ namespace attender
                     res->send_status(403);
                 else
                 {
-                    if (!res->send_file(path))
-                        res->send_status(404);
+                    res->send_file(path, 404);
                 }
             }
             MOUNT_CASE_END()
@@ -249,12 +248,14 @@ namespace attender
                     res->send_status(403);
                 else
                 {
-                    std::shared_ptr <std::ofstream> writer(new std::ofstream{path, std::ios_base::binary});
-                    if (!writer->good())
+                    auto writer = std::make_shared <http_file_sink> (req, res);
+                    if (!writer->open(path))
                         res->status(400).send(path + " not openable");
                     else
-                        req->read_body(*writer, 0).then([writer, res](){
-                            res->status(204).end();
+                        req->read_body(writer, 0).then([writer, res](){
+                            writer->flush([res](boost::system::error_code ec){
+                                res->status(ec ? 500 : 204).end();
+                            });
                         }).except([](auto){
                             //std::cout << err.message() << "\n";
                         });
@@ -268,12 +269,14 @@ namespace attender
                     res->send_status(403);
                 else
                 {
-                    std::shared_ptr <std::ofstream> writer(new std::ofstream{path, std::ios_base::binary});
-                    if (!writer->good())
+                    auto writer = std::make_shared <http_file_sink> (req, res);
+                    if (!writer->open(path))
                         res->status(400).send(path + " not openable");
                     else
-                        req->read_body(*writer, 0).then([writer, res](){
-                            res->send_status(204);
+                        req->read_body(writer, 0).then([writer, res](){
+                            writer->flush([res](boost::system::error_code ec){
+                                res->send_status(ec ? 500 : 204);
+                            });
                         }).except([](auto){
 
                         });
@@ -299,9 +302,13 @@ namespace attender
                     res->send_status(403);
                 else
                 {
-                    std::ifstream reader(path, std::ios_base::binary);
-                    if (!reader.good())
+                    // only the file system metadata is needed, the file is not opened on the io thread.
+                    boost::system::error_code ec;
+                    auto size = boost::filesystem::file_size(path, ec);
+                    if (ec || !boost::filesystem::is_regular_file(path, ec))
                         res->send_status(404);
+                    else
+                        res->status(200).set("Content-Length", std::to_string(size)).end();
                 }
             }
             MOUNT_CASE_END()
@@ -0,0 +1,525 @@
+#include <attender/http/sse_hub.hpp>
+#include <attender/http/http_connection_interface.hpp>
+#include <attender/http/request.hpp>
+#include <attender/http/response.hpp>
+
+#include <boost/asio/steady_timer.hpp>
+
+#include <algorithm>
+#include <charconv>
+#include <deque>
+#include <mutex>
+#include <string_view>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace attender
+{
+//#####################################################################################################################
+    namespace
+    {
+        // immutable and shared by all subscribers that write it.
+        using frame = std::shared_ptr <std::string const>;
+
+        // a subscriber writes at most this many frames with one gathering write.
+        constexpr std::size_t max_gather = 64;
+
+        /**
+         *  Wraps the payload into a chunk of the chunked transfer coding.
+         */
+        frame make_frame(std::string_view payload)
+        {
+            char size[2 * sizeof(std::size_t)];
+            auto [end, ec] = std::to_chars(size, size + sizeof(size), payload.size(), 16);
+
+            std::string chunk;
+            chunk.reserve(static_cast <std::size_t> (end - size) + payload.size() + 4);
+            chunk.append(size, end);
+            chunk.append("\r\n");
+            chunk.append(payload);
+            chunk.append("\r\n");
+            return std::make_shared <std::string const> (std::move(chunk));
+        }
+
+        frame const& last_chunk()
+        {
+            static frame const last = std::make_shared <std::string const> ("0\r\n\r\n");
+            return last;
+        }
+    }
+//#####################################################################################################################
+    struct sse_hub::implementation : public std::enable_shared_from_this <sse_hub::implementation>
+    {
+        struct subscriber
+        {
+            std::string topic;
+            response_handler* response;
+            std::shared_ptr <conclusion_observer> observer;
+            std::weak_ptr <implementation> hub;
+
+            std::mutex protect;
+            std::deque <frame> queue;
+
+            // kept alive while they are written.
+            std::vector <frame> writing;
+
+            // a write is in flight or a flush is posted. Only then the connection is written to.
+            bool busy = true;
+
+            // the last chunk is queued, the response ends after it.
+            bool ending = false;
+
+            // the response ends without the last chunk.
+            bool aborted = false;
+
+            // end was called, the response is gone.
+            bool ended = false;
+        };
+
+        enum class action
+        {
+            none,
+            flush,
+            cancel
+        };
+
+        struct topic_state
+        {
+            std::vector <std::shared_ptr <subscriber>> subscribers;
+            std::deque <std::pair <std::string, frame>> replay;
+        };
+
+        asio::io_service* service;
+        sse_options options;
+        frame heartbeat_frame;
+        frame retry_frame;
+
+        // all members below are guarded by protect.
+        mutable std::mutex protect;
+        boost::asio::steady_timer heartbeat;
+        std::unordered_map <std::string, topic_state> topics;
+        bool closed;
+
+        implementation(asio::io_service* service, sse_options const& options)
+            : service{service}
+            , options{options}
+            , heartbeat_frame{make_frame(":\n\n")}
+            , retry_frame{}
+            , protect{}
+            , heartbeat{*service}
+            , topics{}
+            , closed{false}
+        {
+            if (options.retry.count() > 0)
+                retry_frame = make_frame("retry: " + std::to_string(options.retry.count()) + "\n\n");
+        }
+
+        /**
+         *  Queues a frame for the subscriber, guarded by the lock of the hub.
+         */
+        action enqueue(subscriber& sub, frame const& data)
+        {
+            std::lock_guard <std::mutex> guard{sub.protect};
+            if (sub.ending || sub.aborted)
+                return action::none;
+
+            if (sub.queue.size() >= options.queue_limit)
+            {
+                if (options.overflow == sse_overflow::disconnect)
+                {
+                    sub.aborted = true;
+                    sub.queue.clear();
+                    if (sub.busy)
+                        return action::cancel;
+                    sub.busy = true;
+                    return action::flush;
+                }
+                sub.queue.pop_front();
+            }
+
+            sub.queue.push_back(data);
+            if (sub.busy)
+                return action::none;
+            sub.busy = true;
+            return action::flush;
+        }
+
+        /**
+         *  Queues the last chunk, the response ends after it was written. Guarded by the lock of the hub.
+         */
+        action end_stream(subscriber& sub)
+        {
+            std::lock_guard <std::mutex> guard{sub.protect};
+            if (sub.ending || sub.aborted)
+                return action::none;
+
+            sub.ending = true;
+            sub.queue.push_back(last_chunk());
+            if (sub.busy)
+                return action::none;
+            sub.busy = true;
+            return action::flush;
+        }
+
+        /**
+         *  Starts the writes and cancellations with one post to the io context.
+         */
+        void dispatch(std::vector <std::shared_ptr <subscriber>> flushes, std::vector <std::shared_ptr <subscriber>> cancels)
+        {
+            if (flushes.empty() && cancels.empty())
+                return;
+
+            asio::post(*service, [flushes = std::move(flushes), cancels = std::move(cancels)]{
+                for (auto const& sub : cancels)
+                    cancel(sub);
+                for (auto const& sub : flushes)
+                    flush(sub);
+            });
+        }
+
+        /**
+         *  Writes what is queued or ends the response. Runs on the io context while busy and no write is in flight.
+         */
+        static void flush(std::shared_ptr <subscriber> const& sub)
+        {
+            std::unique_lock <std::mutex> lock{sub->protect};
+
+            // the connection is gone already.
+            if (!sub->observer->is_alive())
+            {
+                sub->ended = true;
+                lock.unlock();
+                return remove(sub);
+            }
+
+            if (sub->aborted || (sub->ending && sub->queue.empty()))
+            {
+                sub->ended = true;
+                lock.unlock();
+                remove(sub);
+                return sub->response->end();
+            }
+
+            if (sub->queue.empty())
+            {
+                sub->busy = false;
+                return;
+            }
+
+            http_connection_interface::buffer_sequence buffers;
+            while (!sub->queue.empty() && sub->writing.size() < max_gather)
+            {
+                sub->writing.push_back(std::move(sub->queue.front()));
+                sub->queue.pop_front();
+                buffers.push_back(asio::buffer(*sub->writing.back()));
+            }
+            lock.unlock();
+
+            sub->response->get_connection()->write_buffers(buffers, [sub](boost::system::error_code ec, std::size_t) {
+                {
+                    std::lock_guard <std::mutex> guard{sub->protect};
+                    sub->writing.clear();
+                    if (ec)
+                        sub->aborted = true;
+                }
+                flush(sub);
+            });
+        }
+
+        /**
+         *  Notices a client that closed the connection, even while nothing is written to it.
+         *  A client of an event stream sends nothing, so the socket only becomes readable when it is closed.
+         *  Nothing is read, the wait does not interfere with the connection or TLS.
+         */
+        static void watch(std::shared_ptr <subscriber> const& sub)
+        {
+            auto* socket = sub->response->get_connection()->get_socket();
+            socket->async_wait(asio::ip::tcp::socket::wait_read, [sub, socket](boost::system::error_code ec) {
+                std::unique_lock <std::mutex> lock{sub->protect};
+                if (ec == asio::error::operation_aborted || sub->ended || sub->aborted || !sub->observer->is_alive())
+                    return;
+
+                // data instead of the end of the stream, the client is still there but cannot be watched anymore.
+                boost::system::error_code available_ec;
+                if (!ec && socket->available(available_ec) != 0 && !available_ec)
+                    return;
+
+                sub->aborted = true;
+                sub->queue.clear();
+                if (sub->busy)
+                    return;
+                sub->busy = true;
+                lock.unlock();
+                flush(sub);
+            });
+        }
+
+        /**
+         *  Aborts the write in flight of a subscriber that overflowed, its completion ends the response.
+         */
+        static void cancel(std::shared_ptr <subscriber> const& sub)
+        {
+            std::lock_guard <std::mutex> guard{sub->protect};
+            if (sub->ended || !sub->observer->is_alive())
+                return;
+
+            boost::system::error_code ec;
+            sub->response->get_connection()->get_socket()->cancel(ec);
+        }
+
+        static void remove(std::shared_ptr <subscriber> const& sub)
+        {
+            auto hub = sub->hub.lock();
+            if (!hub)
+                return;
+
+            std::lock_guard <std::mutex> guard{hub->protect};
+            auto iter = hub->topics.find(sub->topic);
+            if (iter == hub->topics.end())
+                return;
+
+            auto& subscribers = iter->second.subscribers;
+            auto position = std::find(subscribers.begin(), subscribers.end(), sub);
+            if (position != subscribers.end())
+            {
+                std::swap(*position, subscribers.back());
+                subscribers.pop_back();
+            }
+            if (subscribers.empty() && iter->second.replay.empty())
+                hub->topics.erase(iter);
+        }
+
+        /**
+         *  Guarded by protect.
+         */
+        void schedule_heartbeat()
+        {
+            if (options.heartbeat_interval.count() <= 0)
+                return;
+
+            heartbeat.expires_after(options.heartbeat_interval);
+            heartbeat.async_wait([weak = weak_from_this()](boost::system::error_code ec) {
+                if (ec)
+                    return;
+                if (auto hub = weak.lock())
+                    hub->beat();
+            });
+        }
+
+        /**
+         *  Sends a comment to every subscriber that has nothing to write.
+         */
+        void beat()
+        {
+            std::vector <std::shared_ptr <subscriber>> flushes;
+            {
+                std::lock_guard <std::mutex> guard{protect};
+                if (closed)
+                    return;
+
+                for (auto& [name, state] : topics)
+                {
+                    for (auto const& sub : state.subscribers)
+                    {
+                        std::lock_guard <std::mutex> sub_guard{sub->protect};
+                        if (sub->busy || sub->ending || sub->aborted)
+                            continue;
+
+                        sub->queue.push_back(heartbeat_frame);
+                        sub->busy = true;
+                        flushes.push_back(sub);
+                    }
+                }
+                schedule_heartbeat();
+            }
+            dispatch(std::move(flushes), {});
+        }
+    };
+//#####################################################################################################################
+    sse_hub::sse_hub(asio::io_service& service, sse_options options)
+        : impl_{std::make_shared <implementation> (&service, options)}
+    {
+        std::lock_guard <std::mutex> guard{impl_->protect};
+        impl_->schedule_heartbeat();
+    }
+//---------------------------------------------------------------------------------------------------------------------
+    sse_hub::~sse_hub()
+    {
+        close();
+    }
+//---------------------------------------------------------------------------------------------------------------------
+    void sse_hub::subscribe(std::string const& topic, request_handler* req, response_handler* res)
+    {
+        auto sub = std::make_shared <implementation::subscriber> ();
+        sub->topic = topic;
+        sub->response = res;
+        sub->observer = res->observe_conclusion();
+        sub->hub = impl_;
+
+        auto last_event_id = req->get_header_field("Last-Event-ID");
+        bool closed = false;
+        {
+            // one lock, or close could run before the subscriber is added and it would never end.
+            std::lock_guard <std::mutex> guard{impl_->protect};
+            closed = impl_->closed;
+            if (!closed)
+            {
+                if (impl_->retry_frame)
+                    sub->queue.push_back(impl_->retry_frame);
+
+                // the client missed the events after its last one. If that is not in the ring anymore, it missed them all.
+                auto& entry = impl_->topics[topic];
+                if (last_event_id)
+                {
+                    auto const& replay = entry.replay;
+                    auto last = std::find_if(replay.rbegin(), replay.rend(), [&last_event_id](auto const& event) {
+                        return event.first == *last_event_id;
+                    });
+                    for (auto iter = last.base(); iter != replay.end(); ++iter)
+                        sub->queue.push_back(iter->second);
+                }
+                entry.subscribers.push_back(sub);
+            }
+        }
+        if (closed)
+            return res->send_status(503);
+
+        res->status(200);
+        res->set("Content-Type", "text/event-stream");
+        res->set("Cache-Control", "no-cache");
+        res->set("Transfer-Encoding", "chunked");
+
+        // the subscriber is busy until the header is sent, events published meanwhile are queued.
+        res->send_header([sub](boost::system::error_code ec, std::size_t) {
+            if (ec)
+            {
+                std::lock_guard <std::mutex> guard{sub->protect};
+                sub->aborted = true;
+            }
+            else
+                implementation::watch(sub);
+            implementation::flush(sub);
+        });
+    }
+//---------------------------------------------------------------------------------------------------------------------
+    std::size_t sse_hub::publish(std::string const& topic, sse_event const& event)
+    {
+        auto data = make_frame(format(event));
+        auto const replayable = !event.id.empty() && impl_->options.replay_capacity > 0;
+
+        std::vector <std::shared_ptr <implementation::subscriber>> flushes;
+        std::vector <std::shared_ptr <implementation::subscriber>> cancels;
+        std::size_t reached = 0;
+        {
+            std::lock_guard <std::mutex> guard{impl_->protect};
+            if (impl_->closed)
+                return 0;
+
+            auto iter = impl_->topics.find(topic);
+            if (iter == impl_->topics.end())
+            {
+                // the ring is kept for clients that subscribe later.
+                if (!replayable)
+                    return 0;
+                iter = impl_->topics.emplace(topic, implementation::topic_state{}).first;
+            }
+
+            if (replayable)
+            {
+                auto& replay = iter->second.replay;
+                if (replay.size() == impl_->options.replay_capacity)
+                    replay.pop_front();
+                replay.emplace_back(event.id, data);
+            }
+
+            for (auto const& sub : iter->second.subscribers)
+            {
+                switch (impl_->enqueue(*sub, data))
+                {
+                    case implementation::action::flush:
+                        flushes.push_back(sub);
+                        ++reached;
+                        break;
+                    case implementation::action::cancel:
+                        cancels.push_back(sub);
+                        break;
+                    case implementation::action::none:
+                        ++reached;
+                        break;
+                }
+            }
+        }
+        impl_->dispatch(std::move(flushes), std::move(cancels));
+        return reached;
+    }
+//---------------------------------------------------------------------------------------------------------------------
+    void sse_hub::close()
+    {
+        std::vector <std::shared_ptr <implementation::subscriber>> flushes;
+        {
+            std::lock_guard <std::mutex> guard{impl_->protect};
+            if (impl_->closed)
+                return;
+            impl_->closed = true;
+            impl_->heartbeat.cancel();
+
+            for (auto& [name, state] : impl_->topics)
+            {
+                for (auto const& sub : state.subscribers)
+                {
+                    if (impl_->end_stream(*sub) == implementation::action::flush)
+                        flushes.push_back(sub);
+                }
+            }
+            impl_->topics.clear();
+        }
+        impl_->dispatch(std::move(flushes), {});
+    }
+//---------------------------------------------------------------------------------------------------------------------
+    std::size_t sse_hub::subscriber_count(std::string const& topic) const
+    {
+        std::lock_guard <std::mutex> guard{impl_->protect};
+        auto iter = impl_->topics.find(topic);
+        if (iter == impl_->topics.end())
+            return 0;
+        return iter->second.subscribers.size();
+    }
+//---------------------------------------------------------------------------------------------------------------------
+    std::size_t sse_hub::subscriber_count() const
+    {
+        std::lock_guard <std::mutex> guard{impl_->protect};
+        std::size_t count = 0;
+        for (auto const& [name, state] : impl_->topics)
+            count += state.subscribers.size();
+        return count;
+    }
+//---------------------------------------------------------------------------------------------------------------------
+    std::string sse_hub::format(sse_event const& event)
+    {
+        std::string text;
+        text.reserve(event.id.size() + event.event.size() + event.data.size() + 32);
+
+        if (!event.id.empty())
+            text.append("id: ").append(event.id).append("\n");
+        if (!event.event.empty())
+            text.append("event: ").append(event.event).append("\n");
+
+        // every line of the data is a field of its own, lines end with CRLF, LF or CR.
+        std::string_view data = event.data;
+        for (;;)
+        {
+            auto line_end = data.find_first_of("\r\n");
+            text.append("data: ").append(data.substr(0, line_end)).append("\n");
+            if (line_end == std::string_view::npos)
+                break;
+
+            if (data[line_end] == '\r' && line_end + 1 < data.size() && data[line_end + 1] == '\n')
+                ++line_end;
+            data.remove_prefix(line_end + 1);
+        }
+        text.append("\n");
+        return text;
+    }
+//#####################################################################################################################
+}
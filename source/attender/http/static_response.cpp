@@ -0,0 +1,90 @@
+#include <attender/http/static_response.hpp>
+
+#include <boost/algorithm/string/predicate.hpp>
+
+namespace attender
+{
+//#####################################################################################################################
+    namespace
+    {
+        response_header make_header(int code, std::string const& content_type)
+        {
+            response_header header;
+            header.set_code(code);
+            header.set_field("Content-Type", content_type);
+            return header;
+        }
+    }
+//#####################################################################################################################
+    static_response::static_response(int code, std::string_view body, std::string const& content_type)
+        : static_response(make_header(code, content_type), body)
+    {
+    }
+//---------------------------------------------------------------------------------------------------------------------
+    static_response::static_response(response_header header, std::string_view body)
+        : buffer_{}
+        , status_line_size_{0}
+        , body_offset_{0}
+        , code_{header.get_code()}
+    {
+        header.set_field("Content-Length", std::to_string(body.size()));
+        header.remove_field("Date");
+
+        auto buffer = std::make_shared <std::string> ();
+        buffer->reserve(64 + header.get_fields().serialized_size() + body.size());
+
+        header.append_status_line_to(*buffer);
+        status_line_size_ = buffer->size();
+
+        header.append_fields_to(*buffer);
+        buffer->append("\r\n");
+        body_offset_ = buffer->size();
+
+        buffer->append(body);
+        buffer_ = std::move(buffer);
+    }
+//---------------------------------------------------------------------------------------------------------------------
+    int static_response::get_code() const noexcept
+    {
+        return code_;
+    }
+//---------------------------------------------------------------------------------------------------------------------
+    std::string_view static_response::get_status_line() const noexcept
+    {
+        return std::string_view{*buffer_}.substr(0, status_line_size_);
+    }
+//---------------------------------------------------------------------------------------------------------------------
+    std::string_view static_response::get_remainder() const noexcept
+    {
+        return std::string_view{*buffer_}.substr(status_line_size_);
+    }
+//---------------------------------------------------------------------------------------------------------------------
+    std::string_view static_response::get_body() const noexcept
+    {
+        return std::string_view{*buffer_}.substr(body_offset_);
+    }
+//---------------------------------------------------------------------------------------------------------------------
+    bool static_response::has_field(std::string_view name) const noexcept
+    {
+        // the fields lie between the status line and the empty line, one "name: value\r\n" each.
+        auto fields = std::string_view{*buffer_}.substr(status_line_size_, body_offset_ - status_line_size_);
+        for (std::size_t begin = 0; begin < fields.size();)
+        {
+            auto end = fields.find("\r\n", begin);
+            auto line = fields.substr(begin, end - begin);
+            auto colon = line.find(':');
+            if (colon != std::string_view::npos && boost::algorithm::iequals(line.substr(0, colon), name))
+                return true;
+            if (end == std::string_view::npos)
+                break;
+            begin = end + 2;
+        }
+        return false;
+    }
+//---------------------------------------------------------------------------------------------------------------------
+    std::shared_ptr <std::string const> const& static_response::get_buffer() const noexcept
+    {
+        return buffer_;
+    }
+//#####################################################################################################################
+}
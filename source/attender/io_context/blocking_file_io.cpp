@@ -0,0 +1,105 @@
+#include <attender/io_context/blocking_file_io.hpp>
+
+#include <algorithm>
+
+namespace attender
+{
+//#####################################################################################################################
+    blocking_file_io::blocking_file_io(asio::io_context* context, file_io_options const& options)
+        : context_{context}
+        , lock_{}
+        , wake_{}
+        , queue_{}
+        , threads_{}
+        , stopping_{false}
+    {
+        // every thread performs one operation at a time, so the queue depth caps the amount of threads.
+        auto thread_count = std::max <std::size_t> (1, std::min(options.threads, options.queue_depth));
+        for (std::size_t i = 0; i != thread_count; ++i)
+            threads_.emplace_back([this]{ work(); });
+    }
+//---------------------------------------------------------------------------------------------------------------------
+    blocking_file_io::~blocking_file_io()
+    {
+        std::deque <operation> aborted;
+        {
+            std::lock_guard <std::mutex> guard{lock_};
+            stopping_ = true;
+            aborted.swap(queue_);
+        }
+        wake_.notify_all();
+
+        for (auto& thread : threads_)
+            thread.join();
+
+        for (auto& op : aborted)
+        {
+            asio::post(*context_, [handler = std::move(op.handler)]{
+                handler(asio::error::operation_aborted, 0);
+            });
+        }
+    }
+//---------------------------------------------------------------------------------------------------------------------
+    void blocking_file_io::async_read(async_file const& file, std::uint64_t offset, char* buffer, std::size_t size, file_io_callback handler)
+    {
+        enqueue({&file, offset, buffer, nullptr, size, std::move(handler)});
+    }
+//---------------------------------------------------------------------------------------------------------------------
+    void blocking_file_io::async_write(async_file const& file, std::uint64_t offset, char const* buffer, std::size_t size, file_io_callback handler)
+    {
+        enqueue({&file, offset, nullptr, buffer, size, std::move(handler)});
+    }
+//---------------------------------------------------------------------------------------------------------------------
+    void blocking_file_io::async_open(async_file& file, std::string const& path, async_file::mode open_mode, file_io_callback handler)
+    {
+        enqueue({&file, 0, nullptr, nullptr, 0, std::move(handler), &file, path, open_mode});
+    }
+//---------------------------------------------------------------------------------------------------------------------
+    char const* blocking_file_io::backend() const
+    {
+        return "threads";
+    }
+//---------------------------------------------------------------------------------------------------------------------
+    void blocking_file_io::enqueue(operation&& op)
+    {
+        {
+            std::lock_guard <std::mutex> guard{lock_};
+            queue_.push_back(std::move(op));
+        }
+        wake_.notify_one();
+    }
+//---------------------------------------------------------------------------------------------------------------------
+    void blocking_file_io::work()
+    {
+        for (;;)
+        {
+            std::unique_lock <std::mutex> guard{lock_};
+            wake_.wait(guard, [this]{ return stopping_ || !queue_.empty(); });
+            if (stopping_)
+                return;
+
+            auto op = std::move(queue_.front());
+            queue_.pop_front();
+            guard.unlock();
+
+            boost::system::error_code ec;
+            std::size_t amount = 0;
+            if (op.opened)
+            {
+                if (op.opened->open(op.path, op.open_mode))
+                    amount = static_cast <std::size_t> (op.opened->size());
+                else
+                    ec = make_error_code(boost::system::errc::no_such_file_or_directory);
+            }
+            else if (op.read_buffer)
+                amount = op.file->read_at(op.offset, op.read_buffer, op.size, ec);
+            else
+                amount = op.file->write_at(op.offset, op.write_buffer, op.size, ec);
+
+            asio::post(*context_, [handler = std::move(op.handler), ec, amount]{
+                handler(ec, amount);
+            });
+        }
+    }
+//#####################################################################################################################
+}
@@ -0,0 +1,184 @@
+#include <attender/io_context/file_io.hpp>
+#include <attender/io_context/blocking_file_io.hpp>
+#include <attender/io_context/uring_file_io.hpp>
+
+#ifdef WINDOWS
+#   include <io.h>
+#   include <fcntl.h>
+#   include <sys/stat.h>
+#else
+#   include <fcntl.h>
+#   include <sys/stat.h>
+#   include <unistd.h>
+#endif
+
+#include <cerrno>
+#include <system_error>
+
+namespace attender
+{
+    namespace
+    {
+        boost::system::error_code last_error()
+        {
+            return {errno, boost::system::system_category()};
+        }
+    }
+//#####################################################################################################################
+    async_file::async_file() noexcept
+        : fd_{-1}
+    {
+    }
+//---------------------------------------------------------------------------------------------------------------------
+    async_file::~async_file()
+    {
+        close();
+    }
+//---------------------------------------------------------------------------------------------------------------------
+    bool async_file::open(std::string const& path, mode open_mode)
+    {
+        close();
+#ifdef WINDOWS
+        if (open_mode == mode::read)
+            return assign(::_open(path.c_str(), _O_RDONLY | _O_BINARY));
+        else
+            return assign(::_open(path.c_str(), _O_WRONLY | _O_CREAT | _O_TRUNC | _O_BINARY, _S_IREAD | _S_IWRITE));
+#else
+        if (open_mode == mode::read)
+            return assign(::open(path.c_str(), O_RDONLY | O_CLOEXEC));
+        else
+            return assign(::open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644));
+#endif
+    }
+//---------------------------------------------------------------------------------------------------------------------
+    bool async_file::assign(int fd)
+    {
+        close();
+        fd_ = fd;
+#ifndef WINDOWS
+        // directories can be opened for reading, but not read from.
+        struct stat info;
+        if (fd_ != -1 && (::fstat(fd_, &info) != 0 || !S_ISREG(info.st_mode)))
+            close();
+#endif
+        return fd_ != -1;
+    }
+//---------------------------------------------------------------------------------------------------------------------
+    void async_file::close()
+    {
+        if (fd_ == -1)
+            return;
+#ifdef WINDOWS
+        ::_close(fd_);
+#else
+        ::close(fd_);
+#endif
+        fd_ = -1;
+    }
+//---------------------------------------------------------------------------------------------------------------------
+    bool async_file::is_open() const
+    {
+        return fd_ != -1;
+    }
+//---------------------------------------------------------------------------------------------------------------------
+    int async_file::native_handle() const
+    {
+        return fd_;
+    }
+//---------------------------------------------------------------------------------------------------------------------
+    std::uint64_t async_file::size() const
+    {
+#ifdef WINDOWS
+        struct _stat64 info;
+        if (::_fstat64(fd_, &info) != 0)
+            return 0;
+#else
+        struct stat info;
+        if (::fstat(fd_, &info) != 0)
+            return 0;
+#endif
+        return static_cast <std::uint64_t> (info.st_size);
+    }
+//---------------------------------------------------------------------------------------------------------------------
+    std::size_t async_file::read_at(std::uint64_t offset, char* buffer, std::size_t size, boost::system::error_code& ec) const
+    {
+        std::size_t total = 0;
+        while (total < size)
+        {
+#ifdef WINDOWS
+            // there is no pread, operations on one file are not issued concurrently.
+            if (::_lseeki64(fd_, static_cast <__int64> (offset + total), SEEK_SET) == -1)
+            {
+                ec = last_error();
+                return total;
+            }
+            auto amount = ::_read(fd_, buffer + total, static_cast <unsigned int> (size - total));
+#else
+            auto amount = ::pread(fd_, buffer + total, size - total, static_cast <off_t> (offset + total));
+#endif
+            if (amount < 0)
+            {
+                if (errno == EINTR)
+                    continue;
+                ec = last_error();
+                return total;
+            }
+            if (amount == 0)
+                break;
+            total += static_cast <std::size_t> (amount);
+        }
+        return total;
+    }
+//---------------------------------------------------------------------------------------------------------------------
+    std::size_t async_file::write_at(std::uint64_t offset, char const* buffer, std::size_t size, boost::system::error_code& ec) const
+    {
+        std::size_t total = 0;
+        while (total < size)
+        {
+#ifdef WINDOWS
+            if (::_lseeki64(fd_, static_cast <__int64> (offset + total), SEEK_SET) == -1)
+            {
+                ec = last_error();
+                return total;
+            }
+            auto amount = ::_write(fd_, buffer + total, static_cast <unsigned int> (size - total));
+#else
+            auto amount = ::pwrite(fd_, buffer + total, size - total, static_cast <off_t> (offset + total));
+#endif
+            if (amount < 0)
+            {
+                if (errno == EINTR)
+                    continue;
+                ec = last_error();
+                return total;
+            }
+            if (amount == 0)
+            {
+                // nothing was written and nothing failed, retrying would not make progress.
+                ec = make_error_code(boost::system::errc::io_error);
+                return total;
+            }
+            total += static_cast <std::size_t> (amount);
+        }
+        return total;
+    }
+//#####################################################################################################################
+    std::unique_ptr <file_io_service> file_io_service::create(asio::io_context* context, file_io_options const& options)
+    {
+#ifdef ATTENDER_ENABLE_IO_URING
+        if (options.prefer_io_uring)
+        {
+            try
+            {
+                return std::make_unique <uring_file_io> (context, options);
+            }
+            catch (std::system_error const&)
+            {
+                // io_uring is unavailable at runtime, fall through to the thread pool.
+            }
+        }
+#endif
+        return std::make_unique <blocking_file_io> (context, options);
+    }
+//#####################################################################################################################
+}
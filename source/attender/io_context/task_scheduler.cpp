@@ -0,0 +1,321 @@
+#include <attender/io_context/task_scheduler.hpp>
+
+namespace attender
+{
+    namespace
+    {
+        thread_local task_scheduler* current_scheduler = nullptr;
+        thread_local std::size_t current_index = 0;
+
+        constexpr std::size_t spins_before_sleep = 64;
+    }
+//#####################################################################################################################
+    task_scheduler::task_scheduler(task_scheduler_options const& options)
+        : workers_{}
+        , injection_lock_{}
+        , injected_{}
+        , sleep_lock_{}
+        , wake_{}
+        , sleeping_{0}
+        , pending_{0}
+        , stopping_{false}
+    {
+        auto thread_count = options.threads == 0 ? 1 : options.threads;
+        for (std::size_t i = 0; i != thread_count; ++i)
+            workers_.push_back(std::make_unique <worker>());
+
+        // deques must all exist before anyone steals.
+        for (std::size_t i = 0; i != thread_count; ++i)
+            workers_[i]->thread = std::thread{[this, i]{ work(i); }};
+    }
+//---------------------------------------------------------------------------------------------------------------------
+    task_scheduler::~task_scheduler()
+    {
+        {
+            std::lock_guard <std::mutex> guard{sleep_lock_};
+            stopping_.store(true);
+        }
+        wake_.notify_all();
+
+        for (auto& w : workers_)
+            w->thread.join();
+
+        // tasks that never ran. Their groups must not wait for them forever.
+        auto cancel = [cancelled = std::make_exception_ptr(task_cancelled{})](task* job) {
+            auto* group = job->group;
+            delete job;
+            if (group)
+                group->finish(cancelled);
+        };
+        for (auto& w : workers_)
+            while (auto job = w->deque.steal())
+                cancel(*job);
+        for (auto* job : injected_)
+            cancel(job);
+        injected_.clear();
+    }
+//---------------------------------------------------------------------------------------------------------------------
+    task_scheduler* task_scheduler::current() noexcept
+    {
+        return current_scheduler;
+    }
+//---------------------------------------------------------------------------------------------------------------------
+    std::size_t task_scheduler::get_thread_count() const noexcept
+    {
+        return workers_.size();
+    }
+//---------------------------------------------------------------------------------------------------------------------
+    void task_scheduler::submit(std::function <void()> work)
+    {
+        submit(new task{std::move(work), nullptr});
+    }
+//---------------------------------------------------------------------------------------------------------------------
+    void task_scheduler::submit(task* job)
+    {
+        pending_.fetch_add(1);
+        if (current_scheduler == this)
+            workers_[current_index]->deque.push(job);
+        else
+        {
+            std::lock_guard <std::mutex> guard{injection_lock_};
+            injected_.push_back(job);
+        }
+
+        if (sleeping_.load() != 0)
+        {
+            // taking the lock orders this against a worker that is about to sleep.
+            std::lock_guard <std::mutex> guard{sleep_lock_};
+            wake_.notify_one();
+        }
+    }
+//---------------------------------------------------------------------------------------------------------------------
+    task_scheduler::task* task_scheduler::find_task(std::size_t self)
+    {
+        auto const worker_count = workers_.size();
+        if (self < worker_count)
+        {
+            if (auto job = workers_[self]->deque.pop())
+                return *job;
+        }
+
+        {
+            std::lock_guard <std::mutex> guard{injection_lock_};
+            if (!injected_.empty())
+            {
+                auto* job = injected_.front();
+                injected_.pop_front();
+                return job;
+            }
+        }
+
+        auto start = self < worker_count ? self + 1 : 0;
+        for (std::size_t i = 0; i != worker_count; ++i)
+        {
+            auto victim = (start + i) % worker_count;
+            if (victim == self)
+                continue;
+            if (auto job = workers_[victim]->deque.steal())
+                return *job;
+        }
+        return nullptr;
+    }
+//---------------------------------------------------------------------------------------------------------------------
+    void task_scheduler::execute(task* job)
+    {
+        pending_.fetch_sub(1);
+
+        std::exception_ptr exception;
+        try
+        {
+            job->work();
+        }
+        catch(...)
+        {
+            exception = std::current_exception();
+        }
+
+        auto* group = job->group;
+        delete job;
+        if (group)
+            group->finish(exception);
+    }
+//---------------------------------------------------------------------------------------------------------------------
+    bool task_scheduler::run_one()
+    {
+        auto* job = find_task(current_index);
+        if (!job)
+            return false;
+        execute(job);
+        return true;
+    }
+//---------------------------------------------------------------------------------------------------------------------
+    void task_scheduler::work(std::size_t index)
+    {
+        current_scheduler = this;
+        current_index = index;
+
+        std::size_t idle = 0;
+        while (!stopping_.load())
+        {
+            if (auto* job = find_task(index))
+            {
+                idle = 0;
+                execute(job);
+                continue;
+            }
+
+            if (++idle < spins_before_sleep)
+            {
+                std::this_thread::yield();
+                continue;
+            }
+
+            std::unique_lock <std::mutex> guard{sleep_lock_};
+            sleeping_.fetch_add(1);
+            wake_.wait(guard, [this]{ return stopping_.load() || pending_.load() != 0; });
+            sleeping_.fetch_sub(1);
+            idle = 0;
+        }
+    }
+//#####################################################################################################################
+    task_group::task_group(task_scheduler& scheduler)
+        : scheduler_{&scheduler}
+        , outstanding_{0}
+        , lock_{}
+        , finished_{}
+        , exception_{}
+    {
+    }
+//---------------------------------------------------------------------------------------------------------------------
+    task_group::~task_group()
+    {
+        try
+        {
+            wait();
+        }
+        catch(...)
+        {
+        }
+    }
+//---------------------------------------------------------------------------------------------------------------------
+    void task_group::run(std::function <void()> work)
+    {
+        outstanding_.fetch_add(1);
+        scheduler_->submit(new task_scheduler::task{std::move(work), this});
+    }
+//---------------------------------------------------------------------------------------------------------------------
+    void task_group::wait()
+    {
+        // workers help with queued tasks while waiting. Other threads block, taking arbitrary tasks from the
+        // shared queue would let their stacks grow with every nested wait.
+        if (task_scheduler::current() == scheduler_)
+        {
+            while (outstanding_.load(std::memory_order_acquire) != 0)
+            {
+                if (!scheduler_->run_one())
+                    std::this_thread::yield();
+            }
+        }
+
+        std::exception_ptr exception;
+        {
+            // also orders this after the last finish, which still holds the lock after its decrement.
+            std::unique_lock <std::mutex> lock{lock_};
+            finished_.wait(lock, [this]{ return outstanding_.load(std::memory_order_acquire) == 0; });
+            std::swap(exception, exception_);
+        }
+        if (exception)
+            std::rethrow_exception(exception);
+    }
+//---------------------------------------------------------------------------------------------------------------------
+    void task_group::finish(std::exception_ptr const& exception)
+    {
+        if (exception)
+        {
+            std::lock_guard <std::mutex> guard{lock_};
+            if (!exception_)
+                exception_ = exception;
+        }
+
+        // only the last task takes the lock. A waiter takes it before it returns, so the group outlives this.
+        auto outstanding = outstanding_.load(std::memory_order_relaxed);
+        while (outstanding > 1)
+        {
+            if (outstanding_.compare_exchange_weak(outstanding, outstanding - 1, std::memory_order_release, std::memory_order_relaxed))
+                return;
+        }
+
+        std::lock_guard <std::mutex> guard{lock_};
+        if (outstanding_.fetch_sub(1, std::memory_order_release) == 1)
+            finished_.notify_all();
+    }
+//#####################################################################################################################
+    task_sequence::task_sequence()
+        : scheduler_{nullptr}
+        , group_{}
+        , queue_lock_{}
+        , queued_{}
+        , queue_running_{false}
+    {
+    }
+//---------------------------------------------------------------------------------------------------------------------
+    task_sequence::~task_sequence()
+    {
+        // the queue has to outlive the draining task, which the group waits for.
+        group_.reset();
+    }
+//---------------------------------------------------------------------------------------------------------------------
+    void task_sequence::set_scheduler(task_scheduler* scheduler)
+    {
+        scheduler_ = scheduler;
+        group_.reset();
+        if (scheduler_)
+            group_ = std::make_unique <task_group> (*scheduler_);
+    }
+//---------------------------------------------------------------------------------------------------------------------
+    task_scheduler* task_sequence::get_scheduler() const noexcept
+    {
+        return scheduler_;
+    }
+//---------------------------------------------------------------------------------------------------------------------
+    void task_sequence::run(std::function <void()> operation)
+    {
+        if (!scheduler_)
+            return operation();
+
+        std::lock_guard <std::mutex> guard{queue_lock_};
+        queued_.push_back(std::move(operation));
+        if (!queue_running_)
+        {
+            queue_running_ = true;
+            group_->run([this]{ run_queued(); });
+        }
+    }
+//---------------------------------------------------------------------------------------------------------------------
+    void task_sequence::wait()
+    {
+        if (group_)
+            group_->wait();
+    }
+//---------------------------------------------------------------------------------------------------------------------
+    void task_sequence::run_queued()
+    {
+        // a single task works off the queue, so the operations never run concurrently.
+        for (;;)
+        {
+            std::function <void()> operation;
+            {
+                std::lock_guard <std::mutex> guard{queue_lock_};
+                if (queued_.empty())
+                {
+                    queue_running_ = false;
+                    return;
+                }
+                operation = std::move(queued_.front());
+                queued_.pop_front();
+            }
+            operation();
+        }
+    }
+//#####################################################################################################################
+}
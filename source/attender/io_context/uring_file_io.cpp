@@ -0,0 +1,189 @@
+#include <attender/io_context/uring_file_io.hpp>
+
+#ifdef ATTENDER_ENABLE_IO_URING
+
+#include <fcntl.h>
+
+#include <system_error>
+
+namespace attender
+{
+//#####################################################################################################################
+    uring_file_io::uring_file_io(asio::io_context* context, file_io_options const& options)
+        : context_{context}
+        , ring_{}
+        , lock_{}
+        , backlog_{}
+        , in_flight_{0}
+        , queue_depth_{options.queue_depth == 0 ? 1 : options.queue_depth}
+        , stopping_{false}
+        , reaper_{}
+    {
+        // one additional entry for the wake up on shutdown.
+        auto result = io_uring_queue_init(static_cast <unsigned> (queue_depth_ + 1), &ring_, 0);
+        if (result < 0)
+            throw std::system_error(-result, std::system_category(), "io_uring_queue_init");
+
+        reaper_ = std::thread{[this]{ reap(); }};
+    }
+//---------------------------------------------------------------------------------------------------------------------
+    uring_file_io::~uring_file_io()
+    {
+        std::deque <operation*> aborted;
+        {
+            std::lock_guard <std::mutex> guard{lock_};
+            stopping_ = true;
+            aborted.swap(backlog_);
+
+            io_uring_sqe* sqe = nullptr;
+            while ((sqe = io_uring_get_sqe(&ring_)) == nullptr)
+                io_uring_submit(&ring_);
+            io_uring_prep_nop(sqe);
+            io_uring_sqe_set_data(sqe, nullptr);
+            io_uring_submit(&ring_);
+        }
+        reaper_.join();
+
+        for (auto* op : aborted)
+        {
+            asio::post(*context_, [handler = std::move(op->handler)]{
+                handler(asio::error::operation_aborted, 0);
+            });
+            delete op;
+        }
+        io_uring_queue_exit(&ring_);
+    }
+//---------------------------------------------------------------------------------------------------------------------
+    void uring_file_io::async_read(async_file const& file, std::uint64_t offset, char* buffer, std::size_t size, file_io_callback handler)
+    {
+        submit(new operation{file.native_handle(), offset, buffer, nullptr, size, 0, std::move(handler)});
+    }
+//---------------------------------------------------------------------------------------------------------------------
+    void uring_file_io::async_write(async_file const& file, std::uint64_t offset, char const* buffer, std::size_t size, file_io_callback handler)
+    {
+        submit(new operation{file.native_handle(), offset, nullptr, buffer, size, 0, std::move(handler)});
+    }
+//---------------------------------------------------------------------------------------------------------------------
+    void uring_file_io::async_open(async_file& file, std::string const& path, async_file::mode open_mode, file_io_callback handler)
+    {
+        auto flags = open_mode == async_file::mode::read ? O_RDONLY | O_CLOEXEC : O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC;
+        submit(new operation{-1, 0, nullptr, nullptr, 0, 0, std::move(handler), &file, path, flags});
+    }
+//---------------------------------------------------------------------------------------------------------------------
+    char const* uring_file_io::backend() const
+    {
+        return "io_uring";
+    }
+//---------------------------------------------------------------------------------------------------------------------
+    void uring_file_io::submit(operation* op)
+    {
+        std::lock_guard <std::mutex> guard{lock_};
+        if (stopping_)
+        {
+            asio::post(*context_, [handler = std::move(op->handler)]{
+                handler(asio::error::operation_aborted, 0);
+            });
+            delete op;
+            return;
+        }
+        if (in_flight_ >= queue_depth_)
+        {
+            backlog_.push_back(op);
+            return;
+        }
+        ++in_flight_;
+        prepare(op);
+        io_uring_submit(&ring_);
+    }
+//---------------------------------------------------------------------------------------------------------------------
+    void uring_file_io::prepare(operation* op)
+    {
+        // the lock is held and in_flight_ guarantees a free entry.
+        auto* sqe = io_uring_get_sqe(&ring_);
+        auto remaining = static_cast <unsigned> (op->size - op->done);
+        if (op->opened)
+            io_uring_prep_openat(sqe, AT_FDCWD, op->path.c_str(), op->flags, 0644);
+        else if (op->read_buffer)
+            io_uring_prep_read(sqe, op->fd, op->read_buffer + op->done, remaining, op->offset + op->done);
+        else
+            io_uring_prep_write(sqe, op->fd, op->write_buffer + op->done, remaining, op->offset + op->done);
+        io_uring_sqe_set_data(sqe, op);
+    }
+//---------------------------------------------------------------------------------------------------------------------
+    void uring_file_io::reap()
+    {
+        bool shutdown = false;
+        for (;;)
+        {
+            io_uring_cqe* cqe = nullptr;
+            if (io_uring_wait_cqe(&ring_, &cqe) < 0)
+                continue;
+
+            auto* op = static_cast <operation*> (io_uring_cqe_get_data(cqe));
+            auto result = cqe->res;
+            io_uring_cqe_seen(&ring_, cqe);
+
+            // the shutdown nop, operations in flight are still completed.
+            if (!op)
+            {
+                shutdown = true;
+                std::lock_guard <std::mutex> guard{lock_};
+                if (in_flight_ == 0)
+                    return;
+                continue;
+            }
+
+            boost::system::error_code ec;
+            if (op->opened)
+            {
+                // an open completes with the descriptor, checking it and taking its size is a cheap fstat.
+                if (result < 0)
+                    ec = {-result, boost::system::system_category()};
+                else if (op->opened->assign(result))
+                    op->done = static_cast <std::size_t> (op->opened->size());
+                else
+                    ec = make_error_code(boost::system::errc::no_such_file_or_directory);
+            }
+            else
+            {
+                if (result > 0)
+                    op->done += static_cast <std::size_t> (result);
+
+                // short reads and writes are continued, unless the end of the file was reached.
+                if (result > 0 && op->done < op->size)
+                {
+                    std::lock_guard <std::mutex> guard{lock_};
+                    prepare(op);
+                    io_uring_submit(&ring_);
+                    continue;
+                }
+
+                if (result < 0)
+                    ec = {-result, boost::system::system_category()};
+                else if (result == 0 && op->write_buffer && op->done < op->size)
+                    ec = make_error_code(boost::system::errc::io_error);
+            }
+
+            asio::post(*context_, [handler = std::move(op->handler), ec, done = op->done]{
+                handler(ec, done);
+            });
+            delete op;
+
+            std::lock_guard <std::mutex> guard{lock_};
+            --in_flight_;
+            if (!backlog_.empty())
+            {
+                auto* next = backlog_.front();
+                backlog_.pop_front();
+                ++in_flight_;
+                prepare(next);
+                io_uring_submit(&ring_);
+            }
+            else if (shutdown && in_flight_ == 0)
+                return;
+        }
+    }
+//#####################################################################################################################
+}
+
+#endif // ATTENDER_ENABLE_IO_URING
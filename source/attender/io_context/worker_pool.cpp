@@ -0,0 +1,90 @@
+#include <attender/io_context/worker_pool.hpp>
+
+#include <algorithm>
+
+namespace attender
+{
+//#####################################################################################################################
+    worker_pool::worker_pool(worker_pool_options const& options)
+        : queue_limit_{options.queue_limit}
+        , lock_{}
+        , wake_{}
+        , queue_{}
+        , threads_{}
+        , statistics_{}
+        , total_wait_{}
+        , stopping_{false}
+    {
+        auto thread_count = options.threads == 0 ? 1 : options.threads;
+        for (std::size_t i = 0; i != thread_count; ++i)
+            threads_.emplace_back([this]{ work(); });
+    }
+//---------------------------------------------------------------------------------------------------------------------
+    worker_pool::~worker_pool()
+    {
+        {
+            std::lock_guard <std::mutex> guard{lock_};
+            stopping_ = true;
+        }
+        wake_.notify_all();
+
+        for (auto& thread : threads_)
+            thread.join();
+    }
+//---------------------------------------------------------------------------------------------------------------------
+    bool worker_pool::post(std::function <void()> job)
+    {
+        {
+            std::lock_guard <std::mutex> guard{lock_};
+            if (stopping_ || queue_.size() >= queue_limit_)
+            {
+                ++statistics_.rejected;
+                return false;
+            }
+
+            queue_.push_back({std::move(job), std::chrono::steady_clock::now()});
+            statistics_.queued = queue_.size();
+            statistics_.peak_queued = std::max(statistics_.peak_queued, statistics_.queued);
+        }
+        wake_.notify_one();
+        return true;
+    }
+//---------------------------------------------------------------------------------------------------------------------
+    worker_pool_statistics worker_pool::get_statistics() const
+    {
+        std::lock_guard <std::mutex> guard{lock_};
+        auto statistics = statistics_;
+        auto started = statistics_.completed + statistics_.active;
+        if (started != 0)
+            statistics.average_wait = std::chrono::duration_cast <std::chrono::microseconds> (total_wait_ / started);
+        return statistics;
+    }
+//---------------------------------------------------------------------------------------------------------------------
+    void worker_pool::work()
+    {
+        std::unique_lock <std::mutex> guard{lock_};
+        for (;;)
+        {
+            wake_.wait(guard, [this]{ return stopping_ || !queue_.empty(); });
+            if (stopping_)
+                return;
+
+            auto job = std::move(queue_.front());
+            queue_.pop_front();
+
+            auto waited = std::chrono::steady_clock::now() - job.enqueued;
+            total_wait_ += waited;
+            statistics_.max_wait = std::max(statistics_.max_wait, std::chrono::duration_cast <std::chrono::microseconds> (waited));
+            statistics_.queued = queue_.size();
+            ++statistics_.active;
+            guard.unlock();
+
+            job.job();
+
+            guard.lock();
+            --statistics_.active;
+            ++statistics_.completed;
+        }
+    }
+//#####################################################################################################################
+}
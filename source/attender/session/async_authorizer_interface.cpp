@@ -0,0 +1,33 @@
+#include <attender/session/async_authorizer_interface.hpp>
+
+#include <utility>
+
+namespace attender
+{
+//#####################################################################################################################
+    sync_authorizer_adapter::sync_authorizer_adapter(std::shared_ptr <authorizer_interface> authorizer)
+        : authorizer_{std::move(authorizer)}
+    {
+    }
+//---------------------------------------------------------------------------------------------------------------------
+    std::string sync_authorizer_adapter::realm() const
+    {
+        return authorizer_->realm();
+    }
+//---------------------------------------------------------------------------------------------------------------------
+    void sync_authorizer_adapter::negotiate_authorization_method(request_handler* req, response_handler* res)
+    {
+        authorizer_->negotiate_authorization_method(req, res);
+    }
+//---------------------------------------------------------------------------------------------------------------------
+    void sync_authorizer_adapter::async_perform_authorization(request_handler* req, response_handler* res, authorization_callback on_complete)
+    {
+        on_complete(authorizer_->try_perform_authorization(req, res));
+    }
+//---------------------------------------------------------------------------------------------------------------------
+    authorizer_interface* sync_authorizer_adapter::get_authorizer() const
+    {
+        return authorizer_.get();
+    }
+//#####################################################################################################################
+}
@@ -0,0 +1,35 @@
+#include <attender/session/async_session_storage_interface.hpp>
+
+namespace attender
+{
+//#####################################################################################################################
+    sync_session_storage_adapter::sync_session_storage_adapter(session_storage_interface& storage)
+        : storage_{storage}
+    {
+    }
+//---------------------------------------------------------------------------------------------------------------------
+    void sync_session_storage_adapter::async_lookup_session(std::string const& id, session* session, lookup_callback on_complete)
+    {
+        on_complete({}, storage_.lookup_session(id, session));
+    }
+//---------------------------------------------------------------------------------------------------------------------
+    void sync_session_storage_adapter::async_create_session(create_callback on_complete)
+    {
+        on_complete({}, storage_.create_session());
+    }
+//---------------------------------------------------------------------------------------------------------------------
+    void sync_session_storage_adapter::async_set_session(std::string const& id, session const& session, set_callback on_complete)
+    {
+        auto stored = storage_.set_session(id, session);
+        if (on_complete)
+            on_complete({}, stored);
+    }
+//---------------------------------------------------------------------------------------------------------------------
+    void sync_session_storage_adapter::async_delete_session(std::string const& id, completion_callback on_complete)
+    {
+        storage_.delete_session(id);
+        if (on_complete)
+            on_complete({});
+    }
+//#####################################################################################################################
+}
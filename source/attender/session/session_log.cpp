@@ -0,0 +1,573 @@
+#include <attender/session/session_log.hpp>
+
+#include <boost/filesystem.hpp>
+#include <boost/interprocess/file_mapping.hpp>
+#include <boost/interprocess/mapped_region.hpp>
+#include <boost/interprocess/sync/file_lock.hpp>
+
+#include <algorithm>
+#include <condition_variable>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <limits>
+#include <optional>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+namespace attender
+{
+//#####################################################################################################################
+    namespace
+    {
+        namespace interprocess = boost::interprocess;
+
+        constexpr char segment_magic[8] = {'a', 't', 't', 'e', 'n', 'd', 'e', 'r'};
+        constexpr std::uint32_t segment_version = 1;
+        constexpr std::size_t segment_header_size = 16;
+
+        // checksum, size of the id, size of the data.
+        constexpr std::size_t record_header_size = 12;
+        constexpr std::uint32_t tombstone_marker = 0xFFFFFFFF;
+
+        // compaction moves this many records per lock of the writers.
+        constexpr std::size_t compaction_batch = 256;
+
+        struct record
+        {
+            std::string_view id;
+            std::string_view data;
+            bool tombstone;
+            std::uint32_t size;
+        };
+
+        /**
+         *  FNV-1a over the sizes, the id and the data.
+         */
+        std::uint32_t checksum(std::uint32_t id_size, std::uint32_t data_size, std::string_view id, std::string_view data)
+        {
+            std::uint32_t hash = 2166136261u;
+            auto mix = [&hash](char const* bytes, std::size_t size) {
+                for (std::size_t i = 0; i != size; ++i)
+                {
+                    hash ^= static_cast <unsigned char> (bytes[i]);
+                    hash *= 16777619u;
+                }
+            };
+            mix(reinterpret_cast <char const*> (&id_size), sizeof(id_size));
+            mix(reinterpret_cast <char const*> (&data_size), sizeof(data_size));
+            mix(id.data(), id.size());
+            mix(data.data(), data.size());
+            return hash;
+        }
+
+        /**
+         *  Reads the record at offset.
+         *
+         *  @return nullopt at the end of the written part, or if the record is incomplete or damaged.
+         */
+        std::optional <record> parse_record(char const* base, std::size_t offset, std::size_t end)
+        {
+            if (end - offset < record_header_size)
+                return std::nullopt;
+
+            std::uint32_t header[3];
+            std::memcpy(header, base + offset, sizeof(header));
+            auto const tombstone = header[2] == tombstone_marker;
+            auto const data_size = tombstone ? 0 : header[2];
+            if (header[1] == 0 || end - offset - record_header_size < std::size_t{header[1]} + data_size)
+                return std::nullopt;
+
+            auto const* payload = base + offset + record_header_size;
+            record parsed{
+                {payload, header[1]},
+                {payload + header[1], data_size},
+                tombstone,
+                static_cast <std::uint32_t> (record_header_size + header[1] + data_size)
+            };
+            if (checksum(header[1], header[2], parsed.id, parsed.data) != header[0])
+                return std::nullopt;
+            return parsed;
+        }
+
+        std::string segment_name(std::uint32_t number)
+        {
+            char name[32];
+            std::snprintf(name, sizeof(name), "sessions.%08u.log", static_cast <unsigned> (number));
+            return name;
+        }
+
+        std::optional <std::uint32_t> segment_number(std::string const& name)
+        {
+            unsigned number = 0;
+            char rest = 0;
+            if (name.size() != 21 || std::sscanf(name.c_str(), "sessions.%8u.lo%c", &number, &rest) != 2 || rest != 'g')
+                return std::nullopt;
+            return static_cast <std::uint32_t> (number);
+        }
+    }
+//#####################################################################################################################
+    struct session_log::segment
+    {
+        std::uint32_t number;
+        boost::filesystem::path path;
+        interprocess::file_mapping file;
+        interprocess::mapped_region region;
+
+        // the written bytes, including the header of the segment. Only the active segment grows.
+        std::size_t used;
+
+        // the bytes of records that were replaced or deleted.
+        std::size_t garbage;
+
+        // the file is deleted with the segment.
+        bool obsolete;
+
+        segment(std::uint32_t number, boost::filesystem::path const& path)
+            : number{number}
+            , path{path}
+            , file{path.string().c_str(), interprocess::read_write}
+            , region{file, interprocess::read_write}
+            , used{segment_header_size}
+            , garbage{0}
+            , obsolete{false}
+        {
+        }
+
+        ~segment()
+        {
+            region = interprocess::mapped_region{};
+            file = interprocess::file_mapping{};
+            if (obsolete)
+            {
+                boost::system::error_code ec;
+                boost::filesystem::remove(path, ec);
+            }
+        }
+
+        char* data()
+        {
+            return static_cast <char*> (region.get_address());
+        }
+
+        std::size_t capacity() const
+        {
+            return region.get_size();
+        }
+    };
+//#####################################################################################################################
+    struct session_log::directory_lock
+    {
+        interprocess::file_lock file;
+
+        explicit directory_lock(boost::filesystem::path const& path)
+            : file{}
+        {
+            // only an existing file can be locked, it stays empty.
+            {
+                std::ofstream created{path.string(), std::ios::binary | std::ios::app};
+                if (!created)
+                    throw std::runtime_error("cannot create session log lock: " + path.string());
+            }
+            file = interprocess::file_lock{path.string().c_str()};
+            if (!file.try_lock())
+                throw std::runtime_error("session log is in use by another process: " + path.parent_path().string());
+        }
+
+        ~directory_lock()
+        {
+            file.unlock();
+        }
+    };
+//#####################################################################################################################
+    session_log::session_log(session_log_options options)
+        : options_{std::move(options)}
+        , lock_{}
+        , protect_{}
+        , write_protect_{}
+        , compact_protect_{}
+        , index_{}
+        , tombstones_{}
+        , segments_{}
+        , active_{nullptr}
+        , compactor_{}
+    {
+        if (options_.segment_size > std::numeric_limits <std::uint32_t>::max())
+            throw std::invalid_argument("segments of a session log must be smaller than 4 GB");
+
+        boost::filesystem::create_directories(options_.directory);
+        lock_ = std::make_unique <directory_lock> (boost::filesystem::path{options_.directory} / "sessions.lock");
+        open_segments();
+
+        if (options_.compaction_interval.count() > 0)
+            compactor_ = std::jthread{[this](std::stop_token stop){ run_compaction(stop); }};
+    }
+//---------------------------------------------------------------------------------------------------------------------
+    session_log::~session_log()
+    {
+        if (compactor_.joinable())
+        {
+            compactor_.request_stop();
+            compactor_.join();
+        }
+        flush();
+    }
+//---------------------------------------------------------------------------------------------------------------------
+    void session_log::open_segments()
+    {
+        std::vector <std::pair <std::uint32_t, boost::filesystem::path>> found;
+        for (auto const& entry : boost::filesystem::directory_iterator{options_.directory})
+        {
+            if (auto number = segment_number(entry.path().filename().string()))
+                found.emplace_back(*number, entry.path());
+        }
+        std::sort(found.begin(), found.end());
+
+        for (auto const& [number, path] : found)
+        {
+            // a crash while the segment was created.
+            if (boost::filesystem::file_size(path) < segment_header_size)
+            {
+                boost::filesystem::remove(path);
+                continue;
+            }
+
+            auto opened = std::make_unique <segment> (number, path);
+            if (std::memcmp(opened->data(), segment_magic, sizeof(segment_magic)) != 0 ||
+                std::memcmp(opened->data() + sizeof(segment_magic), &segment_version, sizeof(segment_version)) != 0)
+            {
+                throw std::runtime_error("not a session log segment: " + path.string());
+            }
+
+            // the latest record of an id wins, the scan of a segment ends at the first torn record.
+            auto offset = segment_header_size;
+            while (auto parsed = parse_record(opened->data(), offset, opened->capacity()))
+            {
+                location where{opened.get(), static_cast <std::uint32_t> (offset), parsed->size, number};
+                offset += parsed->size;
+
+                if (parsed->tombstone)
+                    index_tombstone(parsed->id, where);
+                else
+                    index_record(parsed->id, where);
+            }
+            opened->used = offset;
+            segments_.emplace(number, std::move(opened));
+        }
+
+        if (segments_.empty())
+            active_ = &add_segment(1, options_.segment_size);
+        else
+            active_ = segments_.rbegin()->second.get();
+    }
+//---------------------------------------------------------------------------------------------------------------------
+    session_log::segment& session_log::add_segment(std::uint32_t number, std::size_t size)
+    {
+        auto path = boost::filesystem::path{options_.directory} / segment_name(number);
+        {
+            std::ofstream created{path.string(), std::ios::binary | std::ios::trunc};
+            if (!created)
+                throw std::runtime_error("cannot create session log segment: " + path.string());
+        }
+        boost::filesystem::resize_file(path, std::max(size, segment_header_size));
+
+        auto added = std::make_unique <segment> (number, path);
+        std::memcpy(added->data(), segment_magic, sizeof(segment_magic));
+        std::memcpy(added->data() + sizeof(segment_magic), &segment_version, sizeof(segment_version));
+
+        auto& result = *added;
+        segments_.emplace(number, std::move(added));
+        return result;
+    }
+//---------------------------------------------------------------------------------------------------------------------
+    session_log::location session_log::append(std::string_view id, std::string_view data, bool tombstone)
+    {
+        if (tombstone)
+            data = {};
+
+        auto const size = record_header_size + id.size() + data.size();
+        if (id.empty() || size > std::numeric_limits <std::uint32_t>::max() - segment_header_size)
+            throw std::length_error("session log records must have an id and be smaller than 4 GB");
+
+        if (active_->capacity() - active_->used < size)
+        {
+            auto number = segments_.rbegin()->first + 1;
+            std::unique_lock <std::shared_mutex> guard{protect_};
+            active_ = &add_segment(number, std::max(options_.segment_size, segment_header_size + size));
+        }
+
+        std::uint32_t header[3] = {
+            0,
+            static_cast <std::uint32_t> (id.size()),
+            tombstone ? tombstone_marker : static_cast <std::uint32_t> (data.size())
+        };
+        header[0] = checksum(header[1], header[2], id, data);
+
+        auto* out = active_->data() + active_->used;
+        std::memcpy(out, header, sizeof(header));
+        std::memcpy(out + record_header_size, id.data(), id.size());
+        std::memcpy(out + record_header_size + id.size(), data.data(), data.size());
+
+        location where{active_, static_cast <std::uint32_t> (active_->used), static_cast <std::uint32_t> (size), active_->number};
+        active_->used += size;
+        return where;
+    }
+//---------------------------------------------------------------------------------------------------------------------
+    void session_log::retire(location const& where)
+    {
+        where.owner->garbage += where.size;
+    }
+//---------------------------------------------------------------------------------------------------------------------
+    void session_log::index_record(std::string_view id, location where)
+    {
+        auto [iter, inserted] = index_.try_emplace(std::string{id}, where);
+        if (!inserted)
+        {
+            retire(iter->second);
+            where.oldest = iter->second.oldest;
+            iter->second = where;
+            return;
+        }
+
+        // a deleted id that is put again, the records from before the deletion may still be around.
+        auto dead = tombstones_.find(iter->first);
+        if (dead != std::end(tombstones_))
+        {
+            iter->second.oldest = dead->second.oldest;
+            tombstones_.erase(dead);
+        }
+    }
+//---------------------------------------------------------------------------------------------------------------------
+    void session_log::index_tombstone(std::string_view id, location const& where)
+    {
+        // a tombstone holds no data, it is garbage from the start.
+        retire(where);
+
+        auto iter = index_.find(std::string{id});
+        if (iter != std::end(index_))
+        {
+            retire(iter->second);
+            tombstones_[iter->first] = {iter->second.oldest, where.owner->number};
+            index_.erase(iter);
+            return;
+        }
+
+        // a tombstone that was appended again by compaction.
+        auto dead = tombstones_.find(std::string{id});
+        if (dead != std::end(tombstones_))
+            dead->second.tombstone = where.owner->number;
+    }
+//---------------------------------------------------------------------------------------------------------------------
+    void session_log::put(std::string_view id, std::string_view data)
+    {
+        std::lock_guard <std::mutex> write_guard{write_protect_};
+        auto where = append(id, data, false);
+
+        std::unique_lock <std::shared_mutex> guard{protect_};
+        index_record(id, where);
+    }
+//---------------------------------------------------------------------------------------------------------------------
+    bool session_log::replace(std::string_view id, std::string_view data)
+    {
+        std::lock_guard <std::mutex> write_guard{write_protect_};
+
+        // the index only changes under the write lock, reading it needs no more.
+        auto iter = index_.find(std::string{id});
+        if (iter == std::end(index_))
+            return false;
+        auto where = append(id, data, false);
+
+        std::unique_lock <std::shared_mutex> guard{protect_};
+        retire(iter->second);
+        where.oldest = iter->second.oldest;
+        iter->second = where;
+        return true;
+    }
+//---------------------------------------------------------------------------------------------------------------------
+    void session_log::erase(std::string_view id)
+    {
+        std::lock_guard <std::mutex> write_guard{write_protect_};
+        auto iter = index_.find(std::string{id});
+        if (iter == std::end(index_))
+            return;
+        auto where = append(id, {}, true);
+
+        std::unique_lock <std::shared_mutex> guard{protect_};
+        index_tombstone(id, where);
+    }
+//---------------------------------------------------------------------------------------------------------------------
+    bool session_log::read(std::string const& id, std::function <void(std::string_view)> const& reader) const
+    {
+        std::shared_lock <std::shared_mutex> guard{protect_};
+        auto iter = index_.find(id);
+        if (iter == std::end(index_))
+            return false;
+
+        auto const& where = iter->second;
+        auto const* stored = where.owner->data() + where.offset;
+        std::uint32_t id_size;
+        std::memcpy(&id_size, stored + 4, sizeof(id_size));
+        reader({stored + record_header_size + id_size, where.size - record_header_size - id_size});
+        return true;
+    }
+//---------------------------------------------------------------------------------------------------------------------
+    bool session_log::contains(std::string const& id) const
+    {
+        std::shared_lock <std::shared_mutex> guard{protect_};
+        return index_.find(id) != std::end(index_);
+    }
+//---------------------------------------------------------------------------------------------------------------------
+    std::size_t session_log::size() const
+    {
+        std::shared_lock <std::shared_mutex> guard{protect_};
+        return index_.size();
+    }
+//---------------------------------------------------------------------------------------------------------------------
+    std::size_t session_log::segment_count() const
+    {
+        std::shared_lock <std::shared_mutex> guard{protect_};
+        return segments_.size();
+    }
+//---------------------------------------------------------------------------------------------------------------------
+    void session_log::clear()
+    {
+        std::lock_guard <std::mutex> compact_guard{compact_protect_};
+        std::lock_guard <std::mutex> write_guard{write_protect_};
+        std::unique_lock <std::shared_mutex> guard{protect_};
+
+        auto number = segments_.rbegin()->first + 1;
+        for (auto& [segment_number, cleared] : segments_)
+            cleared->obsolete = true;
+        segments_.clear();
+        index_.clear();
+        tombstones_.clear();
+        active_ = &add_segment(number, options_.segment_size);
+    }
+//---------------------------------------------------------------------------------------------------------------------
+    void session_log::flush()
+    {
+        // appends change the size of the active segment under the write lock only, the snapshot needs it too.
+        // The shared lock keeps the segments from being removed while they are written.
+        std::unique_lock <std::mutex> write_guard{write_protect_};
+        std::shared_lock <std::shared_mutex> guard{protect_};
+        std::vector <std::pair <segment*, std::size_t>> written;
+        written.reserve(segments_.size());
+        for (auto& [number, flushed] : segments_)
+            written.emplace_back(flushed.get(), flushed->used);
+        write_guard.unlock();
+
+        for (auto const& [flushed, used] : written)
+            flushed->region.flush(0, used, false);
+    }
+//---------------------------------------------------------------------------------------------------------------------
+    std::size_t session_log::compact()
+    {
+        std::lock_guard <std::mutex> compact_guard{compact_protect_};
+
+        std::vector <segment*> compacted;
+        {
+            std::lock_guard <std::mutex> write_guard{write_protect_};
+            for (auto& [number, candidate] : segments_)
+            {
+                if (candidate.get() == active_)
+                    continue;
+
+                auto const written = candidate->used - segment_header_size;
+                if (written == 0 || (candidate->garbage > 0 && candidate->garbage > options_.compaction_threshold * written))
+                    compacted.push_back(candidate.get());
+            }
+        }
+
+        for (auto* candidate : compacted)
+            compact_segment(*candidate);
+        return compacted.size();
+    }
+//---------------------------------------------------------------------------------------------------------------------
+    void session_log::compact_segment(segment& compacted)
+    {
+        // the segment is full, its records do not change anymore. Only compaction removes segments.
+        auto offset = segment_header_size;
+        auto const end = compacted.used;
+
+        // the ranges the live records were appended to, they are on disk before the old file goes.
+        struct appended_range
+        {
+            segment* owner;
+            std::size_t begin;
+            std::size_t end;
+        };
+        std::vector <appended_range> appended;
+        auto track = [&appended](location const& where) {
+            if (!appended.empty() && appended.back().owner == where.owner)
+                appended.back().end = where.offset + where.size;
+            else
+                appended.push_back({where.owner, where.offset, where.offset + where.size});
+        };
+
+        while (offset < end)
+        {
+            std::lock_guard <std::mutex> write_guard{write_protect_};
+            for (std::size_t i = 0; i != compaction_batch && offset < end; ++i)
+            {
+                auto parsed = parse_record(compacted.data(), offset, end);
+                if (!parsed)
+                {
+                    offset = end;
+                    break;
+                }
+                auto const old_offset = offset;
+                offset += parsed->size;
+
+                auto iter = index_.find(std::string{parsed->id});
+                if (parsed->tombstone)
+                {
+                    // only the latest tombstone of an id is kept, and only while an older segment may hold a record of it.
+                    auto dead = tombstones_.find(std::string{parsed->id});
+                    if (iter != std::end(index_) || dead == std::end(tombstones_) || dead->second.tombstone != compacted.number)
+                        continue;
+
+                    auto older = segments_.lower_bound(dead->second.oldest);
+                    if (older == std::end(segments_) || older->first >= compacted.number)
+                    {
+                        tombstones_.erase(dead);
+                        continue;
+                    }
+                    auto where = append(parsed->id, {}, true);
+                    track(where);
+                    retire(where);
+                    dead->second.tombstone = where.owner->number;
+                    continue;
+                }
+
+                if (iter == std::end(index_) || iter->second.owner != &compacted || iter->second.offset != old_offset)
+                    continue;
+
+                auto where = append(parsed->id, parsed->data, false);
+                track(where);
+                std::unique_lock <std::shared_mutex> guard{protect_};
+                where.oldest = iter->second.oldest;
+                iter->second = where;
+            }
+        }
+
+        // only compaction and clear remove segments, the targets stay valid without the locks.
+        for (auto const& range : appended)
+            range.owner->region.flush(range.begin, range.end - range.begin, false);
+
+        std::lock_guard <std::mutex> write_guard{write_protect_};
+        std::unique_lock <std::shared_mutex> guard{protect_};
+        compacted.obsolete = true;
+        segments_.erase(compacted.number);
+    }
+//---------------------------------------------------------------------------------------------------------------------
+    void session_log::run_compaction(std::stop_token stop)
+    {
+        std::mutex protect;
+        std::condition_variable_any wake;
+        std::unique_lock <std::mutex> lock{protect};
+        while (!wake.wait_for(lock, stop, options_.compaction_interval, []{ return false; }) && !stop.stop_requested())
+            compact();
+    }
+//#####################################################################################################################
+}
@@ -1,13 +1,33 @@
 #include <attender/session/session_manager.hpp>
 
+#include <stdexcept>
+
 namespace attender
 {
 //#####################################################################################################################
     session_manager::session_manager(std::unique_ptr <session_storage_interface> session_storage)
         : session_storage_{std::move(session_storage)}
+        , async_storage_{session_storage_ ? std::make_unique <sync_session_storage_adapter> (*session_storage_) : nullptr}
     {
 
     }
 //---------------------------------------------------------------------------------------------------------------------
+    session_manager::session_manager(std::unique_ptr <async_session_storage_interface> session_storage)
+        : session_storage_{}
+        , async_storage_{std::move(session_storage)}
+    {
+    }
+//---------------------------------------------------------------------------------------------------------------------
+    bool session_manager::is_synchronous() const
+    {
+        return session_storage_ != nullptr;
+    }
+//---------------------------------------------------------------------------------------------------------------------
+    session_storage_interface& session_manager::sync_storage()
+    {
+        if (!session_storage_)
+            throw std::logic_error("the session storage is asynchronous, use the async_ functions of the session_manager");
+        return *session_storage_;
+    }
 //#####################################################################################################################
 }
@@ -0,0 +1,646 @@
+#include <attender/session/shared_session_table.hpp>
+
+#include <boost/interprocess/mapped_region.hpp>
+#include <boost/interprocess/shared_memory_object.hpp>
+
+#include <pthread.h>
+
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <cerrno>
+#include <chrono>
+#include <cstring>
+#include <stdexcept>
+#include <system_error>
+#include <thread>
+
+namespace attender
+{
+//#####################################################################################################################
+    namespace
+    {
+        namespace interprocess = boost::interprocess;
+
+        constexpr char table_magic[8] = {'a', 't', 't', 's', 'e', 's', 's', '1'};
+        constexpr std::uint32_t table_version = 2;
+
+        // states of the shared memory, it is zero filled when it is created.
+        constexpr std::uint32_t uninitialized = 0;
+        constexpr std::uint32_t initializing = 1;
+        constexpr std::uint32_t ready = 2;
+
+        constexpr std::uint32_t no_block = 0xFFFFFFFFu;
+
+        static_assert(std::atomic_ref <std::uint64_t>::is_always_lock_free, "the free list must be lock free");
+        static_assert(std::atomic_ref <std::uint32_t>::is_always_lock_free, "the stripe counters must be lock free");
+
+        constexpr std::size_t align_to(std::size_t size, std::size_t alignment)
+        {
+            return (size + alignment - 1) / alignment * alignment;
+        }
+
+        /**
+         *  FNV-1a, mixed so that high and low bits are usable. Not std::hash, it must match between processes.
+         *  0 marks empty slots and is never returned.
+         */
+        std::uint64_t hash_id(std::string_view id)
+        {
+            std::uint64_t hash = 14695981039346656037ull;
+            for (auto c : id)
+            {
+                hash ^= static_cast <unsigned char> (c);
+                hash *= 1099511628211ull;
+            }
+            hash *= 0x9E3779B97F4A7C15ull;
+            return hash == 0 ? 1 : hash;
+        }
+
+        std::int64_t milliseconds_now()
+        {
+            using namespace std::chrono;
+            return duration_cast <milliseconds> (system_clock::now().time_since_epoch()).count();
+        }
+    }
+//#####################################################################################################################
+    struct shared_session_table::mapping
+    {
+        interprocess::shared_memory_object object;
+        interprocess::mapped_region region;
+
+        mapping(std::string const& name, std::size_t size)
+            : object{}
+            , region{}
+        {
+            // only the process that creates the object sizes it. Others never map it before, so the size
+            // cannot change under a mapping.
+            try
+            {
+                object = interprocess::shared_memory_object{interprocess::create_only, name.c_str(), interprocess::read_write};
+                object.truncate(static_cast <interprocess::offset_t> (size));
+            }
+            catch (interprocess::interprocess_exception const& error)
+            {
+                if (error.get_error_code() != interprocess::already_exists_error)
+                    throw;
+                object = interprocess::shared_memory_object{interprocess::open_only, name.c_str(), interprocess::read_write};
+
+                interprocess::offset_t existing = 0;
+                auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds{10};
+                while (object.get_size(existing) && existing == 0)
+                {
+                    if (std::chrono::steady_clock::now() > deadline)
+                        throw std::runtime_error("shared session table " + name + " was not initialized");
+                    std::this_thread::sleep_for(std::chrono::milliseconds{1});
+                }
+                if (static_cast <std::size_t> (existing) != size)
+                    throw std::runtime_error("shared session table " + name + " has a different layout");
+            }
+            region = interprocess::mapped_region{object, interprocess::read_write};
+        }
+    };
+//---------------------------------------------------------------------------------------------------------------------
+    struct shared_session_table::header
+    {
+        char magic[8];
+        std::uint32_t version;
+        std::uint32_t state;
+        std::uint64_t slot_count;
+        std::uint64_t stripe_count;
+        std::uint64_t id_capacity;
+        std::uint64_t data_capacity;
+        std::uint64_t block_size;
+        std::uint64_t block_count;
+
+        // the first free overflow block in the low half, a counter against ABA in the high half.
+        std::uint64_t free_blocks;
+    };
+//---------------------------------------------------------------------------------------------------------------------
+    struct alignas(64) shared_session_table::stripe
+    {
+        // process shared and robust, a lock held by a dead process is handed to the next one with EOWNERDEAD.
+        pthread_mutex_t lock;
+        std::uint32_t count;
+    };
+//---------------------------------------------------------------------------------------------------------------------
+    /**
+     *  Followed by id_capacity bytes of id and data_capacity bytes of data.
+     */
+    struct shared_session_table::slot
+    {
+        // 0 if the slot is empty.
+        std::uint64_t hash;
+
+        // milliseconds since the epoch, the clock is shared by the processes.
+        std::int64_t created;
+        std::int64_t last_access;
+
+        std::uint32_t id_size;
+        std::uint32_t data_size;
+
+        // the first block of the data that does not fit into the slot.
+        std::uint32_t overflow;
+        std::uint32_t reserved;
+
+        char* id()
+        {
+            return reinterpret_cast <char*> (this + 1);
+        }
+        char const* id() const
+        {
+            return reinterpret_cast <char const*> (this + 1);
+        }
+        char* data(std::size_t id_capacity)
+        {
+            return id() + id_capacity;
+        }
+        char const* data(std::size_t id_capacity) const
+        {
+            return id() + id_capacity;
+        }
+    };
+//---------------------------------------------------------------------------------------------------------------------
+    class shared_session_table::stripe_guard
+    {
+    public:
+        /**
+         *  If the last owner died while it held the lock, the stripe is repaired before it is used.
+         */
+        stripe_guard(shared_session_table const& table, std::size_t index)
+            : lock_{&table.stripe_at(index).lock}
+        {
+            auto result = pthread_mutex_lock(lock_);
+            if (result == EOWNERDEAD)
+            {
+                table.repair(index);
+                result = pthread_mutex_consistent(lock_);
+            }
+            if (result != 0)
+                throw std::system_error(result, std::generic_category(), "cannot lock a stripe of the shared session table");
+        }
+        ~stripe_guard()
+        {
+            pthread_mutex_unlock(lock_);
+        }
+
+        stripe_guard(stripe_guard const&) = delete;
+        stripe_guard& operator=(stripe_guard const&) = delete;
+
+    private:
+        pthread_mutex_t* lock_;
+    };
+//#####################################################################################################################
+    shared_session_table::shared_session_table(shared_session_options const& options)
+        : mapping_{}
+        , header_{nullptr}
+        , stripes_{nullptr}
+        , slots_{nullptr}
+        , blocks_{nullptr}
+        , slot_count_{std::bit_ceil(std::max <std::size_t> (options.slot_count, 1))}
+        , stripe_count_{std::min(std::bit_ceil(std::max <std::size_t> (options.stripe_count, 1)), slot_count_)}
+        , stripe_bits_{static_cast <unsigned> (std::countr_zero(stripe_count_))}
+        , slot_size_{align_to(sizeof(slot) + options.id_capacity + options.data_capacity, alignof(slot))}
+        , id_capacity_{options.id_capacity}
+        , data_capacity_{options.data_capacity}
+        , block_size_{align_to(std::max <std::size_t> (options.overflow_block_size, 2 * sizeof(std::uint32_t)), sizeof(std::uint32_t))}
+        , block_count_{std::min <std::size_t> (options.overflow_size / block_size_, no_block)}
+        , absolute_{0}
+        , idle_{0}
+    {
+        auto const stripes_offset = align_to(sizeof(header), alignof(stripe));
+        auto const slots_offset = stripes_offset + stripe_count_ * sizeof(stripe);
+        auto const blocks_offset = slots_offset + slot_count_ * slot_size_;
+
+        mapping_ = std::make_unique <mapping> (options.name, blocks_offset + block_count_ * block_size_);
+        auto* base = static_cast <char*> (mapping_->region.get_address());
+        header_ = reinterpret_cast <header*> (base);
+        stripes_ = base + stripes_offset;
+        slots_ = base + slots_offset;
+        blocks_ = base + blocks_offset;
+
+        std::atomic_ref <std::uint32_t> state{header_->state};
+        auto expected = uninitialized;
+        if (state.compare_exchange_strong(expected, initializing, std::memory_order_acquire))
+        {
+            initialize();
+            state.store(ready, std::memory_order_release);
+            return;
+        }
+
+        // another process is initializing it.
+        auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds{10};
+        while (state.load(std::memory_order_acquire) != ready)
+        {
+            if (std::chrono::steady_clock::now() > deadline)
+                throw std::runtime_error("shared session table " + options.name + " was not initialized");
+            std::this_thread::sleep_for(std::chrono::milliseconds{1});
+        }
+        validate();
+    }
+//---------------------------------------------------------------------------------------------------------------------
+    shared_session_table::~shared_session_table() = default;
+//---------------------------------------------------------------------------------------------------------------------
+    void shared_session_table::initialize()
+    {
+        std::memcpy(header_->magic, table_magic, sizeof(table_magic));
+        header_->version = table_version;
+        header_->slot_count = slot_count_;
+        header_->stripe_count = stripe_count_;
+        header_->id_capacity = id_capacity_;
+        header_->data_capacity = data_capacity_;
+        header_->block_size = block_size_;
+        header_->block_count = block_count_;
+
+        pthread_mutexattr_t attributes;
+        pthread_mutexattr_init(&attributes);
+        pthread_mutexattr_setpshared(&attributes, PTHREAD_PROCESS_SHARED);
+        pthread_mutexattr_setrobust(&attributes, PTHREAD_MUTEX_ROBUST);
+        for (std::size_t i = 0; i != stripe_count_; ++i)
+        {
+            auto result = pthread_mutex_init(&stripe_at(i).lock, &attributes);
+            if (result != 0)
+            {
+                pthread_mutexattr_destroy(&attributes);
+                throw std::system_error(result, std::generic_category(), "cannot create the stripe locks of the shared session table");
+            }
+        }
+        pthread_mutexattr_destroy(&attributes);
+
+        for (std::size_t i = 0; i != block_count_; ++i)
+        {
+            auto next = i + 1 == block_count_ ? no_block : static_cast <std::uint32_t> (i + 1);
+            std::memcpy(block_at(static_cast <std::uint32_t> (i)), &next, sizeof(next));
+        }
+        header_->free_blocks = block_count_ == 0 ? no_block : 0;
+    }
+//---------------------------------------------------------------------------------------------------------------------
+    void shared_session_table::validate() const
+    {
+        if (std::memcmp(header_->magic, table_magic, sizeof(table_magic)) != 0 ||
+            header_->version != table_version ||
+            header_->slot_count != slot_count_ ||
+            header_->stripe_count != stripe_count_ ||
+            header_->id_capacity != id_capacity_ ||
+            header_->data_capacity != data_capacity_ ||
+            header_->block_size != block_size_ ||
+            header_->block_count != block_count_)
+        {
+            throw std::runtime_error("shared session table has a different layout");
+        }
+    }
+//---------------------------------------------------------------------------------------------------------------------
+    shared_session_table::stripe& shared_session_table::stripe_at(std::size_t index) const
+    {
+        return reinterpret_cast <stripe*> (stripes_)[index];
+    }
+//---------------------------------------------------------------------------------------------------------------------
+    shared_session_table::slot& shared_session_table::slot_at(std::size_t index) const
+    {
+        return *reinterpret_cast <slot*> (slots_ + index * slot_size_);
+    }
+//---------------------------------------------------------------------------------------------------------------------
+    char* shared_session_table::block_at(std::uint32_t index) const
+    {
+        return blocks_ + std::size_t{index} * block_size_;
+    }
+//---------------------------------------------------------------------------------------------------------------------
+    std::ptrdiff_t shared_session_table::find(std::size_t stripe_index, std::uint64_t hash, std::string_view id) const
+    {
+        auto const stripe_size = slot_count_ / stripe_count_;
+        auto const first = stripe_index * stripe_size;
+        auto position = static_cast <std::size_t> (hash) & (stripe_size - 1);
+        for (std::size_t probe = 0; probe != stripe_size; ++probe, position = (position + 1) & (stripe_size - 1))
+        {
+            auto const& record = slot_at(first + position);
+            if (record.hash == 0)
+                return -1;
+            if (record.hash == hash && record.id_size == id.size() && std::memcmp(record.id(), id.data(), id.size()) == 0)
+                return static_cast <std::ptrdiff_t> (position);
+        }
+        return -1;
+    }
+//---------------------------------------------------------------------------------------------------------------------
+    bool shared_session_table::expired(slot const& record, std::int64_t now) const
+    {
+        auto const absolute = absolute_.load(std::memory_order_relaxed);
+        auto const idle = idle_.load(std::memory_order_relaxed);
+        if (absolute > 0 && record.created + absolute <= now)
+            return true;
+        if (idle > 0)
+        {
+            auto last_access = std::atomic_ref <std::int64_t>{const_cast <slot&> (record).last_access}.load(std::memory_order_relaxed);
+            return last_access + idle <= now;
+        }
+        return false;
+    }
+//---------------------------------------------------------------------------------------------------------------------
+    std::uint32_t shared_session_table::pop_block()
+    {
+        std::atomic_ref <std::uint64_t> head{header_->free_blocks};
+        auto current = head.load(std::memory_order_acquire);
+        for (;;)
+        {
+            auto block = static_cast <std::uint32_t> (current);
+            if (block == no_block)
+                return no_block;
+
+            // may be read while another process takes the block, the counter makes that compare exchange fail.
+            auto next = std::atomic_ref <std::uint32_t>{*reinterpret_cast <std::uint32_t*> (block_at(block))}.load(std::memory_order_relaxed);
+            auto replacement = ((current >> 32) + 1) << 32 | next;
+            if (head.compare_exchange_weak(current, replacement, std::memory_order_acquire, std::memory_order_acquire))
+                return block;
+        }
+    }
+//---------------------------------------------------------------------------------------------------------------------
+    void shared_session_table::push_block(std::uint32_t block)
+    {
+        std::atomic_ref <std::uint64_t> head{header_->free_blocks};
+        std::atomic_ref <std::uint32_t> next{*reinterpret_cast <std::uint32_t*> (block_at(block))};
+        auto current = head.load(std::memory_order_relaxed);
+        for (;;)
+        {
+            next.store(static_cast <std::uint32_t> (current), std::memory_order_relaxed);
+            auto replacement = ((current >> 32) + 1) << 32 | block;
+            if (head.compare_exchange_weak(current, replacement, std::memory_order_release, std::memory_order_relaxed))
+                return;
+        }
+    }
+//---------------------------------------------------------------------------------------------------------------------
+    std::uint32_t shared_session_table::store(std::string_view data)
+    {
+        auto const payload = block_size_ - sizeof(std::uint32_t);
+        std::uint32_t first = no_block;
+        char* previous = nullptr;
+        while (!data.empty())
+        {
+            auto block = pop_block();
+            if (block == no_block)
+            {
+                release(first);
+                throw std::length_error("shared session table has no overflow blocks left");
+            }
+
+            auto* bytes = block_at(block);
+            std::atomic_ref <std::uint32_t>{*reinterpret_cast <std::uint32_t*> (bytes)}.store(no_block, std::memory_order_relaxed);
+            auto part = std::min(payload, data.size());
+            std::memcpy(bytes + sizeof(std::uint32_t), data.data(), part);
+            data.remove_prefix(part);
+
+            if (previous == nullptr)
+                first = block;
+            else
+                std::atomic_ref <std::uint32_t>{*reinterpret_cast <std::uint32_t*> (previous)}.store(block, std::memory_order_relaxed);
+            previous = bytes;
+        }
+        return first;
+    }
+//---------------------------------------------------------------------------------------------------------------------
+    void shared_session_table::load(slot const& record, std::string& data) const
+    {
+        data.resize(record.data_size);
+        auto const inline_size = std::min <std::size_t> (record.data_size, data_capacity_);
+        std::memcpy(data.data(), record.data(id_capacity_), inline_size);
+
+        auto const payload = block_size_ - sizeof(std::uint32_t);
+        auto offset = inline_size;
+        for (auto block = record.overflow; block != no_block && offset < data.size();)
+        {
+            auto const* bytes = block_at(block);
+            auto part = std::min(payload, data.size() - offset);
+            std::memcpy(data.data() + offset, bytes + sizeof(std::uint32_t), part);
+            offset += part;
+            block = std::atomic_ref <std::uint32_t>{*reinterpret_cast <std::uint32_t*> (const_cast <char*> (bytes))}.load(std::memory_order_relaxed);
+        }
+    }
+//---------------------------------------------------------------------------------------------------------------------
+    void shared_session_table::release(std::uint32_t block)
+    {
+        while (block != no_block)
+        {
+            auto next = std::atomic_ref <std::uint32_t>{*reinterpret_cast <std::uint32_t*> (block_at(block))}.load(std::memory_order_relaxed);
+            push_block(block);
+            block = next;
+        }
+    }
+//---------------------------------------------------------------------------------------------------------------------
+    void shared_session_table::erase_at(std::size_t stripe_index, std::size_t position)
+    {
+        auto const stripe_size = slot_count_ / stripe_count_;
+        auto const mask = stripe_size - 1;
+        auto const first = stripe_index * stripe_size;
+        release(slot_at(first + position).overflow);
+
+        // shifts the following records back, unless that would move them in front of their home slot.
+        auto hole = position;
+        auto next = position;
+        for (std::size_t probe = 1; probe != stripe_size; ++probe)
+        {
+            next = (next + 1) & mask;
+            auto const& record = slot_at(first + next);
+            if (record.hash == 0)
+                break;
+
+            auto home = static_cast <std::size_t> (record.hash) & mask;
+            auto const movable = next > hole ? (home <= hole || home > next) : (home <= hole && home > next);
+            if (movable)
+            {
+                std::memcpy(&slot_at(first + hole), &record, slot_size_);
+                hole = next;
+            }
+        }
+        std::memset(&slot_at(first + hole), 0, slot_size_);
+        std::atomic_ref <std::uint32_t>{stripe_at(stripe_index).count}.fetch_sub(1, std::memory_order_relaxed);
+    }
+//---------------------------------------------------------------------------------------------------------------------
+    void shared_session_table::repair(std::size_t stripe_index) const
+    {
+        // the dead process may have been shifting records, so that two slots share an overflow chain.
+        // the records are dropped and their blocks are not released, which could release one twice.
+        auto const stripe_size = slot_count_ / stripe_count_;
+        std::memset(&slot_at(stripe_index * stripe_size), 0, stripe_size * slot_size_);
+        std::atomic_ref <std::uint32_t>{stripe_at(stripe_index).count}.store(0, std::memory_order_relaxed);
+    }
+//---------------------------------------------------------------------------------------------------------------------
+    bool shared_session_table::insert(std::string_view id, std::string_view data)
+    {
+        if (id.empty() || id.size() > id_capacity_)
+            throw std::length_error("session id does not fit into a slot of the shared session table");
+
+        auto const hash = hash_id(id);
+        auto const stripe_index = stripe_bits_ == 0 ? 0 : static_cast <std::size_t> (hash >> (64 - stripe_bits_));
+        auto const stripe_size = slot_count_ / stripe_count_;
+        auto& owner = stripe_at(stripe_index);
+        auto const now = milliseconds_now();
+
+        stripe_guard guard{*this, stripe_index};
+        auto existing = find(stripe_index, hash, id);
+        if (existing >= 0)
+        {
+            if (!expired(slot_at(stripe_index * stripe_size + existing), now))
+                return false;
+            erase_at(stripe_index, static_cast <std::size_t> (existing));
+        }
+
+        if (std::atomic_ref <std::uint32_t>{owner.count}.load(std::memory_order_relaxed) == stripe_size)
+            throw std::length_error("stripe of the shared session table is full");
+        auto const inline_size = std::min(data.size(), data_capacity_);
+        auto overflow = store(data.substr(inline_size));
+
+        auto position = static_cast <std::size_t> (hash) & (stripe_size - 1);
+        while (slot_at(stripe_index * stripe_size + position).hash != 0)
+            position = (position + 1) & (stripe_size - 1);
+
+        auto& record = slot_at(stripe_index * stripe_size + position);
+        record.hash = hash;
+        record.created = now;
+        record.last_access = now;
+        record.id_size = static_cast <std::uint32_t> (id.size());
+        record.data_size = static_cast <std::uint32_t> (data.size());
+        record.overflow = overflow;
+        std::memcpy(record.id(), id.data(), id.size());
+        std::memcpy(record.data(id_capacity_), data.data(), inline_size);
+        std::atomic_ref <std::uint32_t>{owner.count}.fetch_add(1, std::memory_order_relaxed);
+        return true;
+    }
+//---------------------------------------------------------------------------------------------------------------------
+    bool shared_session_table::replace(std::string_view id, std::string_view data)
+    {
+        auto const hash = hash_id(id);
+        auto const stripe_index = stripe_bits_ == 0 ? 0 : static_cast <std::size_t> (hash >> (64 - stripe_bits_));
+        auto const stripe_size = slot_count_ / stripe_count_;
+        auto const now = milliseconds_now();
+
+        stripe_guard guard{*this, stripe_index};
+        auto position = find(stripe_index, hash, id);
+        if (position < 0)
+            return false;
+
+        auto& record = slot_at(stripe_index * stripe_size + position);
+        if (expired(record, now))
+        {
+            erase_at(stripe_index, static_cast <std::size_t> (position));
+            return false;
+        }
+
+        // the old data stays if there are not enough blocks for the new one.
+        auto const inline_size = std::min(data.size(), data_capacity_);
+        auto overflow = store(data.substr(inline_size));
+        release(record.overflow);
+
+        record.last_access = now;
+        record.data_size = static_cast <std::uint32_t> (data.size());
+        record.overflow = overflow;
+        std::memcpy(record.data(id_capacity_), data.data(), inline_size);
+        return true;
+    }
+//---------------------------------------------------------------------------------------------------------------------
+    void shared_session_table::erase(std::string_view id)
+    {
+        auto const hash = hash_id(id);
+        auto const stripe_index = stripe_bits_ == 0 ? 0 : static_cast <std::size_t> (hash >> (64 - stripe_bits_));
+
+        stripe_guard guard{*this, stripe_index};
+        auto position = find(stripe_index, hash, id);
+        if (position >= 0)
+            erase_at(stripe_index, static_cast <std::size_t> (position));
+    }
+//---------------------------------------------------------------------------------------------------------------------
+    session_state shared_session_table::read(std::string_view id, std::string* data)
+    {
+        auto const hash = hash_id(id);
+        auto const stripe_index = stripe_bits_ == 0 ? 0 : static_cast <std::size_t> (hash >> (64 - stripe_bits_));
+        auto const stripe_size = slot_count_ / stripe_count_;
+        auto const now = milliseconds_now();
+
+        stripe_guard guard{*this, stripe_index};
+        auto position = find(stripe_index, hash, id);
+        if (position < 0)
+            return session_state::not_found;
+
+        auto& record = slot_at(stripe_index * stripe_size + position);
+        if (!expired(record, now))
+        {
+            if (idle_.load(std::memory_order_relaxed) > 0)
+                record.last_access = now;
+            if (data != nullptr)
+                load(record, *data);
+            return session_state::live;
+        }
+
+        // removed right away, instead of waiting for the sweep.
+        erase_at(stripe_index, static_cast <std::size_t> (position));
+        return session_state::timed_out;
+    }
+//---------------------------------------------------------------------------------------------------------------------
+    void shared_session_table::set_expiry(std::chrono::milliseconds absolute, std::chrono::milliseconds idle)
+    {
+        absolute_.store(absolute.count(), std::memory_order_relaxed);
+        idle_.store(idle.count(), std::memory_order_relaxed);
+    }
+//---------------------------------------------------------------------------------------------------------------------
+    std::size_t shared_session_table::sweep()
+    {
+        if (absolute_.load(std::memory_order_relaxed) <= 0 && idle_.load(std::memory_order_relaxed) <= 0)
+            return 0;
+
+        auto const stripe_size = slot_count_ / stripe_count_;
+        std::size_t removed = 0;
+        for (std::size_t i = 0; i != stripe_count_; ++i)
+        {
+            auto const now = milliseconds_now();
+            stripe_guard guard{*this, i};
+            for (std::size_t position = 0; position != stripe_size;)
+            {
+                auto const& record = slot_at(i * stripe_size + position);
+                if (record.hash == 0 || !expired(record, now))
+                {
+                    ++position;
+                    continue;
+                }
+
+                // the position is checked again, erase_at may have moved a record into it.
+                erase_at(i, position);
+                ++removed;
+            }
+        }
+        return removed;
+    }
+//---------------------------------------------------------------------------------------------------------------------
+    std::size_t shared_session_table::size() const
+    {
+        std::size_t count = 0;
+        for (std::size_t i = 0; i != stripe_count_; ++i)
+            count += std::atomic_ref <std::uint32_t>{stripe_at(i).count}.load(std::memory_order_relaxed);
+        return count;
+    }
+//---------------------------------------------------------------------------------------------------------------------
+    void shared_session_table::clear()
+    {
+        auto const stripe_size = slot_count_ / stripe_count_;
+        for (std::size_t i = 0; i != stripe_count_; ++i)
+        {
+            auto& cleared = stripe_at(i);
+            stripe_guard guard{*this, i};
+            for (std::size_t position = 0; position != stripe_size; ++position)
+            {
+                auto& record = slot_at(i * stripe_size + position);
+                if (record.hash == 0)
+                    continue;
+                release(record.overflow);
+                std::memset(&record, 0, slot_size_);
+            }
+            std::atomic_ref <std::uint32_t>{cleared.count}.store(0, std::memory_order_relaxed);
+        }
+    }
+//---------------------------------------------------------------------------------------------------------------------
+    std::size_t shared_session_table::capacity() const
+    {
+        return slot_count_;
+    }
+//---------------------------------------------------------------------------------------------------------------------
+    bool shared_session_table::remove(std::string const& name)
+    {
+        return interprocess::shared_memory_object::remove(name.c_str());
+    }
+//#####################################################################################################################
+}
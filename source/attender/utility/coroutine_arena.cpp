@@ -0,0 +1,54 @@
+#include <attender/utility/coroutine_arena.hpp>
+
+namespace attender
+{
+//#####################################################################################################################
+    coroutine_arena::coroutine_arena() noexcept
+        : storage_{}
+        , top_{0}
+        , live_{0}
+    {
+    }
+//---------------------------------------------------------------------------------------------------------------------
+    std::size_t coroutine_arena::align(std::size_t size) noexcept
+    {
+        constexpr std::size_t alignment = alignof(std::max_align_t);
+        return (size + alignment - 1) & ~(alignment - 1);
+    }
+//---------------------------------------------------------------------------------------------------------------------
+    void* coroutine_arena::allocate(std::size_t size) noexcept
+    {
+        size = align(size);
+        if (size > sizeof(storage_) - top_)
+            return nullptr;
+
+        void* ptr = storage_ + top_;
+        top_ += size;
+        live_ += size;
+        return ptr;
+    }
+//---------------------------------------------------------------------------------------------------------------------
+    void coroutine_arena::deallocate(void* ptr, std::size_t size) noexcept
+    {
+        size = align(size);
+        live_ -= size;
+
+        auto offset = static_cast <std::size_t> (static_cast <std::byte*> (ptr) - storage_);
+        if (live_ == 0)
+            top_ = 0;
+        else if (offset + size == top_)
+            top_ = offset;
+    }
+//---------------------------------------------------------------------------------------------------------------------
+    bool coroutine_arena::owns(void const* ptr) const noexcept
+    {
+        auto const* byte_ptr = static_cast <std::byte const*> (ptr);
+        return byte_ptr >= storage_ && byte_ptr < storage_ + sizeof(storage_);
+    }
+//---------------------------------------------------------------------------------------------------------------------
+    std::size_t coroutine_arena::used() const noexcept
+    {
+        return top_;
+    }
+//#####################################################################################################################
+}
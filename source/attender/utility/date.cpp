@@ -1,28 +1,55 @@
 #include <attender/utility/date.hpp>
 
-#include <sstream>
-#include <iomanip>
+#include <ctime>
 
 namespace attender
 {
-//#####################################################################################################################
-    std::string tm_formatter(std::tm* tm, const char* suffix = nullptr)
+    namespace
     {
-        static constexpr const char* weekdays[] = {"Mon", "Tue", "Wed", "Thu", "Fri", "Sat", "Sun"};
-        static constexpr const char* months[] = {"Jan", "Feb", "Mar", "Apr", "May", "Jun", "Jul", "Aug", "Sep", "Oct", "Nov", "Dec"};
+        void write_two_digits(char* out, int value)
+        {
+            out[0] = static_cast <char> ('0' + value / 10);
+            out[1] = static_cast <char> ('0' + value % 10);
+        }
+
+        void write_gmt(std::time_t time, char* out)
+        {
+            // tm_wday counts from sunday.
+            static constexpr char const* weekdays[] = {"Sun", "Mon", "Tue", "Wed", "Thu", "Fri", "Sat"};
+            static constexpr char const* months[] = {"Jan", "Feb", "Mar", "Apr", "May", "Jun", "Jul", "Aug", "Sep", "Oct", "Nov", "Dec"};
+
+            std::tm tm{};
+#ifdef _WIN32
+            gmtime_s(&tm, &time);
+#else
+            gmtime_r(&time, &tm);
+#endif
 
-        std::stringstream sstr;
-        sstr << weekdays[tm->tm_wday] << ", "
-             << tm->tm_mday << " "
-             << months[tm->tm_mon] << ' '
-             << (1900+tm->tm_year) << " "
-             << std::setfill('0') << std::setw(2) << tm->tm_hour << ':'
-             << std::setfill('0') << std::setw(2) << tm->tm_min << ':'
-             << std::setfill('0') << std::setw(2) << tm->tm_sec
-        ;
-        if (suffix != nullptr)
-            sstr << suffix;
-        return sstr.str();
+            // Sun, 06 Nov 1994 08:49:37 GMT
+            auto append = [&out](char const* what, std::size_t count) {
+                for (std::size_t i = 0; i != count; ++i)
+                    *out++ = what[i];
+            };
+            append(weekdays[tm.tm_wday], 3);
+            append(", ", 2);
+            write_two_digits(out, tm.tm_mday);
+            out += 2;
+            *out++ = ' ';
+            append(months[tm.tm_mon], 3);
+            *out++ = ' ';
+            auto year = 1900 + tm.tm_year;
+            write_two_digits(out, year / 100);
+            write_two_digits(out + 2, year % 100);
+            out += 4;
+            *out++ = ' ';
+            write_two_digits(out, tm.tm_hour);
+            out[2] = ':';
+            write_two_digits(out + 3, tm.tm_min);
+            out[5] = ':';
+            write_two_digits(out + 6, tm.tm_sec);
+            out += 8;
+            append(" GMT", 4);
+        }
     }
 //#####################################################################################################################
     date::date(std::chrono::system_clock::time_point time_point)
@@ -42,8 +69,28 @@ namespace attender
 //---------------------------------------------------------------------------------------------------------------------
     std::string date::to_gmt_string() const
     {
-        auto time = std::chrono::system_clock::to_time_t(time_point_);
-        return tm_formatter(gmtime(&time), " GMT");
+        std::string result(gmt_string_length, '\0');
+        write_gmt_string(result.data());
+        return result;
+    }
+//---------------------------------------------------------------------------------------------------------------------
+    void date::write_gmt_string(char* out) const
+    {
+        write_gmt(std::chrono::system_clock::to_time_t(time_point_), out);
+    }
+//#####################################################################################################################
+    std::string_view current_gmt_string()
+    {
+        thread_local std::time_t formatted_second = -1;
+        thread_local char formatted[date::gmt_string_length];
+
+        auto now = std::chrono::system_clock::to_time_t(std::chrono::system_clock::now());
+        if (now != formatted_second)
+        {
+            write_gmt(now, formatted);
+            formatted_second = now;
+        }
+        return {formatted, date::gmt_string_length};
     }
 //#####################################################################################################################
 }
@@ -0,0 +1,22 @@
+#pragma once
+
+#include <coroutine>
+#include <exception>
+
+namespace attender::tests
+{
+    /**
+     *  A coroutine that starts right away and is never awaited.
+     */
+    struct detached_coroutine
+    {
+        struct promise_type
+        {
+            detached_coroutine get_return_object() { return {}; }
+            std::suspend_never initial_suspend() noexcept { return {}; }
+            std::suspend_never final_suspend() noexcept { return {}; }
+            void return_void() {}
+            void unhandled_exception() { std::terminate(); }
+        };
+    };
+}
@@ -0,0 +1,104 @@
+#pragma once
+
+#include <attender/encoding/compression.hpp>
+#include <attender/http/mime.hpp>
+
+#include <gtest/gtest.h>
+#include <zlib.h>
+
+#include <string>
+#include <thread>
+
+namespace attender::tests
+{
+    namespace
+    {
+        std::string inflate_all(std::string const& compressed, int window_bits)
+        {
+            z_stream stream{};
+            inflateInit2(&stream, window_bits);
+
+            std::string result(1 << 20, '\0');
+            stream.next_in = reinterpret_cast <Bytef*> (const_cast <char*> (compressed.data()));
+            stream.avail_in = static_cast <uInt> (compressed.size());
+            stream.next_out = reinterpret_cast <Bytef*> (result.data());
+            stream.avail_out = static_cast <uInt> (result.size());
+            inflate(&stream, Z_FINISH);
+            result.resize(stream.total_out);
+
+            inflateEnd(&stream);
+            return result;
+        }
+    }
+
+    TEST(CompressionTests, NegotiatesByQuality)
+    {
+        compression_options options;
+
+        EXPECT_EQ(negotiate_coding("gzip, deflate, br", options), content_coding::brotli);
+        EXPECT_EQ(negotiate_coding("gzip;q=1.0, br;q=0.5", options), content_coding::gzip);
+        EXPECT_EQ(negotiate_coding("deflate, GZIP;q=0.9", options), content_coding::deflate);
+        EXPECT_EQ(negotiate_coding("br;q=0, gzip;q=0", options), content_coding::identity);
+        EXPECT_EQ(negotiate_coding("*;q=0.1, br;q=0", options), content_coding::gzip);
+        EXPECT_EQ(negotiate_coding("identity", options), content_coding::identity);
+        EXPECT_EQ(negotiate_coding("", options), content_coding::identity);
+
+        options.allow_brotli = false;
+        EXPECT_EQ(negotiate_coding("br, gzip;q=0.2", options), content_coding::gzip);
+    }
+
+    TEST(CompressionTests, CompressibleMimeTypes)
+    {
+        EXPECT_TRUE(is_compressible_mime("application/json"));
+        EXPECT_TRUE(is_compressible_mime("text/html; charset=utf-8"));
+        EXPECT_TRUE(is_compressible_mime("application/problem+json"));
+        EXPECT_TRUE(is_compressible_mime("image/svg+xml"));
+        EXPECT_FALSE(is_compressible_mime("image/png"));
+        EXPECT_FALSE(is_compressible_mime("application/zip"));
+        EXPECT_FALSE(is_compressible_mime("application/json-seq-but-not-really"));
+    }
+
+    TEST(CompressionTests, GzipAndDeflateRoundTrip)
+    {
+        compression_options options;
+        std::string body;
+        for (int i = 0; i != 1000; ++i)
+            body += "{\"id\":" + std::to_string(i) + ",\"name\":\"entry\"},";
+
+        std::string compressed;
+        ASSERT_TRUE(compress(content_coding::gzip, body, compressed, options));
+        EXPECT_LT(compressed.size(), body.size() / 4);
+        EXPECT_EQ(inflate_all(compressed, 15 + 16), body);
+
+        // the per thread stream is reset and reused.
+        ASSERT_TRUE(compress(content_coding::gzip, "second", compressed, options));
+        EXPECT_EQ(inflate_all(compressed, 15 + 16), "second");
+
+        ASSERT_TRUE(compress(content_coding::deflate, body, compressed, options));
+        EXPECT_EQ(inflate_all(compressed, 15), body);
+
+        ASSERT_TRUE(compress(content_coding::brotli, body, compressed, options));
+        EXPECT_LT(compressed.size(), body.size() / 4);
+
+        EXPECT_FALSE(compress(content_coding::identity, body, compressed, options));
+    }
+
+    TEST(CompressionTests, DefaultCompressionLevel)
+    {
+        compression_options options;
+        options.zlib_level = Z_DEFAULT_COMPRESSION;
+
+        // a new thread, its streams are not initialized yet.
+        std::thread{[&options]{
+            std::string compressed;
+            ASSERT_TRUE(compress(content_coding::gzip, "first", compressed, options));
+            EXPECT_EQ(inflate_all(compressed, 15 + 16), "first");
+
+            ASSERT_TRUE(compress(content_coding::gzip, "second", compressed, options));
+            EXPECT_EQ(inflate_all(compressed, 15 + 16), "second");
+
+            ASSERT_TRUE(compress(content_coding::deflate, "third", compressed, options));
+            EXPECT_EQ(inflate_all(compressed, 15), "third");
+        }}.join();
+    }
+}
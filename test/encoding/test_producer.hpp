@@ -0,0 +1,98 @@
+#pragma once
+
+#include <attender/encoding/producer.hpp>
+
+#include <gtest/gtest.h>
+
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace attender::tests
+{
+    /**
+     *  Keeps its output in one string that reallocates while it grows, like most simple producers.
+     */
+    class string_producer : public producer
+    {
+    public:
+        void produce(std::string const& data)
+        {
+            std::lock_guard <std::recursive_mutex> guard{buffer_protect_};
+            buffer_ += data;
+        }
+
+        std::string encoding() const override
+        {
+            return "identity";
+        }
+        std::size_t available() const override
+        {
+            return buffer_.size();
+        }
+        char const* data() const override
+        {
+            return buffer_.data();
+        }
+        void buffer_locked_do(std::function <void()> const& fn) const override
+        {
+            std::lock_guard <std::recursive_mutex> guard{buffer_protect_};
+            fn();
+        }
+        bool complete() const override
+        {
+            return false;
+        }
+        void has_consumed(std::size_t size) override
+        {
+            {
+                std::lock_guard <std::recursive_mutex> guard{buffer_protect_};
+                buffer_.erase(0, size);
+            }
+            producer::has_consumed(size);
+        }
+        void on_error(boost::system::error_code) override {}
+        void start_production() override {}
+
+    private:
+        std::string buffer_;
+        mutable std::recursive_mutex buffer_protect_;
+    };
+
+    TEST(ProducerTests, DefaultSpansSurviveReallocation)
+    {
+        string_producer producer;
+        producer.produce("first");
+
+        std::vector <std::pair <char const*, std::size_t>> spans;
+        producer.for_each_available([&spans](char const* data, std::size_t size) {
+            spans.emplace_back(data, size);
+        });
+        ASSERT_EQ(spans.size(), 1u);
+        EXPECT_NE(spans.front().first, producer.data());
+
+        // grows the string far beyond its capacity while the span would be written.
+        producer.produce(std::string(1'000'000, 'x'));
+        EXPECT_EQ(std::string(spans.front().first, spans.front().second), "first");
+    }
+
+    TEST(ProducerTests, DefaultSpanHoldsEverythingAvailable)
+    {
+        string_producer producer;
+        std::string collected;
+        producer.for_each_available([&collected](char const* data, std::size_t size) {
+            collected.append(data, size);
+        });
+        EXPECT_TRUE(collected.empty());
+
+        producer.produce("ab");
+        producer.produce("cd");
+        producer.for_each_available([&collected](char const* data, std::size_t size) {
+            collected.append(data, size);
+        });
+        EXPECT_EQ(collected, "abcd");
+
+        producer.has_consumed(4);
+        EXPECT_EQ(producer.available(), 0u);
+    }
+}
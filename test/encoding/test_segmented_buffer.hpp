@@ -0,0 +1,80 @@
+#pragma once
+
+#include <attender/encoding/segmented_buffer.hpp>
+
+#include <gtest/gtest.h>
+
+#include <string>
+
+namespace attender::tests
+{
+    namespace
+    {
+        std::string contents(segmented_buffer const& buffer)
+        {
+            std::string result;
+            buffer.for_each([&](std::string_view span) {
+                result += span;
+            });
+            return result;
+        }
+    }
+
+    TEST(SegmentedBufferTests, AppendsAcrossSegments)
+    {
+        segmented_buffer buffer{4};
+        EXPECT_EQ(buffer.append("0123456789", 10), 10u);
+
+        EXPECT_EQ(buffer.size(), 10u);
+        EXPECT_EQ(buffer.front(), "0123");
+        EXPECT_EQ(contents(buffer), "0123456789");
+    }
+
+    TEST(SegmentedBufferTests, ConsumeDoesNotMoveData)
+    {
+        segmented_buffer buffer{4};
+        buffer.append("0123456789", 10);
+        auto first = buffer.front().data();
+
+        buffer.consume(2);
+        EXPECT_EQ(buffer.front(), "23");
+        EXPECT_EQ(buffer.front().data(), first + 2);
+        buffer.consume(3);
+        EXPECT_EQ(buffer.front(), "567");
+        buffer.consume(5);
+        EXPECT_TRUE(buffer.empty());
+        EXPECT_TRUE(buffer.front().empty());
+    }
+
+    TEST(SegmentedBufferTests, ReusesRetiredSegments)
+    {
+        segmented_buffer buffer{4};
+        buffer.append("0123", 4);
+        auto first = buffer.front().data();
+        buffer.append("4567", 4);
+        buffer.consume(4);
+
+        // the retired first segment is the spare for the next one.
+        buffer.append("89", 2);
+        buffer.consume(4);
+        EXPECT_EQ(buffer.front(), "89");
+        EXPECT_EQ(buffer.front().data(), first);
+
+        buffer.append("ab", 2);
+        buffer.append("cd", 2);
+        EXPECT_EQ(contents(buffer), "89abcd");
+    }
+
+    TEST(SegmentedBufferTests, RefusesBeyondLimit)
+    {
+        segmented_buffer buffer{4, 6};
+        EXPECT_EQ(buffer.append("0123456789", 10), 6u);
+        EXPECT_TRUE(buffer.prepare().empty());
+
+        buffer.consume(3);
+        auto space = buffer.prepare();
+        EXPECT_EQ(space.size(), 2u);
+        EXPECT_EQ(buffer.append("xyz", 3), 3u);
+        EXPECT_EQ(contents(buffer), "345xyz");
+    }
+}
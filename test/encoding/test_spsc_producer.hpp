@@ -0,0 +1,79 @@
+#pragma once
+
+#include <attender/encoding/spsc_producer.hpp>
+
+#include <gtest/gtest.h>
+
+#include <string>
+
+namespace attender::tests
+{
+    class SpscProducerTests : public ::testing::Test
+    {
+    protected:
+        SpscProducerTests()
+            : service_{}
+            , producer_{service_, 16}
+        {
+        }
+
+        std::string spans()
+        {
+            std::string result;
+            producer_.for_each_available([&result](char const* data, std::size_t size) {
+                result.append(data, size);
+                result += '|';
+            });
+            return result;
+        }
+
+    protected:
+        asio::io_service service_;
+        spsc_producer producer_;
+    };
+
+    TEST_F(SpscProducerTests, PushIsAllOrNothing)
+    {
+        EXPECT_EQ(producer_.capacity(), 16u);
+        EXPECT_TRUE(producer_.try_push("0123456789"));
+        EXPECT_FALSE(producer_.try_push("abcdefg"));
+        EXPECT_TRUE(producer_.try_push("abcdef"));
+        EXPECT_EQ(producer_.buffered(), 16u);
+        EXPECT_FALSE(producer_.try_push("x"));
+    }
+
+    TEST_F(SpscProducerTests, ConsumerReadsAcrossTheEndOfTheRing)
+    {
+        producer_.try_push("0123456789");
+        producer_.has_consumed(8);
+        producer_.try_push("abcdefgh");
+
+        EXPECT_EQ(producer_.available(), 8u);
+        EXPECT_EQ(std::string(producer_.data(), producer_.available()), "89abcdef");
+        EXPECT_EQ(spans(), "89abcdef|gh|");
+
+        producer_.has_consumed(8);
+        EXPECT_EQ(spans(), "gh|");
+    }
+
+    TEST_F(SpscProducerTests, WakeupsAreCoalesced)
+    {
+        producer_.try_push("a");
+        producer_.try_push("b");
+        producer_.finish();
+        EXPECT_EQ(service_.poll(), 1u);
+
+        service_.restart();
+        producer_.flush();
+        EXPECT_EQ(service_.poll(), 1u);
+    }
+
+    TEST_F(SpscProducerTests, CompleteOnceDrained)
+    {
+        producer_.try_push("abc");
+        producer_.finish();
+        EXPECT_FALSE(producer_.complete());
+        producer_.has_consumed(3);
+        EXPECT_TRUE(producer_.complete());
+    }
+}
@@ -0,0 +1,65 @@
+#pragma once
+
+#include <attender/encoding/streaming_producer.hpp>
+
+#include <gtest/gtest.h>
+
+#include <string>
+
+namespace attender::tests
+{
+    class StreamingProducerTests : public ::testing::Test
+    {
+    protected:
+        StreamingProducerTests()
+            : producer_{"identity", []{}, [](auto){}}
+        {
+            producer_.set_water_marks(100, 200);
+        }
+
+        void fill()
+        {
+            std::string piece(64, 'x');
+            while (producer_.try_push(piece))
+            {}
+        }
+
+    protected:
+        streaming_producer producer_;
+    };
+
+    TEST_F(StreamingProducerTests, TryPushStopsAtHighWaterMark)
+    {
+        fill();
+        EXPECT_TRUE(producer_.is_full());
+        EXPECT_EQ(producer_.buffered(), 256u);
+        EXPECT_FALSE(producer_.try_push("x"));
+        EXPECT_EQ(producer_.buffered(), 256u);
+    }
+
+    TEST_F(StreamingProducerTests, WritableOnceDrainedToLowWaterMark)
+    {
+        fill();
+        int calls = 0;
+        producer_.when_writable([&calls]{ ++calls; });
+        EXPECT_EQ(calls, 0);
+
+        producer_.has_consumed(100);
+        EXPECT_EQ(calls, 0);
+        EXPECT_FALSE(producer_.is_full());
+
+        producer_.has_consumed(56);
+        EXPECT_EQ(calls, 1);
+
+        producer_.has_consumed(100);
+        EXPECT_EQ(calls, 1);
+        EXPECT_TRUE(producer_.try_push("x"));
+    }
+
+    TEST_F(StreamingProducerTests, WritableRightAwayIfDrained)
+    {
+        int calls = 0;
+        producer_.when_writable([&calls]{ ++calls; });
+        EXPECT_EQ(calls, 1);
+    }
+}
@@ -0,0 +1,125 @@
+#pragma once
+
+#include <attender/encoding/zlib.hpp>
+#include <attender/io_context/task_scheduler.hpp>
+
+#include <gtest/gtest.h>
+#include <zlib.h>
+
+#include <string>
+#include <thread>
+
+namespace attender::tests
+{
+    namespace
+    {
+        std::string drain(zlib_encoder& encoder)
+        {
+            std::string result;
+            for (std::size_t size = 0; (size = encoder.available()) != 0;)
+            {
+                encoder.buffer_locked_do([&]{
+                    result.append(encoder.data(), size);
+                });
+                encoder.has_consumed(size);
+            }
+            return result;
+        }
+
+        std::string inflate_stream(std::string const& compressed, int window_bits)
+        {
+            z_stream stream{};
+            inflateInit2(&stream, window_bits);
+
+            std::string result(1 << 20, '\0');
+            stream.next_in = reinterpret_cast <Bytef*> (const_cast <char*> (compressed.data()));
+            stream.avail_in = static_cast <uInt> (compressed.size());
+            stream.next_out = reinterpret_cast <Bytef*> (result.data());
+            stream.avail_out = static_cast <uInt> (result.size());
+            inflate(&stream, Z_FINISH);
+            result.resize(stream.total_out);
+
+            inflateEnd(&stream);
+            return result;
+        }
+    }
+
+    TEST(ZlibEncoderTests, GzipStreamsInPieces)
+    {
+        gzip_encoder encoder;
+        EXPECT_EQ(encoder.encoding(), "gzip");
+
+        std::string input;
+        std::string compressed;
+        for (int i = 0; i != 2000; ++i)
+        {
+            auto line = "line " + std::to_string(i) + "\n";
+            input += line;
+            encoder << line;
+            if (i % 500 == 0)
+            {
+                encoder.flush();
+                compressed += drain(encoder);
+            }
+        }
+        EXPECT_FALSE(encoder.complete());
+
+        encoder.finish();
+        compressed += drain(encoder);
+
+        EXPECT_TRUE(encoder.complete());
+        EXPECT_EQ(inflate_stream(compressed, 15 + 16), input);
+    }
+
+    TEST(ZlibEncoderTests, CompleteOnlyAfterEverythingWasConsumed)
+    {
+        deflate_encoder encoder{{9, 12, 9}};
+        EXPECT_EQ(encoder.encoding(), "deflate");
+
+        encoder << std::string(100'000, 'a');
+        encoder.finish();
+        EXPECT_FALSE(encoder.complete());
+
+        auto compressed = drain(encoder);
+        EXPECT_TRUE(encoder.complete());
+        EXPECT_EQ(inflate_stream(compressed, 15), std::string(100'000, 'a'));
+    }
+
+    TEST(ZlibEncoderTests, ResetStartsNewStream)
+    {
+        gzip_encoder encoder;
+        encoder << "first";
+        encoder.finish();
+        drain(encoder);
+
+        encoder.reset();
+        EXPECT_FALSE(encoder.complete());
+        encoder << "second";
+        encoder.finish();
+        EXPECT_EQ(inflate_stream(drain(encoder), 15 + 16), "second");
+    }
+
+    TEST(ZlibEncoderTests, CompressesOnScheduler)
+    {
+        task_scheduler scheduler{{.threads = 2}};
+        gzip_encoder encoder;
+        encoder.set_scheduler(&scheduler);
+
+        std::string input;
+        for (int i = 0; i != 100; ++i)
+        {
+            auto piece = std::to_string(i) + ",";
+            input += piece;
+            encoder << piece;
+        }
+        encoder.finish();
+
+        std::string compressed;
+        while (!encoder.complete())
+        {
+            compressed += drain(encoder);
+            std::this_thread::yield();
+        }
+        EXPECT_EQ(inflate_stream(compressed, 15 + 16), input);
+    }
+}
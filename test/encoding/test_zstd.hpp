@@ -0,0 +1,129 @@
+#pragma once
+
+#ifdef ATTENDER_ENABLE_ZSTD
+
+#include <attender/encoding/zstd.hpp>
+
+#include <gtest/gtest.h>
+#include <zstd.h>
+
+#include <string>
+#include <thread>
+
+namespace attender::tests
+{
+    namespace
+    {
+        std::string drain(zstd_encoder& encoder)
+        {
+            std::string result;
+            for (std::size_t size = 0; (size = encoder.available()) != 0;)
+            {
+                encoder.buffer_locked_do([&]{
+                    result.append(encoder.data(), size);
+                });
+                encoder.has_consumed(size);
+            }
+            return result;
+        }
+
+        std::string decompress(std::string const& compressed)
+        {
+            auto* stream = ZSTD_createDStream();
+            std::string result;
+            std::string buffer(ZSTD_DStreamOutSize(), '\0');
+            ZSTD_inBuffer input{compressed.data(), compressed.size(), 0};
+            while (input.pos != input.size)
+            {
+                ZSTD_outBuffer output{buffer.data(), buffer.size(), 0};
+                auto status = ZSTD_decompressStream(stream, &output, &input);
+                if (ZSTD_isError(status))
+                {
+                    ADD_FAILURE() << ZSTD_getErrorName(status);
+                    break;
+                }
+                result.append(buffer.data(), output.pos);
+            }
+            ZSTD_freeDStream(stream);
+            return result;
+        }
+    }
+
+    TEST(ZstdEncoderTests, ProducesFrameWithWorkers)
+    {
+        zstd_encoder encoder{{3, 2, true, 0}};
+        EXPECT_EQ(encoder.encoding(), "zstd");
+
+        std::string compressed;
+        for (int i = 0; i != 100'000; ++i)
+        {
+            encoder << "{\"id\":" + std::to_string(i) + "},";
+            if (i % 10'000 == 0)
+                compressed += drain(encoder);
+        }
+        encoder.finish();
+        EXPECT_FALSE(encoder.complete());
+
+        compressed += drain(encoder);
+        EXPECT_TRUE(encoder.complete());
+
+        ASSERT_GE(compressed.size(), 4u);
+        EXPECT_EQ(compressed.substr(0, 4), "\x28\xB5\x2F\xFD");
+        EXPECT_LT(compressed.size(), 100'000u);
+    }
+
+    TEST(ZstdEncoderTests, DefaultWorkersFitTheLibrary)
+    {
+        auto config = zstd_configuration::make_default();
+        auto bounds = ZSTD_cParam_getBounds(ZSTD_c_nbWorkers);
+        ASSERT_FALSE(ZSTD_isError(bounds.error));
+        EXPECT_GE(config.workers, bounds.lowerBound);
+        EXPECT_LE(config.workers, bounds.upperBound);
+
+        zstd_encoder encoder;
+        encoder << std::string{"default"};
+        encoder.finish();
+        EXPECT_EQ(decompress(drain(encoder)), "default");
+    }
+
+    TEST(ZstdEncoderTests, RoundTripsWhileConsumedConcurrently)
+    {
+        zstd_encoder encoder{{3, 2, false, 0}};
+        std::string original;
+        std::string compressed;
+
+        // the consumer drains while the workers compress, flushes must not keep it out.
+        std::thread consumer{[&]{
+            while (!encoder.complete())
+                compressed += drain(encoder);
+        }};
+        for (int i = 0; i != 50'000; ++i)
+        {
+            auto piece = "{\"id\":" + std::to_string(i) + "},";
+            original += piece;
+            encoder << piece;
+            if (i % 5'000 == 0)
+                encoder.flush();
+        }
+        encoder.finish();
+        consumer.join();
+
+        EXPECT_EQ(decompress(compressed), original);
+    }
+
+    TEST(ZstdEncoderTests, ResetStartsNewFrame)
+    {
+        zstd_encoder encoder{{1, 0, false, 0}};
+        encoder << "first";
+        encoder.finish();
+        drain(encoder);
+
+        encoder.reset();
+        EXPECT_FALSE(encoder.complete());
+        encoder << "second";
+        encoder.finish();
+        EXPECT_EQ(decompress(drain(encoder)), "second");
+    }
+}
+
+#endif // ATTENDER_ENABLE_ZSTD
@@ -0,0 +1,94 @@
+#pragma once
+
+#include <attender/http/chunked_decoder.hpp>
+#include <attender/http/http_read_sink.hpp>
+#include <attender/http/http_server.hpp>
+#include <attender/http/request.hpp>
+#include <attender/http/response.hpp>
+#include <attender/io_context/managed_io_context.hpp>
+#include <attender/io_context/thread_pooler.hpp>
+
+#include <boost/asio.hpp>
+
+#include <gtest/gtest.h>
+
+#include <memory>
+#include <string>
+
+namespace attender::tests
+{
+    class ChunkedDecoderTests : public ::testing::Test
+    {
+    public:
+        ChunkedDecoderTests()
+            : body_{}
+            , sink_{&body_}
+            , decoder_{}
+        {}
+
+    protected:
+        std::string body_;
+        http_string_sink sink_;
+        chunked_decoder decoder_;
+    };
+
+    TEST_F(ChunkedDecoderTests, DecodesWholeBody)
+    {
+        std::string encoded = "5\r\nhello\r\n6;ext=1\r\n world\r\n0\r\n\r\n";
+        EXPECT_EQ(decoder_.feed(encoded.data(), encoded.size(), sink_), chunked_decoder::result::finished);
+        EXPECT_EQ(body_, "hello world");
+    }
+
+    TEST_F(ChunkedDecoderTests, DecodesBytewise)
+    {
+        std::string encoded = "A\r\n0123456789\r\n0\r\nX-Checksum: abc \r\n\r\n";
+        for (std::size_t i = 0; i != encoded.size() - 1; ++i)
+            EXPECT_EQ(decoder_.feed(encoded.data() + i, 1, sink_), chunked_decoder::result::need_more);
+        EXPECT_EQ(decoder_.feed(encoded.data() + encoded.size() - 1, 1, sink_), chunked_decoder::result::finished);
+        EXPECT_EQ(body_, "0123456789");
+        EXPECT_EQ(decoder_.get_trailers().at("X-Checksum"), "abc");
+    }
+
+    TEST_F(ChunkedDecoderTests, StopsAtLimit)
+    {
+        decoder_.reset(4);
+        std::string encoded = "5\r\nhello\r\n0\r\n\r\n";
+        EXPECT_EQ(decoder_.feed(encoded.data(), encoded.size(), sink_), chunked_decoder::result::limit_reached);
+        EXPECT_EQ(body_, "hell");
+    }
+
+    TEST_F(ChunkedDecoderTests, RejectsMalformedInput)
+    {
+        std::string encoded = "5\r\nhelloXX";
+        EXPECT_EQ(decoder_.feed(encoded.data(), encoded.size(), sink_), chunked_decoder::result::malformed);
+    }
+
+    TEST(ChunkedRequestTests, TrailerLookupIgnoresCase)
+    {
+        managed_io_context <thread_pooler> context;
+        http_server server{context.get_io_context(), [](auto*, auto const&, auto const&){}};
+        server.post("/upload", [](auto req, auto res) {
+            auto body = std::make_shared <std::string> ();
+            req->read_body(*body).then([req, res, body]{
+                res->send(*body + "/" + req->get_trailer_field("x-checksum").value_or("none"));
+            });
+        });
+        server.start("0", "127.0.0.1");
+
+        boost::asio::io_context client;
+        boost::asio::ip::tcp::socket socket{client};
+        socket.connect({boost::asio::ip::make_address("127.0.0.1"), server.get_local_endpoint().port()});
+        std::string request =
+            "POST /upload HTTP/1.1\r\nHost: localhost\r\nTransfer-Encoding: chunked\r\n\r\n"
+            "5\r\nhello\r\n0\r\nX-Checksum: abc\r\n\r\n"
+        ;
+        boost::asio::write(socket, boost::asio::buffer(request));
+
+        std::string received;
+        boost::system::error_code ec;
+        boost::asio::read(socket, boost::asio::dynamic_buffer(received), ec);
+        EXPECT_NE(received.find("\r\n\r\nhello/abc"), std::string::npos);
+
+        context.teardown();
+    }
+}
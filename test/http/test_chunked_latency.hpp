@@ -0,0 +1,250 @@
+#pragma once
+
+#include "../detached_coroutine.hpp"
+
+#include <attender/encoding/streaming_producer.hpp>
+#include <attender/http/http_server.hpp>
+#include <attender/http/response.hpp>
+#include <attender/io_context/managed_io_context.hpp>
+#include <attender/io_context/thread_pooler.hpp>
+
+#include <boost/asio.hpp>
+
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace attender::tests
+{
+    /**
+     *  Streams whose producer waits for the connection. The first chunk must reach the client
+     *  as soon as the consumer is attached, before the producer writes anything else.
+     */
+    class ChunkedLatencyTests : public ::testing::Test
+    {
+    protected:
+        ChunkedLatencyTests()
+            : context_{}
+            , server_{context_.get_io_context(), [](auto*, auto const&, auto const&){}}
+            , producers_{}
+            , protect_{}
+            , events_{}
+            , gate_{}
+            , gate_open_{false}
+        {
+        }
+
+        ~ChunkedLatencyTests()
+        {
+            openGate();
+            context_.teardown();
+            for (auto& producer : producers_)
+                producer.join();
+        }
+
+        template <typename ProduceT>
+        void setupStream(ProduceT produce)
+        {
+            server_.get("/stream", [this, produce](auto, auto res) {
+                auto produ = std::make_shared <streaming_producer> ("identity", []{}, [](auto){});
+                {
+                    std::lock_guard <std::mutex> guard{protect_};
+                    producers_.emplace_back([produ, produce]{ produce(*produ); });
+                }
+                res->send_chunked(*produ, [produ](auto){});
+            });
+            server_.start("0", "127.0.0.1");
+        }
+
+        void record(std::string const& event)
+        {
+            std::lock_guard <std::mutex> guard{protect_};
+            events_.push_back(event);
+        }
+
+        void openGate()
+        {
+            std::lock_guard <std::mutex> guard{protect_};
+            gate_open_ = true;
+            gate_.notify_all();
+        }
+
+        /**
+         *  Called by producers, they continue once the client received the first chunk.
+         */
+        void waitForGate()
+        {
+            std::unique_lock <std::mutex> guard{protect_};
+            gate_.wait_for(guard, std::chrono::seconds{5}, [this]{ return gate_open_; });
+        }
+
+        /**
+         *  Reads until marker was received, or the deadline passed.
+         */
+        static bool readUntil(boost::asio::io_context& context, boost::asio::ip::tcp::socket& socket, std::string& received, std::string const& marker)
+        {
+            bool found = false;
+            boost::asio::async_read_until(socket, boost::asio::dynamic_buffer(received), marker, [&found](auto ec, auto) {
+                found = !ec;
+            });
+            context.restart();
+            context.run_for(std::chrono::seconds{5});
+            if (!context.stopped())
+            {
+                socket.cancel();
+                context.restart();
+                context.run();
+            }
+            return found;
+        }
+
+        /**
+         *  Reads until the connection ends, or the deadline passed.
+         *
+         *  @return How the connection ended, eof if the server closed it normally.
+         */
+        static boost::system::error_code readToEnd(boost::asio::io_context& context, boost::asio::ip::tcp::socket& socket, std::string& received)
+        {
+            boost::system::error_code result = boost::asio::error::timed_out;
+            boost::asio::async_read(socket, boost::asio::dynamic_buffer(received), [&result](auto ec, auto) {
+                result = ec;
+            });
+            context.restart();
+            context.run_for(std::chrono::seconds{5});
+            if (!context.stopped())
+            {
+                socket.cancel();
+                context.restart();
+                context.run();
+                result = boost::asio::error::timed_out;
+            }
+            return result;
+        }
+
+        /**
+         *  Requests the stream, records when the first chunk arrived and lets the producers continue.
+         *
+         *  @return The whole response.
+         */
+        std::string requestStream()
+        {
+            boost::asio::io_context context;
+            boost::asio::ip::tcp::socket socket{context};
+            socket.connect({boost::asio::ip::make_address("127.0.0.1"), server_.get_local_endpoint().port()});
+            boost::asio::write(socket, boost::asio::buffer(std::string{"GET /stream HTTP/1.1\r\nHost: localhost\r\n\r\n"}));
+
+            std::string received;
+            if (readUntil(context, socket, received, "5\r\nfirst\r\n"))
+                record("received first");
+            openGate();
+
+            readUntil(context, socket, received, "0\r\n\r\n");
+            return received;
+        }
+
+        /**
+         *  Resumes on the io thread once the consumer is attached.
+         */
+        detached_coroutine writeFirstWhenAttached(streaming_producer& produ)
+        {
+            co_await produ.attached_co();
+            record("attached");
+            produ << std::string{"first"};
+        }
+
+        std::vector <std::string> events()
+        {
+            std::lock_guard <std::mutex> guard{protect_};
+            return events_;
+        }
+
+    protected:
+        managed_io_context <thread_pooler> context_;
+        http_server server_;
+        std::vector <std::thread> producers_;
+
+        std::mutex protect_;
+        std::vector <std::string> events_;
+        std::condition_variable gate_;
+        bool gate_open_;
+    };
+
+    TEST_F(ChunkedLatencyTests, BlockingProducerStartsWhenConsumerAttaches)
+    {
+        setupStream([this](streaming_producer& produ) {
+            if (produ.wait_for_consumer(std::chrono::seconds{5}))
+                record("attached");
+            produ << std::string{"first"};
+            waitForGate();
+            record("second");
+            produ << std::string{"second"};
+            produ.finish();
+        });
+
+        auto received = requestStream();
+        EXPECT_NE(received.find("5\r\nfirst\r\n6\r\nsecond\r\n0\r\n\r\n"), std::string::npos);
+        EXPECT_EQ(events(), (std::vector <std::string> {"attached", "received first", "second"}));
+    }
+
+    TEST_F(ChunkedLatencyTests, AttachCallbackStartsProduction)
+    {
+        setupStream([this](streaming_producer& produ) {
+            produ.when_attached([this, &produ]{
+                record("attached");
+                produ << std::string{"first"};
+            });
+            waitForGate();
+            record("second");
+            produ << std::string{"second"};
+            produ.finish();
+        });
+
+        auto received = requestStream();
+        EXPECT_NE(received.find("5\r\nfirst\r\n6\r\nsecond\r\n0\r\n\r\n"), std::string::npos);
+        EXPECT_EQ(events(), (std::vector <std::string> {"attached", "received first", "second"}));
+    }
+
+    TEST_F(ChunkedLatencyTests, AwaitingAttachmentStartsProduction)
+    {
+        setupStream([this](streaming_producer& produ) {
+            writeFirstWhenAttached(produ);
+            waitForGate();
+            record("second");
+            produ << std::string{"second"};
+            produ.finish();
+        });
+
+        auto received = requestStream();
+        EXPECT_NE(received.find("5\r\nfirst\r\n6\r\nsecond\r\n0\r\n\r\n"), std::string::npos);
+        EXPECT_EQ(events(), (std::vector <std::string> {"attached", "received first", "second"}));
+    }
+
+    TEST_F(ChunkedLatencyTests, BufferOverrunResetsTheConnection)
+    {
+        setupStream([](streaming_producer& produ) {
+            produ.set_buffer_limit(1024);
+            produ.wait_for_consumer(std::chrono::seconds{5});
+            produ << std::string{"first"};
+            produ << std::string(64 * 1024, 'x');
+        });
+
+        boost::asio::io_context context;
+        boost::asio::ip::tcp::socket socket{context};
+        socket.connect({boost::asio::ip::make_address("127.0.0.1"), server_.get_local_endpoint().port()});
+        boost::asio::write(socket, boost::asio::buffer(std::string{"GET /stream HTTP/1.1\r\nHost: localhost\r\n\r\n"}));
+
+        // the truncated stream must not end like a complete one.
+        std::string received;
+        auto ec = readToEnd(context, socket, received);
+        EXPECT_EQ(received.find("0\r\n\r\n"), std::string::npos);
+        EXPECT_TRUE(ec);
+        EXPECT_NE(ec, boost::asio::error::eof);
+        EXPECT_NE(ec, boost::asio::error::timed_out);
+    }
+}
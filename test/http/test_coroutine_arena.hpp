@@ -0,0 +1,89 @@
+#pragma once
+
+#include <attender/http/http_task.hpp>
+#include <attender/utility/coroutine_arena.hpp>
+
+#include <gtest/gtest.h>
+
+#include <cstddef>
+
+namespace attender::tests
+{
+    TEST(CoroutineArenaTests, ReleasedTopIsReused)
+    {
+        coroutine_arena arena;
+        auto* first = arena.allocate(100);
+        auto* second = arena.allocate(100);
+        ASSERT_NE(first, nullptr);
+        ASSERT_NE(second, nullptr);
+        EXPECT_TRUE(arena.owns(first));
+        EXPECT_TRUE(arena.owns(second));
+        EXPECT_LT(static_cast <std::byte*> (first), static_cast <std::byte*> (second));
+
+        arena.deallocate(second, 100);
+        EXPECT_EQ(arena.allocate(100), second);
+
+        arena.deallocate(second, 100);
+        arena.deallocate(first, 100);
+        EXPECT_EQ(arena.used(), 0u);
+        EXPECT_EQ(arena.allocate(100), first);
+    }
+
+    TEST(CoroutineArenaTests, OutOfOrderReleaseIsReclaimedWithTheTop)
+    {
+        coroutine_arena arena;
+        auto* first = arena.allocate(64);
+        auto* second = arena.allocate(64);
+        auto const used = arena.used();
+
+        // the space below the top stays taken until the top is released too.
+        arena.deallocate(first, 64);
+        EXPECT_EQ(arena.used(), used);
+
+        arena.deallocate(second, 64);
+        EXPECT_EQ(arena.used(), 0u);
+        EXPECT_EQ(arena.allocate(64), first);
+    }
+
+    TEST(CoroutineArenaTests, ExhaustedArenaReturnsNull)
+    {
+        coroutine_arena arena;
+        EXPECT_EQ(arena.allocate(config::coroutine_arena_size + 1), nullptr);
+        EXPECT_EQ(arena.used(), 0u);
+
+        auto* all = arena.allocate(config::coroutine_arena_size);
+        ASSERT_NE(all, nullptr);
+        EXPECT_EQ(arena.allocate(1), nullptr);
+
+        arena.deallocate(all, config::coroutine_arena_size);
+        EXPECT_NE(arena.allocate(1), nullptr);
+    }
+
+    TEST(CoroutineArenaTests, SmallFramesStayInTheArena)
+    {
+        coroutine_arena arena;
+        auto* frame = internal::allocate_frame(256, &arena);
+        EXPECT_TRUE(arena.owns(frame));
+        EXPECT_GT(arena.used(), 256u);
+
+        internal::deallocate_frame(frame, 256);
+        EXPECT_EQ(arena.used(), 0u);
+    }
+
+    TEST(CoroutineArenaTests, LargeFramesFallBackToTheHeap)
+    {
+        coroutine_arena arena;
+        auto* frame = internal::allocate_frame(config::coroutine_arena_size, &arena);
+        ASSERT_NE(frame, nullptr);
+        EXPECT_FALSE(arena.owns(frame));
+        EXPECT_EQ(arena.used(), 0u);
+
+        // the arena still serves the frames that fit.
+        auto* small = internal::allocate_frame(256, &arena);
+        EXPECT_TRUE(arena.owns(small));
+
+        internal::deallocate_frame(small, 256);
+        internal::deallocate_frame(frame, config::coroutine_arena_size);
+        EXPECT_EQ(arena.used(), 0u);
+    }
+}
@@ -0,0 +1,104 @@
+#pragma once
+
+#include <attender/http/http_server.hpp>
+#include <attender/http/http_task.hpp>
+#include <attender/http/response.hpp>
+#include <attender/io_context/managed_io_context.hpp>
+#include <attender/io_context/thread_pooler.hpp>
+
+#include <boost/asio.hpp>
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <stdexcept>
+#include <string>
+
+namespace attender::tests
+{
+    class CoroutineRouteTests : public ::testing::Test
+    {
+    protected:
+        CoroutineRouteTests()
+            : context_{}
+            , server_{context_.get_io_context(), [](auto*, auto const&, auto const&){}}
+        {
+        }
+
+        ~CoroutineRouteTests()
+        {
+            context_.teardown();
+        }
+
+        /**
+         *  Requests the path and reads until the server closes the connection, error_ tells how it closed.
+         */
+        std::string get(std::string const& path)
+        {
+            server_.start("0", "127.0.0.1");
+
+            boost::asio::io_context context;
+            boost::asio::ip::tcp::socket socket{context};
+            socket.connect({boost::asio::ip::make_address("127.0.0.1"), server_.get_local_endpoint().port()});
+            std::string request = "GET " + path + " HTTP/1.1\r\nHost: localhost\r\n\r\n";
+            boost::asio::write(socket, boost::asio::buffer(request));
+
+            std::string received;
+            boost::asio::read(socket, boost::asio::dynamic_buffer(received), error_);
+            return received;
+        }
+
+    protected:
+        managed_io_context <thread_pooler> context_;
+        http_server server_;
+        boost::system::error_code error_;
+    };
+
+    TEST_F(CoroutineRouteTests, SendsResponse)
+    {
+        server_.get_co("/co", [](request_handler*, response_handler* res) -> http_task {
+            co_await res->send_co("coroutine");
+        });
+
+        auto received = get("/co");
+        EXPECT_EQ(received.find("HTTP/1.1 200"), 0u);
+        EXPECT_EQ(received.substr(received.size() - 13), "\r\n\r\ncoroutine");
+    }
+
+    TEST_F(CoroutineRouteTests, EndsWithoutSend)
+    {
+        server_.get_co("/co_empty", [](request_handler*, response_handler*) -> http_task {
+            co_return;
+        });
+
+        auto received = get("/co_empty");
+        EXPECT_EQ(received.find("HTTP/1.1 204"), 0u);
+    }
+
+    TEST_F(CoroutineRouteTests, FrameLivesInTheConnectionArena)
+    {
+        std::atomic <std::size_t> used{0};
+        server_.get_co("/co_arena", [&used](request_handler*, response_handler* res) -> http_task {
+            used = internal::arena_of(res)->used();
+            co_await res->send_co("arena");
+        });
+
+        auto received = get("/co_arena");
+        EXPECT_EQ(received.find("HTTP/1.1 200"), 0u);
+        EXPECT_GT(used.load(), 0u);
+    }
+
+    TEST_F(CoroutineRouteTests, ExceptionAfterHeaderResetsTheConnection)
+    {
+        server_.get_co("/co_throw", [](request_handler*, response_handler* res) -> http_task {
+            co_await res->write_chunk_co("partial");
+            throw std::runtime_error("failed");
+        });
+
+        auto received = get("/co_throw");
+        EXPECT_EQ(received.find("HTTP/1.1 200"), 0u);
+        EXPECT_EQ(received.find("0\r\n\r\n"), std::string::npos);
+        EXPECT_TRUE(error_);
+        EXPECT_NE(error_, boost::asio::error::eof);
+    }
+}
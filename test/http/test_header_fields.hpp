@@ -0,0 +1,87 @@
+#pragma once
+
+#include <attender/http/header_fields.hpp>
+
+#include <gtest/gtest.h>
+
+#include <string>
+#include <vector>
+
+namespace attender::tests
+{
+    TEST(HeaderFieldsTests, KeepsInsertionOrder)
+    {
+        header_fields fields;
+        fields.set("X-First", "1");
+        fields.set("Content-Type", "text/plain");
+        fields.set("X-Last", "2");
+
+        std::string serialized;
+        fields.append_to(serialized);
+        EXPECT_EQ(serialized, "X-First: 1\r\nContent-Type: text/plain\r\nX-Last: 2\r\n");
+        EXPECT_EQ(fields.serialized_size(), serialized.size());
+    }
+
+    TEST(HeaderFieldsTests, NamesAreCaseInsensitive)
+    {
+        header_fields fields;
+        fields.set("content-length", "5");
+        fields.set("x-custom", "a");
+
+        EXPECT_TRUE(fields.contains("Content-Length"));
+        EXPECT_TRUE(fields.contains("X-CUSTOM"));
+        EXPECT_FALSE(fields.try_set("CONTENT-LENGTH", "7"));
+        EXPECT_EQ(fields.get("Content-Length").value(), "5");
+        EXPECT_EQ(fields.size(), 2u);
+    }
+
+    TEST(HeaderFieldsTests, MultipleValues)
+    {
+        header_fields fields;
+        fields.add("Link", "<a>");
+        fields.add("Vary", "Accept");
+        fields.add("Link", "<b>");
+
+        EXPECT_EQ(fields.size(), 3u);
+        EXPECT_EQ(fields.get("Link").value(), "<a>, <b>");
+
+        fields.set("Link", "<c>");
+        std::vector <std::string> lines;
+        fields.for_each([&lines](std::string_view name, std::string_view value) {
+            lines.push_back(std::string{name} + "=" + std::string{value});
+        });
+        ASSERT_EQ(lines.size(), 2u);
+        EXPECT_EQ(lines[0], "Link=<c>");
+        EXPECT_EQ(lines[1], "Vary=Accept");
+
+        EXPECT_EQ(fields.erase("link"), 1u);
+        EXPECT_FALSE(fields.contains("Link"));
+    }
+
+    TEST(HeaderFieldsTests, ReplacingValuesReclaimsSpace)
+    {
+        header_fields fields;
+        fields.set("X-Keep", "keep");
+        for (int i = 0; i != 1000; ++i)
+            fields.set("X-Counter", std::to_string(i) + std::string(50, 'x'));
+
+        EXPECT_EQ(fields.get("X-Keep").value(), "keep");
+        EXPECT_EQ(fields.get("X-Counter").value(), "999" + std::string(50, 'x'));
+    }
+
+    TEST(HeaderFieldsTests, ErasingValuesReclaimsSpace)
+    {
+        header_fields fields;
+        fields.set("X-Keep", "keep");
+        for (int i = 0; i != 1000; ++i)
+        {
+            fields.set("X-Counter-" + std::to_string(i % 3), std::to_string(i) + std::string(50, 'x'));
+            EXPECT_EQ(fields.erase("X-Counter-" + std::to_string(i % 3)), 1u);
+        }
+        fields.set("X-Last", "last");
+
+        EXPECT_EQ(fields.size(), 2u);
+        EXPECT_EQ(fields.get("X-Keep").value(), "keep");
+        EXPECT_EQ(fields.get("X-Last").value(), "last");
+    }
+}
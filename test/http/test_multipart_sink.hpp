@@ -0,0 +1,94 @@
+#pragma once
+
+#include <attender/http/multipart_sink.hpp>
+
+#include <gtest/gtest.h>
+
+#include <deque>
+#include <string>
+#include <vector>
+
+namespace attender::tests
+{
+    class MultipartSinkTests : public ::testing::Test
+    {
+    public:
+        struct part
+        {
+            multipart_header header;
+            std::string body;
+        };
+
+        std::shared_ptr <http_multipart_sink> makeSink()
+        {
+            return std::make_shared <http_multipart_sink>("XyZ", [this](multipart_header const& header) {
+                parts_.push_back({header, {}});
+                return std::make_shared <http_string_sink>(&parts_.back().body);
+            });
+        }
+
+    protected:
+        std::string body_ =
+            "preamble\r\n"
+            "--XyZ\r\n"
+            "Content-Disposition: form-data; name=\"field\"\r\n"
+            "\r\n"
+            "value\r\n"
+            "--XyZ\r\n"
+            "Content-Disposition: form-data; name=\"file\"; filename=\"a \\\"b\\\".txt\"\r\n"
+            "Content-Type: application/octet-stream\r\n"
+            "\r\n"
+            "line\r\n--XyNot a boundary\r\n\r\n--X\r\n"
+            "--XyZ--\r\n"
+            "epilogue";
+        std::deque <part> parts_;
+    };
+
+    TEST_F(MultipartSinkTests, ParsesParts)
+    {
+        auto sink = makeSink();
+        sink->write(body_.data(), body_.size());
+
+        EXPECT_TRUE(sink->finished());
+        EXPECT_FALSE(sink->failed());
+        ASSERT_EQ(parts_.size(), 2u);
+        EXPECT_EQ(parts_[0].header.name().get(), "field");
+        EXPECT_EQ(parts_[0].body, "value");
+        EXPECT_EQ(parts_[1].header.name().get(), "file");
+        EXPECT_EQ(parts_[1].header.filename().get(), "a \"b\".txt");
+        EXPECT_EQ(parts_[1].header.content_type(), "application/octet-stream");
+        EXPECT_EQ(parts_[1].body, "line\r\n--XyNot a boundary\r\n\r\n--X");
+    }
+
+    TEST_F(MultipartSinkTests, ParsesIndependentOfSplitting)
+    {
+        for (std::size_t step = 1; step != body_.size(); ++step)
+        {
+            parts_.clear();
+            auto sink = makeSink();
+            for (std::size_t i = 0; i < body_.size(); i += step)
+                sink->write(body_.data() + i, std::min(step, body_.size() - i));
+
+            EXPECT_TRUE(sink->finished()) << "step " << step;
+            ASSERT_EQ(parts_.size(), 2u) << "step " << step;
+            EXPECT_EQ(parts_[0].body, "value") << "step " << step;
+            EXPECT_EQ(parts_[1].body, "line\r\n--XyNot a boundary\r\n\r\n--X") << "step " << step;
+        }
+    }
+
+    TEST_F(MultipartSinkTests, ExtractsBoundary)
+    {
+        EXPECT_EQ(http_multipart_sink::get_boundary("multipart/form-data; boundary=abc").get(), "abc");
+        EXPECT_EQ(http_multipart_sink::get_boundary("Multipart/Form-Data; charset=utf-8; boundary=\"a b\"").get(), "a b");
+        EXPECT_FALSE(http_multipart_sink::get_boundary("text/plain; boundary=abc"));
+        EXPECT_FALSE(http_multipart_sink::get_boundary("multipart/form-data"));
+    }
+
+    TEST_F(MultipartSinkTests, FailsOnMalformedDelimiter)
+    {
+        auto sink = makeSink();
+        std::string body = "--XyZ garbage\r\n\r\n";
+        sink->write(body.data(), body.size());
+        EXPECT_TRUE(sink->failed());
+    }
+}
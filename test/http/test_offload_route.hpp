@@ -0,0 +1,87 @@
+#pragma once
+
+#include <attender/http/http_server.hpp>
+#include <attender/http/request.hpp>
+#include <attender/http/response.hpp>
+#include <attender/io_context/managed_io_context.hpp>
+#include <attender/io_context/thread_pooler.hpp>
+
+#include <boost/asio.hpp>
+
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <future>
+#include <string>
+#include <thread>
+
+namespace attender::tests
+{
+    class OffloadRouteTests : public ::testing::Test
+    {
+    protected:
+        OffloadRouteTests()
+            : context_{}
+            , server_{context_.get_io_context(), [](auto*, auto const&, auto const&){}}
+        {
+        }
+
+        ~OffloadRouteTests()
+        {
+            context_.teardown();
+        }
+
+        bool waitForNoConnections()
+        {
+            auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds{5};
+            while (server_.get_connections()->count() != 0)
+            {
+                if (std::chrono::steady_clock::now() > deadline)
+                    return false;
+                std::this_thread::sleep_for(std::chrono::milliseconds{5});
+            }
+            return true;
+        }
+
+    protected:
+        managed_io_context <thread_pooler> context_;
+        http_server server_;
+    };
+
+    TEST_F(OffloadRouteTests, HandlerOutlivesClosedConnection)
+    {
+        std::promise <void> started;
+        std::promise <void> closed;
+        std::promise <std::string> path_after_close;
+
+        server_.get("/blocking", [&](auto req, auto res) {
+            started.set_value();
+            closed.get_future().wait();
+
+            // the response fails or completes, either way the connection is removed while the handler runs.
+            auto observer = res->observe_conclusion();
+            res->send("late");
+            auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds{5};
+            while (observer->is_alive() && std::chrono::steady_clock::now() < deadline)
+                std::this_thread::sleep_for(std::chrono::milliseconds{1});
+
+            path_after_close.set_value(observer->is_alive() ? std::string{} : req->path());
+        }, {.execution = execution_mode::offload});
+        server_.start("0", "127.0.0.1");
+
+        boost::asio::io_context context;
+        boost::asio::ip::tcp::socket socket{context};
+        socket.connect({boost::asio::ip::make_address("127.0.0.1"), server_.get_local_endpoint().port()});
+        std::string request = "GET /blocking HTTP/1.1\r\nHost: localhost\r\n\r\n";
+        boost::asio::write(socket, boost::asio::buffer(request));
+
+        ASSERT_EQ(started.get_future().wait_for(std::chrono::seconds{5}), std::future_status::ready);
+        socket.close();
+        closed.set_value();
+
+        auto path = path_after_close.get_future();
+        ASSERT_EQ(path.wait_for(std::chrono::seconds{10}), std::future_status::ready);
+        EXPECT_EQ(path.get(), "/blocking");
+        EXPECT_TRUE(waitForNoConnections());
+    }
+}
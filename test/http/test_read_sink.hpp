@@ -0,0 +1,40 @@
+#pragma once
+
+#include <attender/http/http_read_sink.hpp>
+
+#include <gtest/gtest.h>
+
+#include <string>
+#include <vector>
+
+namespace attender::tests
+{
+    TEST(ReadSinkTests, SpanSinkPassesViewsIntoTheBuffer)
+    {
+        std::vector <char> buffer{'a', 'b', 'c', 'd'};
+        std::vector <std::span <const char>> views;
+        http_span_sink sink{[&views](std::span <const char> data) {
+            views.push_back(data);
+        }};
+
+        sink.write(buffer, 3);
+
+        ASSERT_EQ(views.size(), 1u);
+        EXPECT_EQ(views.front().data(), buffer.data());
+        EXPECT_EQ(views.front().size(), 3u);
+        EXPECT_EQ(sink.get_total_bytes_written(), 3u);
+    }
+
+    TEST(ReadSinkTests, StringSinkReservesExpectedSize)
+    {
+        std::string body;
+        http_string_sink sink{&body};
+
+        sink.expect(1000);
+        auto capacity = body.capacity();
+        EXPECT_GE(capacity, 1000u);
+
+        sink.write(std::string(1000, 'x').data(), 1000);
+        EXPECT_EQ(body.capacity(), capacity);
+    }
+}
@@ -0,0 +1,61 @@
+#pragma once
+
+#include <attender/http/response_header.hpp>
+#include <attender/http/response_code.hpp>
+#include <attender/utility/date.hpp>
+
+#include <gtest/gtest.h>
+
+#include <string>
+
+namespace attender::tests
+{
+    TEST(ResponseHeaderTests, DateFormatsRfc2616)
+    {
+        // 784111777 is Sun, 06 Nov 1994 08:49:37 GMT
+        date example{std::chrono::system_clock::from_time_t(784111777)};
+        EXPECT_EQ(example.to_gmt_string(), "Sun, 06 Nov 1994 08:49:37 GMT");
+
+        date monday{std::chrono::system_clock::from_time_t(784111777 + 24 * 60 * 60)};
+        EXPECT_EQ(monday.to_gmt_string(), "Mon, 07 Nov 1994 08:49:37 GMT");
+    }
+
+    TEST(ResponseHeaderTests, CurrentDateHasDateFormat)
+    {
+        auto now = current_gmt_string();
+        EXPECT_EQ(now.size(), date::gmt_string_length);
+        EXPECT_EQ(now.substr(now.size() - 4), " GMT");
+    }
+
+    TEST(ResponseHeaderTests, StatusLinesArePrecomputed)
+    {
+        EXPECT_EQ(status_line(404), "HTTP/1.1 404 Not Found\r\n");
+        EXPECT_EQ(status_line(999), "");
+        EXPECT_EQ(status_line(299), "");
+    }
+
+    TEST(ResponseHeaderTests, SerializesStatusDateFieldsAndCookies)
+    {
+        response_header header;
+        header.set_code(200);
+        header.set_field("Content-Length", "5");
+        header.set_cookie(cookie{"id", "abc"}.set_path("/"));
+
+        auto serialized = header.to_string();
+        EXPECT_EQ(serialized.rfind("HTTP/1.1 200 Ok\r\nDate: ", 0), 0u);
+        EXPECT_NE(serialized.find("\r\nContent-Length: 5\r\n"), std::string::npos);
+        EXPECT_NE(serialized.find("\r\nSet-Cookie: id=abc; Path=/\r\n"), std::string::npos);
+        EXPECT_EQ(serialized.substr(serialized.size() - 4), "\r\n\r\n");
+    }
+
+    TEST(ResponseHeaderTests, CustomStatusLineAndDateAreKept)
+    {
+        response_header header;
+        header.set_code(200);
+        header.set_message("Fine");
+        header.set_field("Date", "Sun, 06 Nov 1994 08:49:37 GMT");
+
+        auto serialized = header.to_string();
+        EXPECT_EQ(serialized, "HTTP/1.1 200 Fine\r\nDate: Sun, 06 Nov 1994 08:49:37 GMT\r\n\r\n");
+    }
+}
@@ -0,0 +1,181 @@
+#pragma once
+
+#include <attender/http/http_server.hpp>
+#include <attender/http/response.hpp>
+#include <attender/http/sse_hub.hpp>
+#include <attender/io_context/managed_io_context.hpp>
+#include <attender/io_context/thread_pooler.hpp>
+
+#include <boost/asio.hpp>
+
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <memory>
+#include <string>
+#include <thread>
+
+namespace attender::tests
+{
+    class SseHubTests : public ::testing::Test
+    {
+    protected:
+        SseHubTests()
+            : context_{}
+            , server_{context_.get_io_context(), [](auto*, auto const&, auto const&){}}
+            , hub_{}
+        {
+        }
+
+        ~SseHubTests()
+        {
+            context_.teardown();
+        }
+
+        void setupHub(sse_options options = {})
+        {
+            hub_ = std::make_unique <sse_hub> (*context_.get_io_context(), options);
+            server_.get("/events/:topic", [this](auto req, auto res) {
+                hub_->subscribe(req->param("topic"), req, res);
+            });
+            server_.start("0", "127.0.0.1");
+        }
+
+        std::unique_ptr <boost::asio::ip::tcp::socket> subscribe(std::string const& topic, std::string const& fields = "")
+        {
+            auto socket = std::make_unique <boost::asio::ip::tcp::socket> (client_context_);
+            socket->connect({boost::asio::ip::make_address("127.0.0.1"), server_.get_local_endpoint().port()});
+
+            std::string request = "GET /events/" + topic + " HTTP/1.1\r\nHost: localhost\r\n" + fields + "\r\n";
+            boost::asio::write(*socket, boost::asio::buffer(request));
+            return socket;
+        }
+
+        /**
+         *  Reads until what is received, the connection is closed or the deadline passed.
+         */
+        std::string readUntil(boost::asio::ip::tcp::socket& socket, std::string const& what)
+        {
+            std::string received;
+            boost::asio::async_read_until(socket, boost::asio::dynamic_buffer(received), what, [](auto, auto){});
+            client_context_.restart();
+            client_context_.run_for(std::chrono::seconds{5});
+            if (!client_context_.stopped())
+            {
+                socket.cancel();
+                client_context_.restart();
+                client_context_.run();
+            }
+            return received;
+        }
+
+        bool waitForSubscribers(std::size_t count)
+        {
+            auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds{5};
+            while (hub_->subscriber_count() != count)
+            {
+                if (std::chrono::steady_clock::now() > deadline)
+                    return false;
+                std::this_thread::sleep_for(std::chrono::milliseconds{1});
+            }
+            return true;
+        }
+
+    protected:
+        managed_io_context <thread_pooler> context_;
+        http_server server_;
+        std::unique_ptr <sse_hub> hub_;
+        boost::asio::io_context client_context_;
+    };
+
+    TEST(SseFormatTests, EveryLineOfDataIsAField)
+    {
+        EXPECT_EQ(sse_hub::format({"a\nb\r\nc", "7", "tick"}), "id: 7\nevent: tick\ndata: a\ndata: b\ndata: c\n\n");
+        EXPECT_EQ(sse_hub::format({"plain"}), "data: plain\n\n");
+    }
+
+    TEST_F(SseHubTests, EventIsSentToAllSubscribersOfTheTopic)
+    {
+        setupHub();
+        auto first = subscribe("news");
+        auto second = subscribe("news");
+        auto other = subscribe("weather");
+        ASSERT_TRUE(waitForSubscribers(3));
+
+        EXPECT_EQ(hub_->publish("news", {"hello"}), 2u);
+
+        // "data: hello\n\n" is 13 bytes, the chunk header is hexadecimal.
+        auto event = std::string{"d\r\ndata: hello\n\n\r\n"};
+        auto received = readUntil(*first, event);
+        EXPECT_NE(received.find("Content-Type: text/event-stream"), std::string::npos);
+        EXPECT_NE(received.find(event), std::string::npos);
+        EXPECT_NE(readUntil(*second, event).find(event), std::string::npos);
+    }
+
+    TEST_F(SseHubTests, ReconnectReplaysMissedEvents)
+    {
+        setupHub();
+        for (int i = 1; i <= 3; ++i)
+            EXPECT_EQ(hub_->publish("news", {"event " + std::to_string(i), std::to_string(i)}), 0u);
+
+        auto socket = subscribe("news", "Last-Event-ID: 1\r\n");
+        auto received = readUntil(*socket, "data: event 3");
+        EXPECT_EQ(received.find("data: event 1"), std::string::npos);
+        auto second = received.find("data: event 2");
+        ASSERT_NE(second, std::string::npos);
+        EXPECT_LT(second, received.find("data: event 3"));
+    }
+
+    TEST_F(SseHubTests, IdleSubscribersReceiveHeartbeats)
+    {
+        setupHub({.heartbeat_interval = std::chrono::milliseconds{20}});
+        auto socket = subscribe("news");
+
+        EXPECT_NE(readUntil(*socket, "3\r\n:\n\n\r\n").find("3\r\n:\n\n\r\n"), std::string::npos);
+    }
+
+    TEST_F(SseHubTests, SlowSubscriberIsDisconnected)
+    {
+        setupHub({.queue_limit = 4, .overflow = sse_overflow::disconnect});
+        boost::asio::ip::tcp::socket socket{client_context_};
+        socket.open(boost::asio::ip::tcp::v4());
+        // a small receive window keeps the amount that must be published before the queue fills small.
+        socket.set_option(boost::asio::socket_base::receive_buffer_size{4096});
+        socket.connect({boost::asio::ip::make_address("127.0.0.1"), server_.get_local_endpoint().port()});
+        boost::asio::write(socket, boost::asio::buffer(std::string{"GET /events/news HTTP/1.1\r\nHost: localhost\r\n\r\n"}));
+        ASSERT_TRUE(waitForSubscribers(1));
+
+        // the client does not read, so the socket buffers fill up and then the queue.
+        std::string large(64 * 1024, 'x');
+        for (int i = 0; i != 256 && hub_->subscriber_count() != 0; ++i)
+        {
+            hub_->publish("news", {large});
+            std::this_thread::sleep_for(std::chrono::milliseconds{1});
+        }
+
+        EXPECT_TRUE(waitForSubscribers(0));
+    }
+
+    TEST_F(SseHubTests, ClosedClientIsRemovedWithoutHeartbeats)
+    {
+        setupHub({.heartbeat_interval = std::chrono::milliseconds{0}});
+        auto socket = subscribe("news");
+        ASSERT_TRUE(waitForSubscribers(1));
+        readUntil(*socket, "text/event-stream");
+
+        socket->close();
+        EXPECT_TRUE(waitForSubscribers(0));
+        EXPECT_EQ(hub_->publish("news", {"late"}), 0u);
+    }
+
+    TEST_F(SseHubTests, CloseTerminatesStreams)
+    {
+        setupHub();
+        auto socket = subscribe("news");
+        ASSERT_TRUE(waitForSubscribers(1));
+
+        hub_->close();
+        EXPECT_NE(readUntil(*socket, "\r\n0\r\n\r\n").find("\r\n0\r\n\r\n"), std::string::npos);
+        EXPECT_EQ(hub_->publish("news", {"late"}), 0u);
+    }
+}
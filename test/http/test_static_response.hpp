@@ -0,0 +1,161 @@
+#pragma once
+
+#include <attender/http/http_server.hpp>
+#include <attender/http/response.hpp>
+#include <attender/http/static_response.hpp>
+#include <attender/io_context/managed_io_context.hpp>
+#include <attender/io_context/thread_pooler.hpp>
+
+#include <boost/asio.hpp>
+
+#include <gtest/gtest.h>
+
+#include <memory>
+#include <string>
+
+namespace attender::tests
+{
+    TEST(StaticResponseTests, SerializesWithoutDate)
+    {
+        static_response response{200, "pong"};
+
+        EXPECT_EQ(response.get_code(), 200);
+        EXPECT_EQ(response.get_status_line(), "HTTP/1.1 200 Ok\r\n");
+        EXPECT_EQ(response.get_remainder(), "Content-Type: text/plain\r\nContent-Length: 4\r\n\r\npong");
+        EXPECT_EQ(response.get_body(), "pong");
+    }
+
+    TEST(StaticResponseTests, TakesFieldsFromHeader)
+    {
+        response_header header;
+        header.set_code(404);
+        header.set_field("Date", "Sun, 06 Nov 1994 08:49:37 GMT");
+        header.set_field("Content-Length", "1000");
+        header.set_field("Cache-Control", "max-age=60");
+
+        static_response response{header, ""};
+
+        EXPECT_EQ(response.get_status_line(), "HTTP/1.1 404 Not Found\r\n");
+        EXPECT_EQ(response.get_remainder(), "Content-Length: 0\r\nCache-Control: max-age=60\r\n\r\n");
+    }
+
+    TEST(StaticResponseTests, CopiesShareTheBuffer)
+    {
+        static_response response{200, std::string(1000, 'x'), "application/octet-stream"};
+        auto copy = response;
+
+        EXPECT_EQ(copy.get_buffer().get(), response.get_buffer().get());
+        EXPECT_EQ(copy.get_body().data(), response.get_body().data());
+    }
+
+    TEST(StaticResponseTests, FindsSerializedFields)
+    {
+        static_response response{200, "Content-Length: 3", "text/plain"};
+
+        EXPECT_TRUE(response.has_field("content-type"));
+        EXPECT_TRUE(response.has_field("Content-Length"));
+        EXPECT_FALSE(response.has_field("Content"));
+        EXPECT_FALSE(response.has_field("Date"));
+    }
+
+    class HeaderSentBeforeTests : public ::testing::Test
+    {
+    protected:
+        HeaderSentBeforeTests()
+            : context_{}
+            , server_{context_.get_io_context(), [](auto*, auto const&, auto const&){}}
+        {
+        }
+
+        ~HeaderSentBeforeTests()
+        {
+            context_.teardown();
+        }
+
+        /**
+         *  Requests the path and reads until the server closes the connection.
+         */
+        std::string get(std::string const& path)
+        {
+            server_.start("0", "127.0.0.1");
+
+            boost::asio::io_context context;
+            boost::asio::ip::tcp::socket socket{context};
+            socket.connect({boost::asio::ip::make_address("127.0.0.1"), server_.get_local_endpoint().port()});
+            std::string request = "GET " + path + " HTTP/1.1\r\nHost: localhost\r\n\r\n";
+            boost::asio::write(socket, boost::asio::buffer(request));
+
+            std::string received;
+            boost::system::error_code ec;
+            boost::asio::read(socket, boost::asio::dynamic_buffer(received), ec);
+            return received;
+        }
+
+    protected:
+        managed_io_context <thread_pooler> context_;
+        http_server server_;
+    };
+
+    TEST_F(HeaderSentBeforeTests, StaticResponseSendsBodyOnly)
+    {
+        server_.get("/static", [](auto, auto res) {
+            res->status(200).send_header([res](auto, auto) {
+                res->send(static_response{404, "pong"});
+            });
+        });
+
+        auto received = get("/static");
+        EXPECT_EQ(received.find("HTTP/1.1 200 Ok\r\n"), 0u);
+        EXPECT_EQ(received.find("404"), std::string::npos);
+        EXPECT_EQ(received.substr(received.size() - 8), "\r\n\r\npong");
+    }
+
+    TEST_F(HeaderSentBeforeTests, SharedBufferSendsBodyOnly)
+    {
+        server_.get("/shared", [](auto, auto res) {
+            res->status(200).send_header([res](auto, auto) {
+                res->send(std::make_shared <std::string const> ("pong"));
+            });
+        });
+
+        auto received = get("/shared");
+        EXPECT_EQ(received.find("HTTP/1.1 200 Ok\r\n"), 0u);
+        EXPECT_EQ(received.substr(received.size() - 8), "\r\n\r\npong");
+    }
+
+    using StaticResponseSendTests = HeaderSentBeforeTests;
+
+    TEST_F(StaticResponseSendTests, HandlerFieldsAreNotDuplicated)
+    {
+        server_.get("/static", [](auto, auto res) {
+            res->set("Content-Type", "text/html");
+            res->set("Content-Length", "100");
+            res->set("X-Request", "1");
+            res->send(static_response{200, "pong"});
+        });
+
+        auto received = get("/static");
+        auto fields = received.substr(0, received.find("\r\n\r\n"));
+        EXPECT_EQ(fields.find("Content-Type"), fields.rfind("Content-Type"));
+        EXPECT_EQ(fields.find("Content-Length"), fields.rfind("Content-Length"));
+        EXPECT_NE(fields.find("Content-Type: text/plain\r\n"), std::string::npos);
+        EXPECT_NE(fields.find("Content-Length: 4"), std::string::npos);
+        EXPECT_NE(fields.find("X-Request: 1\r\n"), std::string::npos);
+        EXPECT_EQ(received.substr(received.size() - 8), "\r\n\r\npong");
+    }
+
+    using ResponseFieldTests = HeaderSentBeforeTests;
+
+    TEST_F(ResponseFieldTests, LinksAreSentAsLinkField)
+    {
+        server_.get("/links", [](auto, auto res) {
+            res->links({{"next", "/page/2"}, {"prev", "/page/0"}});
+            res->send("pong");
+        });
+
+        auto received = get("/links");
+        auto fields = received.substr(0, received.find("\r\n\r\n") + 2);
+        EXPECT_NE(fields.find("\r\nLink: </page/2>; rel=\"next\", </page/0>; rel=\"prev\"\r\n"), std::string::npos);
+        EXPECT_EQ(fields.find("Links:"), std::string::npos);
+    }
+}
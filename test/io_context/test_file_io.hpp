@@ -0,0 +1,242 @@
+#pragma once
+
+#include <attender/http/http_server.hpp>
+#include <attender/io_context/blocking_file_io.hpp>
+#include <attender/io_context/file_io.hpp>
+#include <attender/io_context/managed_io_context.hpp>
+#include <attender/io_context/thread_pooler.hpp>
+
+#include <boost/asio.hpp>
+#include <boost/filesystem.hpp>
+
+#include <gtest/gtest.h>
+
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <vector>
+
+namespace attender::tests
+{
+    class FileIoTests : public ::testing::Test
+    {
+    protected:
+        FileIoTests()
+            : directory_{boost::filesystem::temp_directory_path() / boost::filesystem::unique_path("attender-%%%%-%%%%-%%%%")}
+        {
+            boost::filesystem::create_directories(directory_);
+        }
+
+        ~FileIoTests()
+        {
+            boost::system::error_code ec;
+            boost::filesystem::remove_all(directory_, ec);
+        }
+
+        std::string pathOf(std::string const& name) const
+        {
+            return (directory_ / name).string();
+        }
+
+        std::string contentsOf(std::string const& name) const
+        {
+            std::ifstream reader(pathOf(name), std::ios_base::binary);
+            return {std::istreambuf_iterator <char> {reader}, std::istreambuf_iterator <char> {}};
+        }
+
+    protected:
+        boost::filesystem::path directory_;
+    };
+
+    TEST_F(FileIoTests, AsyncFileReadsAndWritesAtOffsets)
+    {
+        async_file file;
+        EXPECT_FALSE(file.open(pathOf("missing"), async_file::mode::read));
+        EXPECT_FALSE(file.open(directory_.string(), async_file::mode::read));
+
+        ASSERT_TRUE(file.open(pathOf("data"), async_file::mode::write));
+        boost::system::error_code ec;
+        EXPECT_EQ(file.write_at(4, "5678", 4, ec), 4u);
+        EXPECT_EQ(file.write_at(0, "1234", 4, ec), 4u);
+        EXPECT_FALSE(ec);
+        EXPECT_EQ(file.size(), 8u);
+        file.close();
+
+        ASSERT_TRUE(file.open(pathOf("data"), async_file::mode::read));
+        char buffer[16];
+        EXPECT_EQ(file.read_at(2, buffer, 4, ec), 4u);
+        EXPECT_EQ(std::string(buffer, 4), "3456");
+
+        // reads end at the end of the file.
+        EXPECT_EQ(file.read_at(6, buffer, sizeof(buffer), ec), 2u);
+        EXPECT_EQ(std::string(buffer, 2), "78");
+        EXPECT_FALSE(ec);
+    }
+
+    TEST_F(FileIoTests, BlockingFileIoCompletesOnTheContext)
+    {
+        asio::io_context context;
+        blocking_file_io io{&context, {.queue_depth = 4, .threads = 2}};
+        EXPECT_STREQ(io.backend(), "threads");
+
+        async_file file;
+        ASSERT_TRUE(file.open(pathOf("data"), async_file::mode::write));
+
+        // the handlers are posted from the threads of io, the context must not run out of work before.
+        auto writing = asio::make_work_guard(context);
+        std::string const data(100'000, 'x');
+        std::size_t written = 0;
+        io.async_write(file, 0, data.data(), data.size(), [&](boost::system::error_code ec, std::size_t amount) {
+            EXPECT_FALSE(ec);
+            written = amount;
+            writing.reset();
+        });
+        context.run();
+        EXPECT_EQ(written, data.size());
+        file.close();
+
+        ASSERT_TRUE(file.open(pathOf("data"), async_file::mode::read));
+        std::vector <char> buffer(data.size() + 10);
+        std::size_t read = 0;
+        auto reading = asio::make_work_guard(context);
+        io.async_read(file, 0, buffer.data(), buffer.size(), [&](boost::system::error_code ec, std::size_t amount) {
+            EXPECT_FALSE(ec);
+            read = amount;
+            reading.reset();
+        });
+        context.restart();
+        context.run();
+        EXPECT_EQ(read, data.size());
+        EXPECT_EQ(std::string(buffer.data(), read), data);
+    }
+
+    TEST_F(FileIoTests, BlockingFileIoCallsEveryHandlerOnDestruction)
+    {
+        asio::io_context context;
+        async_file file;
+        ASSERT_TRUE(file.open(pathOf("data"), async_file::mode::write));
+
+        std::string const data(4096, 'x');
+        int completed = 0;
+        int aborted = 0;
+        {
+            blocking_file_io io{&context, {.queue_depth = 1, .threads = 4}};
+            for (int i = 0; i != 100; ++i)
+            {
+                io.async_write(file, i * data.size(), data.data(), data.size(), [&](boost::system::error_code ec, std::size_t) {
+                    ++completed;
+                    if (ec == asio::error::operation_aborted)
+                        ++aborted;
+                });
+            }
+        }
+        context.run();
+
+        EXPECT_EQ(completed, 100);
+        EXPECT_EQ(file.size(), (100 - aborted) * data.size());
+    }
+
+    TEST_F(FileIoTests, BlockingFileIoOpensOnItsThreads)
+    {
+        std::ofstream{pathOf("present.txt"), std::ios_base::binary} << "0123456789";
+
+        asio::io_context context;
+        blocking_file_io io{&context, {.queue_depth = 4, .threads = 2}};
+        auto opening = asio::make_work_guard(context);
+
+        async_file present;
+        async_file missing;
+        async_file directory;
+        std::vector <std::pair <boost::system::error_code, std::size_t>> results(3);
+        int completed = 0;
+        auto opened = [&](std::size_t index) {
+            return [&, index](boost::system::error_code ec, std::size_t size) {
+                results[index] = {ec, size};
+                if (++completed == 3)
+                    opening.reset();
+            };
+        };
+        io.async_open(present, pathOf("present.txt"), async_file::mode::read, opened(0));
+        io.async_open(missing, pathOf("missing.txt"), async_file::mode::read, opened(1));
+        io.async_open(directory, directory_.string(), async_file::mode::read, opened(2));
+        context.run();
+
+        EXPECT_FALSE(results[0].first);
+        EXPECT_EQ(results[0].second, 10u);
+        EXPECT_TRUE(present.is_open());
+        EXPECT_TRUE(results[1].first);
+        EXPECT_FALSE(missing.is_open());
+        EXPECT_TRUE(results[2].first);
+        EXPECT_FALSE(directory.is_open());
+    }
+
+    class FileMountTests : public FileIoTests
+    {
+    protected:
+        FileMountTests()
+            : context_{}
+            , server_{context_.get_io_context(), [](auto*, auto const&, auto const&){}}
+        {
+            server_.mount(directory_.string(), "/files", [](auto, auto, auto) { return true; },
+                          {mount_options::GET, mount_options::HEAD, mount_options::PUT});
+            server_.start("0", "127.0.0.1");
+        }
+
+        ~FileMountTests()
+        {
+            context_.teardown();
+        }
+
+        std::string request(std::string const& head, std::string const& body = {})
+        {
+            boost::asio::io_context context;
+            boost::asio::ip::tcp::socket socket{context};
+            socket.connect({boost::asio::ip::make_address("127.0.0.1"), server_.get_local_endpoint().port()});
+            boost::asio::write(socket, boost::asio::buffer(head + "Host: localhost\r\nConnection: close\r\n\r\n" + body));
+
+            std::string received;
+            boost::system::error_code ec;
+            boost::asio::read(socket, boost::asio::dynamic_buffer(received), ec);
+            return received;
+        }
+
+    protected:
+        managed_io_context <thread_pooler> context_;
+        http_server server_;
+    };
+
+    TEST_F(FileMountTests, PutWritesBodyThroughFileSink)
+    {
+        std::string body;
+        for (int i = 0; body.size() < 3 * config::file_io_block_size; ++i)
+            body += std::to_string(i) + ",";
+
+        auto response = request("PUT /files/upload.txt HTTP/1.1\r\nContent-Length: " + std::to_string(body.size()) + "\r\n", body);
+        EXPECT_EQ(response.find("HTTP/1.1 204"), 0u);
+        EXPECT_EQ(contentsOf("upload.txt"), body);
+    }
+
+    TEST_F(FileMountTests, GetSendsTheFileOrNotFound)
+    {
+        std::ofstream{pathOf("present.txt"), std::ios_base::binary} << "0123456789";
+
+        auto response = request("GET /files/present.txt HTTP/1.1\r\n");
+        EXPECT_EQ(response.find("HTTP/1.1 200"), 0u);
+        EXPECT_NE(response.find("Content-Length: 10\r\n"), std::string::npos);
+        EXPECT_NE(response.find("\r\n\r\n0123456789"), std::string::npos);
+
+        EXPECT_EQ(request("GET /files/absent.txt HTTP/1.1\r\n").find("HTTP/1.1 404"), 0u);
+    }
+
+    TEST_F(FileMountTests, HeadReportsSizeWithoutBody)
+    {
+        std::ofstream{pathOf("present.txt"), std::ios_base::binary} << "0123456789";
+
+        auto response = request("HEAD /files/present.txt HTTP/1.1\r\n");
+        EXPECT_EQ(response.find("HTTP/1.1 200"), 0u);
+        EXPECT_NE(response.find("Content-Length: 10\r\n"), std::string::npos);
+        EXPECT_EQ(response.find("0123456789"), std::string::npos);
+
+        EXPECT_EQ(request("HEAD /files/absent.txt HTTP/1.1\r\n").find("HTTP/1.1 404"), 0u);
+    }
+}
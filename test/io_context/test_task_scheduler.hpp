@@ -0,0 +1,144 @@
+#pragma once
+
+#include <attender/io_context/task_scheduler.hpp>
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <chrono>
+#include <future>
+#include <memory>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+namespace attender::tests
+{
+    TEST(WorkStealingDequeTests, OwnerPopsLifoThievesStealFifo)
+    {
+        work_stealing_deque <int> deque{2};
+        for (int i = 0; i != 5; ++i)
+            deque.push(i);
+
+        EXPECT_EQ(deque.size(), 5u);
+        EXPECT_EQ(deque.pop().value(), 4);
+        EXPECT_EQ(deque.steal().value(), 0);
+        EXPECT_EQ(deque.pop().value(), 3);
+        EXPECT_EQ(deque.steal().value(), 1);
+        EXPECT_EQ(deque.pop().value(), 2);
+        EXPECT_FALSE(deque.pop());
+        EXPECT_FALSE(deque.steal());
+    }
+
+    TEST(WorkStealingDequeTests, EveryElementIsTakenOnce)
+    {
+        constexpr int count = 100'000;
+        work_stealing_deque <int> deque;
+        std::vector <std::atomic_int> taken(count);
+        std::atomic_bool done{false};
+
+        std::vector <std::thread> thieves;
+        for (int t = 0; t != 3; ++t)
+        {
+            thieves.emplace_back([&]{
+                while (!done.load() || !deque.empty())
+                    if (auto value = deque.steal())
+                        ++taken[*value];
+            });
+        }
+
+        for (int i = 0; i != count; ++i)
+        {
+            deque.push(i);
+            if (i % 3 == 0)
+                if (auto value = deque.pop())
+                    ++taken[*value];
+        }
+        while (auto value = deque.pop())
+            ++taken[*value];
+        done.store(true);
+
+        for (auto& thief : thieves)
+            thief.join();
+
+        for (auto const& t : taken)
+            ASSERT_EQ(t.load(), 1);
+    }
+
+    namespace
+    {
+        long fibonacci(task_scheduler& scheduler, int n)
+        {
+            if (n < 12)
+                return n < 2 ? n : fibonacci(scheduler, n - 1) + fibonacci(scheduler, n - 2);
+
+            long left = 0;
+            task_group group{scheduler};
+            group.run([&]{ left = fibonacci(scheduler, n - 1); });
+            long right = fibonacci(scheduler, n - 2);
+            group.wait();
+            return left + right;
+        }
+    }
+
+    TEST(TaskSchedulerTests, ForkJoinFromWithinTasks)
+    {
+        task_scheduler scheduler{{.threads = 4}};
+        long result = 0;
+        task_group group{scheduler};
+        group.run([&]{ result = fibonacci(scheduler, 25); });
+        group.wait();
+        EXPECT_EQ(result, 75025);
+    }
+
+    TEST(TaskSchedulerTests, GroupRethrowsTaskException)
+    {
+        task_scheduler scheduler{{.threads = 2}};
+        std::atomic_int ran{0};
+        task_group group{scheduler};
+        for (int i = 0; i != 10; ++i)
+            group.run([&ran, i]{
+                ++ran;
+                if (i == 5)
+                    throw std::runtime_error("task failed");
+            });
+        EXPECT_THROW(group.wait(), std::runtime_error);
+        EXPECT_EQ(ran.load(), 10);
+    }
+
+    TEST(TaskSchedulerTests, CurrentIsSetOnWorkers)
+    {
+        task_scheduler scheduler{{.threads = 1}};
+        std::promise <task_scheduler*> seen;
+        scheduler.submit([&seen]{ seen.set_value(task_scheduler::current()); });
+        EXPECT_EQ(seen.get_future().get(), &scheduler);
+        EXPECT_EQ(task_scheduler::current(), nullptr);
+    }
+
+    TEST(TaskSchedulerTests, DestroyedSchedulerCancelsWaitingGroups)
+    {
+        auto scheduler = std::make_unique <task_scheduler> (task_scheduler_options{.threads = 1});
+        std::promise <void> release;
+        std::promise <void> started;
+        scheduler->submit([&started, released = release.get_future().share()]{
+            started.set_value();
+            released.wait();
+        });
+        started.get_future().wait();
+
+        // queued behind the blocking task on the only worker.
+        std::atomic_int ran{0};
+        task_group group{*scheduler};
+        for (int i = 0; i != 3; ++i)
+            group.run([&ran]{ ++ran; });
+
+        std::thread destroyer{[&scheduler]{ scheduler.reset(); }};
+        // lets the destructor stop the worker before the blocking task returns.
+        std::this_thread::sleep_for(std::chrono::milliseconds{50});
+        release.set_value();
+        destroyer.join();
+
+        EXPECT_THROW(group.wait(), task_cancelled);
+        EXPECT_EQ(ran.load(), 0);
+    }
+}
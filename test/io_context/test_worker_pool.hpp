@@ -0,0 +1,53 @@
+#pragma once
+
+#include <attender/io_context/worker_pool.hpp>
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <future>
+
+namespace attender::tests
+{
+    TEST(WorkerPoolTests, RunsPostedJobs)
+    {
+        std::atomic_int counter{0};
+        std::promise <void> all_done;
+        {
+            worker_pool pool{{.threads = 2, .queue_limit = 100}};
+            for (int i = 0; i != 100; ++i)
+            {
+                ASSERT_TRUE(pool.post([&counter, &all_done]{
+                    if (++counter == 100)
+                        all_done.set_value();
+                }));
+            }
+            all_done.get_future().wait();
+        }
+        EXPECT_EQ(counter.load(), 100);
+    }
+
+    TEST(WorkerPoolTests, RejectsWhenQueueIsFull)
+    {
+        std::promise <void> release;
+        auto released = release.get_future().share();
+        std::promise <void> started;
+
+        worker_pool pool{{.threads = 1, .queue_limit = 1}};
+        ASSERT_TRUE(pool.post([&started, released]{
+            started.set_value();
+            released.wait();
+        }));
+        started.get_future().wait();
+
+        EXPECT_TRUE(pool.post([]{}));
+        EXPECT_FALSE(pool.post([]{}));
+
+        auto statistics = pool.get_statistics();
+        EXPECT_EQ(statistics.active, 1u);
+        EXPECT_EQ(statistics.queued, 1u);
+        EXPECT_EQ(statistics.rejected, 1u);
+
+        release.set_value();
+    }
+}
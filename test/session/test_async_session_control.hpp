@@ -0,0 +1,322 @@
+#pragma once
+
+#include <attender/http/http_server.hpp>
+#include <attender/http/request.hpp>
+#include <attender/http/response.hpp>
+#include <attender/io_context/managed_io_context.hpp>
+#include <attender/io_context/thread_pooler.hpp>
+#include <attender/session/async_authorizer_interface.hpp>
+#include <attender/session/async_session_storage_interface.hpp>
+#include <attender/session/memory_session_storage.hpp>
+#include <attender/session/uuid_session_cookie_generator.hpp>
+
+#include <boost/asio.hpp>
+
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace attender::tests
+{
+    /**
+     *  Completes every call on a thread of its own, a little later, like a storage behind the network.
+     */
+    class deferred_session_storage : public async_session_storage_interface
+    {
+    public:
+        void async_lookup_session(std::string const& id, session* session, lookup_callback on_complete) override
+        {
+            defer([this, id, session, on_complete]{
+                on_complete({}, storage_.lookup_session(id, session));
+            });
+        }
+        void async_create_session(create_callback on_complete) override
+        {
+            defer([this, on_complete]{
+                on_complete({}, storage_.create_session());
+            });
+        }
+        void async_set_session(std::string const& id, session const& session, set_callback on_complete) override
+        {
+            auto stored = storage_.set_session(id, session);
+            defer([stored, on_complete]{
+                if (on_complete)
+                    on_complete({}, stored);
+            });
+        }
+        void async_delete_session(std::string const& id, completion_callback on_complete) override
+        {
+            storage_.delete_session(id);
+            defer([on_complete]{
+                if (on_complete)
+                    on_complete({});
+            });
+        }
+
+    private:
+        template <typename FunctionT>
+        void defer(FunctionT function)
+        {
+            std::lock_guard <std::mutex> guard{protect_};
+            threads_.emplace_back([function]{
+                std::this_thread::sleep_for(std::chrono::milliseconds{10});
+                function();
+            });
+        }
+
+    private:
+        memory_session_storage <uuid_generator, session> storage_;
+        std::mutex protect_;
+
+        // last, joined before the storage goes away.
+        std::vector <std::jthread> threads_;
+    };
+
+    /**
+     *  Allows requests with "Authorization: yes", on a thread of its own.
+     */
+    class deferred_authorizer : public async_authorizer_interface
+    {
+    public:
+        ~deferred_authorizer()
+        {
+            for (auto& thread : threads_)
+                thread.join();
+        }
+
+        std::string realm() const override
+        {
+            return "test";
+        }
+        void negotiate_authorization_method(request_handler*, response_handler* res) override
+        {
+            res->send_status(401);
+        }
+        void async_perform_authorization(request_handler* req, response_handler*, authorization_callback on_complete) override
+        {
+            auto allowed = req->get_header_field("Authorization") == std::string{"yes"};
+            std::lock_guard <std::mutex> guard{protect_};
+            threads_.emplace_back([allowed, on_complete]{
+                std::this_thread::sleep_for(std::chrono::milliseconds{10});
+                on_complete(allowed ? authorization_result::allowed_continue : authorization_result::denied);
+            });
+        }
+
+    private:
+        std::mutex protect_;
+        std::vector <std::thread> threads_;
+    };
+
+    /**
+     *  Cannot reach its backend when a session is created.
+     */
+    class unreachable_session_storage : public deferred_session_storage
+    {
+    public:
+        void async_create_session(create_callback on_complete) override
+        {
+            on_complete(make_error_code(boost::system::errc::host_unreachable), {});
+        }
+    };
+
+    /**
+     *  Allows requests with "Authorization: yes".
+     */
+    class header_authorizer : public authorizer_interface
+    {
+    public:
+        std::string realm() const override
+        {
+            return "test";
+        }
+        void negotiate_authorization_method(request_handler*, response_handler* res) override
+        {
+            res->send_status(401);
+        }
+        authorization_result try_perform_authorization(request_handler* req, response_handler*) override
+        {
+            if (req->get_header_field("Authorization") == std::string{"yes"})
+                return authorization_result::allowed_continue;
+            return authorization_result::denied;
+        }
+    };
+
+    class AsyncSessionControlTests : public ::testing::Test
+    {
+    protected:
+        AsyncSessionControlTests()
+            : context_{}
+            , server_{context_.get_io_context(), [](auto*, auto const&, auto const&){}}
+        {
+        }
+
+        ~AsyncSessionControlTests()
+        {
+            context_.teardown();
+        }
+
+        void start()
+        {
+            server_.get("/private", [](auto, auto res) {
+                res->send("secret");
+            });
+            server_.start("0", "127.0.0.1");
+        }
+
+        void installAsync(std::unique_ptr <async_session_storage_interface> storage, bool automatic = true)
+        {
+            std::unique_ptr <session_storage_interface> no_storage;
+            std::unique_ptr <authorizer_interface> no_authorizer;
+            server_.install_session_control({
+                .session_storage = std::move(no_storage),
+                .authorizer = std::move(no_authorizer),
+                .id_cookie_key = "SID",
+                .disable_automatic_authentication = !automatic,
+                .authentication_path = "/login",
+                .async_session_storage = std::move(storage),
+                .async_authorizer = std::make_unique <deferred_authorizer> ()
+            });
+        }
+
+        /**
+         *  Sends a request and reads the response, the connection is closed by the server.
+         */
+        std::string request(std::string const& fields)
+        {
+            boost::asio::ip::tcp::socket socket{client_context_};
+            socket.connect({boost::asio::ip::make_address("127.0.0.1"), server_.get_local_endpoint().port()});
+
+            std::string request = "GET /private HTTP/1.1\r\nHost: localhost\r\nConnection: close\r\n" + fields + "\r\n";
+            boost::asio::write(socket, boost::asio::buffer(request));
+
+            std::string received;
+            char buffer[4096];
+            for (;;)
+            {
+                boost::system::error_code ec;
+                auto size = socket.read_some(boost::asio::buffer(buffer), ec);
+                if (ec)
+                    break;
+                received.append(buffer, size);
+            }
+            return received;
+        }
+
+        static std::string sessionCookieOf(std::string const& response)
+        {
+            auto begin = response.find("SID=");
+            if (begin == std::string::npos)
+                return {};
+            return response.substr(begin, response.find(';', begin) - begin);
+        }
+
+    protected:
+        managed_io_context <thread_pooler> context_;
+        http_server server_;
+        boost::asio::io_context client_context_;
+    };
+
+    TEST_F(AsyncSessionControlTests, RequestsWaitForAsynchronousStorageAndAuthorizer)
+    {
+        installAsync(std::make_unique <deferred_session_storage> ());
+        start();
+
+        EXPECT_NE(request("").find("401"), std::string::npos);
+
+        auto authorized = request("Authorization: yes\r\n");
+        EXPECT_NE(authorized.find("200 Ok"), std::string::npos);
+        EXPECT_NE(authorized.find("secret"), std::string::npos);
+        auto cookie = sessionCookieOf(authorized);
+        ASSERT_FALSE(cookie.empty());
+
+        auto resumed = request("Cookie: " + cookie + "\r\n");
+        EXPECT_NE(resumed.find("secret"), std::string::npos);
+        EXPECT_TRUE(sessionCookieOf(resumed).empty());
+    }
+
+    TEST_F(AsyncSessionControlTests, UnreachableStorageRespondsOnce)
+    {
+        installAsync(std::make_unique <unreachable_session_storage> ());
+        start();
+
+        auto response = request("Authorization: yes\r\n");
+        EXPECT_EQ(response.find("HTTP/1.1 503"), 0u);
+        EXPECT_EQ(response.find("HTTP/1.1", 1), std::string::npos);
+        EXPECT_EQ(response.find("secret"), std::string::npos);
+    }
+
+    TEST_F(AsyncSessionControlTests, SynchronousAuthenticationRefusesAsynchronousBackends)
+    {
+        installAsync(std::make_unique <deferred_session_storage> (), false);
+        server_.get("/login", [this](auto req, auto res) {
+            try
+            {
+                server_.authenticate_session(req, res);
+                res->send("authenticated");
+            }
+            catch (std::logic_error const&)
+            {
+                res->send("refused");
+            }
+        });
+        start();
+
+        std::string request = "GET /login HTTP/1.1\r\nHost: localhost\r\nConnection: close\r\nAuthorization: yes\r\n\r\n";
+        boost::asio::ip::tcp::socket socket{client_context_};
+        socket.connect({boost::asio::ip::make_address("127.0.0.1"), server_.get_local_endpoint().port()});
+        boost::asio::write(socket, boost::asio::buffer(request));
+        std::string received;
+        boost::system::error_code ec;
+        boost::asio::read(socket, boost::asio::dynamic_buffer(received), ec);
+
+        EXPECT_NE(received.find("refused"), std::string::npos);
+        EXPECT_EQ(received.find("HTTP/1.1", 1), std::string::npos);
+    }
+
+    TEST_F(AsyncSessionControlTests, SynchronousStorageAndAuthorizerAreAdapted)
+    {
+        std::unique_ptr <session_storage_interface> storage = std::make_unique <memory_session_storage <uuid_generator, session>> ();
+        std::unique_ptr <authorizer_interface> authorizer = std::make_unique <header_authorizer> ();
+        server_.install_session_control({
+            .session_storage = std::move(storage),
+            .authorizer = std::move(authorizer),
+            .id_cookie_key = "SID"
+        });
+        start();
+
+        EXPECT_NE(request("").find("401"), std::string::npos);
+
+        auto cookie = sessionCookieOf(request("Authorization: yes\r\n"));
+        ASSERT_FALSE(cookie.empty());
+        EXPECT_NE(request("Cookie: " + cookie + "\r\n").find("secret"), std::string::npos);
+
+        using storage_type = memory_session_storage <uuid_generator, session>;
+        EXPECT_EQ(server_.get_session_manager()->get_storage <storage_type> ()->size(), 1);
+    }
+
+    TEST(SessionManagerTests, SynchronousFunctionsNeedSynchronousStorage)
+    {
+        session_manager sessions{std::unique_ptr <async_session_storage_interface> {std::make_unique <deferred_session_storage> ()}};
+        EXPECT_THROW(sessions.make_session(), std::logic_error);
+
+        std::string id;
+        std::mutex protect;
+        std::condition_variable created;
+        sessions.async_make_session([&](boost::system::error_code ec, std::string const& made) {
+            std::lock_guard <std::mutex> guard{protect};
+            EXPECT_FALSE(ec);
+            id = made;
+            created.notify_one();
+        });
+
+        std::unique_lock <std::mutex> lock{protect};
+        ASSERT_TRUE(created.wait_for(lock, std::chrono::seconds{5}, [&]{ return !id.empty(); }));
+        EXPECT_NE(sessions.get_storage <deferred_session_storage> (), nullptr);
+    }
+}
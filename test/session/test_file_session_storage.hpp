@@ -0,0 +1,290 @@
+#pragma once
+
+#include <attender/session/file_session_storage.hpp>
+#include <attender/session/uuid_session_cookie_generator.hpp>
+
+#include <boost/filesystem.hpp>
+
+#include <gtest/gtest.h>
+
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include <fstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace attender::tests
+{
+    class stored_session : public session, public session_data
+    {
+    public:
+        using session::session;
+
+        std::string serialize() override
+        {
+            return user;
+        }
+        void deserialize(std::string const& data) override
+        {
+            user = data;
+        }
+
+        std::string user;
+    };
+
+    using file_storage = file_session_storage <uuid_generator, stored_session>;
+
+    class FileSessionStorageTests : public ::testing::Test
+    {
+    protected:
+        FileSessionStorageTests()
+            : directory_{boost::filesystem::temp_directory_path() / boost::filesystem::unique_path("attender-%%%%-%%%%-%%%%")}
+        {
+        }
+
+        ~FileSessionStorageTests()
+        {
+            boost::system::error_code ec;
+            boost::filesystem::remove_all(directory_, ec);
+        }
+
+        session_log_options options(std::size_t segment_size = 64 * 1024)
+        {
+            return {
+                .directory = directory_.string(),
+                .segment_size = segment_size,
+                .compaction_interval = std::chrono::milliseconds{0}
+            };
+        }
+
+        std::string userOf(file_storage& storage, std::string const& id)
+        {
+            stored_session restored;
+            if (!storage.get_session(id, &restored))
+                return "<none>";
+            return restored.user;
+        }
+
+    protected:
+        boost::filesystem::path directory_;
+    };
+
+    TEST_F(FileSessionStorageTests, SessionsSurviveReopening)
+    {
+        std::string id;
+        {
+            file_storage storage{options()};
+            id = storage.create_session();
+
+            stored_session changed{id};
+            changed.user = "someone";
+            EXPECT_TRUE(storage.set_session(id, changed));
+            EXPECT_FALSE(storage.set_session("unknown", changed));
+        }
+
+        file_storage storage{options()};
+        EXPECT_EQ(storage.size(), 1);
+        EXPECT_EQ(userOf(storage, id), "someone");
+
+        stored_session restored;
+        ASSERT_TRUE(storage.get_session(id, &restored));
+        EXPECT_EQ(restored.id(), id);
+    }
+
+    TEST_F(FileSessionStorageTests, DeletedSessionsStayDeleted)
+    {
+        std::string kept;
+        std::string deleted;
+        {
+            file_storage storage{options()};
+            kept = storage.create_session();
+            deleted = storage.create_session();
+            storage.delete_session(deleted);
+            EXPECT_FALSE(storage.get_session(deleted, nullptr));
+        }
+
+        file_storage storage{options()};
+        EXPECT_EQ(storage.size(), 1);
+        EXPECT_TRUE(storage.get_session(kept, nullptr));
+        EXPECT_FALSE(storage.get_session(deleted, nullptr));
+    }
+
+    TEST_F(FileSessionStorageTests, CompactionRemovesSegmentsAndKeepsLiveSessions)
+    {
+        std::vector <std::string> ids;
+        {
+            file_storage storage{options(4096)};
+            for (int i = 0; i != 100; ++i)
+                ids.push_back(storage.create_session());
+
+            // most sessions are replaced several times and some are deleted, the first segments become garbage.
+            for (int round = 0; round != 5; ++round)
+            {
+                for (std::size_t i = 0; i != ids.size(); ++i)
+                {
+                    stored_session changed{ids[i]};
+                    changed.user = "user " + std::to_string(i) + " round " + std::to_string(round);
+                    storage.set_session(ids[i], changed);
+                }
+            }
+            for (std::size_t i = 0; i < ids.size(); i += 10)
+                storage.delete_session(ids[i]);
+
+            auto before = storage.log().segment_count();
+            EXPECT_GT(storage.compact(), 0);
+            EXPECT_LT(storage.log().segment_count(), before);
+            EXPECT_EQ(storage.size(), 90);
+        }
+
+        file_storage storage{options(4096)};
+        EXPECT_EQ(storage.size(), 90);
+        for (std::size_t i = 0; i != ids.size(); ++i)
+        {
+            if (i % 10 == 0)
+                EXPECT_FALSE(storage.get_session(ids[i], nullptr));
+            else
+                EXPECT_EQ(userOf(storage, ids[i]), "user " + std::to_string(i) + " round 4");
+        }
+    }
+
+    TEST_F(FileSessionStorageTests, CompactionAfterFlushKeepsEveryLiveSession)
+    {
+        std::vector <std::string> ids;
+        {
+            file_storage storage{options(4096)};
+            for (int i = 0; i != 60; ++i)
+                ids.push_back(storage.create_session());
+            for (std::size_t i = 0; i != ids.size(); ++i)
+            {
+                stored_session changed{ids[i]};
+                changed.user = "user " + std::to_string(i);
+                storage.set_session(ids[i], changed);
+            }
+            storage.log().flush();
+
+            // the moved records are written to disk by compaction itself, before the old segments are deleted.
+            EXPECT_GT(storage.compact(), 0);
+        }
+
+        file_storage storage{options(4096)};
+        EXPECT_EQ(storage.size(), ids.size());
+        for (std::size_t i = 0; i != ids.size(); ++i)
+            EXPECT_EQ(userOf(storage, ids[i]), "user " + std::to_string(i));
+    }
+
+    TEST_F(FileSessionStorageTests, DamagedRecordEndsTheScan)
+    {
+        std::string first;
+        std::string second;
+        {
+            file_storage storage{options()};
+            first = storage.create_session();
+            second = storage.create_session();
+        }
+
+        // flips a byte in the id of the second record, as a torn write would.
+        boost::filesystem::path segment;
+        for (auto const& entry : boost::filesystem::directory_iterator{directory_})
+        {
+            if (entry.path().extension() == ".log")
+                segment = entry.path();
+        }
+        {
+            std::fstream file{segment.string(), std::ios::in | std::ios::out | std::ios::binary};
+            auto second_record = 16 + 12 + first.size();
+            file.seekp(static_cast <std::streamoff> (second_record + 12));
+            file.put('#');
+        }
+
+        file_storage storage{options()};
+        EXPECT_TRUE(storage.get_session(first, nullptr));
+        EXPECT_FALSE(storage.get_session(second, nullptr));
+
+        // new records go where the damaged one was.
+        auto third = storage.create_session();
+        EXPECT_TRUE(storage.get_session(third, nullptr));
+    }
+
+    TEST_F(FileSessionStorageTests, TombstonesAreCompactedAway)
+    {
+        std::vector <std::string> ids;
+        {
+            file_storage storage{options(4096)};
+            for (int i = 0; i != 200; ++i)
+                ids.push_back(storage.create_session());
+            for (auto const& id : ids)
+                storage.delete_session(id);
+
+            // the records are compacted first, then nothing needs the tombstones anymore.
+            EXPECT_GT(storage.log().segment_count(), 4);
+            storage.compact();
+            EXPECT_EQ(storage.log().segment_count(), 1);
+
+            // no tombstone was appended again, so there is nothing left to compact.
+            storage.compact();
+            EXPECT_EQ(storage.log().segment_count(), 1);
+        }
+
+        file_storage storage{options(4096)};
+        EXPECT_EQ(storage.size(), 0);
+        for (auto const& id : ids)
+            EXPECT_FALSE(storage.get_session(id, nullptr));
+    }
+
+    TEST_F(FileSessionStorageTests, TombstonesOutliveOlderRecords)
+    {
+        std::string deleted;
+        {
+            // 85 records of 48 bytes fit into a segment.
+            file_storage storage{options(4096)};
+            deleted = storage.create_session();
+            for (int i = 0; i != 84; ++i)
+                storage.create_session();
+
+            std::vector <std::string> doomed;
+            for (int i = 0; i != 85; ++i)
+                doomed.push_back(storage.create_session());
+
+            // the first segment stays, because it is mostly live. The segment of the tombstones is all garbage.
+            storage.delete_session(deleted);
+            for (auto const& id : doomed)
+                storage.delete_session(id);
+            EXPECT_EQ(storage.log().segment_count(), 4);
+
+            storage.compact();
+            EXPECT_EQ(storage.log().segment_count(), 2);
+            EXPECT_FALSE(storage.get_session(deleted, nullptr));
+        }
+
+        file_storage storage{options(4096)};
+        EXPECT_EQ(storage.size(), 84);
+        EXPECT_FALSE(storage.get_session(deleted, nullptr));
+    }
+
+    TEST_F(FileSessionStorageTests, DirectoryIsLockedAgainstOtherProcesses)
+    {
+        file_storage storage{options()};
+
+        auto child = ::fork();
+        ASSERT_NE(child, -1);
+        if (child == 0)
+        {
+            try
+            {
+                file_storage second{options()};
+                ::_exit(0);
+            }
+            catch (std::runtime_error const&)
+            {
+                ::_exit(1);
+            }
+        }
+
+        int status = 0;
+        ASSERT_EQ(::waitpid(child, &status, 0), child);
+        ASSERT_TRUE(WIFEXITED(status));
+        EXPECT_EQ(WEXITSTATUS(status), 1);
+    }
+}
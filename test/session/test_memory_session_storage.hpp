@@ -0,0 +1,191 @@
+#pragma once
+
+#include <attender/session/memory_session_storage.hpp>
+#include <attender/session/uuid_session_cookie_generator.hpp>
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <chrono>
+#include <set>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace attender::tests
+{
+    class counted_session : public session
+    {
+    public:
+        using session::session;
+
+        int visits = 0;
+    };
+
+    using sharded_storage = memory_session_storage <uuid_generator, counted_session>;
+
+    TEST(MemorySessionStorageTests, SnapshotsAreNotChangedBySetSession)
+    {
+        sharded_storage storage{4};
+        auto id = storage.create_session();
+
+        auto before = storage.find_session(id);
+        ASSERT_NE(before, nullptr);
+
+        auto changed = *before;
+        changed.visits = 3;
+        EXPECT_TRUE(storage.set_session(id, changed));
+
+        EXPECT_EQ(before->visits, 0);
+        EXPECT_EQ(storage.find_session(id)->visits, 3);
+
+        counted_session copy;
+        EXPECT_TRUE(storage.get_session(id, &copy));
+        EXPECT_EQ(copy.visits, 3);
+        EXPECT_EQ(copy.id(), id);
+    }
+
+    TEST(MemorySessionStorageTests, UnknownSessionsAreNotFound)
+    {
+        sharded_storage storage;
+        EXPECT_EQ(storage.find_session("nope"), nullptr);
+        EXPECT_FALSE(storage.get_session("nope", nullptr));
+        EXPECT_FALSE(storage.set_session("nope", counted_session{"nope"}));
+
+        auto id = storage.create_session();
+        storage.delete_session(id);
+        EXPECT_FALSE(storage.get_session(id, nullptr));
+    }
+
+    TEST(MemorySessionStorageTests, SessionsCreatedConcurrentlyAreDistinct)
+    {
+        sharded_storage storage{8};
+        std::vector <std::vector <std::string>> ids(4);
+        std::vector <std::thread> threads;
+        for (auto& created : ids)
+        {
+            threads.emplace_back([&storage, &created]{
+                for (int i = 0; i != 1000; ++i)
+                    created.push_back(storage.create_session());
+            });
+        }
+        for (auto& thread : threads)
+            thread.join();
+
+        std::set <std::string> distinct;
+        for (auto const& created : ids)
+            distinct.insert(created.begin(), created.end());
+        EXPECT_EQ(distinct.size(), 4000);
+        EXPECT_EQ(storage.size(), 4000);
+
+        storage.clear();
+        EXPECT_EQ(storage.size(), 0);
+    }
+
+    TEST(MemorySessionStorageTests, IdleSessionsTimeOutUnlessUsed)
+    {
+        using namespace std::chrono_literals;
+
+        sharded_storage storage;
+        storage.set_expiry({.idle = 200ms, .sweep_interval = 0ms});
+        auto used = storage.create_session();
+        auto unused = storage.create_session();
+
+        for (int i = 0; i != 4; ++i)
+        {
+            std::this_thread::sleep_for(100ms);
+            EXPECT_EQ(storage.lookup_session(used, nullptr), session_state::live);
+        }
+
+        EXPECT_EQ(storage.lookup_session(unused, nullptr), session_state::timed_out);
+        EXPECT_EQ(storage.lookup_session(unused, nullptr), session_state::not_found);
+        EXPECT_EQ(storage.size(), 1);
+    }
+
+    TEST(MemorySessionStorageTests, AbsoluteExpiryIsNotRenewed)
+    {
+        using namespace std::chrono_literals;
+
+        sharded_storage storage;
+        storage.set_expiry({.absolute = 200ms, .sweep_interval = 0ms});
+        auto id = storage.create_session();
+
+        std::this_thread::sleep_for(100ms);
+        EXPECT_NE(storage.find_session(id), nullptr);
+        std::this_thread::sleep_for(150ms);
+        EXPECT_EQ(storage.find_session(id), nullptr);
+    }
+
+    TEST(MemorySessionStorageTests, SweepRemovesExpiredSessionsInTheBackground)
+    {
+        using namespace std::chrono_literals;
+
+        sharded_storage storage{4};
+        storage.set_expiry({.idle = 50ms, .sweep_interval = 20ms, .sweep_batch = 8});
+        for (int i = 0; i != 500; ++i)
+            storage.create_session();
+        auto kept = storage.create_session();
+
+        auto deadline = std::chrono::steady_clock::now() + 5s;
+        while (storage.size() > 1 && std::chrono::steady_clock::now() < deadline)
+        {
+            storage.get_session(kept, nullptr);
+            std::this_thread::sleep_for(10ms);
+        }
+        EXPECT_EQ(storage.size(), 1);
+        EXPECT_TRUE(storage.get_session(kept, nullptr));
+    }
+
+    TEST(MemorySessionStorageTests, LeastRecentlyUsedSessionMakesRoom)
+    {
+        sharded_storage storage{1};
+        storage.set_expiry({.max_sessions = 3});
+        auto first = storage.create_session();
+        auto second = storage.create_session();
+        auto third = storage.create_session();
+
+        EXPECT_TRUE(storage.get_session(first, nullptr));
+        auto fourth = storage.create_session();
+
+        EXPECT_EQ(storage.size(), 3);
+        EXPECT_TRUE(storage.get_session(first, nullptr));
+        EXPECT_FALSE(storage.get_session(second, nullptr));
+        EXPECT_TRUE(storage.get_session(third, nullptr));
+        EXPECT_TRUE(storage.get_session(fourth, nullptr));
+    }
+
+    TEST(MemorySessionStorageTests, ExpiryChangesWhileInUse)
+    {
+        using namespace std::chrono_literals;
+
+        sharded_storage storage{4};
+        std::atomic_bool done{false};
+        std::vector <std::jthread> users;
+        for (int i = 0; i != 2; ++i)
+        {
+            users.emplace_back([&storage, &done]{
+                while (!done)
+                {
+                    auto id = storage.create_session();
+                    storage.get_session(id, nullptr);
+                    storage.sweep();
+                }
+            });
+        }
+
+        for (int i = 0; i != 50; ++i)
+        {
+            storage.set_expiry({.idle = 1h, .max_sessions = 40, .sweep_interval = 0ms});
+            storage.set_expiry({});
+        }
+        storage.set_expiry({.max_sessions = 40});
+        done = true;
+        users.clear();
+
+        // the limit holds for sessions created from now on.
+        storage.clear();
+        for (int i = 0; i != 100; ++i)
+            storage.create_session();
+        EXPECT_LE(storage.size(), 40);
+    }
+}
@@ -0,0 +1,224 @@
+#pragma once
+
+#include <attender/session/shared_memory_session_storage.hpp>
+#include <attender/session/uuid_session_cookie_generator.hpp>
+
+#include <boost/interprocess/mapped_region.hpp>
+#include <boost/interprocess/shared_memory_object.hpp>
+#include <gtest/gtest.h>
+
+#include <pthread.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include <chrono>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace attender::tests
+{
+    class shared_session : public session, public session_data
+    {
+    public:
+        using session::session;
+
+        std::string serialize() override
+        {
+            return user;
+        }
+        void deserialize(std::string const& data) override
+        {
+            user = data;
+        }
+
+        std::string user;
+    };
+
+    using shared_storage = shared_memory_session_storage <uuid_generator, shared_session>;
+
+    class SharedMemorySessionStorageTests : public ::testing::Test
+    {
+    protected:
+        SharedMemorySessionStorageTests()
+            : name_{"attender-test-" + std::to_string(std::random_device{}())}
+        {
+        }
+
+        ~SharedMemorySessionStorageTests()
+        {
+            shared_session_table::remove(name_);
+        }
+
+        shared_session_options options()
+        {
+            return {
+                .name = name_,
+                .slot_count = 1024,
+                .stripe_count = 16,
+                .overflow_size = 64 * 1024
+            };
+        }
+
+    protected:
+        std::string name_;
+    };
+
+    TEST_F(SharedMemorySessionStorageTests, StoragesWithTheSameNameShareSessions)
+    {
+        shared_storage first{options()};
+        shared_storage second{options()};
+
+        auto id = first.create_session();
+        shared_session changed{id};
+        changed.user = "someone";
+        EXPECT_TRUE(second.set_session(id, changed));
+
+        shared_session restored;
+        ASSERT_TRUE(first.get_session(id, &restored));
+        EXPECT_EQ(restored.id(), id);
+        EXPECT_EQ(restored.user, "someone");
+        EXPECT_EQ(second.size(), 1);
+
+        second.delete_session(id);
+        EXPECT_FALSE(first.get_session(id, nullptr));
+    }
+
+    TEST_F(SharedMemorySessionStorageTests, LargeSessionsUseOverflowBlocksThatAreReused)
+    {
+        shared_storage storage{options()};
+        std::string large(20'000, 'x');
+
+        // 64 KiB of blocks hold about three of these at a time.
+        for (int i = 0; i != 20; ++i)
+        {
+            auto id = storage.create_session();
+            shared_session changed{id};
+            changed.user = large + std::to_string(i);
+            ASSERT_TRUE(storage.set_session(id, changed));
+
+            shared_session restored;
+            ASSERT_TRUE(storage.get_session(id, &restored));
+            EXPECT_EQ(restored.user, changed.user);
+            storage.delete_session(id);
+        }
+
+        auto id = storage.create_session();
+        shared_session changed{id};
+        changed.user = std::string(200'000, 'x');
+        EXPECT_THROW(storage.set_session(id, changed), std::length_error);
+    }
+
+    TEST_F(SharedMemorySessionStorageTests, DeletesKeepCollidingIdsReachable)
+    {
+        shared_session_table table{{.name = name_, .slot_count = 16, .stripe_count = 1}};
+        for (int i = 0; i != 16; ++i)
+            EXPECT_TRUE(table.insert("id" + std::to_string(i), std::to_string(i)));
+        EXPECT_THROW(table.insert("one too many", ""), std::length_error);
+        EXPECT_FALSE(table.insert("id3", ""));
+
+        for (int i = 0; i < 16; i += 3)
+            table.erase("id" + std::to_string(i));
+
+        for (int i = 0; i != 16; ++i)
+        {
+            std::string data;
+            auto state = table.read("id" + std::to_string(i), &data);
+            if (i % 3 == 0)
+                EXPECT_EQ(state, session_state::not_found);
+            else
+            {
+                EXPECT_EQ(state, session_state::live);
+                EXPECT_EQ(data, std::to_string(i));
+            }
+        }
+        EXPECT_EQ(table.size(), 10);
+    }
+
+    TEST_F(SharedMemorySessionStorageTests, IdleSessionsTimeOut)
+    {
+        shared_storage storage{options()};
+        storage.set_expiry({.idle = std::chrono::milliseconds{100}, .sweep_interval = std::chrono::milliseconds{0}});
+
+        auto used = storage.create_session();
+        auto unused = storage.create_session();
+        for (int i = 0; i != 4; ++i)
+        {
+            std::this_thread::sleep_for(std::chrono::milliseconds{40});
+            EXPECT_EQ(storage.lookup_session(used, nullptr), session_state::live);
+        }
+
+        EXPECT_EQ(storage.lookup_session(unused, nullptr), session_state::timed_out);
+        EXPECT_EQ(storage.lookup_session(unused, nullptr), session_state::not_found);
+
+        std::this_thread::sleep_for(std::chrono::milliseconds{150});
+        EXPECT_EQ(storage.sweep(), 1);
+        EXPECT_EQ(storage.size(), 0);
+    }
+
+    TEST_F(SharedMemorySessionStorageTests, ConcurrentOpenersAgreeOnOneLayout)
+    {
+        // half of them want a bigger table, only the layout of the one that created it may be used.
+        std::vector <int> opened(8, 0);
+        {
+            std::vector <std::jthread> openers;
+            for (std::size_t i = 0; i != opened.size(); ++i)
+            {
+                openers.emplace_back([this, i, &opened]{
+                    auto wanted = options();
+                    wanted.slot_count = i % 2 == 0 ? 1024 : 2048;
+                    try
+                    {
+                        shared_storage storage{wanted};
+                        storage.create_session();
+                        opened[i] = 1;
+                    }
+                    catch (std::runtime_error const&)
+                    {
+                        opened[i] = -1;
+                    }
+                });
+            }
+        }
+
+        int small = 0;
+        int big = 0;
+        for (std::size_t i = 0; i != opened.size(); ++i)
+            (i % 2 == 0 ? small : big) += opened[i] == 1;
+        EXPECT_TRUE((small == 4 && big == 0) || (small == 0 && big == 4));
+
+        auto other = options();
+        other.slot_count = small == 4 ? 2048 : 1024;
+        EXPECT_THROW(shared_storage{other}, std::runtime_error);
+    }
+
+    TEST_F(SharedMemorySessionStorageTests, StripeOfADeadProcessIsRepaired)
+    {
+        shared_session_table table{{.name = name_, .slot_count = 16, .stripe_count = 1}};
+        ASSERT_TRUE(table.insert("lost", "data"));
+
+        auto child = ::fork();
+        ASSERT_NE(child, -1);
+        if (child == 0)
+        {
+            // the only stripe lock is the first thing behind the header, at the first 64 byte boundary.
+            namespace interprocess = boost::interprocess;
+            interprocess::shared_memory_object object{interprocess::open_only, name_.c_str(), interprocess::read_write};
+            interprocess::mapped_region region{object, interprocess::read_write};
+            auto* lock = reinterpret_cast <pthread_mutex_t*> (static_cast <char*> (region.get_address()) + 128);
+            ::_exit(pthread_mutex_lock(lock) == 0 ? 0 : 1);
+        }
+
+        int status = 0;
+        ASSERT_EQ(::waitpid(child, &status, 0), child);
+        ASSERT_TRUE(WIFEXITED(status));
+        ASSERT_EQ(WEXITSTATUS(status), 0);
+
+        EXPECT_EQ(table.read("lost", nullptr), session_state::not_found);
+        EXPECT_EQ(table.size(), 0);
+        EXPECT_TRUE(table.insert("next", "data"));
+        EXPECT_EQ(table.read("next", nullptr), session_state::live);
+    }
+}
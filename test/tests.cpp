@@ -1,5 +1,31 @@
 // #include "http/test_http_server.hpp"
 // #include "http/test_header.hpp"
+#include "http/test_chunked_decoder.hpp"
+#include "http/test_read_sink.hpp"
+#include "http/test_multipart_sink.hpp"
+#include "http/test_response_header.hpp"
+#include "http/test_header_fields.hpp"
+#include "http/test_static_response.hpp"
+#include "http/test_chunked_latency.hpp"
+#include "http/test_sse_hub.hpp"
+#include "http/test_offload_route.hpp"
+#include "http/test_coroutine_arena.hpp"
+#include "http/test_coroutine_route.hpp"
+#include "encoding/test_compression.hpp"
+#include "encoding/test_producer.hpp"
+#include "encoding/test_segmented_buffer.hpp"
+#include "encoding/test_streaming_producer.hpp"
+#include "encoding/test_spsc_producer.hpp"
+#include "encoding/test_zlib.hpp"
+#include "encoding/test_zstd.hpp"
+#include "session/test_memory_session_storage.hpp"
+#include "session/test_file_session_storage.hpp"
+#include "session/test_shared_memory_session_storage.hpp"
+#include "session/test_async_session_control.hpp"
+#include "io_context/test_worker_pool.hpp"
+#include "io_context/test_task_scheduler.hpp"
+#include "io_context/test_file_io.hpp"
+#include "utility/test_completion_awaitable.hpp"
 // #include "websocket/test_websocket_client.hpp"
 // #include "websocket/test_websocket_secure_client.hpp"
 #include "websocket/test_websocket_server.hpp"
@@ -0,0 +1,62 @@
+#pragma once
+
+#include "../detached_coroutine.hpp"
+
+#include <attender/utility/completion_awaitable.hpp>
+
+#include <boost/asio/error.hpp>
+
+#include <gtest/gtest.h>
+
+#include <functional>
+#include <thread>
+
+namespace attender::tests
+{
+    inline auto completes_inline(boost::system::error_code ec)
+    {
+        return completion_awaitable{[ec](auto const& on_complete) {
+            on_complete(ec);
+        }};
+    }
+
+    TEST(CompletionAwaitableTests, InlineCompletionDoesNotNestResumption)
+    {
+        int completed = 0;
+        bool finished = false;
+        auto run = [&]() -> detached_coroutine {
+            // every resumption from within the initiator would add stack frames.
+            for (int i = 0; i != 1'000'000; ++i)
+            {
+                if (!co_await completes_inline({}))
+                    ++completed;
+            }
+            auto ec = co_await completes_inline(boost::asio::error::eof);
+            EXPECT_EQ(ec, boost::asio::error::eof);
+            finished = true;
+        };
+        run();
+
+        EXPECT_TRUE(finished);
+        EXPECT_EQ(completed, 1'000'000);
+    }
+
+    TEST(CompletionAwaitableTests, ResumesWhenCompletedLater)
+    {
+        std::function <void(boost::system::error_code)> pending;
+        boost::system::error_code result;
+        bool finished = false;
+        auto run = [&]() -> detached_coroutine {
+            result = co_await completion_awaitable{[&pending](auto const& on_complete) {
+                pending = on_complete;
+            }};
+            finished = true;
+        };
+        run();
+
+        EXPECT_FALSE(finished);
+        std::thread{[&pending]{ pending(boost::asio::error::timed_out); }}.join();
+        EXPECT_TRUE(finished);
+        EXPECT_EQ(result, boost::asio::error::timed_out);
+    }
+}